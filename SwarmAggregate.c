@@ -0,0 +1,143 @@
+/*
+ * SwarmAggregate.c
+ *
+ *  Created on: Oct 16, 2026
+ *      Author: MicroTechEE
+ */
+
+// STD C
+#include <stdbool.h>
+#include "string.h"
+
+#include <Message.h>
+#include <SwarmMSP430.h>
+#include <SwarmAggregate.h>
+
+/* - - - - - - - - - - - - - HELPERS - - - - - - - - - - - - - - - */
+static SwarmTxTag agg_defaultSink(SwarmModem* modem, const unsigned char* packet, unsigned int len)
+{
+    // into the FRAM queue like everything else, there's no TX ring tag to give back so 1 just means it's in
+    return swarm_queuePush(&modem->queue, packet, len) ? 1 : 0;
+}
+
+static unsigned int agg_recordSize(unsigned int len)
+{
+    return len < SWARM_AGG_EXT_LEN ? len + 1 : len + 2;   // header byte, plus the length byte for big ones
+}
+
+static SwarmTxTag agg_send(SwarmAggregator* agg)
+{
+    SwarmTxTag tag;
+
+    if(agg->len <= 1)
+        return 0;
+    tag = agg->sink(agg->modem, agg->packet, agg->len);
+    if(tag == 0){
+        agg->stats.sinkBusy++;                  // keep it, we'll try again on the next flush
+        return 0;
+    }
+    agg->stats.packets++;
+    agg->stats.packetBytes += agg->len;
+    agg->len = 0;
+    return tag;
+}
+
+/* - - - - - - - - - - - - - FUNCTIONS - - - - - - - - - - - - - - - */
+void swarm_aggInit(SwarmAggregator* agg, struct SwarmModem* modem, SwarmAggSink sink)
+{
+    memset(agg, 0, sizeof(*agg));
+    agg->modem = modem;
+    agg->fillThreshold = SWARM_AGG_FILL_DEFAULT;
+    agg->maxAgeMs = SWARM_AGG_AGE_DEFAULT_ms;
+    agg->sink = sink ? sink : agg_defaultSink;
+}
+
+unsigned int swarm_aggFree(const SwarmAggregator* agg)
+{
+    return SWARM_AGG_PACKET_MAX - (agg->len ? agg->len : 1);
+}
+
+bool swarm_aggAdd(SwarmAggregator* agg, unsigned char type, const unsigned char* data, unsigned int len,
+                  unsigned long now)
+{
+    unsigned int size = agg_recordSize(len);
+
+    if(type > 15 || size > SWARM_AGG_PACKET_MAX - 1){
+        agg->stats.rejected++;
+        return false;
+    }
+    if(size > swarm_aggFree(agg)){
+        if(!agg_send(agg)){                     // doesn't fit, send what we have and start a new one
+            agg->stats.rejected++;
+            return false;
+        }
+        agg->stats.flushFill++;
+    }
+
+    if(agg->len == 0){
+        agg->packet[0] = SWARM_AGG_VERSION;
+        agg->len = 1;
+        agg->openedAt = now;
+    }
+    if(len < SWARM_AGG_EXT_LEN)
+        agg->packet[agg->len++] = (unsigned char)(type << 4 | len);
+    else{
+        agg->packet[agg->len++] = (unsigned char)(type << 4 | SWARM_AGG_EXT_LEN);
+        agg->packet[agg->len++] = (unsigned char)len;
+    }
+    memcpy(&agg->packet[agg->len], data, len);
+    agg->len += len;
+    agg->stats.records++;
+    agg->stats.recordBytes += len;
+
+    if(agg->len >= agg->fillThreshold && agg_send(agg))
+        agg->stats.flushFill++;
+    return true;
+}
+
+void swarm_aggService(SwarmAggregator* agg, unsigned long now)
+{
+    if(agg->len > 1 && agg->maxAgeMs && (long)(now - agg->openedAt - agg->maxAgeMs) >= 0 && agg_send(agg))
+        agg->stats.flushAge++;
+}
+
+SwarmTxTag swarm_aggFlush(SwarmAggregator* agg)
+{
+    SwarmTxTag tag;
+
+    if(agg->len <= 1)
+        return 0;
+    tag = agg_send(agg);
+    if(tag)
+        agg->stats.flushManual++;
+    return tag;
+}
+
+/* - - - - DECODING - - - - */
+bool swarm_aggIsPacket(const unsigned char* packet, unsigned int len)
+{
+    return len > 1 && packet[0] == SWARM_AGG_VERSION;
+}
+
+bool swarm_aggNextRecord(const unsigned char* packet, unsigned int len, unsigned int* pos, SwarmAggRecord* record)
+{
+    // start with *pos = 0, returns false at the end of the packet or if it's corrupt
+    unsigned int p = *pos ? *pos : 1;           // skip the version byte
+    unsigned int dataLen;
+
+    if(!swarm_aggIsPacket(packet, len) || p >= len)
+        return false;
+    record->type = packet[p] >> 4;
+    dataLen = packet[p++] & 0x0F;
+    if(dataLen == SWARM_AGG_EXT_LEN){
+        if(p >= len)
+            return false;
+        dataLen = packet[p++];
+    }
+    if(p + dataLen > len)
+        return false;
+    record->len = (unsigned char)dataLen;
+    record->data = &packet[p];
+    *pos = p + dataLen;
+    return true;
+}
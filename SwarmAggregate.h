@@ -0,0 +1,79 @@
+/*
+ * SwarmAggregate.h
+ *
+ *  Created on: Oct 16, 2026
+ *      Author: MicroTechEE
+ */
+
+#ifndef SWARMAGGREGATE_H_
+#define SWARMAGGREGATE_H_
+
+#include <stdbool.h>
+#include <SwarmTx.h>
+
+/* Packs lots of small sensor records into full $TD packets, Swarm charges per packet whether it's 4 bytes or 192.
+ * This is the SAT_HEADER_INTERNAL_SEND_AGGREGATED_DATA idea, records go in as they're taken and a packet goes out when
+ * it's full (fillThreshold), when the oldest record in it hits maxAgeMs, or when you call swarm_aggFlush().
+ *
+ * Packet layout, everything after the first byte is records back to back until the end of the payload:
+ *
+ *      [SWARM_AGG_VERSION] [type:4 | len:4] [len bytes] [type:4 | len:4] [len bytes] ...
+ *
+ * len 0..14 is the data length, 15 means the real length is in the next byte (15..189). Types are yours, 0..15.
+ * swarm_aggNextRecord() walks a packet back out, it's the same code on the board and in linux/swarm_aggdecode.
+ */
+
+#define SWARM_AGG_VERSION                               0xA1     // first byte of every packet, bump it if the layout changes
+#define SWARM_AGG_PACKET_MAX                            192      // SAT_NUMBER_MAX_PACKET_BYTES_HEX
+#define SWARM_AGG_EXT_LEN                               15       // len nibble that means "length byte follows"
+#define SWARM_AGG_FILL_DEFAULT                          176      // flush once the packet is this full
+#define SWARM_AGG_AGE_DEFAULT_ms                        3600000  // or once the oldest record is an hour old
+
+struct SwarmModem;
+
+/* * * * * * * * STRUCTS * * * * * * * * * */
+typedef SwarmTxTag (*SwarmAggSink)(struct SwarmModem* modem, const unsigned char* packet,
+                                   unsigned int len);           // 0 = couldn't take it, try later
+
+typedef struct{
+    unsigned char type;
+    unsigned char len;
+    const unsigned char* data;                  // points into the packet
+}SwarmAggRecord;
+
+typedef struct{
+    unsigned long packets;
+    unsigned long records;
+    unsigned long recordBytes;                  // data only, no headers
+    unsigned long packetBytes;                  // everything that was sent
+    unsigned long flushFill;
+    unsigned long flushAge;
+    unsigned long flushManual;
+    unsigned long sinkBusy;                     // sink returned 0, packet kept
+    unsigned long rejected;                     // too big, bad type, or full and the sink was busy
+}SwarmAggStats;
+
+typedef struct{
+    unsigned char packet[SWARM_AGG_PACKET_MAX];
+    unsigned int len;                           // 0 = empty, otherwise includes the version byte
+    unsigned long openedAt;                     // millis of the first record in this packet
+    unsigned int fillThreshold;
+    unsigned long maxAgeMs;
+    struct SwarmModem* modem;                   // handed to the sink
+    SwarmAggSink sink;
+    SwarmAggStats stats;
+}SwarmAggregator;
+
+/* * * * * * * * FUNCTIONS * * * * * * * * * */
+void swarm_aggInit(SwarmAggregator* agg, struct SwarmModem* modem, SwarmAggSink sink);   // sink 0 = swarm_queuePush()
+bool swarm_aggAdd(SwarmAggregator* agg, unsigned char type, const unsigned char* data, unsigned int len,
+                  unsigned long now);
+void swarm_aggService(SwarmAggregator* agg, unsigned long now);            // age flush, call from the main loop
+SwarmTxTag swarm_aggFlush(SwarmAggregator* agg);
+unsigned int swarm_aggFree(const SwarmAggregator* agg);
+
+/* Decoding, board or host */
+bool swarm_aggIsPacket(const unsigned char* packet, unsigned int len);
+bool swarm_aggNextRecord(const unsigned char* packet, unsigned int len, unsigned int* pos, SwarmAggRecord* record);
+
+#endif /* SWARMAGGREGATE_H_ */
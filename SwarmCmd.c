@@ -0,0 +1,211 @@
+/*
+ * SwarmCmd.c
+ *
+ *  Created on: Oct 16, 2026
+ *      Author: MicroTechEE
+ */
+
+// STD C
+#include <stdbool.h>
+
+#include <Message.h>
+#include <SwarmMSP430.h>
+#include <SwarmCmd.h>
+
+/* Slot states */
+#define CMD_QUEUED                                      0        // not sent yet, waiting on due or an earlier same header
+#define CMD_WAITING                                     1        // sent, waiting on the reply until due
+
+/* - - - - - - - - - - - - - HELPERS - - - - - - - - - - - - - - - */
+static bool cmd_isDue(unsigned long now, unsigned long due)
+{
+    return (long)(now - due) >= 0;              // wrap safe
+}
+
+static void cmd_finish(SwarmCmdEngine* engine, unsigned char index, SwarmReply result, const SwarmSentence* reply)
+{
+    SwarmCmdSlot done = engine->slot[index];
+    unsigned char i;
+
+    // take it out first so the callback is free to submit again
+    for(i = index; i + 1 < engine->count; i++)
+        engine->slot[i] = engine->slot[i + 1];
+    engine->count--;
+
+    if(result == SwarmReplyOk)
+        engine->stats.completed++;
+    else if(result == SwarmReplyError)
+        engine->stats.errors++;
+    else
+        engine->stats.timeouts++;
+
+    if(done.done)
+        done.done(engine->modem, done.header, result, reply);
+}
+
+static bool cmd_isAck(const SwarmSentence* sentence)
+{
+    // OK, ERR, or a bare number (the rate, for a ?)
+    const char* field = &sentence->line[sentence->fieldStart[0]];
+    unsigned int i;
+
+    if(sentence->isError || sentence->fieldCount == 0)
+        return true;
+    if(sentence->fieldLen[0] == 2 && field[0] == 'O' && field[1] == 'K')
+        return true;
+    if(sentence->fieldCount != 1 || sentence->fieldLen[0] == 0)
+        return false;
+    for(i = 0; i < sentence->fieldLen[0]; i++){
+        if(field[i] < '0' || field[i] > '9')
+            return false;
+    }
+    return true;
+}
+
+static bool cmd_headerBlocked(const SwarmCmdEngine* engine, unsigned char index)
+{
+    // an older command with the same header has to get its reply first
+    unsigned char i;
+
+    for(i = 0; i < index; i++){
+        if(engine->slot[i].header == engine->slot[index].header)
+            return true;
+    }
+    return false;
+}
+
+/* - - - - - - - - - - - - - FUNCTIONS - - - - - - - - - - - - - - - */
+void swarm_cmdInit(SwarmCmdEngine* engine, struct SwarmModem* modem)
+{
+    engine->modem = modem;
+    engine->count = 0;
+    engine->stats.sent = 0;
+    engine->stats.retries = 0;
+    engine->stats.completed = 0;
+    engine->stats.errors = 0;
+    engine->stats.timeouts = 0;
+    engine->stats.full = 0;
+}
+
+void swarm_cmdCancelAll(SwarmCmdEngine* engine)
+{
+    engine->count = 0;
+}
+
+bool swarm_cmdSubmit(SwarmCmdEngine* engine, const char* cmd, const char* params, unsigned int timeoutMs,
+                     unsigned int delayMs, SwarmCmdDone done)
+{
+    SwarmCmdSlot* s;
+
+    if(engine->count >= SWARM_CMD_SLOTS){
+        engine->stats.full++;
+        return false;
+    }
+    s = &engine->slot[engine->count++];
+    s->cmd = cmd;
+    s->params = params;
+    s->header = (unsigned int)cmd[1] << 8 | (unsigned char)cmd[2];   // "$CS" -> SAT_HEADER_DEVICE_INFO
+    s->timeoutMs = timeoutMs ? timeoutMs : SAT_RX_TIMEOUT_ms;
+    s->due = engine->modem->hal->millis() + delayMs;
+    s->triesLeft = SWARM_CMD_RETRIES + 1;
+    s->state = CMD_QUEUED;
+    s->ackOnly = params[0] == '?' || (params[0] >= '0' && params[0] <= '9');   // "600", not "@" / "C=U" / ""
+    s->done = done;
+
+    if(delayMs == 0)
+        swarm_cmdService(engine, s->due);       // nothing to wait for, get it on the wire now
+    return true;
+}
+
+void swarm_cmdService(SwarmCmdEngine* engine, unsigned long now)
+{
+    SwarmCmdSlot* s;
+    unsigned char i = 0;
+
+    while(i < engine->count){
+        s = &engine->slot[i];
+        if(!cmd_isDue(now, s->due) || (s->state == CMD_QUEUED && cmd_headerBlocked(engine, i))){
+            i++;
+            continue;
+        }
+
+        if(s->state == CMD_WAITING){
+            if(s->triesLeft == 0){
+                cmd_finish(engine, i, SwarmReplyTimeout, 0);
+                continue;                       // the next one slid into i
+            }
+            engine->stats.retries++;
+            s->timeoutMs = s->timeoutMs >= SWARM_CMD_TIMEOUT_MAX_ms / 2 ? SWARM_CMD_TIMEOUT_MAX_ms : s->timeoutMs * 2;
+        }
+
+        if(swarm_sendCommand(engine->modem, (char*)s->cmd, (char*)s->params) == 0){
+            i++;                                // TX ring is full, try again next time around
+            continue;
+        }
+        engine->stats.sent++;
+        s->triesLeft--;
+        s->state = CMD_WAITING;
+        s->due = now + s->timeoutMs;
+        i++;
+    }
+}
+
+void swarm_cmdOnSentence(SwarmCmdEngine* engine, const SwarmSentence* sentence)
+{
+    // The oldest command waiting on this header gets it, unsolicited ones with the same header count too, except
+    // a data line for a rate set. An ERR that modem->errors says is worth another go uses up a try instead, now or
+    // after the backoff
+    SwarmCmdSlot* s;
+    SwarmRecovery recovery;
+    unsigned char i;
+
+    for(i = 0; i < engine->count; i++){
+        s = &engine->slot[i];
+        if(s->state == CMD_WAITING && s->header == sentence->header){
+            if(s->ackOnly && !cmd_isAck(sentence))
+                return;                         // streamed while it waits, the OK is still to come
+            if(sentence->isError && s->triesLeft){
+                recovery = swarm_errorPolicy(&engine->modem->errors, sentence);
+                if(recovery == SwarmRecoverRetry || recovery == SwarmRecoverBackoff){
+                    s->state = CMD_QUEUED;
+                    s->due = engine->modem->hal->millis();
+                    if(recovery == SwarmRecoverBackoff)
+                        s->due += swarm_errorBackoffMs(&engine->modem->errors, SWARM_CMD_RETRIES - s->triesLeft);
+                    engine->stats.retries++;
+                    return;
+                }
+            }
+            cmd_finish(engine, i, sentence->isError ? SwarmReplyError : SwarmReplyOk, sentence);
+            return;
+        }
+    }
+}
+
+bool swarm_cmdIsPending(const SwarmCmdEngine* engine, unsigned int header)
+{
+    unsigned char i;
+
+    for(i = 0; i < engine->count; i++){
+        if(engine->slot[i].header == header)
+            return true;
+    }
+    return false;
+}
+
+unsigned long swarm_cmdIdleMs(const SwarmCmdEngine* engine, unsigned long now, unsigned long maxMs)
+{
+    // nothing for swarm_cmdService() to do before this, a reply can only make it sooner and that's a sentence anyway
+    unsigned char i;
+    long left;
+
+    for(i = 0; i < engine->count; i++){
+        if(engine->slot[i].state == CMD_QUEUED && cmd_headerBlocked(engine, i))
+            continue;                           // goes when the one ahead of it is done, not on a clock
+        left = (long)(engine->slot[i].due - now);
+        if(left <= 0)
+            return 0;
+        if((unsigned long)left < maxMs)
+            maxMs = (unsigned long)left;
+    }
+    return maxMs;
+}
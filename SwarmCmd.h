@@ -0,0 +1,87 @@
+/*
+ * SwarmCmd.h
+ *
+ *  Created on: Oct 16, 2026
+ *      Author: MicroTechEE
+ */
+
+#ifndef SWARMCMD_H_
+#define SWARMCMD_H_
+
+#include <stdbool.h>
+#include <SwarmParser.h>
+
+/* Keeps track of every command we're waiting on an answer for. Each command is matched to its reply by header
+ * ($CS -> $CS ...), gets SAT_RX_TIMEOUT_ms (or whatever you pass) to answer and is sent again with the timeout
+ * doubled if it doesn't, up to SWARM_CMD_RETRIES times. Then the callback gets SwarmReplyTimeout.
+ *
+ * Commands with different headers go out back to back without waiting on each other, the M138 answers them
+ * in order. Two with the same header can't be told apart so the second waits until the first is done.
+ *
+ *      swarm_cmdSubmit(&modem->cmds, SAT_CMD_DEVICE_ID, SAT_CMD_PARAM_NO_PARAMS, 0, 0, myDone);
+ *
+ * An ERR the modem->errors policy says to Retry or Backoff (SwarmErrors.h) uses up one of those tries too, the
+ * callback only sees SwarmReplyError once they're gone or for an ERR that's dropped.
+ *
+ * Setting a rate ("$GN 600") or asking for one ("$GN ?") is only answered by OK, ERR or the rate itself. With the
+ * rate streaming, a $GN data line that comes in while it waits isn't the answer and is left for whoever wants it.
+ * A poll ("$GN @") and everything else takes whatever comes back with the header.
+ *
+ * cmd and params are kept by pointer for retries, pass string literals / defines, not stack buffers.
+ */
+
+#define SWARM_CMD_SLOTS                                 6        // queued + waiting on a reply
+#define SWARM_CMD_RETRIES                               3        // resends after the first try
+#define SWARM_CMD_TIMEOUT_MAX_ms                        8000     // backoff stops doubling here
+
+struct SwarmModem;
+
+/* * * * * * * * STRUCTS * * * * * * * * * */
+typedef enum{
+    SwarmReplyOk = 0,
+    SwarmReplyError,                            // $XX ERR,...
+    SwarmReplyTimeout                           // nothing back after every retry
+}SwarmReply;
+
+typedef void (*SwarmCmdDone)(struct SwarmModem* modem, unsigned int header, SwarmReply result,
+                             const SwarmSentence* reply);       // reply is 0 on timeout
+
+typedef struct{
+    const char* cmd;
+    const char* params;
+    unsigned int header;                        // SAT_HEADER_* we expect back
+    unsigned int timeoutMs;                     // for the current try, doubles every retry
+    unsigned long due;                          // queued: when to send, waiting: when to give up on this try
+    unsigned char triesLeft;
+    unsigned char state;
+    bool ackOnly;                               // a rate set or ?, a data line with the header doesn't answer it
+    SwarmCmdDone done;
+}SwarmCmdSlot;
+
+typedef struct{
+    unsigned long sent;                         // including retries
+    unsigned long retries;
+    unsigned long completed;
+    unsigned long errors;
+    unsigned long timeouts;
+    unsigned long full;                         // swarm_cmdSubmit() found no free slot
+}SwarmCmdStats;
+
+typedef struct{
+    struct SwarmModem* modem;                   // where commands go and who the callbacks are for
+    SwarmCmdSlot slot[SWARM_CMD_SLOTS];         // oldest first
+    unsigned char count;
+    SwarmCmdStats stats;
+}SwarmCmdEngine;
+
+/* * * * * * * * FUNCTIONS * * * * * * * * * */
+void swarm_cmdInit(SwarmCmdEngine* engine, struct SwarmModem* modem);
+void swarm_cmdCancelAll(SwarmCmdEngine* engine);            // no callbacks, i.e. the modem rebooted
+bool swarm_cmdSubmit(SwarmCmdEngine* engine, const char* cmd, const char* params, unsigned int timeoutMs,
+                     unsigned int delayMs, SwarmCmdDone done);  // timeoutMs 0 = SAT_RX_TIMEOUT_ms
+void swarm_cmdService(SwarmCmdEngine* engine, unsigned long now);
+void swarm_cmdOnSentence(SwarmCmdEngine* engine, const SwarmSentence* sentence);
+bool swarm_cmdIsPending(const SwarmCmdEngine* engine, unsigned int header);
+unsigned long swarm_cmdIdleMs(const SwarmCmdEngine* engine, unsigned long now, unsigned long maxMs);   // until the next resend / timeout
+
+#endif /* SWARMCMD_H_ */
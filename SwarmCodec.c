@@ -0,0 +1,161 @@
+/*
+ * SwarmCodec.c
+ *
+ *  Created on: Oct 16, 2026
+ *      Author: MicroTechEE
+ */
+
+// STD C
+#include <stdbool.h>
+
+#include <SwarmCodec.h>
+
+#define CODEC_LONG_BITS                                 (sizeof(long) * 8)
+
+/* - - - - - - - - - - - - - HELPERS - - - - - - - - - - - - - - - */
+static unsigned long codec_zigzag(long value)
+{
+    // 0, -1, 1, -2, 2 ... -> 0, 1, 2, 3, 4 ...
+    return ((unsigned long)value << 1) ^ (unsigned long)(value >> (CODEC_LONG_BITS - 1));
+}
+
+static long codec_unzigzag(unsigned long value)
+{
+    return (long)(value >> 1) ^ -(long)(value & 1);
+}
+
+/* - - - - - - - - - - - - - FUNCTIONS - - - - - - - - - - - - - - - */
+void swarm_codecInit(SwarmCodec* codec, unsigned char* buff, unsigned int max)
+{
+    codec->buff = buff;
+    codec->max = max;
+    codec->bits = 0;
+    codec->overflow = false;
+}
+
+unsigned int swarm_codecLength(const SwarmCodec* codec)
+{
+    return (codec->bits + 7) / 8;
+}
+
+/* - - - - WRITING - - - - */
+void swarm_codecPutBits(SwarmCodec* codec, unsigned long value, unsigned char bits)
+{
+    unsigned int byte;
+    unsigned char bit;
+
+    if(codec->bits + bits > codec->max * 8){
+        codec->overflow = true;
+        return;
+    }
+    while(bits){
+        bits--;
+        byte = codec->bits >> 3;
+        bit = (unsigned char)(0x80 >> (codec->bits & 7));
+        if((codec->bits & 7) == 0)
+            codec->buff[byte] = 0;              // fresh byte, don't leave old data in the padding
+        if((value >> bits) & 1)
+            codec->buff[byte] |= bit;
+        codec->bits++;
+    }
+}
+
+void swarm_codecPutVarint(SwarmCodec* codec, unsigned long value)
+{
+    // low 7 bits first, top bit set means another byte follows
+    while(value >= 0x80){
+        swarm_codecPutBits(codec, (value & 0x7F) | 0x80, 8);
+        value >>= 7;
+    }
+    swarm_codecPutBits(codec, value, 8);
+}
+
+void swarm_codecPutSVarint(SwarmCodec* codec, long value)
+{
+    swarm_codecPutVarint(codec, codec_zigzag(value));
+}
+
+void swarm_codecPutDelta(SwarmCodec* codec, long value, long* previous)
+{
+    swarm_codecPutSVarint(codec, value - *previous);
+    *previous = value;
+}
+
+void swarm_codecPutGps(SwarmCodec* codec, long latitude, long longitude)
+{
+    swarm_codecPutBits(codec, (unsigned long)(latitude + 90L * SWARM_CODEC_GPS_SCALE), SWARM_CODEC_LAT_BITS);
+    swarm_codecPutBits(codec, (unsigned long)(longitude + 180L * SWARM_CODEC_GPS_SCALE), SWARM_CODEC_LON_BITS);
+}
+
+/* - - - - READING - - - - */
+unsigned long swarm_codecGetBits(SwarmCodec* codec, unsigned char bits)
+{
+    unsigned long value = 0;
+
+    if(codec->bits + bits > codec->max * 8){
+        codec->overflow = true;
+        return 0;
+    }
+    while(bits--){
+        value = (value << 1) | ((codec->buff[codec->bits >> 3] >> (7 - (codec->bits & 7))) & 1);
+        codec->bits++;
+    }
+    return value;
+}
+
+unsigned long swarm_codecGetVarint(SwarmCodec* codec)
+{
+    unsigned long value = 0;
+    unsigned long byte;
+    unsigned char shift = 0;
+
+    do{
+        byte = swarm_codecGetBits(codec, 8);
+        if(shift < CODEC_LONG_BITS)
+            value |= (byte & 0x7F) << shift;
+        shift += 7;
+    }while((byte & 0x80) && !codec->overflow);
+    return value;
+}
+
+long swarm_codecGetSVarint(SwarmCodec* codec)
+{
+    return codec_unzigzag(swarm_codecGetVarint(codec));
+}
+
+long swarm_codecGetDelta(SwarmCodec* codec, long* previous)
+{
+    *previous += swarm_codecGetSVarint(codec);
+    return *previous;
+}
+
+void swarm_codecGetGps(SwarmCodec* codec, long* latitude, long* longitude)
+{
+    *latitude = (long)swarm_codecGetBits(codec, SWARM_CODEC_LAT_BITS) - 90L * SWARM_CODEC_GPS_SCALE;
+    *longitude = (long)swarm_codecGetBits(codec, SWARM_CODEC_LON_BITS) - 180L * SWARM_CODEC_GPS_SCALE;
+}
+
+/* - - - - HELPERS - - - - */
+long swarm_codecGpsFromMicro(long microDegrees)
+{
+    // info.gps is in 1e-6 degrees, the codec steps are 1e-5, rounded
+    return (microDegrees < 0 ? microDegrees - SWARM_CODEC_GPS_MICRO / 2 : microDegrees + SWARM_CODEC_GPS_MICRO / 2) /
+           SWARM_CODEC_GPS_MICRO;
+}
+
+long swarm_codecGpsToMicro(long fixed)
+{
+    return fixed * SWARM_CODEC_GPS_MICRO;
+}
+
+bool swarm_codecIsPrintable(const unsigned char* data, unsigned int len)
+{
+    // '"' ends the string, '*' and '$' would confuse anything parsing the sentence
+    unsigned int i;
+
+    for(i = 0; i < len; i++){
+        if(data[i] < 0x20 || data[i] > 0x7E || data[i] == '"' || data[i] == '*' || data[i] == '$')
+            return false;
+    }
+    return len > 0;
+}
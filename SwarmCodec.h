@@ -0,0 +1,68 @@
+/*
+ * SwarmCodec.h
+ *
+ *  Created on: Oct 16, 2026
+ *      Author: MicroTechEE
+ */
+
+#ifndef SWARMCODEC_H_
+#define SWARMCODEC_H_
+
+#include <stdbool.h>
+
+/* Squeezes samples down before they become a $TD payload (or a SwarmAggregate record). Everything goes into
+ * one bit stream, MSB first, so fields don't have to land on byte boundaries:
+ *
+ *      swarm_codecPutBits()        fixed width, i.e. a 12 bit ADC reading takes 12 bits, not 16
+ *      swarm_codecPutVarint()      7 bits a byte, small numbers are small (0..127 is 1 byte)
+ *      swarm_codecPutSVarint()     zig-zag first so -1 is 1 byte too, not 5
+ *      swarm_codecPutDelta()       zig-zag varint of the change since the last sample, a slow time series is ~1 byte
+ *      swarm_codecPutGps()         lat/lon as 25 + 26 bit fixed point, ~1.1m steps, instead of 2 floats
+ *
+ * The readers are the same code run backwards, use them on the ground to decode. Both sides have to agree on the
+ * order of the fields, the stream doesn't describe itself (wrap it in a SwarmAggregate record type if it should).
+ */
+
+#define SWARM_CODEC_GPS_SCALE                           100000L  // 1e-5 degrees per step
+#define SWARM_CODEC_GPS_MICRO                           10L      // micro-degrees per step
+#define SWARM_CODEC_LAT_BITS                            25       // (90 + 90) * 1e5 < 2^25
+#define SWARM_CODEC_LON_BITS                            26       // (180 + 180) * 1e5 < 2^26
+
+/* * * * * * * * STRUCTS * * * * * * * * * */
+typedef struct{
+    unsigned char* buff;
+    unsigned int max;                           // bytes
+    unsigned int bits;                          // written (or read) so far
+    bool overflow;                              // ran off the end, the rest was dropped
+}SwarmCodec;
+
+typedef enum{
+    SwarmPayloadHex = 0,                        // 2 chars a byte, anything goes
+    SwarmPayloadAscii,                          // 1 char a byte, printable only (see swarm_codecIsPrintable)
+    SwarmPayloadAuto                            // ASCII if it can be, hex if not
+}SwarmPayloadMode;
+
+/* * * * * * * * FUNCTIONS * * * * * * * * * */
+void swarm_codecInit(SwarmCodec* codec, unsigned char* buff, unsigned int max);
+unsigned int swarm_codecLength(const SwarmCodec* codec);                   // bytes, the last one padded with 0s
+
+/* Writing */
+void swarm_codecPutBits(SwarmCodec* codec, unsigned long value, unsigned char bits);
+void swarm_codecPutVarint(SwarmCodec* codec, unsigned long value);
+void swarm_codecPutSVarint(SwarmCodec* codec, long value);
+void swarm_codecPutDelta(SwarmCodec* codec, long value, long* previous);
+void swarm_codecPutGps(SwarmCodec* codec, long latitude, long longitude);  // fixed point, see swarm_codecGpsFromMicro()
+
+/* Reading */
+unsigned long swarm_codecGetBits(SwarmCodec* codec, unsigned char bits);
+unsigned long swarm_codecGetVarint(SwarmCodec* codec);
+long swarm_codecGetSVarint(SwarmCodec* codec);
+long swarm_codecGetDelta(SwarmCodec* codec, long* previous);
+void swarm_codecGetGps(SwarmCodec* codec, long* latitude, long* longitude);
+
+/* Helpers */
+long swarm_codecGpsFromMicro(long microDegrees);                          // modem->info.gps -> swarm_codecPutGps()
+long swarm_codecGpsToMicro(long fixed);
+bool swarm_codecIsPrintable(const unsigned char* data, unsigned int len);
+
+#endif /* SWARMCODEC_H_ */
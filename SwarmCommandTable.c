@@ -0,0 +1,32 @@
+/*
+ * SwarmCommandTable.c
+ *
+ *  GENERATED by linux/swarm_gencmds.c from SAT_PREBUILT_COMMANDS in SwarmMSP430.h, don't edit.
+ *  Run "make -C linux commands" after changing the commands.
+ */
+
+#include <Message.h>
+#include <SwarmMSP430.h>
+
+const SwarmPrebuiltCmd swarmCommandTable[SwarmCmdCount] = {
+    [SwarmCmdDeviceId] = {"$CS", "", "$CS*10\n", 7},
+    [SwarmCmdDateTimeLast] = {"$DT", "@", "$DT @*70\n", 9},
+    [SwarmCmdFwVersion] = {"$FV", "", "$FV*10\n", 7},
+    [SwarmCmdGpioWakeLowHigh] = {"$GP 3", "", "$GP 3*04\n", 9},
+    [SwarmCmdGpioWakeHighLow] = {"$GP 4", "", "$GP 4*03\n", 9},
+    [SwarmCmdGpsInfoLast] = {"$GN", "@", "$GN @*69\n", 9},
+    [SwarmCmdGpsFixLast] = {"$GS", "@", "$GS @*74\n", 9},
+    [SwarmCmdGpsJammingLast] = {"$GJ", "@", "$GJ @*6D\n", 9},
+    [SwarmCmdPowerStatusLast] = {"$PW", "@", "$PW @*67\n", 9},
+    [SwarmCmdQueryUnsent] = {"$MT", "C=U", "$MT C=U*12\n", 11},
+    [SwarmCmdDeleteUnsent] = {"$MT", "D=U", "$MT D=U*15\n", 11},
+    [SwarmCmdQueryUnread] = {"$MM", "C=U", "$MM C=U*0B\n", 11},
+    [SwarmCmdReadOldest] = {"$MM", "R=O", "$MM R=O*00\n", 11},
+    [SwarmCmdMarkAllRead] = {"$MM", "M=*", "$MM M=**7A\n", 11},
+    [SwarmCmdDeleteRead] = {"$MM", "D=*", "$MM D=**73\n", 11},
+    [SwarmCmdPowerOff] = {"$PO", "", "$PO*1F\n", 7},
+    [SwarmCmdRestart] = {"$RS", "", "$RS*01\n", 7},
+    [SwarmCmdBackgroundRssi] = {"$RT", "180", "$RT 180*1F\n", 11},
+    [SwarmCmdRssiLast] = {"$RT", "@", "$RT @*66\n", 9},
+    [SwarmCmdSleepDefault] = {"$SL", "S=86400", "$SL S=86400*6B\n", 15},
+};
@@ -0,0 +1,402 @@
+/*
+ * SwarmDownlink.c
+ *
+ *  Created on: Oct 16, 2026
+ *      Author: MicroTechEE
+ */
+
+// STD C
+#include <stdbool.h>
+#include "string.h"
+
+#include <Message.h>
+#include <SwarmMSP430.h>
+#include <SwarmDownlink.h>
+
+/* $MM run states */
+#define DL_IDLE                                         0
+#define DL_QUERY                                        1        // $MM C=U
+#define DL_READ                                         2        // $MM R=O, one after the other
+#define DL_MARK                                         3        // $MM M=*
+#define DL_DELETE                                       4        // $MM D=*
+
+/* - - - - - - - - - - - - - HELPERS - - - - - - - - - - - - - - - */
+static signed char dl_hexNibble(char c)
+{
+    if(c >= '0' && c <= '9')
+        return c - '0';
+    if(c >= 'A' && c <= 'F')
+        return c - 'A' + 10;
+    if(c >= 'a' && c <= 'f')
+        return c - 'a' + 10;
+    return -1;
+}
+
+static SwarmDownlinkMsg* dl_claim(SwarmDownlink* downlink, unsigned int keepFree)
+{
+    // the slot at head, not visible to the consumer until dl_commit()
+    if(downlink->head - downlink->tail >= SWARM_DOWNLINK_SLOTS - keepFree){
+        downlink->stats.dropped++;
+        return 0;
+    }
+    return &downlink->slot[downlink->head % SWARM_DOWNLINK_SLOTS];
+}
+
+static void dl_commit(SwarmDownlink* downlink)
+{
+    downlink->head++;                           // publish, one 16 bit write
+    if(swarm_downlinkDepth(downlink) > downlink->stats.highWater)
+        downlink->stats.highWater = swarm_downlinkDepth(downlink);
+}
+
+/* - - - - THE MODEM'S UNREAD LIST - - - - */
+static bool dl_canTrack(const SwarmDownlink* downlink)
+{
+    // an $RD goes in rdHave only if nothing unread is behind the ones there, otherwise it joins behind
+    return downlink->behind == 0 && downlink->rdCount < SWARM_DOWNLINK_TRACK;
+}
+
+static void dl_track(SwarmDownlink* downlink, bool have)
+{
+    if(!dl_canTrack(downlink)){
+        downlink->behind++;
+        return;
+    }
+    if(have)
+        downlink->rdHave |= 1UL << downlink->rdCount;
+    else
+        downlink->rdMissing++;
+    downlink->rdCount++;
+}
+
+static bool dl_untrackOldest(SwarmDownlink* downlink)
+{
+    // R=O took the oldest unread one, true if that was an $RD we delivered
+    bool have;
+
+    if(downlink->rdCount == 0){
+        if(downlink->behind)
+            downlink->behind--;
+        return false;
+    }
+    have = downlink->rdHave & 1;
+    downlink->rdHave >>= 1;
+    downlink->rdCount--;
+    if(!have)
+        downlink->rdMissing--;
+    return have;
+}
+
+static void dl_forget(SwarmDownlink* downlink)
+{
+    // nothing unread on the modem
+    downlink->rdHave = 0;
+    downlink->rdCount = 0;
+    downlink->rdMissing = 0;
+    downlink->behind = 0;
+}
+
+static unsigned int dl_missing(const SwarmDownlink* downlink)
+{
+    return downlink->rdMissing + downlink->behind;
+}
+
+static bool dl_decodeInto(SwarmDownlink* downlink, SwarmDownlinkMsg* message, const char* text, unsigned int len)
+{
+    unsigned int dataLen;
+
+    if(!swarm_downlinkDecode(text, len, message->data, &dataLen)){
+        downlink->stats.bad++;
+        return false;
+    }
+    message->len = (unsigned char)dataLen;
+    return true;
+}
+
+static SwarmDownlinkHandler dl_handler(const SwarmDownlink* downlink, unsigned int appId)
+{
+    unsigned char i;
+
+    for(i = 0; i < downlink->routes; i++){
+        if(downlink->route[i].appId == appId)
+            return downlink->route[i].handler;
+    }
+    return downlink->fallback;
+}
+
+static bool dl_submit(SwarmDownlink* downlink, const char* params, SwarmCmdDone done, unsigned char state)
+{
+    if(!swarm_cmdSubmit(&downlink->modem->cmds, SAT_CMD_MSG_RX_MANAGEMENT, params, 0, 0, done))
+        return false;                           // engine is full, service tries again
+    downlink->state = state;
+    downlink->stats.commands++;
+    return true;
+}
+
+static void dl_deleteDone(SwarmModem* modem, unsigned int header, SwarmReply result, const SwarmSentence* reply)
+{
+    modem->downlink.state = DL_IDLE;
+    if(result == SwarmReplyOk)
+        modem->downlink.stats.cleanups++;
+}
+
+static void dl_markDone(SwarmModem* modem, unsigned int header, SwarmReply result, const SwarmSentence* reply)
+{
+    modem->downlink.state = DL_IDLE;
+    if(result != SwarmReplyOk)
+        return;
+    dl_forget(&modem->downlink);                // every one of them was delivered, service checked before M=*
+    dl_submit(&modem->downlink, SAT_CMD_PARAM_DELETE_READ, dl_deleteDone, DL_DELETE);
+}
+
+static void dl_readDone(SwarmModem* modem, unsigned int header, SwarmReply result, const SwarmSentence* reply);
+
+static void dl_readNext(SwarmDownlink* downlink)
+{
+    // one slot is kept for this read, an $RD that lands in the meantime can't take it
+    if(downlink->batchLeft && dl_missing(downlink) && swarm_downlinkDepth(downlink) < SWARM_DOWNLINK_SLOTS &&
+       dl_submit(downlink, SAT_CMD_PARAM_READ_OLDEST, dl_readDone, DL_READ))
+        return;
+
+    downlink->state = DL_IDLE;
+    if(downlink->batchRead)
+        dl_submit(downlink, SAT_CMD_PARAM_DELETE_READ, dl_deleteDone, DL_DELETE);
+}
+
+static void dl_readDone(SwarmModem* modem, unsigned int header, SwarmReply result, const SwarmSentence* reply)
+{
+    SwarmDownlink* downlink = &modem->downlink;
+    SwarmDownlinkMsg* message;
+    SwarmMmReply mm;
+
+    if(result != SwarmReplyOk || !swarm_sentenceMm(reply, &mm) || mm.kind != SwarmMmMessage){
+        if(result == SwarmReplyError)
+            dl_forget(downlink);                // $MM ERR,DBXNOMORE, or close enough
+        downlink->batchLeft = 0;
+        dl_readNext(downlink);
+        return;
+    }
+
+    downlink->stats.read++;
+    downlink->batchRead++;                      // it's marked read on the modem either way
+    downlink->batchLeft--;
+    if(dl_untrackOldest(downlink)){
+        downlink->stats.repeats++;              // the $RD of this very message is in the ring already
+        dl_readNext(downlink);
+        return;
+    }
+    message = dl_claim(downlink, 0);
+    if(message){
+        message->appId = mm.appId;
+        message->rssi = 0;
+        message->snr = 0;
+        message->fdev = 0;
+        message->epoch = mm.epoch;
+        message->source = SwarmDownlinkFromMm;
+        if(dl_decodeInto(downlink, message, mm.data, mm.dataLen))
+            dl_commit(downlink);
+    }
+    dl_readNext(downlink);
+}
+
+static void dl_queryDone(SwarmModem* modem, unsigned int header, SwarmReply result, const SwarmSentence* reply)
+{
+    SwarmDownlink* downlink = &modem->downlink;
+    unsigned int known;
+    SwarmMmReply mm;
+
+    downlink->state = DL_IDLE;
+    if(result != SwarmReplyOk || !swarm_sentenceMm(reply, &mm) || mm.kind != SwarmMmCount)
+        return;                                 // still not synced, service asks again
+    downlink->synced = true;
+    known = downlink->rdCount + downlink->behind;
+    if(mm.count > known)
+        downlink->behind += mm.count - known;   // came in while we weren't listening, newest so they go last
+    while(mm.count < known--)
+        dl_untrackOldest(downlink);             // fewer than we thought, the oldest are the ones gone
+}
+
+/* - - - - - - - - - - - - - FUNCTIONS - - - - - - - - - - - - - - - */
+void swarm_downlinkInit(SwarmDownlink* downlink, struct SwarmModem* modem)
+{
+    // the route table is left alone so handlers can be registered before swarm_startup()
+    downlink->modem = modem;
+    downlink->head = 0;
+    downlink->tail = 0;
+    dl_forget(downlink);                        // $MM C=U puts anything that's waiting in behind
+    downlink->state = DL_IDLE;
+    downlink->synced = false;
+    downlink->batchLeft = 0;
+    downlink->batchRead = 0;
+    downlink->lastQuery = 0;
+    downlink->lastRd = 0;
+    downlink->cleanupIdleMs = SWARM_DOWNLINK_CLEANUP_ms;
+    memset(&downlink->stats, 0, sizeof(downlink->stats));
+}
+
+bool swarm_downlinkRoute(SwarmDownlink* downlink, unsigned int appId, SwarmDownlinkHandler handler)
+{
+    unsigned char i;
+
+    for(i = 0; i < downlink->routes; i++){
+        if(downlink->route[i].appId == appId)
+            break;
+    }
+    if(handler == 0){
+        if(i == downlink->routes)
+            return false;
+        for(; i + 1 < downlink->routes; i++)
+            downlink->route[i] = downlink->route[i + 1];
+        downlink->routes--;
+        return true;
+    }
+    if(i == downlink->routes){
+        if(downlink->routes >= SWARM_DOWNLINK_ROUTES)
+            return false;
+        downlink->routes++;
+    }
+    downlink->route[i].appId = appId;
+    downlink->route[i].handler = handler;
+    return true;
+}
+
+void swarm_downlinkFallback(SwarmDownlink* downlink, SwarmDownlinkHandler handler)
+{
+    downlink->fallback = handler;
+}
+
+/* - - - - DRIVER SIDE - - - - */
+void swarm_downlinkService(SwarmDownlink* downlink, unsigned long now)
+{
+    SwarmModem* modem = downlink->modem;
+
+    if(downlink->state != DL_IDLE && !swarm_cmdIsPending(&modem->cmds, SAT_HEADER_MESSAGE_MANAGEMENT_RX))
+        downlink->state = DL_IDLE;              // the engine was flushed (modem rebooted), no callback is coming
+
+    if(!modem->info.satFullyInitialized || modem->info.isSleeping){
+        downlink->synced = false;               // ask again once we're listening, it may have something for us
+        return;
+    }
+    if(downlink->state != DL_IDLE)
+        return;
+
+    if(!downlink->synced || now - downlink->lastQuery >= SWARM_DOWNLINK_QUERY_ms){
+        if(dl_submit(downlink, SAT_CMD_PARAM_QUERY_UNSENT_MESSAGES, dl_queryDone, DL_QUERY))
+            downlink->lastQuery = now;
+    }
+    else if(dl_missing(downlink) && swarm_downlinkDepth(downlink) < SWARM_DOWNLINK_SLOTS){
+        // on the modem and not here yet, read them back while there's room
+        downlink->batchLeft = SWARM_DOWNLINK_BATCH;
+        downlink->batchRead = 0;
+        downlink->stats.batches++;
+        dl_readNext(downlink);
+    }
+    else if(!dl_missing(downlink) && downlink->rdCount &&
+            (downlink->rdCount >= SWARM_DOWNLINK_BATCH || now - downlink->lastRd >= downlink->cleanupIdleMs)){
+        // every $RD since the last clean up made it into the ring, the modem's copies can go.
+        // An $RD that lands in the few ms between M=* and its OK is the one gap
+        dl_submit(downlink, SAT_CMD_PARAM_MARK_ALL_READ, dl_markDone, DL_MARK);
+    }
+}
+
+void swarm_downlinkOnRd(SwarmDownlink* downlink, const SwarmSentence* sentence, unsigned long now)
+{
+    SwarmRdMessage rd;
+    SwarmDownlinkMsg* message;
+
+    if(!swarm_sentenceRd(sentence, &rd))
+        return;
+    downlink->stats.received++;
+    downlink->lastRd = now;
+
+    // it's unread on the modem too. Behind others we don't have yet it waits its turn for R=O, so the order holds
+    message = dl_canTrack(downlink) ? dl_claim(downlink, downlink->state == DL_READ ? 1 : 0) : 0;
+    if(message == 0){
+        dl_track(downlink, false);              // $MM R=O gets it
+        return;
+    }
+    message->appId = rd.appId;
+    message->rssi = rd.rssi;
+    message->snr = rd.snr;
+    message->fdev = rd.fdev;
+    message->epoch = 0;
+    message->source = SwarmDownlinkFromRd;
+    if(!dl_decodeInto(downlink, message, rd.data, rd.dataLen)){
+        dl_track(downlink, true);               // bad on the modem too, reading it back won't help
+        return;
+    }
+    dl_commit(downlink);
+    dl_track(downlink, true);
+}
+
+bool swarm_downlinkDecode(const char* text, unsigned int len, unsigned char* data, unsigned int* dataLen)
+{
+    // "quoted ASCII" is taken as is, anything else has to be pairs of hex digits
+    unsigned int i;
+    signed char high;
+    signed char low;
+
+    if(len >= 2 && text[0] == '"' && text[len - 1] == '"'){
+        len -= 2;
+        if(len > SWARM_DOWNLINK_DATA_MAX)
+            return false;
+        memcpy(data, text + 1, len);
+        *dataLen = len;
+        return true;
+    }
+    if(len == 0 || (len & 1) || len / 2 > SWARM_DOWNLINK_DATA_MAX)
+        return false;
+    for(i = 0; i < len; i += 2){
+        high = dl_hexNibble(text[i]);
+        low = dl_hexNibble(text[i + 1]);
+        if(high < 0 || low < 0)
+            return false;
+        data[i / 2] = (unsigned char)(high << 4 | low);
+    }
+    *dataLen = len / 2;
+    return true;
+}
+
+bool swarm_downlinkIsBusy(const SwarmDownlink* downlink)
+{
+    return downlink->state != DL_IDLE;
+}
+
+/* - - - - HANDLER SIDE - - - - */
+unsigned int swarm_downlinkDispatch(SwarmDownlink* downlink)
+{
+    const SwarmDownlinkMsg* message;
+    SwarmDownlinkHandler handler;
+    unsigned int count = 0;
+
+    while((message = swarm_downlinkPeek(downlink)) != 0){
+        handler = dl_handler(downlink, message->appId);
+        if(handler){
+            handler(message);
+            downlink->stats.delivered++;
+        }
+        else
+            downlink->stats.unrouted++;
+        swarm_downlinkRelease(downlink);
+        count++;
+    }
+    return count;
+}
+
+const SwarmDownlinkMsg* swarm_downlinkPeek(const SwarmDownlink* downlink)
+{
+    if(downlink->tail == downlink->head)
+        return 0;
+    return &downlink->slot[downlink->tail % SWARM_DOWNLINK_SLOTS];
+}
+
+void swarm_downlinkRelease(SwarmDownlink* downlink)
+{
+    if(downlink->tail != downlink->head)
+        downlink->tail++;                       // slot goes back to the producer
+}
+
+unsigned int swarm_downlinkDepth(const SwarmDownlink* downlink)
+{
+    return downlink->head - downlink->tail;
+}
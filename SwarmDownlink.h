@@ -0,0 +1,132 @@
+/*
+ * SwarmDownlink.h
+ *
+ *  Created on: Oct 16, 2026
+ *      Author: MicroTechEE
+ */
+
+#ifndef SWARMDOWNLINK_H_
+#define SWARMDOWNLINK_H_
+
+#include <stdbool.h>
+#include <SwarmParser.h>
+
+/* Inbound messages, the other half of SwarmQueue. Every $RD the modem pushes at us and every message read back with
+ * $MM R=O is decoded (hex or "quoted ASCII") straight into a slot of a ring, no copy of the line anywhere else.
+ * swarm_downlinkDispatch() then hands each one to the handler registered for its appID.
+ *
+ *      Producer: the sentence side, swarm_handleMsg()      -> swarm_downlinkOnRd() / the $MM callbacks
+ *      Consumer: whoever runs the handlers                 -> swarm_downlinkDispatch(), or Peek() + Release()
+ *
+ * head is only written by the producer and tail only by the consumer, same as SwarmTxRing, so the handlers can run
+ * in another task or a lower priority loop (SAT_DOWNLINK_DISPATCH 0) without any locking.
+ *
+ * The modem keeps its own copy of every message it receives, and that database is only managed in batches:
+ *
+ *      $RD delivered, SWARM_DOWNLINK_BATCH of them or cleanupIdleMs of quiet  -> $MM M=*  then $MM D=*
+ *      an $RD didn't fit in the ring, or $MM C=U says some came in while we
+ *      weren't listening (startup, wake)                                     -> $MM R=O  back to back, then $MM D=*
+ *
+ * Two or three commands per batch instead of a read and a delete per message. The R=O reads are chained from each
+ * reply's callback so the next one is on the wire right away, and they stop when the ring is full: the rest stay
+ * on the modem, which is the best buffer we have.
+ *
+ * An $RD has no msg_id, so nothing is matched by content: two commands with the same bytes are two commands. Instead
+ * we keep the modem's unread list in the order R=O hands it back. Every $RD since the last M=* is one bit in rdHave
+ * (1 = it's in the ring already), and behind counts the unread ones after those that never reached us ($MM C=U says
+ * more than we know of, or an $RD came while we were still behind). R=O takes them off the front, a message whose
+ * bit is 1 is skipped (stats.repeats), the rest are delivered. M=* only goes out when every one of them is here. The
+ * one gap is an $RD landing in the few ms between M=* going out and its OK.
+ *
+ *      swarm_downlinkRoute(&modem->downlink, 7777, myCommandHandler);      // before or after swarm_startup()
+ */
+
+#define SWARM_DOWNLINK_SLOTS                            8        // decoded messages waiting for a handler, power of 2
+#define SWARM_DOWNLINK_DATA_MAX                         192      // SAT_NUMBER_MAX_PACKET_BYTES_HEX
+#define SWARM_DOWNLINK_ROUTES                           8        // appIDs with their own handler
+#define SWARM_DOWNLINK_BATCH                            16       // $MM R=O per batch, and $RD between clean ups
+#define SWARM_DOWNLINK_TRACK                            32       // $RD between clean ups we keep order of, bits in rdHave
+#define SWARM_DOWNLINK_CLEANUP_ms                       60000    // no $RD for this long -> clean up what's there
+#define SWARM_DOWNLINK_QUERY_ms                         3600000  // $MM C=U this often in case we missed something
+
+struct SwarmModem;
+
+/* * * * * * * * STRUCTS * * * * * * * * * */
+typedef enum{
+    SwarmDownlinkFromRd = 0,                    // pushed by the modem as it arrived
+    SwarmDownlinkFromMm                         // read back from the modem's database
+}SwarmDownlinkSource;
+
+typedef struct{
+    unsigned int appId;
+    int rssi;                                   // dBm, $RD only
+    int snr;                                    // dB, $RD only
+    int fdev;                                   // Hz, $RD only
+    unsigned long epoch;                        // when the modem got it, $MM only
+    unsigned char source;                       // SwarmDownlinkSource
+    unsigned char len;
+    unsigned char data[SWARM_DOWNLINK_DATA_MAX];   // decoded, not the hex
+}SwarmDownlinkMsg;
+
+typedef void (*SwarmDownlinkHandler)(const SwarmDownlinkMsg* message);
+
+typedef struct{
+    unsigned int appId;
+    SwarmDownlinkHandler handler;
+}SwarmDownlinkRoute;
+
+typedef struct{
+    unsigned long received;                     // $RD
+    unsigned long read;                         // $MM R=O
+    unsigned long delivered;                    // handed to a handler
+    unsigned long unrouted;                     // no handler for the appID and no fallback
+    unsigned long dropped;                      // ring full, read back later
+    unsigned long repeats;                      // read back, but its $RD was already delivered
+    unsigned long bad;                          // data wasn't hex or "quoted"
+    unsigned long batches;                      // $MM R=O runs
+    unsigned long cleanups;                     // $MM D=*
+    unsigned long commands;                     // every $MM we sent
+    unsigned int highWater;
+}SwarmDownlinkStats;
+
+typedef struct{
+    struct SwarmModem* modem;                   // whose database the $MM go to
+    SwarmDownlinkMsg slot[SWARM_DOWNLINK_SLOTS];
+    volatile unsigned int head;                 // free running, written by producer
+    volatile unsigned int tail;                 // free running, written by consumer
+    SwarmDownlinkRoute route[SWARM_DOWNLINK_ROUTES];
+    unsigned char routes;
+    SwarmDownlinkHandler fallback;              // any appID without a route, 0 = count it and move on
+
+    unsigned long rdHave;                       // oldest unread $RD is bit 0, 1 = delivered, 0 = it didn't fit
+    unsigned char rdCount;                      // bits in rdHave
+    unsigned char rdMissing;                    // 0 bits in rdHave
+    unsigned int behind;                        // unread on the modem after the rdHave ones, none of them here
+    unsigned char state;
+    bool synced;                                // had an $MM C=U since startup / wake
+    unsigned int batchLeft;                     // $MM R=O left in this run
+    unsigned int batchRead;
+    unsigned long lastQuery;
+    unsigned long lastRd;
+    unsigned long cleanupIdleMs;
+    SwarmDownlinkStats stats;
+}SwarmDownlink;
+
+/* * * * * * * * FUNCTIONS * * * * * * * * * */
+void swarm_downlinkInit(SwarmDownlink* downlink, struct SwarmModem* modem);   // keeps the routes
+bool swarm_downlinkRoute(SwarmDownlink* downlink, unsigned int appId, SwarmDownlinkHandler handler);   // 0 removes it
+void swarm_downlinkFallback(SwarmDownlink* downlink, SwarmDownlinkHandler handler);
+
+/* Driver side */
+void swarm_downlinkService(SwarmDownlink* downlink, unsigned long now);
+void swarm_downlinkOnRd(SwarmDownlink* downlink, const SwarmSentence* sentence, unsigned long now);
+bool swarm_downlinkDecode(const char* text, unsigned int len, unsigned char* data, unsigned int* dataLen);   // hex or "ASCII"
+bool swarm_downlinkIsBusy(const SwarmDownlink* downlink);      // an $MM run is going
+
+/* Handler side */
+unsigned int swarm_downlinkDispatch(SwarmDownlink* downlink);  // how many went out
+const SwarmDownlinkMsg* swarm_downlinkPeek(const SwarmDownlink* downlink);
+void swarm_downlinkRelease(SwarmDownlink* downlink);
+unsigned int swarm_downlinkDepth(const SwarmDownlink* downlink);
+
+#endif /* SWARMDOWNLINK_H_ */
@@ -0,0 +1,178 @@
+/*
+ * SwarmErrors.c
+ *
+ *  Created on: Oct 16, 2026
+ *      Author: MicroTechEE
+ */
+
+// STD C
+#include <stdbool.h>
+#include "string.h"
+
+#include <Message.h>
+#include <SwarmMSP430.h>
+#include <SwarmErrors.h>
+
+/* - - - - - - - - - - - - - GLOBALS - - - - - - - - - - - - - - - */
+typedef struct{
+    const char* text;                           // matches the start of the code, "BADPARAM" takes BADPARAMLENGTH too
+    SwarmErrCode code;
+}SwarmErrName;
+
+static const SwarmErrName errNames[] = {
+    {"BADCHECKSUM",     SwarmErrBadChecksum},
+    {"DBXTOHIVEFULL",   SwarmErrFull},
+    {"NOSPACE",         SwarmErrFull},
+    {"TIMENOTAVAIL",    SwarmErrNoTime},
+    {"NOTIME",          SwarmErrNoTime},
+    {"BUSY",            SwarmErrBusy},
+    {"DBXNOMORE",       SwarmErrNotFound},
+    {"DBXINVMSGID",     SwarmErrNotFound},
+    {"NOCOMMAND",       SwarmErrBadCommand},
+    {"BADPARAM",        SwarmErrBadCommand},
+    {"INVALIDCHAR",     SwarmErrBadCommand},
+    {"BADDATA",         SwarmErrBadCommand},
+    {"TDTOOLONG",       SwarmErrBadCommand},
+    {"BADAPPID",        SwarmErrBadCommand},
+    {"BADEXPIRETIME",   SwarmErrBadCommand},
+    {"BADHOLD",         SwarmErrBadCommand}
+};
+#define SWARM_ERR_NAMES         (sizeof(errNames) / sizeof(errNames[0]))
+
+static const SwarmRecovery policyDefaults[SwarmErrCodeCount] = {
+    SwarmRecoverDrop,                           // SwarmErrNone, never looked up
+    SwarmRecoverRetry,                          // SwarmErrBadChecksum
+    SwarmRecoverDrop,                           // SwarmErrBadCommand
+    SwarmRecoverBackoff,                        // SwarmErrFull
+    SwarmRecoverBackoff,                        // SwarmErrNoTime
+    SwarmRecoverBackoff,                        // SwarmErrBusy
+    SwarmRecoverDrop,                           // SwarmErrNotFound
+    SwarmRecoverDrop                            // SwarmErrOther, going round in circles on something we don't know is worse
+};
+
+/* - - - - - - - - - - - - - FUNCTIONS - - - - - - - - - - - - - - - */
+void swarm_errorInit(SwarmErrors* errors, struct SwarmModem* modem)
+{
+    memset(errors, 0, sizeof(*errors));
+    errors->modem = modem;
+    memcpy(errors->policy, policyDefaults, sizeof(errors->policy));
+    errors->backoffMs = SWARM_ERR_BACKOFF_ms;
+    errors->silentTimeouts = SWARM_ERR_SILENT_TIMEOUTS;
+}
+
+SwarmErrCode swarm_errorCode(const SwarmSentence* sentence)
+{
+    // $XX ERR,<code>  the parser already knows field 0 is ERR
+    const char* text;
+    unsigned int len;
+    unsigned int n;
+    unsigned char i;
+
+    if(!sentence->isError)
+        return SwarmErrNone;
+    text = swarm_sentenceField(sentence, 1, &len);     // "" if there's no code at all, that's Other
+    for(i = 0; i < SWARM_ERR_NAMES; i++){
+        n = strlen(errNames[i].text);
+        if(len >= n && memcmp(text, errNames[i].text, n) == 0)
+            return errNames[i].code;
+    }
+    return SwarmErrOther;
+}
+
+SwarmRecovery swarm_errorPolicy(const SwarmErrors* errors, const SwarmSentence* sentence)
+{
+    return errors->policy[swarm_errorCode(sentence)];
+}
+
+unsigned long swarm_errorBackoffMs(const SwarmErrors* errors, unsigned char attempt)
+{
+    unsigned long ms = errors->backoffMs;
+
+    while(attempt-- && ms < SWARM_ERR_BACKOFF_MAX_ms)
+        ms *= 2;
+    return ms < SWARM_ERR_BACKOFF_MAX_ms ? ms : SWARM_ERR_BACKOFF_MAX_ms;
+}
+
+SwarmRecovery swarm_errorOnSentence(SwarmErrors* errors, const SwarmSentence* sentence, unsigned long now)
+{
+    SwarmErrLast* last = &errors->last;
+    SwarmRecovery recovery;
+    const char* text;
+    unsigned int len;
+
+    last->header = sentence->header;
+    last->code = swarm_errorCode(sentence);
+    last->at = now;
+    text = swarm_sentenceField(sentence, 1, &len);
+    if(len >= sizeof(last->text))
+        len = sizeof(last->text) - 1;
+    memcpy(last->text, text, len);
+    last->text[len] = '\0';
+
+    recovery = errors->policy[last->code];
+    errors->stats.codes[last->code]++;
+    errors->stats.recoveries[recovery]++;
+    return recovery;
+}
+
+void swarm_errorFault(SwarmErrors* errors, SwarmFault fault, unsigned long now)
+{
+    errors->stats.faults[fault]++;
+    errors->latest = fault;
+    if(errors->fault != SwarmFaultNone)
+        return;                                 // still getting over the last one, the clock runs from that
+    errors->fault = fault;
+    errors->faultAt = now;
+}
+
+void swarm_errorFaultWas(SwarmErrors* errors, SwarmFault fault)
+{
+    // boot noise comes before the BOOT line that says why, it's the same fault told better
+    if(errors->latest != SwarmFaultNoise || fault == SwarmFaultNoise || fault == SwarmFaultNone)
+        return;
+    errors->stats.faults[SwarmFaultNoise]--;
+    errors->stats.faults[fault]++;
+    errors->latest = fault;
+    if(errors->fault == SwarmFaultNoise)
+        errors->fault = fault;
+}
+
+void swarm_errorService(SwarmErrors* errors, unsigned long now)
+{
+    SwarmModem* modem = errors->modem;
+    unsigned long ms;
+
+    // any line at all says the modem is there, timeouts in a row with nothing in between say it isn't
+    if(modem->parser.stats.sentences != errors->sentencesSeen){
+        errors->sentencesSeen = modem->parser.stats.sentences;
+        errors->silent = 0;
+    }
+    if(modem->cmds.stats.timeouts != errors->timeoutsSeen){
+        ms = modem->cmds.stats.timeouts - errors->timeoutsSeen;
+        errors->timeoutsSeen = modem->cmds.stats.timeouts;
+        errors->silent = ms + errors->silent < 255 ? (unsigned char)(ms + errors->silent) : 255;
+    }
+    if(errors->silentTimeouts && errors->silent >= errors->silentTimeouts && !modem->info.isSleeping &&
+       !modem->warm.booting){
+        errors->silent = 0;
+        swarm_errorFault(errors, SwarmFaultSilent, now);
+        swarm_reinit(modem);
+        return;
+    }
+
+    if(errors->fault == SwarmFaultNone || !modem->info.satFullyInitialized || modem->warm.booting ||
+       (!modem->queue.modemKnown && swarm_queueDepth(&modem->queue)))
+        return;
+    ms = now - errors->faultAt;                 // initialized and the queue can send, back in service
+    errors->fault = SwarmFaultNone;
+    errors->stats.recovered++;
+    errors->stats.recoveryLastMs = ms;
+    errors->stats.recoveryTotalMs += ms;
+    if(ms > errors->stats.recoveryMaxMs)
+        errors->stats.recoveryMaxMs = ms;
+}
+
+bool swarm_errorInService(const SwarmErrors* errors)
+{
+    return errors->fault == SwarmFaultNone;
+}
@@ -0,0 +1,118 @@
+/*
+ * SwarmErrors.h
+ *
+ *  Created on: Oct 16, 2026
+ *      Author: MicroTechEE
+ */
+
+#ifndef SWARMERRORS_H_
+#define SWARMERRORS_H_
+
+#include <stdbool.h>
+#include <SwarmParser.h>
+
+/* What went wrong and what to do about it. Every $XX ERR,<code> is sorted into a SwarmErrCode, and each code has a
+ * recovery in policy[]:
+ *
+ *      Retry       the same command again straight away, the modem never saw it as we sent it
+ *      Backoff     again after backoffMs, doubled for every try, the modem can't take it yet
+ *      Reinit      the modem's state can't be trusted, swarm_reinit()
+ *      Drop        it won't ever work, the caller gets SwarmReplyError / the $TD is rejected
+ *
+ * The command engine, the queue and SwarmFragment all go by the same policy[], so changing one entry changes it
+ * everywhere:
+ *
+ *      modem->errors.policy[SwarmErrOther] = SwarmRecoverReinit;   // after swarm_modemInit()
+ *
+ * Faults are the bigger things: the modem rebooting ($M138 BOOT, ABORT or boot noise), going quiet
+ * (SWARM_ERR_SILENT_TIMEOUTS commands in a row timed out with nothing heard), or a Reinit error. Each one is timed
+ * until the modem is back in service, satFullyInitialized with $MT C=U answered if the queue has anything for it,
+ * and that's in stats.recovery*.
+ * After a modem reboot with the MCU still up we already have the device ID and the time, so the init doesn't wait
+ * on $DT having a fix again, $CS and $GP and it's back.
+ */
+
+#define SWARM_ERR_BACKOFF_ms                            2000     // first Backoff wait, doubles every try
+#define SWARM_ERR_BACKOFF_MAX_ms                        60000
+#define SWARM_ERR_SILENT_TIMEOUTS                       3        // timeouts in a row with not a line heard, init again
+#define SWARM_ERR_TEXT_MAX                              16       // "DBXTOHIVEFULL" and the '\0'
+
+struct SwarmModem;
+
+/* * * * * * * * STRUCTS * * * * * * * * * */
+typedef enum{
+    SwarmErrNone = 0,
+    SwarmErrBadChecksum,                        // BADCHECKSUM, our line was mangled on the way
+    SwarmErrBadCommand,                         // NOCOMMAND, BADPARAM..., INVALIDCHAR, BADDATA, TDTOOLONG, BADAPPID ...
+    SwarmErrFull,                               // DBXTOHIVEFULL, NOSPACE, no room until something goes up
+    SwarmErrNoTime,                             // TIMENOTAVAIL / NOTIME, needs a GPS time first
+    SwarmErrBusy,                               // BUSY
+    SwarmErrNotFound,                           // DBXNOMORE, DBXINVMSGID, nothing there, not really a fault
+    SwarmErrOther,                              // newer than this table
+    SwarmErrCodeCount
+}SwarmErrCode;
+
+typedef enum{
+    SwarmRecoverDrop = 0,
+    SwarmRecoverRetry,
+    SwarmRecoverBackoff,
+    SwarmRecoverReinit,
+    SwarmRecoverCount
+}SwarmRecovery;
+
+typedef enum{
+    SwarmFaultNone = 0,                         // in service
+    SwarmFaultBoot,                             // $M138 BOOT,POWERON / UPDATED / anything else
+    SwarmFaultAbort,                            // $M138 BOOT,ABORT, its firmware crashed
+    SwarmFaultNoise,                            // boot noise, no BOOT line
+    SwarmFaultSilent,                           // SWARM_ERR_SILENT_TIMEOUTS
+    SwarmFaultError,                            // an ERR with SwarmRecoverReinit
+    SwarmFaultCount
+}SwarmFault;
+
+typedef struct{
+    unsigned int header;                        // who said ERR, SAT_HEADER_*
+    SwarmErrCode code;
+    char text[SWARM_ERR_TEXT_MAX];              // the code as the modem wrote it, cut short
+    unsigned long at;                           // millis
+}SwarmErrLast;
+
+typedef struct{
+    unsigned long codes[SwarmErrCodeCount];     // ERR lines
+    unsigned long recoveries[SwarmRecoverCount];   // what was done about them
+    unsigned long faults[SwarmFaultCount];
+    unsigned long recovered;                    // faults that ended back in service
+    unsigned long recoveryLastMs;               // fault -> in service
+    unsigned long recoveryMaxMs;
+    unsigned long recoveryTotalMs;
+    unsigned long quickInits;                   // inits that didn't wait on $DT, warm.stats.coldStarts has the rest
+}SwarmErrStats;
+
+typedef struct{
+    struct SwarmModem* modem;
+    SwarmRecovery policy[SwarmErrCodeCount];
+    unsigned long backoffMs;
+    unsigned char silentTimeouts;               // 0 = don't watch for it
+
+    SwarmErrLast last;
+    SwarmFault fault;                           // what we're recovering from, SwarmFaultNone = in service
+    unsigned long faultAt;
+    SwarmFault latest;                          // the last one reported, can come while still recovering from fault
+    unsigned char silent;                       // timeouts since we last heard anything
+    unsigned long timeoutsSeen;                 // cmds.stats.timeouts at the last pass
+    unsigned long sentencesSeen;                // parser.stats.sentences at the last pass
+    SwarmErrStats stats;
+}SwarmErrors;
+
+/* * * * * * * * FUNCTIONS * * * * * * * * * */
+void swarm_errorInit(SwarmErrors* errors, struct SwarmModem* modem);   // swarm_modemInit() does this, defaults
+SwarmErrCode swarm_errorCode(const SwarmSentence* sentence);          // SwarmErrNone if it isn't an ERR
+SwarmRecovery swarm_errorPolicy(const SwarmErrors* errors, const SwarmSentence* sentence);
+unsigned long swarm_errorBackoffMs(const SwarmErrors* errors, unsigned char attempt);   // attempt 0 = backoffMs
+SwarmRecovery swarm_errorOnSentence(SwarmErrors* errors, const SwarmSentence* sentence, unsigned long now);
+void swarm_errorFault(SwarmErrors* errors, SwarmFault fault, unsigned long now);   // starts the clock
+void swarm_errorFaultWas(SwarmErrors* errors, SwarmFault fault);      // the fault we're in is really this one
+void swarm_errorService(SwarmErrors* errors, unsigned long now);
+bool swarm_errorInService(const SwarmErrors* errors);
+
+#endif /* SWARMERRORS_H_ */
@@ -0,0 +1,94 @@
+/*
+ * SwarmEvents.c
+ *
+ *  Created on: Oct 16, 2026
+ *      Author: MicroTechEE
+ */
+
+// STD C
+#include <stdbool.h>
+
+#include <Message.h>
+#include <SwarmMSP430.h>
+#include <SwarmEvents.h>
+
+/* - - - - - - - - - - - - - FUNCTIONS - - - - - - - - - - - - - - - */
+bool swarm_eventOn(SwarmEvents* events, unsigned int header, SwarmEventHandler handler)
+{
+    unsigned char i;
+
+    for(i = 0; i < events->routes; i++){
+        if(events->route[i].header == header)
+            break;
+    }
+    if(handler == 0){
+        if(i == events->routes)
+            return false;
+        for(; i + 1 < events->routes; i++)
+            events->route[i] = events->route[i + 1];
+        events->routes--;
+        return true;
+    }
+    if(i == events->routes){
+        if(events->routes >= SWARM_EVENT_ROUTES)
+            return false;
+        events->routes++;
+    }
+    events->route[i].header = header;
+    events->route[i].handler = handler;
+    return true;
+}
+
+void swarm_eventDispatch(SwarmModem* modem, const SwarmSentence* sentence)
+{
+    SwarmEvents* events = &modem->events;
+    unsigned char i;
+
+    for(i = 0; i < events->routes; i++){
+        if(events->route[i].header == sentence->header || events->route[i].header == SWARM_EVENT_ANY){
+            events->stats.dispatched++;
+            events->route[i].handler(modem, sentence);
+        }
+    }
+}
+
+bool swarm_eventPending(const SwarmModem* modem)
+{
+    // safe with interrupts off, it only reads what the ISRs write
+    if(modem->parser.head != modem->parser.tail)
+        return true;
+#if SAT_DOWNLINK_DISPATCH
+    if(swarm_downlinkDepth(&modem->downlink))
+        return true;
+#endif
+    return false;
+}
+
+unsigned long swarm_eventIdleMs(SwarmModem* modem, unsigned long now)
+{
+    if(swarm_eventPending(modem))
+        return 0;
+    return swarm_cmdIdleMs(&modem->cmds, now, SAT_EVENT_IDLE_MAX_ms);
+}
+
+void swarm_eventWait(SwarmModem* const* modems, unsigned int count)
+{
+    unsigned long idle = SAT_EVENT_IDLE_MAX_ms;
+    unsigned long ms;
+    unsigned int i;
+
+    if(count == 0)
+        return;
+    for(i = 0; i < count && idle; i++){
+        ms = swarm_eventIdleMs(modems[i], modems[i]->hal->millis());
+        if(ms < idle)
+            idle = ms;
+    }
+    if(idle == 0 || modems[0]->hal->idle == 0){
+        modems[0]->events.stats.busy++;
+        return;                                 // work already, or a HAL that can't sleep: back to the superloop
+    }
+    modems[0]->events.stats.waits++;
+    modems[0]->events.stats.idleMs += idle;
+    modems[0]->hal->idle(modems, count, idle);  // checks again with interrupts off, then sleeps
+}
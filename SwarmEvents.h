@@ -0,0 +1,72 @@
+/*
+ * SwarmEvents.h
+ *
+ *  Created on: Oct 16, 2026
+ *      Author: MicroTechEE
+ */
+
+#ifndef SWARMEVENTS_H_
+#define SWARMEVENTS_H_
+
+#include <stdbool.h>
+#include <SwarmParser.h>
+
+/* Event driven instead of polled. The RX ISR already finishes each sentence into a parser slot (head written by
+ * the ISR, tail by the main loop, no locks), so all that was missing is waking the CPU when it does and telling
+ * the main loop how long it may sleep:
+ *
+ *      RX ISR:     if(swarm_rxByte(&modem0, UCA0RXBUF)) __bic_SR_register_on_exit(SAT_EVENT_LPM);
+ *      Timer ISR:  if(swarm_halMsp430Tick(10))          __bic_SR_register_on_exit(SAT_EVENT_LPM);
+ *
+ *      swarm_eventOn(&modem0.events, SAT_HEADER_TRANSMIT_DATA, onTd);   // $TD OK / SENT / ERR
+ *      swarm_eventOn(&modem0.events, SAT_HEADER_GPS_INFO, onFix);
+ *      for(;;){
+ *          swarm_handleMsg(&modem0);                   // parses, runs the handlers, services the timers
+ *          swarm_eventWait(modems, 1);                 // LPM until a sentence is in or the next timer is due
+ *      }
+ *
+ * swarm_eventWait() sleeps at most swarm_eventIdleMs(): until the next command resend / timeout, and never longer
+ * than SAT_EVENT_IDLE_MAX_ms so the queue, scheduler and downlink get looked at now and then. Anything you queue
+ * yourself (swarm_queuePush(), swarm_transmitData()) goes out on the next swarm_handleMsg(), call it after.
+ *
+ * Handlers run from swarm_handleMsg(), after the driver has parsed the sentence into modem->info and after any
+ * command callback, so they see the new values. Error replies ($XX ERR,...) are handed over too, check
+ * sentence->isError. SWARM_EVENT_ANY gets every sentence.
+ */
+
+#define SWARM_EVENT_ROUTES                              8        // headers with a handler
+#define SWARM_EVENT_ANY                                 0        // as a header, every sentence
+
+struct SwarmModem;
+
+/* * * * * * * * STRUCTS * * * * * * * * * */
+typedef void (*SwarmEventHandler)(struct SwarmModem* modem, const SwarmSentence* sentence);
+
+typedef struct{
+    unsigned int header;                        // SAT_HEADER_*
+    SwarmEventHandler handler;
+}SwarmEventRoute;
+
+typedef struct{
+    unsigned long dispatched;                   // handler calls
+    unsigned long waits;                        // swarm_eventWait() calls that went to sleep
+    unsigned long busy;                         // ... and ones that didn't, there was work already
+    unsigned long idleMs;                       // total sleep asked for, the actual sleep is shorter if a line came in
+}SwarmEventStats;
+
+typedef struct{
+    SwarmEventRoute route[SWARM_EVENT_ROUTES];
+    unsigned char routes;
+    SwarmEventStats stats;
+}SwarmEvents;
+
+/* * * * * * * * FUNCTIONS * * * * * * * * * */
+bool swarm_eventOn(SwarmEvents* events, unsigned int header, SwarmEventHandler handler);   // 0 removes it
+void swarm_eventDispatch(struct SwarmModem* modem, const SwarmSentence* sentence);        // swarm_handleSentence() does this
+
+/* Main loop */
+bool swarm_eventPending(const struct SwarmModem* modem);       // a finished sentence or a downlink message is waiting
+unsigned long swarm_eventIdleMs(struct SwarmModem* modem, unsigned long now);   // 0 = call swarm_handleMsg() now
+void swarm_eventWait(struct SwarmModem* const* modems, unsigned int count);    // the HAL's idle, for every modem at once
+
+#endif /* SWARMEVENTS_H_ */
@@ -0,0 +1,208 @@
+/*
+ * SwarmFragment.c
+ *
+ *  Created on: Oct 16, 2026
+ *      Author: MicroTechEE
+ */
+
+// STD C
+#include <stdbool.h>
+#include "string.h"
+
+#include <Message.h>
+#include <SwarmMSP430.h>
+#include <SwarmFragment.h>
+
+/* - - - - - - - - - - - - - HELPERS - - - - - - - - - - - - - - - */
+static unsigned long long frag_msgId(const char* text, unsigned int len)
+{
+    unsigned long long id = 0;
+    unsigned int i;
+
+    for(i = 0; i < len && text[i] >= '0' && text[i] <= '9'; i++)
+        id = id * 10 + (unsigned int)(text[i] - '0');
+    return id;
+}
+
+static bool frag_isAcked(const SwarmFragSender* frag, unsigned int seq)
+{
+    return frag->acked[seq >> 3] & (1 << (seq & 7));
+}
+
+static void frag_ack(SwarmFragSender* frag, unsigned int seq)
+{
+    if(frag_isAcked(frag, seq))
+        return;                                 // a resend of one that got there after all
+    frag->acked[seq >> 3] |= (unsigned char)(1 << (seq & 7));
+    frag->ackedCount++;
+    frag->stats.acked++;
+    if(frag->ackedCount == frag->count){
+        frag->stats.blobs++;
+        frag->active = false;
+    }
+}
+
+static unsigned int frag_build(SwarmFragSender* frag, unsigned int seq, unsigned char* packet, unsigned int* crc)
+{
+    // header, then this fragment's share of the blob from the source, then whatever part of the CRC falls in it
+    unsigned long offset = (unsigned long)seq * SWARM_FRAG_DATA;
+    unsigned long left = frag->length + 2 - offset;
+    unsigned int len = left < SWARM_FRAG_DATA ? (unsigned int)left : SWARM_FRAG_DATA;
+    unsigned int blobLen = 0;
+    unsigned int i;
+
+    if(offset < frag->length)
+        blobLen = frag->length - offset < len ? (unsigned int)(frag->length - offset) : len;
+    packet[0] = SWARM_FRAG_VERSION;
+    packet[1] = frag->id;
+    packet[2] = (unsigned char)seq;
+    packet[3] = (unsigned char)(frag->count - 1);
+    if(blobLen && frag->source(frag->modem, offset, packet + SWARM_FRAG_HEADER, blobLen) != blobLen)
+        return 0;
+    *crc = frag->crc;
+    if(seq == frag->next)
+        *crc = swarm_crc16(packet + SWARM_FRAG_HEADER, blobLen, *crc);   // first time through, in order
+    for(i = blobLen; i < len; i++)
+        packet[SWARM_FRAG_HEADER + i] = offset + i == frag->length ? *crc >> 8 : *crc & 0xFF;
+    return SWARM_FRAG_HEADER + len;
+}
+
+/* - - - - - - - - - - - - - FUNCTIONS - - - - - - - - - - - - - - - */
+void swarm_fragInit(SwarmFragSender* frag, struct SwarmModem* modem)
+{
+    unsigned char id = frag->id;               // kept, so ids don't start over after a reset if frag is in FRAM
+
+    memset(frag, 0, sizeof(*frag));
+    frag->id = id;
+    frag->modem = modem;
+    frag->cls = SwarmQueueNormal;
+    modem->frag = frag;                         // swarm_handleMsg() drives it from here
+}
+
+bool swarm_fragSend(SwarmFragSender* frag, unsigned long length, SwarmFragSource source)
+{
+    if(frag->active || length == 0 || length > SWARM_FRAG_LENGTH_MAX || source == 0)
+        return false;
+    frag->source = source;
+    frag->length = length;
+    frag->id++;
+    frag->count = (unsigned int)((length + 2 + SWARM_FRAG_DATA - 1) / SWARM_FRAG_DATA);
+    frag->next = 0;
+    frag->resend = frag->count;
+    frag->crc = 0xFFFF;
+    memset(frag->acked, 0, sizeof(frag->acked));
+    frag->ackedCount = 0;
+    memset(frag->pending, 0, sizeof(frag->pending));
+    frag->lastProgress = frag->modem->hal->millis();
+    frag->active = true;
+    return true;
+}
+
+void swarm_fragCancel(SwarmFragSender* frag)
+{
+    frag->active = false;
+}
+
+bool swarm_fragBusy(const SwarmFragSender* frag)
+{
+    return frag->active;
+}
+
+void swarm_fragService(SwarmFragSender* frag, unsigned long now)
+{
+    // one fragment per pass, and only while the queue has room to spare, everything else gets its turn
+    SwarmQueue* queue = &frag->modem->queue;
+    unsigned char packet[SWARM_QUEUE_DATA_MAX];
+    unsigned long resendMs;
+    unsigned int seq;
+    unsigned int len;
+    unsigned int crc;
+
+    if(!frag->active || swarm_queueRoom(queue, frag->cls) <= SWARM_FRAG_QUEUE_RESERVE)
+        return;
+
+    if(frag->next < frag->count)
+        seq = frag->next;
+    else{
+        if(frag->resend >= frag->count){
+            resendMs = frag->resendMs ? frag->resendMs : queue->cls[frag->cls].holdS * 1000UL;
+            if(now - frag->lastProgress < resendMs)
+                return;
+            frag->resend = 0;                   // the modem has had its chance, the ones without an ack go again
+        }
+        while(frag->resend < frag->count && frag_isAcked(frag, frag->resend))
+            frag->resend++;
+        if(frag->resend >= frag->count){
+            frag->lastProgress = now;           // end of the pass, wait for the acks again
+            return;
+        }
+        seq = frag->resend;
+    }
+
+    len = frag_build(frag, seq, packet, &crc);
+    if(len == 0){
+        frag->stats.failed++;                   // the source couldn't give us what it said it had
+        frag->active = false;
+        return;
+    }
+    if(!swarm_queuePushClass(queue, frag->cls, 0, packet, len))
+        return;
+    if(seq == frag->next){
+        frag->crc = crc;                        // only once it's queued, a retry of this seq would count it twice
+        frag->next++;
+    }
+    else{
+        frag->resend++;
+        frag->stats.resent++;
+    }
+    frag->stats.fragments++;
+    frag->stats.bytes += len - SWARM_FRAG_HEADER;
+    frag->lastProgress = now;
+}
+
+void swarm_fragOnTdReply(SwarmFragSender* frag, const SwarmSentence* sentence)
+{
+    // OK and ERR are for the queue's $TD in flight, SENT carries the msg_id from the OK
+    SwarmFragPending* pending;
+    SwarmTdReply reply;
+    const unsigned char* data;
+    unsigned long long msgId;
+    unsigned int len;
+    unsigned int i;
+
+    if(!frag->active || !swarm_sentenceTd(sentence, &reply))
+        return;
+    if(reply.kind == SwarmTdSent){
+        msgId = frag_msgId(reply.msgId, reply.msgIdLen);
+        for(i = 0; i < SWARM_FRAG_PENDING; i++){
+            pending = &frag->pending[i];
+            if(pending->used && pending->msgId == msgId){
+                pending->used = false;
+                frag->lastProgress = frag->modem->hal->millis();
+                frag_ack(frag, pending->seq);
+                return;
+            }
+        }
+        return;                                 // someone else's, or we forgot it and it goes again
+    }
+
+    if(!swarm_queueReplyIsOurs(&frag->modem->queue))
+        return;                                 // someone else's $TD
+    data = swarm_queueInFlight(&frag->modem->queue, &len);
+    if(data == 0 || len <= SWARM_FRAG_HEADER || data[0] != SWARM_FRAG_VERSION || data[1] != frag->id ||
+       data[3] != (unsigned char)(frag->count - 1))
+        return;                                 // not one of this blob's
+    if(reply.kind == SwarmTdOk){
+        // $TD OK,<msg_id>  remember it for the SENT, the oldest we're still waiting on goes if we're out of room
+        pending = &frag->pending[frag->pendingNext++ % SWARM_FRAG_PENDING];
+        pending->msgId = frag_msgId(reply.msgId, reply.msgIdLen);
+        pending->seq = data[2];
+        pending->used = true;
+        frag->stats.accepted++;
+        frag->lastProgress = frag->modem->hal->millis();
+    }
+    else if(swarm_errorPolicy(&frag->modem->errors, sentence) == SwarmRecoverDrop){
+        frag->stats.failed++;                   // the queue gives up on it, the blob can't be whole without it
+        frag->active = false;
+    }
+}
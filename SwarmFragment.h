@@ -0,0 +1,100 @@
+/*
+ * SwarmFragment.h
+ *
+ *  Created on: Oct 16, 2026
+ *      Author: MicroTechEE
+ */
+
+#ifndef SWARMFRAGMENT_H_
+#define SWARMFRAGMENT_H_
+
+#include <stdbool.h>
+#include <SwarmParser.h>
+#include <SwarmQueue.h>
+
+/* Sends one blob bigger than a $TD (a log, a config dump, up to SWARM_FRAG_LENGTH_MAX) as a run of SwarmQueue
+ * messages. The blob never has to be in RAM: the source callback is asked for each piece as there's room in the
+ * queue, by offset, and asked again for any piece that has to go twice.
+ *
+ *      [SWARM_FRAG_VERSION] [blob id] [seq] [last seq] [up to SWARM_FRAG_DATA bytes]
+ *
+ * The blob is followed by its swarm_crc16, big end first, as if it were two more bytes of data, so the last fragment
+ * carries it and the other end can tell a whole blob from a wrong one. Every fragment but the last is full.
+ *
+ * Each fragment's $TD OK msg_id is kept until its $TD SENT, that's the ack. Once every fragment is in the modem and
+ * resendMs goes by without an ack (the modem's hold ran out, or it was dropped here unsent), the ones that never
+ * got one are read from the source again and queued again. The ground side throws away the copies, see
+ * linux/SwarmDefrag.h.
+ *
+ *      static unsigned int logSource(SwarmModem* modem, unsigned long offset, unsigned char* data, unsigned int len)
+ *      {
+ *          return flashLogRead(offset, data, len);         // len bytes from offset, fewer is an error
+ *      }
+ *
+ *      swarm_fragInit(&frag, &modem);
+ *      swarm_fragSend(&frag, logLength, logSource);        // false if the last one isn't done
+ *
+ * swarm_handleMsg() does the rest, look at frag.stats or swarm_fragBusy() to see how it's going. The ground
+ * remembers blobs by id, put the SwarmFragSender in FRAM (SWARM_PERSISTENT) and the ids carry on across a reset
+ * instead of starting over at one the ground has already seen.
+ */
+
+#define SWARM_FRAG_VERSION                              0xF1     // first byte of every fragment, not a SWARM_AGG_VERSION
+#define SWARM_FRAG_HEADER                               4
+#define SWARM_FRAG_DATA                                 (SWARM_QUEUE_DATA_MAX - SWARM_FRAG_HEADER)
+#define SWARM_FRAG_COUNT_MAX                            256      // seq is one byte
+#define SWARM_FRAG_LENGTH_MAX                           ((unsigned long)SWARM_FRAG_COUNT_MAX * SWARM_FRAG_DATA - 2)
+#define SWARM_FRAG_PENDING                              SWARM_QUEUE_MODEM_MAX   // $TD OK waiting on SENT we can match
+#define SWARM_FRAG_QUEUE_RESERVE                        4        // queue slots left for everyone else
+
+struct SwarmModem;
+
+/* * * * * * * * STRUCTS * * * * * * * * * */
+typedef unsigned int (*SwarmFragSource)(struct SwarmModem* modem, unsigned long offset, unsigned char* data,
+                                        unsigned int len);      // len bytes of the blob from offset
+
+typedef struct{
+    unsigned long long msgId;                   // the modem's, from $TD OK
+    unsigned char seq;
+    bool used;
+}SwarmFragPending;
+
+typedef struct{
+    unsigned long blobs;                        // every fragment acked
+    unsigned long failed;                       // the source came up short or the modem rejected a fragment
+    unsigned long fragments;                    // queued, resends included
+    unsigned long resent;
+    unsigned long accepted;                     // $TD OK
+    unsigned long acked;                        // $TD SENT matched to a fragment
+    unsigned long bytes;                        // blob bytes queued, resends included
+}SwarmFragStats;
+
+typedef struct SwarmFragSender{
+    struct SwarmModem* modem;
+    SwarmFragSource source;
+    SwarmQueueClass cls;                        // SwarmQueueNormal, change it before swarm_fragSend()
+    unsigned long resendMs;                     // 0 = the class hold, what the modem waits before dropping it
+    unsigned long length;
+    unsigned char id;                           // blob id, one more each swarm_fragSend()
+    unsigned int count;                         // fragments in this blob
+    unsigned int next;                          // first time through, next seq to queue
+    unsigned int resend;                        // resend pass, next seq to look at, count = not resending
+    unsigned int crc;                           // of the blob so far, all of it once next == count
+    unsigned char acked[SWARM_FRAG_COUNT_MAX / 8];
+    unsigned int ackedCount;
+    SwarmFragPending pending[SWARM_FRAG_PENDING];
+    unsigned int pendingNext;
+    unsigned long lastProgress;                 // millis of the last queue, OK or SENT
+    bool active;
+    SwarmFragStats stats;
+}SwarmFragSender;
+
+/* * * * * * * * FUNCTIONS * * * * * * * * * */
+void swarm_fragInit(SwarmFragSender* frag, struct SwarmModem* modem);      // after swarm_modemInit(), one per modem
+bool swarm_fragSend(SwarmFragSender* frag, unsigned long length, SwarmFragSource source);
+void swarm_fragCancel(SwarmFragSender* frag);                               // what's queued still goes
+bool swarm_fragBusy(const SwarmFragSender* frag);
+void swarm_fragService(SwarmFragSender* frag, unsigned long now);
+void swarm_fragOnTdReply(SwarmFragSender* frag, const SwarmSentence* sentence);   // before the queue sees it
+
+#endif /* SWARMFRAGMENT_H_ */
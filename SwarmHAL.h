@@ -0,0 +1,64 @@
+/*
+ * SwarmHAL.h
+ *
+ *  Created on: Oct 16, 2026
+ *      Author: MicroTechEE
+ */
+
+#ifndef SWARMHAL_H_
+#define SWARMHAL_H_
+
+#include <stdbool.h>
+#include "misc.h"
+#include <SwarmTx.h>
+
+/* The HAL is everything SwarmMSP430.c needs from the board: UART, the wake GPIO, a delay, a ms clock and the RTC.
+ * TX is asynchronous: uartTxStart() only has to get the ISR or DMA going on modem->txRing and return, it gets
+ * called again every time something new is queued so it must be harmless when TX is already running.
+ *
+ *      swarmHalMsp430  -> SwarmHAL_MSP430.c, DriverLib + UART.h from my other repositories, port is a SwarmMsp430Port
+ *      swarmHalLinux   -> linux/SwarmHAL_Linux.c, a tty or the pty backed M138 simulator, port is a SwarmLinuxPort
+ *
+ * The UART and GPIO calls get the modem, modem->port says which UART and which pin. That's all it takes to run
+ * two modems on one board, each SwarmModem has its own port. The clock, delay and RTC are the board's, not the
+ * modem's, so they don't. Porting to another controller is just filling in one of these tables and a port struct
+ * for swarm_modemInit(). The swarm_* code itself never changes.
+ */
+
+struct SwarmModem;
+
+/* * * * * * * * STRUCTS * * * * * * * * * */
+typedef struct{
+    void (*uartOpen)(struct SwarmModem* modem);                     // 115200 8N1 with RX interrupt running
+    void (*uartClose)(struct SwarmModem* modem);
+    void (*uartTxStart)(struct SwarmModem* modem);                  // start draining modem->txRing if idle, never blocks
+    void (*gpioWrite)(struct SwarmModem* modem, char pinState);     // SAT_GPIO_HIGH or SAT_GPIO_LOW
+    void (*delayMs)(unsigned int ms);
+    void (*rtcSet)(Calendar dateTime);
+    unsigned long (*millis)(void);                                  // free running, only differences are used so wrap is fine
+    void (*idle)(struct SwarmModem* const* modems, unsigned int count,
+                 unsigned long maxMs);                              // sleep until a sentence is in or maxMs, 0 = can't sleep
+    unsigned int (*ticks)(void);                                    // free running hardware timer for SwarmStats, 0 = none
+}SwarmHal;
+
+typedef struct{
+    unsigned int uartBase;                                          // EUSCI_A0_BASE ...
+    unsigned char gpioPort;                                         // wake pin, GPIO_PORT_P8 ...
+    unsigned int gpioPin;                                           // BIT1 ...
+    unsigned char dmaChannel;                                       // SAT_TX_USE_DMA only
+    unsigned char dmaTrigger;                                       // UCAxTXIFG for uartBase, check the datasheet
+
+    struct SwarmModem* modem;                                       // set by uartOpen, for the ISRs
+    volatile bool txRunning;
+    unsigned int txDmaLen;                                          // size of the block the DMA is moving right now
+}SwarmMsp430Port;
+
+/* * * * * * * * GLOBALS * * * * * * * * * */
+extern const SwarmHal swarmHalMsp430;
+
+/* * * * * * * * FUNCTIONS * * * * * * * * * */
+void swarm_halMsp430TxIsr(struct SwarmModem* modem);                // only with SAT_TX_USE_DMA 0, see SwarmHAL_MSP430.c
+bool swarm_halMsp430DmaIsr(void);                                   // only with SAT_TX_USE_DMA 1, from your DMA_VECTOR ISR
+bool swarm_halMsp430Tick(unsigned int ms);                          // call from a timer ISR you already have, true = leave LPM
+
+#endif /* SWARMHAL_H_ */
@@ -0,0 +1,272 @@
+/*
+ * SwarmHAL_MSP430.c
+ *
+ *  Created on: Oct 16, 2026
+ *      Author: MicroTechEE
+ */
+
+// STD C
+#include <stdbool.h>
+#include <stdint.h>
+
+// TI Libraries
+#include <msp430.h>
+#include "gpio.h"
+#include "eusci_a_uart.h"
+#include "dma.h"
+
+//
+//#include "Pins.h"
+#include <Message.h>
+#include <SwarmMSP430.h>
+#include <SwarmHAL.h>
+#include "misc.h"
+#include "UART.h"
+
+#define MSP430_PORTS                    4       // modems open at once, the eUSCI_A count on the FR5994
+
+/* - - - - - - - - - - - - - GLOBALS - - - - - - - - - - - - - - - */
+static SwarmMsp430Port* openPorts[MSP430_PORTS] = {0};    // for swarm_halMsp430DmaIsr()
+static volatile unsigned long msTicks = 0;     // advanced by swarm_halMsp430Tick()
+static volatile unsigned long wakeAt = 0;      // msp430_idle() wants the CPU back by then
+static volatile bool wakeArmed = false;
+
+/* - - - - - - - - - - - - - FUNCTIONS - - - - - - - - - - - - - - - */
+/* - - - - UART - - - - */
+static void msp430_uartInit(SwarmMsp430Port* port)
+{
+    // SAT_UART goes through UART.h like it always has, any other eUSCI_A is set up here.
+    // 115200 from the 8 MHz SMCLK UART.h runs on, the pins' peripheral function is yours to set
+    EUSCI_A_UART_initParam param = {0};
+
+    if(port->uartBase == SAT_UART){
+        uart_setup(BAUD115200);                    // Swarm only uses 115200
+        uart_configureRxInterrupt(UART_ENABLE_INTERRUPT);
+        return;
+    }
+    param.selectClockSource = EUSCI_A_UART_CLOCKSOURCE_SMCLK;
+    param.clockPrescalar = 4;
+    param.firstModReg = 5;
+    param.secondModReg = 0x55;
+    param.parity = EUSCI_A_UART_NO_PARITY;
+    param.msborLsbFirst = EUSCI_A_UART_LSB_FIRST;
+    param.numberofStopBits = EUSCI_A_UART_ONE_STOP_BIT;
+    param.uartMode = EUSCI_A_UART_MODE;
+    param.overSampling = EUSCI_A_UART_OVERSAMPLING_BAUDRATE_GENERATION;
+    EUSCI_A_UART_init(port->uartBase, &param);
+    EUSCI_A_UART_enable(port->uartBase);
+    EUSCI_A_UART_clearInterrupt(port->uartBase, EUSCI_A_UART_RECEIVE_INTERRUPT);
+    EUSCI_A_UART_enableInterrupt(port->uartBase, EUSCI_A_UART_RECEIVE_INTERRUPT);
+}
+
+static void msp430_uartOpen(SwarmModem* modem)
+{
+    SwarmMsp430Port* port = (SwarmMsp430Port*)modem->port;
+    unsigned char i;
+#if SAT_TX_USE_DMA
+    DMA_initParam dmaParam = {0};
+#endif
+
+    port->modem = modem;
+    port->txRunning = false;
+    for(i = 0; i < MSP430_PORTS && openPorts[i] && openPorts[i] != port; i++);
+    if(i < MSP430_PORTS)
+        openPorts[i] = port;
+
+    msp430_uartInit(port);
+
+#if SAT_TX_USE_DMA
+    // one byte per TXIFG, the DMA interrupt fires when the whole block is in the UART
+    dmaParam.channelSelect = port->dmaChannel;
+    dmaParam.transferModeSelect = DMA_TRANSFER_SINGLE;
+    dmaParam.transferSize = 1;
+    dmaParam.triggerSourceSelect = port->dmaTrigger;
+    dmaParam.transferUnitSelect = DMA_SIZE_SRCBYTE_DSTBYTE;
+    dmaParam.triggerTypeSelect = DMA_TRIGGER_RISINGEDGE;
+    DMA_init(&dmaParam);
+    DMA_setDstAddress(port->dmaChannel, port->uartBase + OFS_UCAxTXBUF, DMA_DIRECTION_UNCHANGED);
+    DMA_enableInterrupt(port->dmaChannel);
+#endif
+}
+
+static void msp430_uartClose(SwarmModem* modem)
+{
+    SwarmMsp430Port* port = (SwarmMsp430Port*)modem->port;
+    unsigned char i;
+
+#if SAT_TX_USE_DMA
+    DMA_disableTransfers(port->dmaChannel);
+#endif
+    port->txRunning = false;
+    if(port->uartBase == SAT_UART){
+        uart_configureRxInterrupt(UART_DISABLE_INTERRUPT);
+        uart_configureTxInterrupt(UART_DISABLE_INTERRUPT);
+        uart_closeUart();
+    }
+    else{
+        EUSCI_A_UART_disableInterrupt(port->uartBase, EUSCI_A_UART_RECEIVE_INTERRUPT | EUSCI_A_UART_TRANSMIT_INTERRUPT);
+        EUSCI_A_UART_disable(port->uartBase);
+    }
+    for(i = 0; i < MSP430_PORTS; i++){
+        if(openPorts[i] == port)
+            openPorts[i] = 0;
+    }
+}
+
+#if SAT_TX_USE_DMA
+static void msp430_txNextBlock(SwarmMsp430Port* port)
+{
+    // Called with interrupts off, from uartTxStart or the DMA ISR
+    const unsigned char* data;
+
+    port->txDmaLen = swarm_txPeek(&port->modem->txRing, &data);
+    if(!port->txDmaLen){
+        port->txRunning = false;
+        return;
+    }
+    DMA_setSrcAddress(port->dmaChannel, (uint32_t)(uintptr_t)data, DMA_DIRECTION_INCREMENT);
+    DMA_setTransferSize(port->dmaChannel, port->txDmaLen);
+    DMA_enableTransfers(port->dmaChannel);
+
+    // The trigger is the rising edge of TXIFG, which is already sitting high when the UART is idle
+    HWREG16(port->uartBase + OFS_UCAxIFG) &= ~UCTXIFG;
+    HWREG16(port->uartBase + OFS_UCAxIFG) |= UCTXIFG;
+}
+
+static void msp430_uartTxStart(SwarmModem* modem)
+{
+    SwarmMsp430Port* port = (SwarmMsp430Port*)modem->port;
+    unsigned short gie = __get_SR_register() & GIE;
+
+    __disable_interrupt();                          // txRunning is shared with the DMA ISR
+    if(!port->txRunning){
+        port->txRunning = true;
+        msp430_txNextBlock(port);
+    }
+    __bis_SR_register(gie);
+}
+
+bool swarm_halMsp430DmaIsr(void)
+{
+    // Call this from your DMA_VECTOR ISR, the driver doesn't own the vector. It only looks at and clears the
+    // channels the open modems use, yours are still yours to handle. Don't read DMAIV before it, that clears a flag
+    SwarmMsp430Port* port;
+    bool handled = false;
+    unsigned char i;
+
+    for(i = 0; i < MSP430_PORTS; i++){
+        port = openPorts[i];
+        if(port && DMA_getInterruptStatus(port->dmaChannel) == DMA_INT_ACTIVE){
+            DMA_clearInterrupt(port->dmaChannel);
+            swarm_txConsume(&port->modem->txRing, port->txDmaLen);
+            msp430_txNextBlock(port);
+            handled = true;
+        }
+    }
+    return handled;
+}
+#else
+static void msp430_uartTxStart(SwarmModem* modem)
+{
+    SwarmMsp430Port* port = (SwarmMsp430Port*)modem->port;
+
+    port->txRunning = true;
+    EUSCI_A_UART_enableInterrupt(port->uartBase, EUSCI_A_UART_TRANSMIT_INTERRUPT);   // TXIFG is already set, ISR runs right away
+}
+
+void swarm_halMsp430TxIsr(SwarmModem* modem)
+{
+    // Call this from your eUSCI ISR on USCI_UART_UCTXIFG with the modem on that UART, UART.c owns the vector
+    SwarmMsp430Port* port = (SwarmMsp430Port*)modem->port;
+    unsigned char byte;
+
+    if(swarm_txPop(&modem->txRing, &byte))
+        HWREG16(port->uartBase + OFS_UCAxTXBUF) = byte;
+    else{
+        EUSCI_A_UART_disableInterrupt(port->uartBase, EUSCI_A_UART_TRANSMIT_INTERRUPT);
+        port->txRunning = false;
+    }
+}
+#endif
+
+/* - - - - GPIO / TIME - - - - */
+static void msp430_gpioWrite(SwarmModem* modem, char pinState){
+    SwarmMsp430Port* port = (SwarmMsp430Port*)modem->port;
+
+    GPIO_setAsOutputPin(port->gpioPort, port->gpioPin);
+    if(pinState)
+        GPIO_setOutputHighOnPin(port->gpioPort, port->gpioPin);  // Low->High WAKES Swarm by default, unless you changed it
+    else
+        GPIO_setOutputLowOnPin(port->gpioPort, port->gpioPin);   // High->Low You can make High->Low wake if you want
+}
+
+static void msp430_delayMs(unsigned int ms){
+    cycleDelay_ms(ms);
+}
+
+static void msp430_rtcSet(Calendar dateTime){
+    initRTC(dateTime);
+}
+
+bool swarm_halMsp430Tick(unsigned int ms){
+    // Call this from whatever periodic timer ISR the project already runs, resolution only needs to be ~10ms.
+    // true when msp430_idle() is sleeping and its time is up, __bic_SR_register_on_exit(SAT_EVENT_LPM) then
+    msTicks += ms;
+    if(wakeArmed && (long)(msTicks - wakeAt) >= 0){
+        wakeArmed = false;
+        return true;
+    }
+    return false;
+}
+
+static unsigned long msp430_millis(void){
+    unsigned short gie = __get_SR_register() & GIE;
+    unsigned long now;
+
+    __disable_interrupt();                          // 32 bits is two reads on a 16 bit CPU
+    now = msTicks;
+    __bis_SR_register(gie);
+    return now;
+}
+
+static void msp430_idle(SwarmModem* const* modems, unsigned int count, unsigned long maxMs){
+    // The check and the sleep have to be one step, a sentence finishing in between would otherwise sleep
+    // through. GIE and the LPM bits go on in the same instruction, so the ISR can only land after it.
+    unsigned int i;
+
+    __disable_interrupt();
+    for(i = 0; i < count; i++){
+        if(swarm_eventPending(modems[i])){
+            __enable_interrupt();
+            return;
+        }
+    }
+    wakeAt = msTicks + maxMs;
+    wakeArmed = true;
+    __bis_SR_register(SAT_EVENT_LPM | GIE);         // the RX ISR or swarm_halMsp430Tick() ends this
+    __no_operation();
+    wakeArmed = false;
+}
+
+#if SWARM_STATS_ENABLE
+static unsigned int msp430_ticks(void){
+    // SAT_STATS_TIMER_R has to be running continuous mode already, SMCLK makes the numbers CPU cycles
+    return SAT_STATS_TIMER_R;
+}
+#endif
+
+const SwarmHal swarmHalMsp430 = {
+    msp430_uartOpen,
+    msp430_uartClose,
+    msp430_uartTxStart,
+    msp430_gpioWrite,
+    msp430_delayMs,
+    msp430_rtcSet,
+    msp430_millis,
+    msp430_idle,
+#if SWARM_STATS_ENABLE
+    msp430_ticks
+#else
+    0
+#endif
+};
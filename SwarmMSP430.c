@@ -10,130 +10,333 @@
 #include "stdlib.h"
 #include "string.h"
 
-// TI Libraries
-#include "gpio.h"
-#include "eusci_a_uart.h"
-
 //
 //#include "Pins.h"
 #include <Message.h>
 #include <SwarmMSP430.h>
+#include <SwarmHAL.h>
+#include <SwarmParser.h>
 #include "misc.h"
-#include "UART.h"
-#include "xbee_hal.h"
-#include "xmesh.h"
+#include <SwarmCodec.h>
 
 /* - - - - - - - - - - - - - GLOBALS - - - - - - - - - - - - - - - */
-Message * satRxMsg = 0;  //pointer to message struct for message we are actively getting
-
 /* These comands will need to be responded to before satellite module is considered "initialized".
  * You'll want GPS too, but it can't be ascertained until modem is fully ready, figure that out yourself
- * If the order of these is changed, the end of the respective Parse functions need to be changed also
- * You can keep adding init commands but LEAVE "Initialized" LAST
+ * They all go out at once through the command engine, order doesn't matter. You can keep adding init commands,
+ * the modem is initialized once every one of them has been answered
 */
-char cmdArrayIndex = 0;  // this index describes which init command is next to be sent
-char* initCommandArray[4] = {"$CS", "$DT @", SAT_GPIO_WAKE_LOW_HIGH, "Initialized"};
-
-
-// initialize the global struct, if you add more things to the sctruct, add another 0
-SatInfo satInfo = {0, 0, 0, 0, 0, 0, 0, 0, 0, 0};
+static const char* const initCommands[][2] = {
+    {SAT_CMD_DEVICE_ID,         SAT_CMD_PARAM_NO_PARAMS},
+    {SAT_CMD_DATE_TIME,         SAT_CMD_PARAM_QUERY_LAST_MESSAGE},
+    {SAT_GPIO_CONFIGURATION,    SAT_CMD_PARAM_NO_PARAMS}
+};
+#define SAT_INIT_COMMANDS       (sizeof(initCommands) / sizeof(initCommands[0]))
 
 
 /* - - - - - - - - - - - - - FUNCTIONS - - - - - - - - - - - - - - - */
 /* - - - - BASIC - - - - */
-void swarm_startup(void)
+void swarm_modemInit(SwarmModem* modem, const SwarmHal* hal, void* port, SwarmQueueStore* queueStore)
 {
-    uart_setup(BAUD115200);                        // Swarm only uses 115200
-
-    uart_configureRxInterrupt(UART_ENABLE_INTERRUPT);
+    // everything starts at 0, nested structs too, the downlink routes are the only thing startup keeps
+    memset(modem, 0, sizeof(*modem));
+    modem->hal = hal;
+    modem->port = port;
+    modem->queueStore = queueStore;
+    modem->rxMessagePort = UART;
+    swarm_ratesInit(&modem->rates, modem);          // defaults, change them before swarm_ratesStart()
+    swarm_errorInit(&modem->errors, modem);         // policy[] defaults, change them after this
+}
 
-    swarm_sendInitCommand();
+void swarm_startup(SwarmModem* modem)
+{
+    swarm_txInit(&modem->txRing);
+    SWARM_STATS_INIT(modem);                       // compiled out unless SWARM_STATS_ENABLE
+    swarm_parserInit(&modem->parser);
+    swarm_cmdInit(&modem->cmds, modem);
+    swarm_queueInit(&modem->queue, modem, modem->queueStore);   // anything still in FRAM goes out once the modem is up
+    swarm_schedInit(&modem->sched, modem, modem->hal->millis()); // keeps the books from here, decides nothing until started
+    swarm_downlinkInit(&modem->downlink, modem);   // routes registered before this are kept
+    modem->hal->uartOpen(modem);                   // Swarm only uses 115200
+
+    if(swarm_warmIsValid(&modem->warm))
+        swarm_sendProbe(modem);                     // only the MCU was reset, the modem is most likely still up
+    else
+        swarm_sendInitCommand(modem);
 }
 
-void swarm_shutdown(void)
+void swarm_shutdown(SwarmModem* modem)
 {
-    uart_configureRxInterrupt(UART_DISABLE_INTERRUPT);
-    uart_configureTxInterrupt(UART_DISABLE_INTERRUPT);
-    uart_closeUart();
-    swarm_sleep();
+    modem->hal->uartClose(modem);
+    swarm_sleep(modem);
 }
 
-void swarm_gpio(char pinState){
-    if(pinState){
-        GPIO_setAsOutputPin(SAT_GPIO_Port, SAT_GPIO_Pin);
-        GPIO_setOutputHighOnPin(SAT_GPIO_Port, SAT_GPIO_Pin);  // Low->High WAKES Swarm by default, unless you changed it
-    }
-    else{
-        GPIO_setAsOutputPin(SAT_GPIO_Port, SAT_GPIO_Pin);
-        GPIO_setOutputLowOnPin(SAT_GPIO_Port, SAT_GPIO_Pin);   // High->Low You can make High->Low wake if you want
-    }
+void swarm_gpio(SwarmModem* modem, char pinState){
+    modem->hal->gpioWrite(modem, pinState);                 // see the HAL for which edge wakes Swarm
+}
+
+static bool swarm_wakesLowHigh(void){
+    // compare the mode digit, "$GP 3" -> '3' like SwarmWarm does, the two strings aren't the same object
+    return SAT_GPIO_CONFIGURATION[sizeof(SAT_GPIO_CONFIGURATION) - 2] ==
+           SAT_GPIO_WAKE_LOW_HIGH[sizeof(SAT_GPIO_WAKE_LOW_HIGH) - 2];
 }
 
-void swarm_wake(void){
-    swarm_gpio(SAT_GPIO_HIGH);                              // Low->High WAKES Swarm
-    satInfo.isSleeping = false;
-    cycleDelay_ms(20);                                         // not needed, but just in case
+void swarm_wake(SwarmModem* modem){
+    swarm_gpio(modem, SAT_GPIO_HIGH);                       // Low->High WAKES Swarm
+    modem->info.isSleeping = false;
+    modem->hal->delayMs(20);                                // not needed, but just in case
 }
 
-void swarm_sleep(void){
-    if(satInfo.satFullyInitialized && !satInfo.isSleeping)
-        swarm_sendCommand(SAT_CMD_SLEEP_MODE, SAT_DEFAULT_SLEEP_TIME);
-    if(SAT_GPIO_CONFIGURATION == SAT_GPIO_WAKE_LOW_HIGH)
-        swarm_gpio(SAT_GPIO_LOW);  // High->Low Doesn't sleep swarm, but it prepares for wake
+void swarm_sleep(SwarmModem* modem){
+    if(modem->info.satFullyInitialized && !modem->info.isSleeping)
+        swarm_sendPrebuilt(modem, SwarmCmdSleepDefault);
+    if(swarm_wakesLowHigh())
+        swarm_gpio(modem, SAT_GPIO_LOW);  // High->Low Doesn't sleep swarm, but it prepares for wake
     else
-        swarm_gpio(SAT_GPIO_HIGH); // If you changed it to High->Low wake, this will change with it
-    //satInfo.isSleeping = true;  // this occurs when we receive the "$SL OK*xx" response
+        swarm_gpio(modem, SAT_GPIO_HIGH); // If you changed it to High->Low wake, this will change with it
+    //modem->info.isSleeping = true;  // this occurs when we receive the "$SL OK*xx" response
 }
 
-/* - - - - SENDING COMMANDS - - - - */
-void swarm_sendCommand(char* cmd_define, char* params){
-    // pass in entire command string without *checksum i.e.: "DT @"
-    Message * txCmd = 0;
-    unsigned char checksum;
-
-    // it's much easier to create a new string each time than to handle static memory when passing string literal
-    if((strlen(cmd_define)+strlen(params)+5)<=MESSAGE_BUFF_SIZE_SMALL)
-        txCmd = message_requestMsgBuff(small);
+SwarmTxTag swarm_sleepFor(SwarmModem* modem, unsigned long seconds){
+    // Same as swarm_sleep() but for a chosen time, $SL S=<seconds>
+    char params[13] = "S=";                     // "S=" 10 digits '\0'
+    char digits[10];
+    unsigned int n = 0;
+    unsigned int len = 2;
+    SwarmTxTag tag;
+
+    if(!modem->info.satFullyInitialized || modem->info.isSleeping)
+        return 0;
+    if(seconds < SAT_SLEEP_MIN_s)
+        seconds = SAT_SLEEP_MIN_s;
+    if(seconds > SAT_SLEEP_MAX_s)
+        seconds = SAT_SLEEP_MAX_s;              // a year, the modem says ERR to more
+    do{
+        digits[n++] = '0' + seconds % 10;
+        seconds /= 10;
+    }while(seconds && n < sizeof(digits));
+    while(n)
+        params[len++] = digits[--n];
+    params[len] = '\0';
+
+    tag = swarm_sendCommand(modem, SAT_CMD_SLEEP_MODE, params);
+    if(tag == 0)
+        return 0;
+    if(swarm_wakesLowHigh())
+        swarm_gpio(modem, SAT_GPIO_LOW);        // prepare for wake, same as swarm_sleep()
     else
-        txCmd = message_requestMsgBuff(large);
-    message_append(txCmd, (unsigned char*)cmd_define, strlen(cmd_define));
+        swarm_gpio(modem, SAT_GPIO_HIGH);
+    return tag;
+}
 
-    if(*params != 0){
-        message_append(txCmd, " ", 1);
-        message_append(txCmd, (unsigned char*)params, strlen(params));
+/* - - - - SENDING COMMANDS - - - - */
+static bool swarm_matchPrebuilt(const SwarmPrebuiltCmd* entry, const char* cmd_define, const char* params){
+    // matches both ("$DT", "@") and the whole thing in one string ("$DT @", "")
+    const char* c = entry->cmd;
+
+    while(*c && *c == *cmd_define){
+        c++;
+        cmd_define++;
+    }
+    if(*c)
+        return false;
+    if(*cmd_define == ' ' && *params == 0)
+        params = cmd_define + 1;
+    else if(*cmd_define != 0)
+        return false;
+    return strcmp(entry->params, params) == 0;
+}
+
+static const SwarmPrebuiltCmd* swarm_findPrebuilt(const char* cmd_define, const char* params){
+    // header letters first so most entries are skipped without a compare
+    unsigned char i;
+    const SwarmPrebuiltCmd* entry;
+
+    if(cmd_define[0] == 0 || cmd_define[1] == 0)
+        return 0;
+    for(i=0;i<SwarmCmdCount;i++){
+        entry = &swarmCommandTable[i];
+        if(entry->cmd[1] != cmd_define[1] || entry->cmd[2] != cmd_define[2])
+            continue;
+        if(swarm_matchPrebuilt(entry, cmd_define, params))
+            return entry;
     }
+    return 0;
+}
 
-    checksum = swarm_checksum((char*)txCmd->msgPtr, txCmd->dataLength);
-    message_append(txCmd, "*", 1);
-    hexByte_to_ascii(checksum, (unsigned char*)txCmd->msgPtr+txCmd->dataLength);
-    txCmd->dataLength += 2;                // increment by 2 bytes because the conversion function doesn't do this for us
-    message_append(txCmd, NEWLINE, 1);
+SwarmTxTag swarm_sendCommand(SwarmModem* modem, char* cmd_define, char* params){
+    // pass in the command and its params without *checksum i.e.: "$DT", "@"
+    const SwarmPrebuiltCmd* prebuilt;
+    SwarmTxWriter txCmd;
+    SwarmTxTag tag;
 
-    swarm_sendData(txCmd->msgPtr, txCmd->dataLength);
-    cycleDelay_ms(10);
+    prebuilt = swarm_findPrebuilt(cmd_define, params);
+    if(prebuilt)
+        return swarm_sendData(modem, (const unsigned char*)prebuilt->sentence, prebuilt->length);
 
-    message_killMsg(&txCmd);
+    // anything with variable params gets encoded here, straight into the TX ring
+    swarm_txBegin(&modem->txRing, &txCmd);
+    swarm_txPutString(&txCmd, cmd_define);
+    if(*params != 0){
+        swarm_txPutByte(&txCmd, ' ');
+        swarm_txPutString(&txCmd, params);
+    }
+    tag = swarm_txEnd(&txCmd);
+    if(tag){
+        SWARM_STATS_TX(modem, (unsigned int)cmd_define[1] << 8 | (unsigned char)cmd_define[2]);
+        modem->hal->uartTxStart(modem);
+    }
+    return tag;
 }
 
-void swarm_sendInitCommand(void){
+SwarmTxTag swarm_sendPrebuilt(SwarmModem* modem, SwarmCmdId id){
+    // no lookup, no checksum, just a copy into the TX ring
+    if(id >= SwarmCmdCount)
+        return 0;
+    return swarm_sendData(modem, (const unsigned char*)swarmCommandTable[id].sentence, swarmCommandTable[id].length);
+}
+
+static void swarm_initDone(SwarmModem* modem, unsigned int header, SwarmReply result, const SwarmSentence* reply){
+    unsigned char i;
 
-    if(initCommandArray[cmdArrayIndex] == "Initialized"){
-        satInfo.satFullyInitialized = true;
-        satInfo.satConIsEstablished = true;
+    for(i=0;i<SAT_INIT_COMMANDS;i++){
+        if(header == ((unsigned int)initCommands[i][0][1] << 8 | (unsigned char)initCommands[i][0][2]))
+            break;
+    }
+    if(i == SAT_INIT_COMMANDS)
+        return;
+
+    // $DT @ is answered with I (invalid) until the GPS has time, keep asking
+    if(result == SwarmReplyOk && header == SAT_HEADER_DATE_TIME &&
+       !(reply->fieldCount == 2 && reply->line[reply->fieldStart[1]] == 'V'))
+        result = SwarmReplyError;
+
+    if(result != SwarmReplyOk){
+        swarm_cmdSubmit(&modem->cmds, initCommands[i][0], initCommands[i][1], 0, SAT_INIT_RETRY_ms, swarm_initDone);
+        return;
+    }
+
+    if(modem->initPending && --modem->initPending == 0){
+        modem->info.satFullyInitialized = true;
+        modem->info.satConIsEstablished = true;
         // This satellite module is officially initialized
+        swarm_warmSave(&modem->warm);               // next MCU reset only has to check it's the same modem
+        swarm_warmRestoreRates(modem);              // a full init means the modem forgot them
+    }
+}
+
+static void swarm_dateTimeDone(SwarmModem* modem, unsigned int header, SwarmReply result, const SwarmSentence* reply){
+    // $DT @ for the RTC with nothing waiting on it, asked again until the GPS has a time
+    if(result == SwarmReplyOk && reply->fieldCount == 2 && reply->line[reply->fieldStart[1]] == 'V')
+        return;
+    swarm_cmdSubmit(&modem->cmds, SAT_CMD_DATE_TIME, SAT_CMD_PARAM_QUERY_LAST_MESSAGE, 0, SAT_INIT_RETRY_ms, swarm_dateTimeDone);
+}
+
+static bool swarm_canQuickInit(const SwarmModem* modem){
+    // only the modem went away, we still know which one it is and what time it is
+    return modem->info.deviceID.asLong != 0 && modem->queue.epoch != 0;
+}
+
+static void swarm_submitInit(SwarmModem* modem, unsigned int delayMs, bool quick){
+    unsigned char i;
+
+    swarm_cmdCancelAll(&modem->cmds);          // whatever we were waiting on before won't be answered now
+    modem->warm.probing = false;
+    if(quick)
+        modem->errors.stats.quickInits++;
+    else
+        modem->warm.stats.coldStarts++;
+    modem->initPending = SAT_INIT_COMMANDS;
+    swarm_warmRatesAre(&modem->warm, SWARM_WARM_RATE_UNKNOWN);   // whatever the modem had before, we can't tell
+    for(i=0;i<SAT_INIT_COMMANDS;i++){
+        if(quick && ((unsigned int)initCommands[i][0][1] << 8 | (unsigned char)initCommands[i][0][2]) == SAT_HEADER_DATE_TIME){
+            // the RTC and the queue's ET= clock are still good, a GPS fix can take minutes and nothing needs it
+            modem->initPending--;
+            swarm_cmdSubmit(&modem->cmds, SAT_CMD_DATE_TIME, SAT_CMD_PARAM_QUERY_LAST_MESSAGE, 0, delayMs, swarm_dateTimeDone);
+        }
+        else
+            swarm_cmdSubmit(&modem->cmds, initCommands[i][0], initCommands[i][1], 0, delayMs, swarm_initDone);
+    }
+}
+
+void swarm_sendInitCommand(SwarmModem* modem){
+    modem->warm.booting = false;
+    swarm_submitInit(modem, 0, false);
+}
+
+void swarm_reinit(SwarmModem* modem){
+    // Nothing it told us can be trusted any more (it went quiet, or an ERR said so), so init it again now. Whatever
+    // $TD was in flight goes again once $MT C=U says what the modem still has
+    modem->warm.booting = false;
+    modem->info.satConIsEstablished = false;
+    modem->info.satFullyInitialized = false;
+    swarm_queueForgetModem(&modem->queue);
+    swarm_submitInit(modem, 0, swarm_canQuickInit(modem));
+}
+
+static void swarm_probeDone(SwarmModem* modem, unsigned int header, SwarmReply result, const SwarmSentence* reply){
+    // $CS was parsed into modem->info.deviceID before we got here
+    if(!modem->warm.probing)
+        return;                                 // the modem rebooted meanwhile, that init has it
+    modem->warm.probing = false;
+    if(result != SwarmReplyOk || !swarm_warmIsValid(&modem->warm) ||
+       modem->info.deviceID.asLong != modem->warm.store->deviceId){
+        modem->warm.stats.mismatches++;
+        swarm_warmForget(&modem->warm);
+        swarm_sendInitCommand(modem);
         return;
     }
 
-    swarm_sendCommand(initCommandArray[cmdArrayIndex], SAT_CMD_PARAM_NO_PARAMS);
+    modem->warm.stats.warmStarts++;
+    memcpy(modem->warm.rateHave, modem->warm.store->rate, sizeof(modem->warm.rateHave));   // same modem, same rates
+    if(modem->info.modem.firmware[0] == '\0')
+        memcpy(modem->info.modem.firmware, modem->warm.store->firmware, sizeof(modem->info.modem.firmware));
+    modem->initPending = 0;
+    modem->info.satFullyInitialized = true;
+    modem->info.satConIsEstablished = true;
+    // $DT for the RTC, the MCU lost it too
+    swarm_cmdSubmit(&modem->cmds, SAT_CMD_DATE_TIME, SAT_CMD_PARAM_QUERY_LAST_MESSAGE, 0, 0, swarm_dateTimeDone);
+}
+
+void swarm_sendProbe(SwarmModem* modem){
+    // One $CS instead of the whole init, swarm_warmIsValid() said the FRAM record is good
+    swarm_cmdCancelAll(&modem->cmds);
+    modem->warm.booting = false;
+    modem->warm.probing = true;
+    modem->initPending = 0;
+    swarm_warmRatesAre(&modem->warm, SWARM_WARM_RATE_UNKNOWN);
+    swarm_cmdSubmit(&modem->cmds, SAT_CMD_DEVICE_ID, SAT_CMD_PARAM_NO_PARAMS, SWARM_WARM_PROBE_ms, 0, swarm_probeDone);
 }
 
-void swarm_sendData(unsigned char* data, int datalen)
+static void swarm_modemRebooted(SwarmModem* modem, SwarmFault fault){
+    // The modem restarted by itself and forgot everything, and anything sent before BOOT,RUNNING is lost anyway.
+    // The init is queued SWARM_WARM_BOOT_ms out in case that line never makes it, RUNNING brings it forward
+    if(modem->warm.booting){
+        swarm_errorFaultWas(&modem->errors, fault);  // the BOOT line after the noise says why
+        return;
+    }
+    modem->warm.booting = true;
+    modem->warm.stats.reboots++;
+    swarm_errorFault(&modem->errors, fault, modem->hal->millis());
+    modem->info.satConIsEstablished = false;
+    modem->info.satFullyInitialized = false;
+    modem->info.isSleeping = false;
+    swarm_queueForgetModem(&modem->queue);     // its $TD in flight and its count are gone with it
+    swarm_submitInit(modem, SWARM_WARM_BOOT_ms, swarm_canQuickInit(modem));
+    swarm_warmRatesAre(&modem->warm, 0);        // a fresh boot has every rate off
+}
+
+SwarmTxTag swarm_sendData(SwarmModem* modem, const unsigned char* data, unsigned int datalen)
 {
     // This sends data to Swarm Modem, not satellite, This is used when Sending Commands
-    while(uart_isTransmitting()); // Wait until UART is free
-    cycleDelay_ms(30);
+    // Queues and returns immediately, 0 means the TX ring is full and nothing was sent
+    SwarmTxTag tag;
 
-    uart_send(data, datalen);
+    tag = swarm_txWrite(&modem->txRing, data, datalen);
+    if(tag){
+        SWARM_STATS_TX(modem, datalen >= 3 ? (unsigned int)data[1] << 8 | data[2] : 0);
+        modem->hal->uartTxStart(modem);
+    }
+    return tag;
 }
 
 unsigned char swarm_checksum(const char *sz, size_t len){
@@ -146,265 +349,325 @@ unsigned char swarm_checksum(const char *sz, size_t len){
     return cs;
 }
 
+unsigned int swarm_crc16(const unsigned char* data, unsigned int len, unsigned int crc){
+    // CRC-16/CCITT, bit at a time, small and fast enough for a few hundred bytes
+    unsigned char bit;
+
+    while(len--){
+        crc ^= (unsigned int)*data++ << 8;
+        for(bit = 0; bit < 8; bit++)
+            crc = (crc & 0x8000) ? (crc << 1) ^ 0x1021 : crc << 1;
+    }
+    return crc & 0xFFFF;
+}
+
 /* - - - - HANDLING MESSAGES - - - - */
-void swarm_handleMsg(void)
+bool swarm_rxByte(SwarmModem* modem, unsigned char byte)
 {
-    char* msgPtr;
+    // Call this from the UART RX ISR when SAT_RX_FROM_MESSAGE is 0, same few cycles for every byte.
+    // Returns true when this byte finished a sentence, that's the ISR's cue to leave LPM (see SwarmEvents.h)
+    unsigned char head = modem->parser.head;
 
-    satRxMsg = message_getMsg(UART);
-    if(!satRxMsg)
-        return;
+    swarm_parserFeed(&modem->parser, byte);
+    return modem->parser.head != head;
+}
+
+void swarm_handleMsg(SwarmModem* modem)
+{
+    const SwarmSentence* sentence;
+    unsigned long now;
+#if SAT_RX_FROM_MESSAGE
+    Message* rxMsg;                             // the line we're actively getting
+    unsigned int i;
+#endif
+
+    swarm_txService(&modem->txRing);               // TX completion callbacks run here, not in the ISR
+    swarm_cmdService(&modem->cmds, modem->hal->millis());   // resends and timeouts
+
+#if SAT_RX_FROM_MESSAGE
+    // Lines buffered by the UART ISR / Message system still go through the same parser, all of them, not one a call
+    do{
+        rxMsg = message_getMsg((MessagePort)modem->rxMessagePort);
+        if(rxMsg){
+            for(i = 0; i < rxMsg->dataLength; i++)
+                swarm_parserFeed(&modem->parser, rxMsg->msgPtr[i]);
+            if(!rxMsg->dataLength || rxMsg->msgPtr[rxMsg->dataLength - 1] != '\n')
+                swarm_parserFeed(&modem->parser, '\n');
+            message_freeMsg(rxMsg);
+        }
+#endif
 
-    msgPtr = (char*)satRxMsg->msgPtr;  // this shortens and simplifies things
+        while((sentence = swarm_parserGet(&modem->parser)) != 0){
+            swarm_handleSentence(modem, sentence);
+            swarm_parserRelease(&modem->parser);       // slot goes back to the ISR
+        }
+#if SAT_RX_FROM_MESSAGE
+    }while(rxMsg);
+#endif
+
+    now = modem->hal->millis();
+    swarm_errorService(&modem->errors, now);       // gone quiet, back in service
+    swarm_downlinkService(&modem->downlink, now);  // $MM C=U / R=O / D=* in batches
+    swarm_ratesService(&modem->rates, now);        // rates for the power mode, @ for whatever is due
+    if(modem->frag)
+        swarm_fragService(modem->frag, now);       // the next piece of a big send, if the queue has room
+    swarm_queueService(&modem->queue, now);        // feed the modem as it has room
+    swarm_schedService(&modem->sched, now);        // sleep / wake, after the queue so it sees what's in flight
+#if SAT_DOWNLINK_DISPATCH
+    swarm_downlinkDispatch(&modem->downlink);      // after every line is in, so a burst of $RD is handled together
+#endif
+}
+
+void swarm_handleSentence(SwarmModem* modem, const SwarmSentence* sentence)
+{
+    SWARM_STATS_RX(modem, sentence);
+    if(sentence->status == SwarmSentenceBadChecksum || sentence->status == SwarmSentenceNoChecksum)
+        return;  // corrupt line, acting on it would be worse than missing it
+
+    if(sentence->header == SAT_HEADER_TRANSMIT_DATA){
+        if(modem->frag)
+            swarm_fragOnTdReply(modem->frag, sentence);    // while the queue still knows which $TD was in flight
+        swarm_queueOnTdReply(&modem->queue, sentence);     // OK, SENT and ERR all matter to the queue
+    }
 
-    if(swarm_isErrorMessage(satRxMsg)){
-        swarm_handleError(msgPtr);
-        message_freeMsg(satRxMsg);
+    if(swarm_isErrorMessage(sentence)){
+        swarm_handleError(modem, sentence);
+        if(sentence->isError)
+            swarm_cmdOnSentence(&modem->cmds, sentence);   // whoever sent it gets SwarmReplyError
+        swarm_eventDispatch(modem, sentence);
         return;  // it was a satellite message, it was just an error
     }
-    switch(msgPtr[1] << 8 | msgPtr[2]){
+    SWARM_STATS_PARSE_BEGIN(modem);
+    switch(sentence->header){
     case SAT_HEADER_DEVICE_INFO:
-        swarm_parseDeviceIdMessage(msgPtr);
+        swarm_parseDeviceIdMessage(modem, sentence);
         break;
     case SAT_HEADER_GPS_INFO:
-        swarm_parseGpsMessage(msgPtr);
+        swarm_parseGpsMessage(modem, sentence);
+        break;
+    case SAT_HEADER_GPS_JAMMING:
+        swarm_parseGpsJammingMessage(modem, sentence);
+        break;
+    case SAT_HEADER_GPS_STATUS:
+        swarm_parseGpsStatusMessage(modem, sentence);
+        break;
+    case SAT_HEADER_POWER_STATUS:
+        swarm_parsePowerMessage(modem, sentence);
+        break;
+    case SAT_HEADER_FW_VERSION:
+        swarm_parseFwVersionMessage(modem, sentence);
+        break;
+    case SAT_HEADER_RECEIVE_DATA:
+        swarm_parseReceiveDataMessage(modem, sentence);
         break;
     case SAT_HEADER_SLEEP:
-        swarm_parseSleepMessage(msgPtr);
+        swarm_parseSleepMessage(modem, sentence);
         break;
     case SAT_HEADER_DATE_TIME:
-        swarm_parseDateTimeMessage(msgPtr);
+        swarm_parseDateTimeMessage(modem, sentence);
         break;
     case SAT_HEADER_RECEIVE_TEST:
-        swarm_parseRssiMessage(msgPtr);
+        swarm_parseRssiMessage(modem, sentence);
         break;
 //    case SAT_HEADER_INTERNAL_MESSAGE:
-//        swarm_parseInternalMessage(msgPtr);
+//        swarm_parseInternalMessage(sentence);
 //        break;
     case SAT_HEADER_TRANSMIT_DATA:
-        swarm_parseTransmitDataMessage(msgPtr);
+        swarm_parseTransmitDataMessage(modem, sentence);
         break;
     case SAT_HEADER_GPIO_MSG:
-        swarm_parseGpioMessage(msgPtr);
+        swarm_parseGpioMessage(modem, sentence);
         break;
     case SAT_HEADER_MESSAGE_MANAGEMENT_TX:
     case SAT_HEADER_MESSAGE_MANAGEMENT_RX:
-        swarm_parseMessageManagementMessage(msgPtr);
+        swarm_parseMessageManagementMessage(modem, sentence);
         break;
     case SAT_HEADER_MODEM_MSG:
-    default: swarm_parseModemMessage(msgPtr);
+    default: swarm_parseModemMessage(modem, sentence);
         break;
     }
-    message_freeMsg(satRxMsg);
+    SWARM_STATS_PARSE_END(modem, sentence);
+    swarm_ratesOnSentence(&modem->rates, sentence);    // how old each part of modem->info is
+    swarm_cmdOnSentence(&modem->cmds, sentence);       // after parsing, so callbacks see the updated modem->info
+    swarm_eventDispatch(modem, sentence);              // your handlers last, everything above is done
 }
 
-bool swarm_isErrorMessage(Message* message) {
-    // If the String "ERR" is inside a response, return true
-    unsigned char ch;
-    for (ch = 0; ch < message->dataLength; ch++) {
-        if (message->msgPtr[ch] == 'R') {
-            if (message->msgPtr[ch - 2] == 'E' && message->msgPtr[ch - 1] == 'R')
-                return true;
-        }
-    }
-    if(message->msgPtr[0] == '.') // When swarm boots, it sends a bunch of data thats hard to catch, but the .'s are easy to catch
-        return true;
-    return false;
-}
-
-void swarm_handleError(char* msgPtr){
-    // Handle Errors however you see fit
-    // Options are to ignore it, parse it and handle, or to just simply notify that an error occurred
-    if(msgPtr[0] == '.'){  // module rebooted meaning we need to restart the init process on MCU side
-        satInfo.satConIsEstablished = false;
-        satInfo.satFullyInitialized = false;
-        cmdArrayIndex = 0;
-        swarm_sendInitCommand();
-    }
+bool swarm_isErrorMessage(const SwarmSentence* sentence) {
+    // The parser already knows if field 0 is "ERR", and boot noise is flagged when the line starts with '.'
+    return sentence->isError || sentence->status == SwarmSentenceNoise;
 }
 
-void swarm_parseSleepMessage(char* msgPtr){
+void swarm_handleError(SwarmModem* modem, const SwarmSentence* sentence){
+    // The code and what's done about it go by modem->errors.policy[], see SwarmErrors.h. Retry, Backoff and Drop are
+    // up to whoever sent it (the command engine, the queue), only a Reinit is ours
+    unsigned long now = modem->hal->millis();
 
-    if(msgPtr[4] == 'O' && msgPtr[5] == 'K')    // update
-        satInfo.isSleeping = true;              // we'll need to us this to help communication when we're ready to start sleeping this modem
-    else if(msgPtr[4] == 'W' && msgPtr[5] == 'A' && msgPtr[6] == 'K' && msgPtr[7] == 'E') // can I just do *(msgPtr+4) == "WAKE" ?
-        satInfo.isSleeping = false;
+    if(sentence->status == SwarmSentenceNoise){  // module rebooted meaning we need to restart the init process on MCU side
+        swarm_modemRebooted(modem, SwarmFaultNoise);   // once it says BOOT,RUNNING
+        return;
+    }
+    if(swarm_errorOnSentence(&modem->errors, sentence, now) == SwarmRecoverReinit){
+        swarm_errorFault(&modem->errors, SwarmFaultError, now);
+        swarm_reinit(modem);
+    }
 }
 
-void swarm_parseModemMessage(char* msgPtr){
-
-    __no_operation();
+void swarm_parseSleepMessage(SwarmModem* modem, const SwarmSentence* sentence){
 
+    if(swarm_sentenceFieldIs(sentence, 0, "OK"))       // update
+        modem->info.isSleeping = true;              // we'll need to us this to help communication when we're ready to start sleeping this modem
+    else if(sentence->fieldCount && sentence->fieldLen[0] >= 4 && sentence->line[sentence->fieldStart[0]] == 'W') // WAKE,<cause>
+        modem->info.isSleeping = false;
 }
 
-void swarm_parseRssiMessage(char* msgPtr){
-    char* indexPtr;
-    unsigned char i; // messageToDesk[4] = {},
+void swarm_parseModemMessage(SwarmModem* modem, const SwarmSentence* sentence){
+    // $M138 BOOT / DATETIME / POSITION / DEBUG / ERROR, the rest of the boot noise never gets here
+    if(sentence->header != SAT_HEADER_MODEM_MSG || !swarm_sentenceM138(sentence, &modem->info.modem))
+        return;
+    if(modem->info.modem.lastEvent == ModemEventBoot)
+        swarm_modemRebooted(modem, modem->info.modem.bootReason == ModemBootAbort ? SwarmFaultAbort : SwarmFaultBoot);
+    else if(modem->info.modem.lastEvent == ModemEventRunning && modem->warm.booting){
+        modem->warm.booting = false;                // up again, no point waiting out SWARM_WARM_BOOT_ms
+        swarm_submitInit(modem, 0, swarm_canQuickInit(modem));
+    }
+}
 
-    if (strlen(msgPtr) > 20) {                         // if message is long, its a satellite RSSI message
-        satInfo.rssi.satellite = 0xFF;
-        satInfo.rssi.snr = 0xFF;
+void swarm_parseRssiMessage(SwarmModem* modem, const SwarmSentence* sentence){
+    bool isBackground;
 
-        // Parse satellite rssi
-        indexPtr = strchr(msgPtr, '=') + 1; // returns string after '=' ( our number )
-        // Iterate through characters after = until ',' is hit
-        for(i=0;i<5;i++){
-            if(indexPtr[i] == ',')          // find how long the input string will be
-                break;
-        }
-        satInfo.rssi.satellite = ascii_to_char(indexPtr, i);
-
-        // Parse SNR
-        indexPtr = strchr(indexPtr, '=') + 1; // returns string after '=' ( our number )
-        // Iterate through characters after = until ',' is hit
-        for(i=0;i<5;i++){
-            if(indexPtr[i] == ',')            // find how long the input string will be
-                break;
-        }
-        satInfo.rssi.snr = ascii_to_char(indexPtr, i);
+    // RSSI=,SNR=,FDEV=,TS=,DI= is a satellite RSSI message, just RSSI=<rssi_bkgnd> is background
+    if(!swarm_sentenceRt(sentence, &modem->info.rssi, &isBackground) || !isBackground)
+        return;
 
-        // if we want, we can also get Frequency Deviation, Time Received, and Satellite ID
+    if (modem->info.rssi.background > 104)
+        modem->info.signalRating = SignalStrengthExcellent;
+    else if (modem->info.rssi.background > 99)
+        modem->info.signalRating = SignalStrengthGood;
+    else if (modem->info.rssi.background > 96)
+        modem->info.signalRating = SignalStrengthOK;
+    else if (modem->info.rssi.background > 92)
+        modem->info.signalRating = SignalStrengthMarginal;
+    else if (modem->info.rssi.background > 85)
+        modem->info.signalRating = SignalStrengthBad;
+    else
+        modem->info.signalRating = SignalStrengthUndetermined;
+}
 
-    } else {
-        // Parse background RSSI
-        indexPtr = strchr(indexPtr, '=') + 1; // returns string after '=' ( our number )
-        // Iterate through characters after = until ',' is hit
-        for(i=0;i<5;i++){
-            if(indexPtr[i] == ',')            // find how long the input string will be
-                break;
-        }
-        satInfo.rssi.background = ascii_to_char(indexPtr, i);
-
-        if (satInfo.rssi.background > 104)
-            satInfo.signalRating = SignalStrengthExcellent;
-        else if (satInfo.rssi.background > 99)
-            satInfo.signalRating = SignalStrengthGood; // if message is very short, its a background RSSI message
-        else if (satInfo.rssi.background > 96)
-            satInfo.signalRating = SignalStrengthOK;
-        else if (satInfo.rssi.background > 92)
-            satInfo.signalRating = SignalStrengthMarginal;
-        else if (satInfo.rssi.background > 85)
-            satInfo.signalRating = SignalStrengthBad;
-        else
-            satInfo.signalRating = SignalStrengthUndetermined;
+void swarm_parseDateTimeMessage(SwarmModem* modem, const SwarmSentence* sentence){
+    // only a V (valid) time makes it to the RTC, I (invalid), rates and OK are ignored
+    if(swarm_sentenceDt(sentence, &modem->info.dateTime)){
+        modem->hal->rtcSet(modem->info.dateTime);
+        swarm_queueOnDateTime(&modem->queue, &modem->info.dateTime, modem->hal->millis());   // deadlines become ET=
     }
 }
 
-void swarm_parseDateTimeMessage(char* msgPtr){
+void swarm_parseTransmitDataMessage(SwarmModem* modem, const SwarmSentence* sentence){
+//    If you want to do something on Transmit OK response, do it here, the scheduler times OK -> SENT
+    SwarmTdReply reply;
 
-    if(msgPtr[19] == 'V'){   // V means Valid Date/Time, I means Invalid
-        satInfo.dateTime.Year = ascii_to_int(msgPtr+4, 4);
-        satInfo.dateTime.Month = ascii_to_int(msgPtr+8, 2)-1;    // RTC Month is 0-starting (January = 0)
-        satInfo.dateTime.DayOfMonth = ascii_to_int(msgPtr+10, 2);
-        //satInfo.dateTime.DayOfWeek = ascii_to_int(msgPtr[12], 2);
-        satInfo.dateTime.Hours = ascii_to_int(msgPtr+12, 2);
-        satInfo.dateTime.Minutes = ascii_to_int(msgPtr+14, 2);
-        satInfo.dateTime.Seconds = ascii_to_int(msgPtr+16, 2);
-        initRTC(satInfo.dateTime);
-
-        cmdArrayIndex++;  // since we got the first init command response, send next command
-        swarm_sendInitCommand();
-
-    }
+    if(!swarm_sentenceTd(sentence, &reply))
+        return;
+    if(reply.kind == SwarmTdOk)
+        swarm_schedOnTdOk(&modem->sched, modem->hal->millis());
+    else if(reply.kind == SwarmTdSent)
+        swarm_schedOnTdSent(&modem->sched, modem->hal->millis());
 }
 
-void swarm_parseTransmitDataMessage(char* msgPtr){
-//    If you want to do something on Transmit OK response, do it here
-//    if(msgPtr[4] == 'O' && msgPtr[5] == 'K'){
+void swarm_parseGpioMessage(SwarmModem* modem, const SwarmSentence* sentence){
+//    $GP OK is the init command engine's business, anything else like the current mode can be handled here
+//    if(swarm_sentenceFieldIs(sentence, 0, "OK")){
 //        your code here
 //    }
 
 }
 
-void swarm_parseGpioMessage(char* msgPtr){
-
-    if(msgPtr[4] == 'O' && msgPtr[5] == 'K'){
-        cmdArrayIndex++;
-        swarm_sendInitCommand();
-    }
+void swarm_parseGpsJammingMessage(SwarmModem* modem, const SwarmSentence* sentence){
+    swarm_sentenceGj(sentence, &modem->info.gpsJamming);
 }
 
-void swarm_parseDeviceIdMessage(char* msgPtr){
-    char* idToken;
-    char* idPtr;
-    const char delimiter[1] = {'x'};
-
-    idToken = strtok(msgPtr+4, delimiter);  // break msgPtr into strings delimited by 0x
-    idToken = strtok(NULL, delimiter);  // this token will be the device ID
-
-    satInfo.deviceID.asLong = strtol(idToken, &idPtr, 16);  // this converts string to hex (third argument base 16)
+void swarm_parseGpsStatusMessage(SwarmModem* modem, const SwarmSentence* sentence){
+    swarm_sentenceGs(sentence, &modem->info.gpsStatus);
+}
 
-    cmdArrayIndex++;  // since we got the first init command response, send next command
-    swarm_sendInitCommand();
+void swarm_parsePowerMessage(SwarmModem* modem, const SwarmSentence* sentence){
+    swarm_sentencePw(sentence, &modem->info.power);
 }
 
-void swarm_parseGpsMessage(char* msgPtr){
-    char* gpsToken;
-    char* gpsPtr;
-    const char delimiter[1] = {','};
+void swarm_parseFwVersionMessage(SwarmModem* modem, const SwarmSentence* sentence){
+    swarm_sentenceFv(sentence, modem->info.modem.firmware, sizeof(modem->info.modem.firmware));
+}
 
-    // Parse latitude
-    gpsToken = strtok(msgPtr+4, delimiter);  // break msgPtr into strings delimited by comma, ignore first 4 bytes of msgPtr
-    satInfo.gps.latitude.asFloat = strtof(gpsToken, &gpsPtr);
+void swarm_parseReceiveDataMessage(SwarmModem* modem, const SwarmSentence* sentence){
+    // decoded into modem->downlink's ring, your handler gets it by appID, see swarm_downlinkRoute()
+    swarm_downlinkOnRd(&modem->downlink, sentence, modem->hal->millis());
+}
 
-    // Parse longitude
-    gpsToken = strtok(NULL, delimiter);
-    satInfo.gps.longitude.asFloat = strtof(gpsToken, &gpsPtr);
+void swarm_parseDeviceIdMessage(SwarmModem* modem, const SwarmSentence* sentence){
+    // $CS DI=0x<hex>,DN=M138
+    swarm_sentenceCs(sentence, &modem->info.deviceID);
+}
 
-    // If we want to parse Altitude, Course, and Speed, continue the pattern
+void swarm_parseGpsMessage(SwarmModem* modem, const SwarmSentence* sentence){
+    // lat, lon, altitude, course and speed, $GN <rate> or $GN OK leave the last fix alone
+    swarm_sentenceGn(sentence, &modem->info.gps);
 }
 
-void swarm_parseMessageManagementMessage(char* msgPtr){
-    unsigned int unsentMessages = 0;
-    char* tdPtr;
-    if(msgPtr[2] == 'T'){ // "MT"
-        unsentMessages |= strtol(msgPtr+4, &tdPtr, 10);  // base 10 for decimal, returns long
-        if(unsentMessages > 20)
-            swarm_sendCommand(SAT_CMD_MSG_TX_MANAGEMENT, SAT_CMD_PARAM_DELETE_UNSENT_MESSAGES);
-    }
-    else if(msgPtr[2] == 'M'){ // "MM"
+void swarm_parseMessageManagementMessage(SwarmModem* modem, const SwarmSentence* sentence){
+    unsigned int unsentMessages;
+    SwarmMmReply reply;
 
+    if(sentence->header == SAT_HEADER_MESSAGE_MANAGEMENT_TX){ // "MT"
+        if(swarm_sentenceMt(sentence, &unsentMessages))
+            swarm_queueOnUnsentCount(&modem->queue, unsentMessages);   // the queue holds back when it's high, nothing is deleted
+    }
+    else if(sentence->header == SAT_HEADER_MESSAGE_MANAGEMENT_RX){ // "MM"
+        if(swarm_sentenceMm(sentence, &reply) && reply.kind == SwarmMmCount)
+            modem->info.unreadMessages = reply.count;
     }
 
 }
 
 /* - - - - OUTGOING DATA - - - - */
-void swarm_transmitData(char* applicationID, char* holdTime, char* payload, unsigned int numberOfBytes){
-    // This transmits data to a satellite, data is converted to HexASCII and sent
-    Message * dataBuff = 0;
-    unsigned int i;
-    unsigned char checksum;
-
-    dataBuff = message_requestMsgBuff(large);  // This can be dynamic, but it gets messing when considering all possible arguments
-    if(!dataBuff)
-        return;
-
-    message_append(dataBuff, "$TD ", 4);
-
-    if(applicationID != 0){
-        for(i=0;i<strlen(applicationID);i++)
-            message_append(dataBuff, (unsigned char* )applicationID[i], 1);
-    }
+SwarmTxTag swarm_transmitData(SwarmModem* modem, char* applicationID, char* holdTime, char* payload, unsigned int numberOfBytes){
+    // This transmits data to a satellite, data is converted to HexASCII straight into the TX ring as it's sent
+    return swarm_transmitPayload(modem, applicationID, holdTime, (const unsigned char*)payload, numberOfBytes, SwarmPayloadHex);
+}
 
-    if(holdTime != 0){
-        for(i=0;i<strlen(holdTime);i++)
-            message_append(dataBuff, (unsigned char* )holdTime[i], 1);
+SwarmTxTag swarm_transmitPayload(SwarmModem* modem, char* applicationID, char* holdTime, const unsigned char* payload,
+                                 unsigned int numberOfBytes, SwarmPayloadMode mode){
+    // Same as swarm_transmitData, but printable payloads can go as a "quoted string", one char a byte instead of two
+    SwarmTxWriter td;
+    SwarmTxTag tag;
+
+    if(numberOfBytes == 0 || numberOfBytes > SAT_NUMBER_MAX_PACKET_BYTES_HEX)
+        return 0;                               // one $TD carries 192 bytes either way, bigger goes through SwarmFragment
+    if(mode == SwarmPayloadAuto)
+        mode = swarm_codecIsPrintable(payload, numberOfBytes) ? SwarmPayloadAscii : SwarmPayloadHex;
+    else if(mode == SwarmPayloadAscii && !swarm_codecIsPrintable(payload, numberOfBytes))
+        return 0;
+
+    swarm_txBegin(&modem->txRing, &td);
+    swarm_txPutString(&td, SAT_CMD_TRANSMIT_DATA " ");
+    if(applicationID != 0)
+        swarm_txPutString(&td, applicationID);
+    if(holdTime != 0)
+        swarm_txPutString(&td, holdTime);
+    if(mode == SwarmPayloadAscii){
+        swarm_txPutByte(&td, '"');
+        swarm_txPutBytes(&td, payload, numberOfBytes);
+        swarm_txPutByte(&td, '"');
     }
-
-    hex_to_ascii((unsigned char*)payload, dataBuff->msgPtr+dataBuff->dataLength, numberOfBytes);
-    dataBuff->dataLength += (numberOfBytes*2);  // increment by 2*bytes because the conversion function doesn't do this for us
-
-    checksum = swarm_checksum((char*)dataBuff->msgPtr, dataBuff->dataLength);
-    message_append(dataBuff, "*", 1);
-    hexByte_to_ascii(checksum, dataBuff->msgPtr+dataBuff->dataLength);
-    dataBuff->dataLength += 2;                  // increment by 2 bytes because the conversion function doesn't do this for us
-    message_append(dataBuff, NEWLINE, 1);
-
-    swarm_sendData(dataBuff->msgPtr, dataBuff->dataLength);
-    cycleDelay_ms(10);
-
-    satInfo.secondsSinceTransmit = 0; // initially put this inside "$TD OK" handling, but message gets deleted either way
-    message_freeMsg(dataBuff);
+    else
+        swarm_txPutHex(&td, payload, numberOfBytes);
+    tag = swarm_txEnd(&td);                     // appends *xx\n, 0 if it didn't fit
+    if(tag == 0)
+        return 0;
+    SWARM_STATS_TX(modem, SAT_HEADER_TRANSMIT_DATA);
+    modem->queue.tdSent++;                      // the queue tells its own OK / ERR from ours by order
+    modem->hal->uartTxStart(modem);
+
+    modem->info.secondsSinceTransmit = 0; // initially put this inside "$TD OK" handling, but message gets deleted either way
+    return tag;
 }
 
 
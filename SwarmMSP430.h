@@ -6,21 +6,58 @@
  */
 
 #ifndef SATMODEM_H_
-#define TOPLEVEL_INTERNET_SATMODEM_H_
+#define SATMODEM_H_
 
 #include <stdbool.h>
 #include "stdlib.h"
 #include "misc.h"
+#include <SwarmTx.h>
+#include <SwarmParser.h>
+#include <SwarmCmd.h>
+#include <SwarmCodec.h>
+#include <SwarmQueue.h>
+#include <SwarmFragment.h>
+#include <SwarmScheduler.h>
+#include <SwarmSentences.h>
+#include <SwarmDownlink.h>
+#include <SwarmEvents.h>
+#include <SwarmWarm.h>
+#include <SwarmRates.h>
+#include <SwarmErrors.h>
+#include <SwarmStats.h>
+#include <SwarmHAL.h>
 
 #ifndef PINS_H
 #define SAT_GPIO_Port                                   GPIO_PORT_P8
 #define SAT_GPIO_Pin                                    BIT1
 #endif
 
-/* Configure these for your situation */
+/* Configure these for your situation, the SAT_UART / SAT_GPIO / SAT_TX_DMA ones are only what SAT_MSP430_PORT fills in */
 #define SAT_UART                        EUSCI_A0_BASE
-#define SAT_RX_TIMEOUT_ms               RX_BUFF_SIZE_LARGE / 10
+#define SAT_RX_TIMEOUT_ms               1000                            // how long Swarm gets to answer before a resend, doubles each retry
+#define SAT_INIT_RETRY_ms               5000                            // init command that failed or $DT with no valid time yet
 #define SAT_STARTBYTE                   '$'
+#ifndef SAT_RX_FROM_MESSAGE                                              // -D it, SwarmPool.h sizes the line pool from it
+#define SAT_RX_FROM_MESSAGE             1                               // 1 -> swarm_handleMsg() pulls lines from message_getMsg(modem->rxMessagePort), one line in the pool at a time
+#endif                                                                  // 0 -> your UART RX ISR calls swarm_rxByte() for every byte, lines wait in the pool
+#ifndef SAT_DOWNLINK_DISPATCH
+#define SAT_DOWNLINK_DISPATCH           1                               // 1 -> swarm_handleMsg() runs the $RD appID handlers
+#endif                                                                  // 0 -> you call swarm_downlinkDispatch(&modem->downlink)
+#ifndef SAT_TX_USE_DMA
+#define SAT_TX_USE_DMA                  1                               // 1 -> call swarm_halMsp430DmaIsr() from your DMA_VECTOR ISR
+#endif                                                                  // 0 -> call swarm_halMsp430TxIsr() from your eUSCI TX ISR instead
+#define SAT_TX_DMA_CHANNEL              DMA_CHANNEL_0
+#define SAT_TX_DMA_TRIGGER              DMA_TRIGGERSOURCE_15            // UCA0TXIFG on the FR5994, check the datasheet if you move SAT_UART
+#define SAT_MSP430_PORT                 {SAT_UART, SAT_GPIO_Port, SAT_GPIO_Pin, SAT_TX_DMA_CHANNEL, SAT_TX_DMA_TRIGGER}
+#ifndef SAT_EVENT_IDLE_MAX_ms
+#define SAT_EVENT_IDLE_MAX_ms           1000                            // longest swarm_eventWait() sleeps with no command waiting
+#endif
+#ifndef SAT_STATS_TIMER_R
+#define SAT_STATS_TIMER_R               TB0R                            // free running timer you already have, SWARM_STATS_ENABLE only
+#endif
+#ifndef SAT_EVENT_LPM
+#define SAT_EVENT_LPM                   LPM3_bits                       // eUSCI clock request keeps RX going, LPM0_bits if yours doesn't
+#endif
 
 // How to Wake Swarm Modem -- SEE SWARM PRODUCT MANUAL -- Link inside INFO comments
 #define SAT_GPIO_WAKE_LOW_HIGH          "$GP 3"                         // Low->High Transition WAKES Modem
@@ -157,17 +194,7 @@ typedef enum{
     SignalStrengthExcellent
 }SignalRating;
 
-typedef struct{
-    char background;
-    char satellite;
-    char snr;
-}RSSI;
-
-typedef struct{
-    EasyFloat longitude;
-    EasyFloat latitude;
-    // you can put FDEV and other stuff in here if desired
-}GPS;
+/* RSSI, GPS, GPSStatus, GPSJamming, PowerStatus and ModemStatus live in SwarmSentences.h with their parsers */
 
 typedef struct{
     Calendar dateTime;
@@ -177,11 +204,59 @@ typedef struct{
     bool satFullyInitialized;
     RSSI rssi;
     GPS gps;
+    GPSStatus gpsStatus;
+    GPSJamming gpsJamming;
+    PowerStatus power;
+    ModemStatus modem;                          // $M138 boot state and firmware version
     SignalRating signalRating;
+    unsigned int unreadMessages;                // last $MM count
     unsigned int satCounter;
     unsigned int secondsSinceTransmit;
 }SatInfo;
 
+/* Everything about one modem: how to reach it, what we know about it and every queue in between. Nothing in the
+ * driver is global anymore, so a board with two modems just has two of these, and each can be tested on its own.
+ *
+ *      SWARM_PERSISTENT(store0)
+ *      SwarmQueueStore store0 SWARM_PERSISTENT_ATTR = {0};       // FRAM, one per modem
+ *      SwarmMsp430Port port0 = SAT_MSP430_PORT;                  // EUSCI_A0, P8.1, DMA 0
+ *      SwarmModem modem0;
+ *
+ *      swarm_modemInit(&modem0, &swarmHalMsp430, &port0, &store0);
+ *      swarm_startup(&modem0);
+ *      for(;;) swarm_handleMsg(&modem0);
+ *
+ * Give it a SwarmWarmStore too (swarm_warmAttach(), see SwarmWarm.h) and an MCU reset costs one $CS instead of the
+ * whole init.
+ *
+ * A SwarmModem is about 4.5 KB, mostly the TX ring, the parser's line pool and the downlink ring (about 650 bytes
+ * less on the SAT_RX_FROM_MESSAGE path, its pool is smaller). Two fit in the
+ * FR5994's 8 KB of RAM only just, put the second one in FRAM (it's written often, FRAM doesn't mind) or shrink
+ * SWARM_DOWNLINK_SLOTS and SWARM_POOL_FULL_COUNT.
+ */
+typedef struct SwarmModem{
+    const SwarmHal* hal;
+    void* port;                                 // the HAL's: SwarmMsp430Port, SwarmLinuxPort ...
+    unsigned char rxMessagePort;                // MessagePort the UART ISR files this modem's lines under, SAT_RX_FROM_MESSAGE only
+    SatInfo info;
+    SwarmTxRing txRing;                         // everything we send goes through here, drained by the TX ISR / DMA
+    SwarmParser parser;                         // everything we receive goes through here, fed by the RX ISR
+    SwarmCmdEngine cmds;                        // commands waiting on an answer
+    SwarmQueue queue;                           // $TD waiting for room in the modem, kept in queueStore
+    SwarmQueueStore* queueStore;
+    struct SwarmFragSender* frag;               // a blob split over many $TD, set by swarm_fragInit()
+    SwarmScheduler sched;                       // when the modem sleeps, only in charge after swarm_schedStart()
+    SwarmDownlink downlink;                     // $RD / $MM messages for us, decoded and waiting on their handler
+    SwarmEvents events;                         // your per-header handlers, register after swarm_modemInit()
+    SwarmWarm warm;                             // what the last init found, kept in FRAM if you swarm_warmAttach() a store
+    SwarmRates rates;                           // which $GN / $PW / $RT ... the modem streams, only after swarm_ratesStart()
+    SwarmErrors errors;                         // ERR codes and what's done about them, faults and how long they took
+#if SWARM_STATS_ENABLE
+    SwarmStats stats;                           // see SwarmStats.h
+#endif
+    unsigned char initPending;                  // init commands still waiting on a good answer
+}SwarmModem;
+
 
 /* * * * * * * * COMMANDS * * * * * * * * * */
 #define SAT_CMD_DEVICE_ID                              "$CS"
@@ -209,25 +284,75 @@ typedef struct{
 #define SAT_CMD_PARAM_QUERY_UNSENT_MESSAGES            "C=U"
 #define SAT_CMD_PARAM_DELETE_UNSENT_MESSAGES           "D=U"
 #define SAT_CMD_PARAM_DELETE_DB                        "deletedb"
+#define SAT_CMD_PARAM_READ_OLDEST                      "R=O"              // $MM, oldest unread message, marks it read
+#define SAT_CMD_PARAM_MARK_ALL_READ                    "M=*"
+#define SAT_CMD_PARAM_DELETE_READ                      "D=*"              // $MM, every message already read
+
+/* Pre-built commands. These never change so they're encoded once, checksum and all, into SwarmCommandTable.c
+ * (generated, run "make -C linux commands" after changing anything here). swarm_sendCommand() uses the table
+ * whenever the cmd/params pair matches one of these, or call swarm_sendPrebuilt() with the ID directly.
+ */
+#define SAT_PREBUILT_COMMANDS(X) \
+    X(SwarmCmdDeviceId,             SAT_CMD_DEVICE_ID,              SAT_CMD_PARAM_NO_PARAMS) \
+    X(SwarmCmdDateTimeLast,         SAT_CMD_DATE_TIME,              SAT_CMD_PARAM_QUERY_LAST_MESSAGE) \
+    X(SwarmCmdFwVersion,            SAT_CMD_FW_VERSION,             SAT_CMD_PARAM_NO_PARAMS) \
+    X(SwarmCmdGpioWakeLowHigh,      SAT_GPIO_WAKE_LOW_HIGH,         SAT_CMD_PARAM_NO_PARAMS) \
+    X(SwarmCmdGpioWakeHighLow,      SAT_GPIO_WAKE_HIGH_LOW,         SAT_CMD_PARAM_NO_PARAMS) \
+    X(SwarmCmdGpsInfoLast,          SAT_CMD_GPS_INFO,               SAT_CMD_PARAM_QUERY_LAST_MESSAGE) \
+    X(SwarmCmdGpsFixLast,           SAT_CMD_GPS_FIX_QUALITY,        SAT_CMD_PARAM_QUERY_LAST_MESSAGE) \
+    X(SwarmCmdGpsJammingLast,       SAT_CMD_GPS_JAMMING,            SAT_CMD_PARAM_QUERY_LAST_MESSAGE) \
+    X(SwarmCmdPowerStatusLast,      SAT_CMD_POWER_STATUS,           SAT_CMD_PARAM_QUERY_LAST_MESSAGE) \
+    X(SwarmCmdQueryUnsent,          SAT_CMD_MSG_TX_MANAGEMENT,      SAT_CMD_PARAM_QUERY_UNSENT_MESSAGES) \
+    X(SwarmCmdDeleteUnsent,         SAT_CMD_MSG_TX_MANAGEMENT,      SAT_CMD_PARAM_DELETE_UNSENT_MESSAGES) \
+    X(SwarmCmdQueryUnread,          SAT_CMD_MSG_RX_MANAGEMENT,      SAT_CMD_PARAM_QUERY_UNSENT_MESSAGES) \
+    X(SwarmCmdReadOldest,           SAT_CMD_MSG_RX_MANAGEMENT,      SAT_CMD_PARAM_READ_OLDEST) \
+    X(SwarmCmdMarkAllRead,          SAT_CMD_MSG_RX_MANAGEMENT,      SAT_CMD_PARAM_MARK_ALL_READ) \
+    X(SwarmCmdDeleteRead,           SAT_CMD_MSG_RX_MANAGEMENT,      SAT_CMD_PARAM_DELETE_READ) \
+    X(SwarmCmdPowerOff,             SAT_CMD_POWER_OFF,              SAT_CMD_PARAM_NO_PARAMS) \
+    X(SwarmCmdRestart,              SAT_CMD_RESTART_DEVICE,         SAT_CMD_PARAM_NO_PARAMS) \
+    X(SwarmCmdBackgroundRssi,       SAT_CMD_RECEIVE_TEST,           SAT_CMD_PARAM_BACKGROUND_RSSI_RATE) \
+    X(SwarmCmdRssiLast,             SAT_CMD_RECEIVE_TEST,           SAT_CMD_PARAM_QUERY_LAST_MESSAGE) \
+    X(SwarmCmdSleepDefault,         SAT_CMD_SLEEP_MODE,             SAT_DEFAULT_SLEEP_TIME)
+
+#define SAT_PREBUILT_ENUM(id, cmd, params)      id,
+typedef enum{
+    SAT_PREBUILT_COMMANDS(SAT_PREBUILT_ENUM)
+    SwarmCmdCount
+}SwarmCmdId;
+#undef SAT_PREBUILT_ENUM
+
+typedef struct{
+    const char* cmd;                            // what swarm_sendCommand() matches on
+    const char* params;
+    const char* sentence;                       // ready to go, "$CS*10\n"
+    unsigned char length;
+}SwarmPrebuiltCmd;
+
+extern const SwarmPrebuiltCmd swarmCommandTable[SwarmCmdCount];
 
 /* Command Headers for RX Handling */
-#define SAT_HEADER_MODEM_MSG                           'M' <<8 | '1'
-#define SAT_HEADER_SLEEP                               'S' <<8 | 'L'
-#define SAT_HEADER_GPS_INFO                            'G' <<8 | 'N'
-#define SAT_HEADER_GPIO_MSG                            'G' <<8 | 'P'
-#define SAT_HEADER_DEVICE_INFO                         'C' <<8 | 'S'
-#define SAT_HEADER_DATE_TIME                           'D' <<8 | 'T'
-#define SAT_HEADER_TRANSMIT_DATA                       'T' <<8 | 'D'
-#define SAT_HEADER_MESSAGE_MANAGEMENT_TX               'M' <<8 | 'T'
-#define SAT_HEADER_MESSAGE_MANAGEMENT_RX               'M' <<8 | 'M'
-#define SAT_HEADER_RECEIVE_TEST                        'R' <<8 | 'T'
-#define SAT_HEADER_INTERNAL_MESSAGE                    'I' <<8 | 'M'
-#define SAT_HEADER_INTERNAL_INIT_COMMAND               'I' <<8 | 'C'
-#define SAT_HEADER_INTERNAL_GPS_QUERY                  'L' <<8 | 'L'
-#define SAT_HEADER_INTERNAL_QUERY_UNSENT_MESSAGES      'U' <<8 | 'M'
-#define SAT_HEADER_INTERNAL_RSSI                       'S' <<8 | 'S'
-#define SAT_HEADER_INTERNAL_SEND_AGGREGATED_DATA       'S' <<8 | 'D'
-#define SAT_HEADER_INTERNAL_SLEEP                      'S' <<8 | 'L'
+#define SAT_HEADER_MODEM_MSG                           ('M' <<8 | '1')
+#define SAT_HEADER_SLEEP                               ('S' <<8 | 'L')
+#define SAT_HEADER_GPS_INFO                            ('G' <<8 | 'N')
+#define SAT_HEADER_GPS_JAMMING                         ('G' <<8 | 'J')
+#define SAT_HEADER_GPS_STATUS                          ('G' <<8 | 'S')
+#define SAT_HEADER_POWER_STATUS                        ('P' <<8 | 'W')
+#define SAT_HEADER_FW_VERSION                          ('F' <<8 | 'V')
+#define SAT_HEADER_RECEIVE_DATA                        ('R' <<8 | 'D')
+#define SAT_HEADER_GPIO_MSG                            ('G' <<8 | 'P')
+#define SAT_HEADER_DEVICE_INFO                         ('C' <<8 | 'S')
+#define SAT_HEADER_DATE_TIME                           ('D' <<8 | 'T')
+#define SAT_HEADER_TRANSMIT_DATA                       ('T' <<8 | 'D')
+#define SAT_HEADER_MESSAGE_MANAGEMENT_TX               ('M' <<8 | 'T')
+#define SAT_HEADER_MESSAGE_MANAGEMENT_RX               ('M' <<8 | 'M')
+#define SAT_HEADER_RECEIVE_TEST                        ('R' <<8 | 'T')
+#define SAT_HEADER_INTERNAL_MESSAGE                    ('I' <<8 | 'M')
+#define SAT_HEADER_INTERNAL_INIT_COMMAND               ('I' <<8 | 'C')
+#define SAT_HEADER_INTERNAL_GPS_QUERY                  ('L' <<8 | 'L')
+#define SAT_HEADER_INTERNAL_QUERY_UNSENT_MESSAGES      ('U' <<8 | 'M')
+#define SAT_HEADER_INTERNAL_RSSI                       ('S' <<8 | 'S')
+#define SAT_HEADER_INTERNAL_SEND_AGGREGATED_DATA       ('S' <<8 | 'D')
+#define SAT_HEADER_INTERNAL_SLEEP                      ('S' <<8 | 'L')
 
 #define NEWLINE                                         "\n"
 #define SAT_MSG_START_BYTE                              '$'
@@ -235,40 +360,57 @@ typedef struct{
 #define SAT_MSG_APPLICATION_ID                          "AI=7777,"   // this needs a comma after, must be integer
 
 #define SAT_DEFAULT_SLEEP_TIME                          "S=86400"    // 1 day   // sleep time can range from 5s to 31,536,000 ( 8,760 hours, 365 days )
+#define SAT_SLEEP_MIN_s                                 5            // $SL S= limits
+#define SAT_SLEEP_MAX_s                                 31536000UL
 
 #define SAT_NUMBER_MAX_PACKET_BYTES_HEX                 192          // max payload is 192 hex bytes, if using ASCII, one byte will be used per NIBBLE
 #define SAT_NUMBER_MAX_PACKET_BYTES_ASCII               SAT_NUMBER_MAX_PACKET_BYTES_HEX*2  // i.e. instead of 0x35 you will send 0x33 0x35 which is 3 and 5 in ASCII
 
 /* * * * * * * * FUNCTIONS * * * * * * * * * */
 /* Basic */
-void swarm_startup(void);
-void swarm_shutdown(void);
-void swarm_gpio(char pinState);
-void swarm_wake(void);
-void swarm_sleep(void);
+void swarm_modemInit(SwarmModem* modem, const SwarmHal* hal, void* port, SwarmQueueStore* queueStore);
+void swarm_startup(SwarmModem* modem);
+void swarm_shutdown(SwarmModem* modem);
+void swarm_gpio(SwarmModem* modem, char pinState);
+void swarm_wake(SwarmModem* modem);
+void swarm_sleep(SwarmModem* modem);
+SwarmTxTag swarm_sleepFor(SwarmModem* modem, unsigned long seconds);
 
 /* Sending Commands */
-void swarm_sendCommand(char* cmd_define, char* params);
-void swarm_sendInitCommand(void);
-void swarm_sendData(unsigned char* data, int datalen);
+SwarmTxTag swarm_sendCommand(SwarmModem* modem, char* cmd_define, char* params);
+SwarmTxTag swarm_sendPrebuilt(SwarmModem* modem, SwarmCmdId id);
+void swarm_sendInitCommand(SwarmModem* modem);
+void swarm_sendProbe(SwarmModem* modem);                    // warm restart, one $CS against the FRAM record
+void swarm_reinit(SwarmModem* modem);                       // stop trusting the modem and init it again now
+SwarmTxTag swarm_sendData(SwarmModem* modem, const unsigned char* data, unsigned int datalen);
 unsigned char swarm_checksum(const char* sz, size_t len);
+unsigned int swarm_crc16(const unsigned char* data, unsigned int len, unsigned int crc);   // CCITT, start with 0xFFFF
 
 /* Message Handling */
-void swarm_handleMsg(void);
-bool swarm_isErrorMessage(Message* message);
-void swarm_handleError(char* msgPtr);
-void swarm_parseSleepMessage(char* msgPtr);
-void swarm_parseModemMessage(char* msgPtr);
-void swarm_parseRssiMessage(char* msgPtr);
-void swarm_parseDateTimeMessage(char* msgPtr);
-void swarm_parseTransmitDataMessage(char*msgPtr);
-void swarm_parseGpioMessage(char* msgPtr);
-void swarm_parseDeviceIdMessage(char* msgPtr);
-void swarm_parseGpsMessage(char* msgPtr);
-void swarm_parseMessageManagementMessage(char* msgPtr);
+bool swarm_rxByte(SwarmModem* modem, unsigned char byte);   // true = a sentence is ready, wake the main loop
+void swarm_handleMsg(SwarmModem* modem);
+void swarm_handleSentence(SwarmModem* modem, const SwarmSentence* sentence);
+bool swarm_isErrorMessage(const SwarmSentence* sentence);
+void swarm_handleError(SwarmModem* modem, const SwarmSentence* sentence);
+void swarm_parseSleepMessage(SwarmModem* modem, const SwarmSentence* sentence);
+void swarm_parseModemMessage(SwarmModem* modem, const SwarmSentence* sentence);
+void swarm_parseRssiMessage(SwarmModem* modem, const SwarmSentence* sentence);
+void swarm_parseDateTimeMessage(SwarmModem* modem, const SwarmSentence* sentence);
+void swarm_parseTransmitDataMessage(SwarmModem* modem, const SwarmSentence* sentence);
+void swarm_parseGpioMessage(SwarmModem* modem, const SwarmSentence* sentence);
+void swarm_parseGpsJammingMessage(SwarmModem* modem, const SwarmSentence* sentence);
+void swarm_parseGpsStatusMessage(SwarmModem* modem, const SwarmSentence* sentence);
+void swarm_parsePowerMessage(SwarmModem* modem, const SwarmSentence* sentence);
+void swarm_parseFwVersionMessage(SwarmModem* modem, const SwarmSentence* sentence);
+void swarm_parseReceiveDataMessage(SwarmModem* modem, const SwarmSentence* sentence);
+void swarm_parseDeviceIdMessage(SwarmModem* modem, const SwarmSentence* sentence);
+void swarm_parseGpsMessage(SwarmModem* modem, const SwarmSentence* sentence);
+void swarm_parseMessageManagementMessage(SwarmModem* modem, const SwarmSentence* sentence);
 
 /* Outgoing Data */
-void swarm_transmitData(char* applicationID, char* holdTime, char* payload, unsigned int numberOfBytes);
+SwarmTxTag swarm_transmitData(SwarmModem* modem, char* applicationID, char* holdTime, char* payload, unsigned int numberOfBytes);
+SwarmTxTag swarm_transmitPayload(SwarmModem* modem, char* applicationID, char* holdTime, const unsigned char* payload,
+                                 unsigned int numberOfBytes, SwarmPayloadMode mode);
 
 
 
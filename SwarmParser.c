@@ -0,0 +1,311 @@
+/*
+ * SwarmParser.c
+ *
+ *  Created on: Oct 16, 2026
+ *      Author: MicroTechEE
+ */
+
+// STD C
+#include <stdbool.h>
+
+#include <SwarmParser.h>
+
+/* Parser states */
+#define PARSE_IDLE                                      0        // waiting for '$'
+#define PARSE_SKIP                                      1        // throwing away the rest of a line
+#define PARSE_HEADER                                    2        // "$CS" / "$M138" up to the first ' ' or '*'
+#define PARSE_BODY                                      3        // fields
+#define PARSE_CS1                                       4        // first checksum nibble
+#define PARSE_CS2                                       5        // second checksum nibble
+#define PARSE_END                                       6        // waiting on '\n'
+
+/* - - - - - - - - - - - - - HELPERS - - - - - - - - - - - - - - - */
+static signed char parser_hexNibble(unsigned char c)
+{
+    if(c >= '0' && c <= '9')
+        return (signed char)(c - '0');
+    if(c >= 'A' && c <= 'F')
+        return (signed char)(c - 'A' + 10);
+    if(c >= 'a' && c <= 'f')
+        return (signed char)(c - 'a' + 10);
+    return -1;
+}
+
+static SwarmSentence* parser_claim(SwarmParser* parser, unsigned char first)
+{
+    SwarmSentence* s;
+    SwarmPoolBlock block;
+
+    if((unsigned char)(parser->head - parser->tail) >= SWARM_PARSER_SLOTS){
+        parser->stats.dropped++;                        // main loop is behind, lose this line
+        return 0;
+    }
+    block = swarm_poolAlloc(&parser->pool, 1);          // most lines never need more than a Short one
+    if(block == SWARM_POOL_NONE){
+        parser->stats.dropped++;
+        return 0;
+    }
+    s = &parser->slot[parser->head % SWARM_PARSER_SLOTS];
+    s->block = block;
+    s->line = swarm_poolLine(&parser->pool, block);
+    s->line[0] = (char)first;                           // '$' or '.', every block has room for it
+    parser->len = 1;
+    parser->workLen = swarm_poolLen(block);
+    s->header = 0;
+    s->status = SwarmSentenceOk;
+    s->isError = false;
+    s->fieldCount = 0;
+    return s;
+}
+
+static void parser_publish(SwarmParser* parser, unsigned char status)
+{
+    SwarmSentence* s = parser->work;
+
+    s->status = status;
+    s->checksum = parser->cs;
+    s->length = parser->len;
+    s->line[parser->len] = 0;
+    s->isError = s->fieldCount && s->fieldLen[0] == 3 && s->line[s->fieldStart[0]] == 'E' &&
+                 s->line[s->fieldStart[0] + 1] == 'R' && s->line[s->fieldStart[0] + 2] == 'R';
+
+    parser->stats.sentences++;
+    if(status == SwarmSentenceBadChecksum)
+        parser->stats.badChecksum++;
+    else if(status == SwarmSentenceNoChecksum)
+        parser->stats.noChecksum++;
+    else if(status == SwarmSentenceNoise)
+        parser->stats.noise++;
+
+    parser->head++;                                     // publish last, the main loop can have it now
+    parser->work = 0;
+    parser->state = PARSE_IDLE;
+}
+
+static void parser_openField(SwarmParser* parser)
+{
+    SwarmSentence* s = parser->work;
+
+    if(s->fieldCount < SWARM_PARSER_MAX_FIELDS){
+        s->fieldStart[s->fieldCount] = parser->len;
+        s->fieldLen[s->fieldCount] = 0;
+        s->fieldCount++;
+    }
+}
+
+static void parser_closeField(SwarmParser* parser)
+{
+    SwarmSentence* s = parser->work;
+
+    if(s->fieldCount)                                   // the last field swallows any extras
+        s->fieldLen[s->fieldCount - 1] = parser->len - s->fieldStart[s->fieldCount - 1];
+}
+
+static void parser_abandon(SwarmParser* parser)
+{
+    if(parser->work)
+        swarm_poolFreeRx(&parser->pool, parser->work->block);
+    parser->work = 0;
+    parser->state = PARSE_SKIP;
+}
+
+static bool parser_grow(SwarmParser* parser)
+{
+    // the line outgrew its block, on to the next size up
+    SwarmSentence* s = parser->work;
+    char* line;
+
+    if(parser->len >= SWARM_PARSER_LINE_MAX)
+        parser->stats.overflow++;
+    else if((line = swarm_poolGrow(&parser->pool, &s->block, parser->len)) != 0){
+        s->line = line;
+        parser->workLen = swarm_poolLen(s->block);
+        return true;
+    }
+    else
+        parser->stats.dropped++;                        // every bigger block is waiting on the main loop
+    parser_abandon(parser);
+    return false;
+}
+
+static bool parser_append(SwarmParser* parser, unsigned char byte)
+{
+    if(parser->len >= parser->workLen && !parser_grow(parser))
+        return false;
+    parser->work->line[parser->len++] = (char)byte;
+    return true;
+}
+
+/* - - - - - - - - - - - - - FUNCTIONS - - - - - - - - - - - - - - - */
+void swarm_parserInit(SwarmParser* parser)
+{
+    parser->head = 0;
+    parser->tail = 0;
+    parser->work = 0;
+    parser->workLen = 0;
+    parser->state = PARSE_IDLE;
+    parser->cs = 0;
+    parser->rxCs = 0;
+    parser->len = 0;
+    parser->stats.sentences = 0;
+    parser->stats.badChecksum = 0;
+    parser->stats.noChecksum = 0;
+    parser->stats.overflow = 0;
+    parser->stats.dropped = 0;
+    parser->stats.noise = 0;
+    swarm_poolInit(&parser->pool);
+}
+
+/* - - - - RX ISR - - - - */
+void swarm_parserFeed(SwarmParser* parser, unsigned char byte)
+{
+    signed char nibble;
+
+    if(byte == '$'){                                    // always a fresh start, even mid-line (lost '\n' on an overrun)
+        if(parser->state != PARSE_IDLE && parser->state != PARSE_SKIP)
+            parser->stats.dropped++;
+        if(parser->work)
+            swarm_poolFreeRx(&parser->pool, parser->work->block);
+        parser->work = parser_claim(parser, byte);
+        parser->state = parser->work ? PARSE_HEADER : PARSE_SKIP;
+        parser->cs = 0;                                 // '$' isn't part of the checksum
+        return;
+    }
+
+    switch(parser->state){
+    case PARSE_IDLE:
+        if(byte == '.'){                                // When swarm boots it sends a bunch of junk, the .'s are easy to catch
+            parser->work = parser_claim(parser, byte);
+            if(parser->work)
+                parser_publish(parser, SwarmSentenceNoise);
+            parser->state = PARSE_SKIP;
+        }
+        else if(byte != '\r' && byte != '\n')
+            parser->state = PARSE_SKIP;
+        break;
+
+    case PARSE_SKIP:
+        if(byte == '\n')
+            parser->state = PARSE_IDLE;
+        break;
+
+    case PARSE_HEADER:
+    case PARSE_BODY:
+        if(byte == '*'){
+            parser_closeField(parser);
+            parser->state = PARSE_CS1;
+        }
+        else if(byte == '\n' || byte == '\r'){
+            parser_closeField(parser);
+            parser_publish(parser, SwarmSentenceNoChecksum);
+            if(byte == '\r')
+                parser->state = PARSE_SKIP;             // eat the '\n'
+        }
+        else{
+            parser->cs ^= byte;
+            if(!parser_append(parser, byte))
+                break;
+            if(parser->state == PARSE_HEADER){
+                if(parser->len == 3)
+                    parser->work->header = (unsigned int)parser->work->line[1] << 8 | (unsigned char)parser->work->line[2];
+                if(byte == ' ' || byte == ','){
+                    parser->state = PARSE_BODY;
+                    parser_openField(parser);
+                }
+            }
+            else if(byte == ','){
+                parser->len--;                          // field ends before the comma
+                parser_closeField(parser);
+                parser->len++;
+                parser_openField(parser);
+            }
+        }
+        break;
+
+    case PARSE_CS1:
+    case PARSE_CS2:
+        nibble = parser_hexNibble(byte);
+        if(nibble < 0){
+            parser_publish(parser, SwarmSentenceNoChecksum);
+            parser->state = byte == '\n' ? PARSE_IDLE : PARSE_SKIP;
+            break;
+        }
+        if(parser->state == PARSE_CS1){
+            parser->rxCs = (unsigned char)(nibble << 4);
+            parser->state = PARSE_CS2;
+        }
+        else{
+            parser->rxCs |= (unsigned char)nibble;
+            parser->state = PARSE_END;
+        }
+        break;
+
+    case PARSE_END:
+        if(byte == '\r')
+            break;
+        parser_publish(parser, parser->cs == parser->rxCs ? SwarmSentenceOk : SwarmSentenceBadChecksum);
+        if(byte != '\n')
+            parser->state = PARSE_SKIP;
+        break;
+
+    default:
+        parser->state = PARSE_IDLE;
+        break;
+    }
+}
+
+/* - - - - MAIN LOOP - - - - */
+const SwarmSentence* swarm_parserGet(SwarmParser* parser)
+{
+    if(parser->tail == parser->head)
+        return 0;
+    return &parser->slot[parser->tail % SWARM_PARSER_SLOTS];
+}
+
+void swarm_parserRelease(SwarmParser* parser)
+{
+    if(parser->tail != parser->head){
+        swarm_poolFree(&parser->pool, parser->slot[parser->tail % SWARM_PARSER_SLOTS].block);
+        parser->tail++;                                 // hands the slot back to the ISR
+    }
+}
+
+/* - - - - FIELDS - - - - */
+const char* swarm_sentenceField(const SwarmSentence* sentence, unsigned char field, unsigned int* len)
+{
+    if(field >= sentence->fieldCount){
+        *len = 0;
+        return &sentence->line[sentence->length];       // empty string, never a null pointer
+    }
+    *len = sentence->fieldLen[field];
+    return &sentence->line[sentence->fieldStart[field]];
+}
+
+const char* swarm_sentenceValue(const SwarmSentence* sentence, unsigned char field, unsigned int* len)
+{
+    const char* text;
+    unsigned int i;
+
+    text = swarm_sentenceField(sentence, field, len);
+    for(i = 0; i < *len; i++){
+        if(text[i] == '='){
+            *len -= i + 1;
+            return text + i + 1;
+        }
+    }
+    return text;                                        // no KEY=, the whole field is the value
+}
+
+bool swarm_sentenceFieldIs(const SwarmSentence* sentence, unsigned char field, const char* text)
+{
+    const char* f;
+    unsigned int len;
+    unsigned int i;
+
+    f = swarm_sentenceField(sentence, field, &len);
+    for(i = 0; i < len; i++){
+        if(text[i] != f[i])
+            return false;
+    }
+    return text[len] == 0;
+}
@@ -0,0 +1,90 @@
+/*
+ * SwarmParser.h
+ *
+ *  Created on: Oct 16, 2026
+ *      Author: MicroTechEE
+ */
+
+#ifndef SWARMPARSER_H_
+#define SWARMPARSER_H_
+
+#include <stdbool.h>
+#include <SwarmPool.h>
+
+/* Byte at a time M138 sentence parser. Feed it straight from the UART RX ISR, it does a fixed amount of work
+ * per byte: tracks the '$', the two byte header, where every comma separated field starts and a running XOR,
+ * so the *xx checksum is checked the moment the line ends. Nothing ever rescans the line.
+ *
+ *      $RT RSSI=-102,SNR=5,FDEV=-1250,TS=2026-10-16 12:00:00,DI=0x000ab5*4F
+ *       ^^ header    ^field 0        ^field 1 ...
+ *
+ * Finished sentences go into a small ring of slots: the ISR only ever touches head, the main loop only tail,
+ * so there's no locking. If the main loop falls behind and every slot is full, new lines are dropped and
+ * counted rather than overwriting one that's being parsed. The text of each line is in a SwarmPool block its
+ * size, the slot only has where the fields are, and swarm_parserRelease() gives the block back.
+ */
+
+#define SWARM_PARSER_LINE_MAX                           SWARM_POOL_FULL_LEN
+#define SWARM_PARSER_MAX_FIELDS                         12       // extra commas are folded into the last field
+#define SWARM_PARSER_SLOTS                              4        // finished sentences waiting for the main loop, MUST be a power of 2
+
+/* * * * * * * * STRUCTS * * * * * * * * * */
+typedef enum{
+    SwarmSentenceOk = 0,
+    SwarmSentenceBadChecksum,                   // *xx didn't match, the line is untrusted
+    SwarmSentenceNoChecksum,                    // line ended before the *xx
+    SwarmSentenceNoise                          // boot noise, a line starting with '.'
+}SwarmSentenceStatus;
+
+typedef struct{
+    unsigned int header;                        // same as SAT_HEADER_*, i.e. 'C' << 8 | 'S'
+    unsigned char status;                       // SwarmSentenceStatus
+    bool isError;                               // field 0 is "ERR"
+    unsigned char fieldCount;
+    unsigned char checksum;                     // what we calculated
+    unsigned int length;                        // '$' up to but not including the '*', line[length] is 0
+    unsigned int fieldStart[SWARM_PARSER_MAX_FIELDS];   // offsets into line
+    unsigned int fieldLen[SWARM_PARSER_MAX_FIELDS];
+    char* line;                                 // in the parser's pool until swarm_parserRelease()
+    SwarmPoolBlock block;
+}SwarmSentence;
+
+typedef struct{
+    unsigned long sentences;                    // published, good or bad
+    unsigned long badChecksum;
+    unsigned long noChecksum;
+    unsigned long overflow;                     // longer than SWARM_PARSER_LINE_MAX
+    unsigned long dropped;                      // no free slot or pool block, or cut short by a new '$'
+    unsigned long noise;
+}SwarmParserStats;
+
+typedef struct{
+    SwarmSentence slot[SWARM_PARSER_SLOTS];
+    volatile unsigned char head;                // written by the ISR
+    volatile unsigned char tail;                // written by the main loop
+    SwarmSentence* work;                        // slot being filled, 0 while skipping a line
+    unsigned int workLen;                       // chars work->line has room for
+    unsigned char state;
+    unsigned char cs;                           // running XOR
+    unsigned char rxCs;                         // the *xx we received
+    unsigned int len;
+    SwarmParserStats stats;
+    SwarmPool pool;                             // the line text, see SwarmPool.h
+}SwarmParser;
+
+/* * * * * * * * FUNCTIONS * * * * * * * * * */
+void swarm_parserInit(SwarmParser* parser);
+
+/* RX ISR */
+void swarm_parserFeed(SwarmParser* parser, unsigned char byte);
+
+/* Main loop */
+const SwarmSentence* swarm_parserGet(SwarmParser* parser);
+void swarm_parserRelease(SwarmParser* parser);
+
+/* Field access, no scanning */
+const char* swarm_sentenceField(const SwarmSentence* sentence, unsigned char field, unsigned int* len);
+const char* swarm_sentenceValue(const SwarmSentence* sentence, unsigned char field, unsigned int* len);   // text after "KEY="
+bool swarm_sentenceFieldIs(const SwarmSentence* sentence, unsigned char field, const char* text);
+
+#endif /* SWARMPARSER_H_ */
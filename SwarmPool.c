@@ -0,0 +1,151 @@
+/*
+ * SwarmPool.c
+ *
+ *  Created on: Oct 16, 2026
+ *      Author: MicroTechEE
+ */
+
+// STD C
+#include <stdbool.h>
+#include "string.h"
+
+#include <SwarmPool.h>
+
+#define POOL_MASK                                       (SWARM_POOL_RING - 1)
+
+static const unsigned int poolLen[SwarmPoolClassCount] = {SWARM_POOL_SHORT_LEN, SWARM_POOL_MID_LEN, SWARM_POOL_FULL_LEN};
+static const unsigned char poolCount[SwarmPoolClassCount] = {SWARM_POOL_SHORT_COUNT, SWARM_POOL_MID_COUNT,
+                                                              SWARM_POOL_FULL_COUNT};
+
+/* - - - - - - - - - - - - - HELPERS - - - - - - - - - - - - - - - */
+static unsigned char pool_freeCount(const SwarmPool* pool, SwarmPoolClass cls)
+{
+    const SwarmPoolFree* f = &pool->free[cls];
+
+    return (unsigned char)(f->head - f->tail) + (f->spare != SWARM_POOL_NONE);
+}
+
+static SwarmPoolBlock pool_take(SwarmPool* pool, SwarmPoolClass cls)
+{
+    SwarmPoolFree* f = &pool->free[cls];
+    SwarmPoolStats* stats = &pool->stats[cls];
+    SwarmPoolBlock block;
+    unsigned char inUse;
+
+    if(f->spare != SWARM_POOL_NONE){
+        block = f->spare;
+        f->spare = SWARM_POOL_NONE;
+    }
+    else if(f->head != f->tail){
+        block = (SwarmPoolBlock)(cls << 4 | f->ring[f->tail & POOL_MASK]);
+        f->tail++;                                      // the main loop can put one back in that spot now
+    }
+    else
+        return SWARM_POOL_NONE;
+
+    stats->allocs++;
+    inUse = poolCount[cls] - pool_freeCount(pool, cls);
+    if(inUse > stats->highWater)
+        stats->highWater = inUse;
+    return block;
+}
+
+/* - - - - - - - - - - - - - FUNCTIONS - - - - - - - - - - - - - - - */
+void swarm_poolInit(SwarmPool* pool)
+{
+    SwarmPoolFree* f;
+    unsigned char cls;
+    unsigned char i;
+
+    for(cls = 0; cls < SwarmPoolClassCount; cls++){
+        f = &pool->free[cls];
+        for(i = 0; i < poolCount[cls]; i++)
+            f->ring[i] = i;
+        f->head = poolCount[cls];
+        f->tail = 0;
+        f->spare = SWARM_POOL_NONE;
+        pool->stats[cls].allocs = 0;
+        pool->stats[cls].bigger = 0;
+        pool->stats[cls].empty = 0;
+        pool->stats[cls].highWater = 0;
+    }
+}
+
+/* - - - - RX ISR - - - - */
+SwarmPoolBlock swarm_poolAlloc(SwarmPool* pool, unsigned int len)
+{
+    SwarmPoolBlock block;
+    unsigned char want;
+    unsigned char cls;
+
+    for(want = 0; want < SwarmPoolClassCount && poolLen[want] < len; want++)
+        ;
+    if(want == SwarmPoolClassCount)
+        return SWARM_POOL_NONE;                         // longer than any block, not the pool's problem
+    for(cls = want; cls < SwarmPoolClassCount; cls++){
+        block = pool_take(pool, (SwarmPoolClass)cls);
+        if(block != SWARM_POOL_NONE){
+            if(cls != want)
+                pool->stats[want].bigger++;
+            return block;
+        }
+    }
+    pool->stats[want].empty++;
+    return SWARM_POOL_NONE;
+}
+
+void swarm_poolFreeRx(SwarmPool* pool, SwarmPoolBlock block)
+{
+    // the RX side only ever holds the one line it's filling, so its spare for that size is always empty here
+    if(block != SWARM_POOL_NONE)
+        pool->free[block >> 4].spare = block;
+}
+
+char* swarm_poolGrow(SwarmPool* pool, SwarmPoolBlock* block, unsigned int len)
+{
+    // len chars move to the smallest block that has room for one more, never more than a Mid block's worth
+    SwarmPoolBlock bigger;
+    char* line;
+
+    bigger = swarm_poolAlloc(pool, len + 1);
+    if(bigger == SWARM_POOL_NONE)
+        return 0;
+    line = swarm_poolLine(pool, bigger);
+    memcpy(line, swarm_poolLine(pool, *block), len);
+    swarm_poolFreeRx(pool, *block);
+    *block = bigger;
+    return line;
+}
+
+/* - - - - MAIN LOOP - - - - */
+void swarm_poolFree(SwarmPool* pool, SwarmPoolBlock block)
+{
+    SwarmPoolFree* f;
+
+    if(block == SWARM_POOL_NONE)
+        return;
+    f = &pool->free[block >> 4];
+    f->ring[f->head & POOL_MASK] = block & 0x0F;
+    f->head++;                                          // publish last, the RX side can have it now
+}
+
+unsigned int swarm_poolInUse(const SwarmPool* pool, SwarmPoolClass cls)
+{
+    return poolCount[cls] - pool_freeCount(pool, cls);
+}
+
+/* - - - - EITHER - - - - */
+char* swarm_poolLine(SwarmPool* pool, SwarmPoolBlock block)
+{
+    switch(block >> 4){
+    case SwarmPoolShort:    return pool->shortLine[block & 0x0F];
+    case SwarmPoolMid:      return pool->midLine[block & 0x0F];
+    case SwarmPoolFull:     return pool->fullLine[block & 0x0F];
+    default:                return 0;
+    }
+}
+
+unsigned int swarm_poolLen(SwarmPoolBlock block)
+{
+    return (block >> 4) < SwarmPoolClassCount ? poolLen[block >> 4] : 0;
+}
@@ -0,0 +1,102 @@
+/*
+ * SwarmPool.h
+ *
+ *  Created on: Oct 16, 2026
+ *      Author: MicroTechEE
+ */
+
+#ifndef SWARMPOOL_H_
+#define SWARMPOOL_H_
+
+#include <stdbool.h>
+
+/* Line buffers for the parser in three sizes that match what the M138 actually sends, so a 20 byte "$SL OK*3b"
+ * doesn't sit in a 440 byte buffer while a $RD burst is looking for one:
+ *
+ *      Short   "$TD OK,5354468402891"  "$SL OK"  "$M138 BOOT,RUNNING"  "$TD ERR,DBXTOHIVEFULL"  "$DT 20261016120000,V"
+ *      Mid     "$RT RSSI=-102,SNR=5,FDEV=-1250,TS=2026-10-16 12:00:00,DI=0x000ab5"  "$TD SENT ..."  "$PW ..."
+ *      Full    $RD / $MM R= with up to 192 bytes of hex
+ *
+ * A line starts in a Short block and moves up a size when it outgrows it, so nothing is copied for the lines that
+ * are most of the traffic and at most SWARM_POOL_MID_LEN bytes for the rest. If its size is all used up it takes
+ * the next one up.
+ *
+ * Each size keeps its free blocks in a ring. Only the main loop puts blocks back (head), only the RX side takes them
+ * (tail), both single byte writes, so like SwarmTx and the parser slots nothing disables interrupts. The RX side
+ * keeps the one block it gives back itself (a line that moved up, or was dropped) as its own spare instead of
+ * writing head. Alloc and free are O(1), three sizes at most are looked at.
+ *
+ * RAM on the MSP430 is SWARM_POOL_*_COUNT * (SWARM_POOL_*_LEN + 1), about 1.3 KB with these. Two SwarmModems on
+ * the FR5994 with its 8 KB of RAM will need less: one Full block only holds back a $RD that comes while the last one
+ * is still being handled. stats[].highWater tells you what each size really needed.
+ *
+ * That's for the ISR path (SAT_RX_FROM_MESSAGE 0). With the MSP430 default of 1 the Message system has the lines
+ * already and swarm_handleMsg() parses and handles them one at a time, so the pool never holds more than one and
+ * gets one block a size (a second Short in case a Message has two lines), about 600 bytes. Set SAT_RX_FROM_MESSAGE
+ * on the command line so it's seen here too.
+ */
+
+#define SWARM_POOL_SHORT_LEN                            40       // chars, the '\0' is extra
+#define SWARM_POOL_MID_LEN                              112      // $RT with TS= and DI= is 66, a $RD with 36 bytes fits
+#define SWARM_POOL_FULL_LEN                             440      // 384 hex chars: $RD with the longest RSSI= SNR= FDEV= is 427 up to the *, $MM R=O 429
+#if defined(SAT_RX_FROM_MESSAGE) && !SAT_RX_FROM_MESSAGE
+#define SWARM_POOL_SHORT_COUNT                          5
+#define SWARM_POOL_MID_COUNT                            2
+#define SWARM_POOL_FULL_COUNT                           2
+#else
+#define SWARM_POOL_SHORT_COUNT                          2
+#define SWARM_POOL_MID_COUNT                            1
+#define SWARM_POOL_FULL_COUNT                           1
+#endif
+#define SWARM_POOL_RING                                 8        // MUST be a power of 2, at least the biggest count
+#define SWARM_POOL_NONE                                 0xFF
+
+/* * * * * * * * STRUCTS * * * * * * * * * */
+typedef enum{
+    SwarmPoolShort = 0,
+    SwarmPoolMid,
+    SwarmPoolFull,
+    SwarmPoolClassCount
+}SwarmPoolClass;
+
+typedef unsigned char SwarmPoolBlock;                            // class << 4 | index, SWARM_POOL_NONE = no block
+
+typedef struct{
+    unsigned long allocs;
+    unsigned long bigger;                       // this size was all used up, got the next one up
+    unsigned long empty;                        // nothing this size or bigger left, the line was lost
+    unsigned char highWater;                    // most blocks in use at once
+}SwarmPoolStats;
+
+typedef struct{
+    unsigned char ring[SWARM_POOL_RING];        // free block indexes
+    volatile unsigned char head;                // free running, written by the main loop
+    volatile unsigned char tail;                // free running, written by the RX side
+    SwarmPoolBlock spare;                       // RX side's own free block, SWARM_POOL_NONE if none
+}SwarmPoolFree;
+
+typedef struct{
+    SwarmPoolFree free[SwarmPoolClassCount];
+    SwarmPoolStats stats[SwarmPoolClassCount];  // written by the RX side only
+    char shortLine[SWARM_POOL_SHORT_COUNT][SWARM_POOL_SHORT_LEN + 1];
+    char midLine[SWARM_POOL_MID_COUNT][SWARM_POOL_MID_LEN + 1];
+    char fullLine[SWARM_POOL_FULL_COUNT][SWARM_POOL_FULL_LEN + 1];
+}SwarmPool;
+
+/* * * * * * * * FUNCTIONS * * * * * * * * * */
+void swarm_poolInit(SwarmPool* pool);           // every block free, stats cleared
+
+/* RX ISR, or whoever calls swarm_parserFeed() */
+SwarmPoolBlock swarm_poolAlloc(SwarmPool* pool, unsigned int len);   // smallest free block with room for len chars
+void swarm_poolFreeRx(SwarmPool* pool, SwarmPoolBlock block);
+char* swarm_poolGrow(SwarmPool* pool, SwarmPoolBlock* block, unsigned int len);   // 0 = nothing bigger, block kept
+
+/* Main loop */
+void swarm_poolFree(SwarmPool* pool, SwarmPoolBlock block);
+unsigned int swarm_poolInUse(const SwarmPool* pool, SwarmPoolClass cls);
+
+/* Either */
+char* swarm_poolLine(SwarmPool* pool, SwarmPoolBlock block);
+unsigned int swarm_poolLen(SwarmPoolBlock block);  // chars it holds, not counting the '\0'
+
+#endif /* SWARMPOOL_H_ */
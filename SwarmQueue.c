@@ -0,0 +1,472 @@
+/*
+ * SwarmQueue.c
+ *
+ *  Created on: Oct 16, 2026
+ *      Author: MicroTechEE
+ */
+
+// STD C
+#include <stdbool.h>
+#include "string.h"
+
+#include <Message.h>
+#include <SwarmMSP430.h>
+#include <SwarmQueue.h>
+
+/* - - - - - - - - - - - - - GLOBALS - - - - - - - - - - - - - - - */
+static const unsigned int queueSlots[SwarmQueueClassCount] = {
+    SWARM_QUEUE_URGENT_SLOTS, SWARM_QUEUE_NORMAL_SLOTS, SWARM_QUEUE_BULK_SLOTS
+};
+static const unsigned int queueBase[SwarmQueueClassCount] = {
+    0, SWARM_QUEUE_URGENT_SLOTS, SWARM_QUEUE_URGENT_SLOTS + SWARM_QUEUE_NORMAL_SLOTS
+};
+
+/* - - - - - - - - - - - - - HELPERS - - - - - - - - - - - - - - - */
+static unsigned int queue_slotCrc(const SwarmQueueSlot* slot)
+{
+    unsigned int crc = swarm_crc16(&slot->len, 1, 0xFFFF);
+
+    crc = swarm_crc16(&slot->key, 1, crc);
+    crc = swarm_crc16((const unsigned char*)&slot->expires, sizeof(slot->expires), crc);
+    return swarm_crc16(slot->data, slot->len, crc);
+}
+
+static SwarmQueueSlot* queue_slot(SwarmQueueStore* store, unsigned int cls, unsigned int index)
+{
+    // ring sizes are powers of 2, so the free running index wraps onto the same slot
+    return &store->slot[queueBase[cls] + index % queueSlots[cls]];
+}
+
+static unsigned int queue_ringDepth(const SwarmQueueStore* store, unsigned int cls)
+{
+    return store->ring[cls].head - store->ring[cls].tail;
+}
+
+static void queue_commitTail(SwarmQueue* queue, unsigned int cls)
+{
+    SWARM_FRAM_WRITE_BEGIN();
+    queue->store->ring[cls].tail++;             // one 16 bit write, this is the commit
+    SWARM_FRAM_WRITE_END();
+    if(cls == queue->inFlightClass)
+        queue->retryTries = 0;
+}
+
+static void queue_backoff(SwarmQueue* queue)
+{
+    queue->backoffAt = queue->modem->hal->millis();
+    queue->backoffMs = swarm_errorBackoffMs(&queue->modem->errors, queue->backoffTries);
+    if(queue->backoffTries < 255)
+        queue->backoffTries++;
+    queue->stats.backoffs++;
+}
+
+static void queue_skipDead(SwarmQueue* queue, unsigned int cls, unsigned long epoch)
+{
+    // coalesced ones at the tail (their newer value is further up) and ones nobody wants anymore, whether or not
+    // the modem has room, so they don't hold slots a push needs. Never the one in flight
+    SwarmQueueStore* store = queue->store;
+    SwarmQueueSlot* slot;
+
+    if(queue->inFlight && queue->inFlightClass == cls)
+        return;
+    while(queue_ringDepth(store, cls)){
+        slot = queue_slot(store, cls, store->ring[cls].tail);
+        if(!slot->retired){
+            if(!slot->expires || !epoch || epoch + SWARM_QUEUE_HOLD_MIN_s <= slot->expires)
+                return;
+            queue->stats.expired++;             // don't pay for it
+        }
+        queue_commitTail(queue, cls);
+    }
+}
+
+static unsigned long queue_epoch(const Calendar* dateTime)
+{
+    // days since 1970 from the civil date, March based so the leap day is the last day of the year
+    unsigned long month = dateTime->Month + 1;  // RTC Month is 0-starting
+    unsigned long year = dateTime->Year - (month <= 2);
+    unsigned long era = year / 400;
+    unsigned long yearOfEra = year - era * 400;
+    unsigned long dayOfYear = (153 * ((month + 9) % 12) + 2) / 5 + dateTime->DayOfMonth - 1;
+    unsigned long days = era * 146097 + yearOfEra * 365 + yearOfEra / 4 - yearOfEra / 100 + dayOfYear - 719468;
+
+    if(dateTime->Year < 1970 || month > 12 || dateTime->DayOfMonth == 0)
+        return 0;
+    return days * 86400 + dateTime->Hours * 3600UL + dateTime->Minutes * 60UL + dateTime->Seconds;
+}
+
+static unsigned long queue_now(const SwarmQueue* queue, unsigned long now)
+{
+    if(queue->epoch == 0)
+        return 0;
+    return queue->epoch + (now - queue->epochAt) / 1000;
+}
+
+static unsigned int queue_holdParam(char* param, unsigned long expires, unsigned long holdS)
+{
+    // ET=<epoch>, when we know the time, otherwise HD=<seconds> counted from when the modem gets it
+    char digits[10];
+    unsigned long value = expires ? expires : holdS;
+    unsigned int n = 0;
+    unsigned int len = 3;
+
+    param[0] = expires ? 'E' : 'H';
+    param[1] = expires ? 'T' : 'D';
+    param[2] = '=';
+    if(!expires && value < SWARM_QUEUE_HOLD_MIN_s)
+        value = SWARM_QUEUE_HOLD_MIN_s;
+    do{
+        digits[n++] = '0' + value % 10;
+        value /= 10;
+    }while(value && n < sizeof(digits));
+    while(n)
+        param[len++] = digits[--n];
+    param[len++] = ',';                         // same as SAT_MSG_HOLD_TIME_1DAY, the payload follows
+    param[len] = '\0';
+    return len;
+}
+
+/* - - - - - - - - - - - - - FUNCTIONS - - - - - - - - - - - - - - - */
+void swarm_queueInit(SwarmQueue* queue, struct SwarmModem* modem, SwarmQueueStore* store)
+{
+    unsigned int cls;
+    bool trusted = store->magic == SWARM_QUEUE_MAGIC;
+
+    memset(queue, 0, sizeof(*queue));
+    queue->modem = modem;
+    queue->store = store;
+    queue->cls[SwarmQueueUrgent].holdS = SWARM_QUEUE_URGENT_HOLD_s;
+    queue->cls[SwarmQueueUrgent].modemMax = SWARM_QUEUE_MODEM_MAX;
+    queue->cls[SwarmQueueNormal].holdS = SWARM_QUEUE_NORMAL_HOLD_s;
+    queue->cls[SwarmQueueNormal].modemMax = SWARM_QUEUE_MODEM_MAX;
+    queue->cls[SwarmQueueBulk].holdS = SWARM_QUEUE_BULK_HOLD_s;
+    queue->cls[SwarmQueueBulk].modemMax = SWARM_QUEUE_BULK_MODEM_MAX;
+
+    for(cls = 0; cls < SwarmQueueClassCount; cls++){
+        if(queue_ringDepth(store, cls) > queueSlots[cls])
+            trusted = false;
+    }
+    SWARM_FRAM_WRITE_BEGIN();
+    if(!trusted){
+        for(cls = 0; cls < SwarmQueueClassCount; cls++){
+            store->ring[cls].head = 0;          // first boot, or a different layout, nothing in there we can trust
+            store->ring[cls].tail = 0;
+        }
+        store->magic = SWARM_QUEUE_MAGIC;
+    }
+    SWARM_FRAM_WRITE_END();
+}
+
+unsigned int swarm_queueDepth(const SwarmQueue* queue)
+{
+    unsigned int depth = 0;
+    unsigned int cls;
+
+    for(cls = 0; cls < SwarmQueueClassCount; cls++)
+        depth += queue_ringDepth(queue->store, cls);
+    return depth;
+}
+
+unsigned int swarm_queueRoom(const SwarmQueue* queue, SwarmQueueClass cls)
+{
+    if((unsigned int)cls >= SwarmQueueClassCount)
+        return 0;
+    return queueSlots[cls] - queue_ringDepth(queue->store, cls);
+}
+
+const unsigned char* swarm_queueInFlight(const SwarmQueue* queue, unsigned int* len)
+{
+    const SwarmQueueSlot* slot;
+
+    if(!queue->inFlight)
+        return 0;
+    slot = queue_slot(queue->store, queue->inFlightClass, queue->store->ring[queue->inFlightClass].tail);
+    *len = slot->len;
+    return slot->data;
+}
+
+bool swarm_queueReplyIsOurs(const SwarmQueue* queue)
+{
+    return queue->inFlight && queue->tdAnswered == queue->inFlightTd;
+}
+
+bool swarm_queuePush(SwarmQueue* queue, const unsigned char* data, unsigned int len)
+{
+    return swarm_queuePushClass(queue, SwarmQueueNormal, 0, data, len);
+}
+
+bool swarm_queuePushClass(SwarmQueue* queue, SwarmQueueClass cls, unsigned char key, const unsigned char* data,
+                          unsigned int len)
+{
+    SwarmQueueStore* store = queue->store;
+    SwarmQueueRing* ring;
+    SwarmQueueSlot* slot = 0;
+    SwarmQueueSlot* old = 0;
+    unsigned long epoch;
+    unsigned int first;
+    unsigned int i;
+
+    if((unsigned int)cls >= SwarmQueueClassCount || len == 0 || len > SWARM_QUEUE_DATA_MAX){
+        queue->stats.dropped++;
+        return false;
+    }
+    ring = &store->ring[cls];
+
+    epoch = queue_now(queue, queue->modem->hal->millis());
+    queue_skipDead(queue, cls, epoch);
+    first = ring->tail + (queue->inFlight && queue->inFlightClass == cls);
+    if(queue_ringDepth(store, cls) >= queueSlots[cls]){
+        // full, but a retired slot behind a held tail is a free place in line, the push goes there instead
+        for(i = first; i != ring->head && slot == 0; i++){
+            if(queue_slot(store, cls, i)->retired)
+                slot = queue_slot(store, cls, i);
+        }
+        if(slot == 0){
+            queue->stats.dropped++;
+            return false;
+        }
+    }
+    if(key){
+        // latest value wins: an older one with this key that hasn't gone to the modem yet is retired below
+        for(i = first; i != ring->head && old == 0; i++){
+            if(queue_slot(store, cls, i)->key == key && !queue_slot(store, cls, i)->retired)
+                old = queue_slot(store, cls, i);
+        }
+    }
+
+    // fill the slot first, a reset in here just loses this one push: head still points at it, or the retired one
+    // being reused still says retired until it's done
+    SWARM_FRAM_WRITE_BEGIN();
+    if(slot == 0){
+        slot = queue_slot(store, cls, ring->head);
+        slot->retired = 0;
+    }
+    slot->len = (unsigned char)len;
+    slot->key = key;
+    slot->expires = epoch ? epoch + queue->cls[cls].holdS : 0;
+    memcpy(slot->data, data, len);
+    slot->crc = queue_slotCrc(slot);
+    if(slot->retired)
+        slot->retired = 0;                      // commit, one byte
+    else
+        ring->head++;                           // commit
+    if(old)
+        old->retired = 1;                       // one byte, a reset before it and the old value just goes too
+    SWARM_FRAM_WRITE_END();
+
+    if(old)
+        queue->stats.coalesced++;
+    else
+        queue->stats.pushed++;
+    if(swarm_queueDepth(queue) > queue->stats.highWater)
+        queue->stats.highWater = swarm_queueDepth(queue);
+    return true;
+}
+
+bool swarm_queueTakeBack(SwarmQueue* queue, unsigned char* data, unsigned int* len)
+{
+    // For a board with more than one modem: the newest message goes back to the caller so a modem that can't send
+    // it doesn't sit on it. Copied out before head moves, a reset in here leaves it in both places, not in neither.
+    // Only Normal, that's what swarm_queuePush() fills and what another modem can be handed with it
+    SwarmQueueStore* store = queue->store;
+    SwarmQueueRing* ring = &store->ring[SwarmQueueNormal];
+    SwarmQueueSlot* slot;
+    unsigned int keep = queue->inFlight && queue->inFlightClass == SwarmQueueNormal ? 1U : 0U;
+
+    while(queue_ringDepth(store, SwarmQueueNormal) > keep && queue_slot(store, SwarmQueueNormal, ring->head - 1)->retired){
+        SWARM_FRAM_WRITE_BEGIN();
+        ring->head--;                           // a coalesced one, its newer value was taken back already
+        SWARM_FRAM_WRITE_END();
+    }
+    if(queue_ringDepth(store, SwarmQueueNormal) <= keep)
+        return false;
+    slot = queue_slot(store, SwarmQueueNormal, ring->head - 1);
+    if(slot->len == 0 || slot->len > SWARM_QUEUE_DATA_MAX || slot->crc != queue_slotCrc(slot))
+        *len = 0;                               // corrupt, dropped here instead of at the tail
+    else{
+        memcpy(data, slot->data, slot->len);
+        *len = slot->len;
+    }
+
+    SWARM_FRAM_WRITE_BEGIN();
+    ring->head--;                               // one 16 bit write, this is the commit
+    SWARM_FRAM_WRITE_END();
+    if(*len == 0){
+        queue->stats.corrupt++;
+        return false;
+    }
+    queue->stats.takenBack++;
+    return true;
+}
+
+unsigned int swarm_queueHoldParam(const SwarmQueue* queue, SwarmQueueClass cls, char* param)
+{
+    // for a $TD that doesn't go through the queue, the class deadline from now. param is SWARM_QUEUE_HOLD_PARAM_MAX
+    unsigned long epoch = queue_now(queue, queue->modem->hal->millis());
+    unsigned long holdS = queue->cls[(unsigned int)cls < SwarmQueueClassCount ? cls : SwarmQueueNormal].holdS;
+
+    return queue_holdParam(param, epoch ? epoch + holdS : 0, holdS);
+}
+
+void swarm_queueService(SwarmQueue* queue, unsigned long now)
+{
+    SwarmModem* modem = queue->modem;
+    SwarmQueueStore* store = queue->store;
+    SwarmQueueSlot* slot;
+    char hold[SWARM_QUEUE_HOLD_PARAM_MAX];
+    unsigned long epoch;
+    unsigned int cls;
+
+    if(!modem->info.satFullyInitialized || modem->info.isSleeping)
+        return;                                 // a $TD now would wake it, the scheduler decides that
+
+    // find out what the modem is holding, and check now and then in case we missed a $TD SENT
+    if(!queue->modemKnown || now - queue->lastQuery >= SWARM_QUEUE_QUERY_ms)
+        swarm_queueAskModem(queue, now);
+
+    if(queue->inFlight){
+        if(now - queue->inFlightSince < 4UL * SAT_RX_TIMEOUT_ms)
+            return;
+        queue->inFlight = false;                // no OK or ERR, it goes again
+        if((int)(queue->inFlightTd + 1 - queue->tdAnswered) > 0)
+            queue->tdAnswered = queue->inFlightTd + 1;   // and the answers before it are lost too
+    }
+    if(queue->backoffMs){
+        if(now - queue->backoffAt < queue->backoffMs)
+            return;
+        queue->backoffMs = 0;
+    }
+    if(swarm_queueDepth(queue) == 0 || !queue->modemKnown)
+        return;
+
+    // highest class with something in it that the modem has room for, oldest first within a class
+    epoch = queue_now(queue, now);
+    for(cls = 0; cls < SwarmQueueClassCount; cls++){
+        queue_skipDead(queue, cls, epoch);
+        if(queue_ringDepth(store, cls) == 0 || queue->modemUnsent >= queue->cls[cls].modemMax)
+            continue;
+        queue->holding = false;
+
+        slot = queue_slot(store, cls, store->ring[cls].tail);
+        if(slot->len == 0 || slot->len > SWARM_QUEUE_DATA_MAX || slot->crc != queue_slotCrc(slot)){
+            queue->stats.corrupt++;
+            queue_commitTail(queue, cls);
+            return;
+        }
+        queue_holdParam(hold, slot->expires, queue->cls[cls].holdS);
+        queue->inFlightTd = queue->tdSent;
+        if(swarm_transmitPayload(modem, SAT_MSG_APPLICATION_ID, hold, slot->data, slot->len, SwarmPayloadHex) == 0)
+            return;                             // TX ring is full, next time
+        queue->inFlight = true;
+        queue->inFlightClass = (unsigned char)cls;
+        queue->inFlightSince = now;
+        queue->stats.sent++;
+        return;
+    }
+
+    if(!queue->holding)
+        queue->stats.modemFull++;
+    queue->holding = true;                      // backpressure, wait for $TD SENT
+}
+
+void swarm_queueOnTdReply(SwarmQueue* queue, const SwarmSentence* sentence)
+{
+    SwarmTdReply reply;
+    bool ours;
+
+    if(!swarm_sentenceTd(sentence, &reply))
+        return;
+    if(reply.kind == SwarmTdSent){
+        // $TD SENT RSSI=...  one less in the modem, whoever sent it
+        if(queue->modemUnsent)
+            queue->modemUnsent--;
+        return;
+    }
+    if(queue->tdAnswered == queue->tdSent)
+        return;                                 // an answer to nothing we know of
+    ours = swarm_queueReplyIsOurs(queue);
+    queue->tdAnswered++;
+    if(!ours){
+        if(reply.kind == SwarmTdOk)
+            queue->modemUnsent++;               // someone's swarm_transmitData(), the modem holds it all the same
+        return;
+    }
+    queue->inFlight = false;
+
+    if(reply.kind == SwarmTdError){
+        // $TD ERR,<reason>
+        switch(swarm_errorPolicy(&queue->modem->errors, sentence)){
+        case SwarmRecoverRetry:
+        case SwarmRecoverReinit:
+            // same one again (after swarm_reinit() for a Reinit) SWARM_CMD_RETRIES times like the command engine,
+            // then as many with a backoff, then it's dropped below
+            if(++queue->retryTries <= SWARM_CMD_RETRIES)
+                break;
+            if(queue->retryTries <= 2 * SWARM_CMD_RETRIES){
+                queue_backoff(queue);
+                break;
+            }
+            queue->stats.rejected++;
+            queue_commitTail(queue, queue->inFlightClass);
+            break;
+        case SwarmRecoverBackoff:
+            if(swarm_errorCode(sentence) == SwarmErrFull){
+                queue->modemUnsent = SWARM_QUEUE_MODEM_MAX; // modem is full, hold on to it until something is SENT
+                break;
+            }
+            queue_backoff(queue);
+            break;
+        default:
+            queue->stats.rejected++;                        // the message itself is bad, sending it again won't help
+            queue_commitTail(queue, queue->inFlightClass);
+            break;
+        }
+    }
+    else{
+        // $TD OK,<msg_id>  the modem has it, it's not ours to keep anymore
+        queue->backoffTries = 0;
+        queue_commitTail(queue, queue->inFlightClass);
+        queue->stats.accepted++;
+        queue->modemUnsent++;
+    }
+}
+
+bool swarm_queueAskModem(SwarmQueue* queue, unsigned long now)
+{
+    // $MT C=U, the answer goes to swarm_queueOnUnsentCount()
+    SwarmModem* modem = queue->modem;
+
+    if(swarm_cmdIsPending(&modem->cmds, SAT_HEADER_MESSAGE_MANAGEMENT_TX))
+        return true;
+    if(!swarm_cmdSubmit(&modem->cmds, SAT_CMD_MSG_TX_MANAGEMENT, SAT_CMD_PARAM_QUERY_UNSENT_MESSAGES, 0, 0, 0))
+        return false;
+    queue->lastQuery = now;
+    return true;
+}
+
+void swarm_queueOnUnsentCount(SwarmQueue* queue, unsigned int unsent)
+{
+    queue->modemUnsent = unsent;
+    queue->modemKnown = true;
+}
+
+void swarm_queueForgetModem(SwarmQueue* queue)
+{
+    // the $TD in flight goes again, and nothing more until $MT C=U says how much the modem still has
+    queue->inFlight = false;
+    queue->tdAnswered = queue->tdSent;          // a modem that rebooted won't answer what it had
+    queue->modemKnown = false;
+    queue->holding = false;
+    queue->backoffMs = 0;
+}
+
+void swarm_queueOnDateTime(SwarmQueue* queue, const Calendar* dateTime, unsigned long now)
+{
+    // deadlines are stamped in epoch seconds from here on, millis carries it between $DT
+    unsigned long epoch = queue_epoch(dateTime);
+
+    if(epoch == 0)
+        return;
+    queue->epoch = epoch;
+    queue->epochAt = now;
+}
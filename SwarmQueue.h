@@ -0,0 +1,182 @@
+/*
+ * SwarmQueue.h
+ *
+ *  Created on: Oct 16, 2026
+ *      Author: MicroTechEE
+ */
+
+#ifndef SWARMQUEUE_H_
+#define SWARMQUEUE_H_
+
+#include <stdbool.h>
+#include <SwarmTx.h>
+#include <SwarmParser.h>
+#include "misc.h"
+
+/* Outbound $TD queue that survives a reset. The slots live in FRAM (SwarmQueueStore, put it in a SWARM_PERSISTENT
+ * variable) and only two things are ever committed: head after a slot is completely written and tail after the
+ * modem said $TD OK. Both are single 16 bit writes, so a reset at any point leaves either the old or the new queue,
+ * never half a message. Worst case a message is sent twice, never lost.
+ *
+ * The modem answers every $TD with one OK or ERR, in the order they went out. The queue counts every $TD written
+ * (tdSent, swarm_transmitPayload() does that) and every answer (tdAnswered), so only the answer to its own $TD moves
+ * tail. A swarm_transmitData() of your own in between gets its own OK, not ours.
+ *
+ * The modem is only fed while its own unsent count ($MT C=U, plus our $TD OKs minus its $TD SENTs) is below
+ * SWARM_QUEUE_MODEM_MAX. When it's full, messages wait here instead of being deleted with $MT D=U.
+ *
+ *      swarm_queuePush(&modem->queue, packet, len);      // anywhere in the main loop, false if the queue is full
+ *
+ * Every message has a class, each class is its own ring in the store and has its own deadline (cls[].holdS):
+ *
+ *      Urgent  alarms. Always the next one out, and let into the modem until it holds SWARM_QUEUE_MODEM_MAX
+ *      Normal  what swarm_queuePush() queues, the old behaviour, HD=86400
+ *      Bulk    position and status reports. Only fed while the modem holds fewer than SWARM_QUEUE_BULK_MODEM_MAX,
+ *              so a backlog of them in the modem never sits in front of an alarm
+ *
+ * The deadline runs from the push. Once $DT has given us the time it's stamped on the slot and goes to the modem as
+ * ET=<epoch>, so the modem drops it too when it can't get it up in time, and we drop it (stats.expired) instead of
+ * sending it at all when it would have less than SWARM_QUEUE_HOLD_MIN_s left. Without a time it's HD=<holdS>.
+ *
+ * A key (1..255) makes it latest value wins: push a new fix with the same key and class as one that's still here
+ * and not in flight, and the old one is retired (stats.coalesced). The new one is a normal push at head with its
+ * own deadline, only after head is committed does the old slot get its retired byte, and service steps tail over
+ * it. A reset in between leaves both, they both go. A class that's full of retired slots behind a tail that can't
+ * go yet (in flight, or the modem has enough) puts the push in the place of one of them, a full class with none
+ * drops it.
+ *
+ *      swarm_queuePushClass(&modem->queue, SwarmQueueUrgent, 0, alarm, alarmLen);
+ *      swarm_queuePushClass(&modem->queue, SwarmQueueBulk, KEY_POSITION, fix, fixLen);
+ */
+
+#define SWARM_QUEUE_SLOTS                               64       // 64 x 202 bytes of FRAM
+#define SWARM_QUEUE_DATA_MAX                            192      // SAT_NUMBER_MAX_PACKET_BYTES_HEX
+#define SWARM_QUEUE_MODEM_MAX                           20       // unsent messages we let the modem hold
+#define SWARM_QUEUE_QUERY_ms                            600000   // re-sync with $MT C=U this often
+#define SWARM_QUEUE_URGENT_SLOTS                        16       // out of SWARM_QUEUE_SLOTS, each a power of 2
+#define SWARM_QUEUE_BULK_SLOTS                          16
+#define SWARM_QUEUE_NORMAL_SLOTS                        (SWARM_QUEUE_SLOTS - SWARM_QUEUE_URGENT_SLOTS - SWARM_QUEUE_BULK_SLOTS)
+#define SWARM_QUEUE_URGENT_HOLD_s                       86400    // deadlines, from the push
+#define SWARM_QUEUE_NORMAL_HOLD_s                       86400    // SAT_MSG_HOLD_TIME_1DAY, what everything used to get
+#define SWARM_QUEUE_BULK_HOLD_s                         7200     // a two hour old position isn't worth a packet
+#define SWARM_QUEUE_BULK_MODEM_MAX                      4        // modem unsent count Bulk stops feeding at
+#define SWARM_QUEUE_HOLD_MIN_s                          60       // modem minimum for HD=, less left than this is expired
+#define SWARM_QUEUE_HOLD_PARAM_MAX                      16       // "ET=4294967295," and the '\0'
+#define SWARM_QUEUE_MAGIC                               (0x5353 ^ SWARM_QUEUE_SLOTS ^ SWARM_QUEUE_URGENT_SLOTS << 7 ^ \
+                                                         SWARM_QUEUE_BULK_SLOTS << 11)   // store layout changed -> start over
+
+/* FRAM placement. TI's compiler wants a pragma before the definition, msp430-gcc an attribute after the name:
+ *
+ *      SWARM_PERSISTENT(myStore)
+ *      SwarmQueueStore myStore SWARM_PERSISTENT_ATTR = {0};
+ *
+ * If your MPU setup write protects the persistent section, open it in SWARM_FRAM_WRITE_BEGIN / END.
+ */
+#if defined(__TI_COMPILER_VERSION__)
+#define SWARM_PRAGMA(x)                                 _Pragma(#x)
+#define SWARM_PERSISTENT(var)                           SWARM_PRAGMA(PERSISTENT(var))
+#define SWARM_PERSISTENT_ATTR
+#elif defined(__MSP430__) && defined(__GNUC__)
+#define SWARM_PERSISTENT(var)
+#define SWARM_PERSISTENT_ATTR                           __attribute__((persistent))
+#else
+#define SWARM_PERSISTENT(var)
+#define SWARM_PERSISTENT_ATTR
+#endif
+#ifndef SWARM_FRAM_WRITE_BEGIN
+#define SWARM_FRAM_WRITE_BEGIN()
+#define SWARM_FRAM_WRITE_END()
+#endif
+
+struct SwarmModem;
+
+/* * * * * * * * STRUCTS * * * * * * * * * */
+typedef enum{
+    SwarmQueueUrgent = 0,                       // in priority order
+    SwarmQueueNormal,
+    SwarmQueueBulk,
+    SwarmQueueClassCount
+}SwarmQueueClass;
+
+typedef struct{
+    unsigned long holdS;                        // deadline from the push
+    unsigned int modemMax;                      // fed only while the modem holds fewer unsent than this
+}SwarmQueueClassConfig;
+
+typedef struct{
+    unsigned int crc;                           // swarm_crc16 of len, key, expires and data
+    unsigned char len;
+    unsigned char key;                          // 0 = none
+    unsigned char retired;                      // a newer push with the key is behind it, not in the CRC
+    unsigned long expires;                      // epoch seconds, 0 = we had no time at the push, HD= the class hold
+    unsigned char data[SWARM_QUEUE_DATA_MAX];
+}SwarmQueueSlot;
+
+typedef struct{
+    volatile unsigned int head;                 // free running, committed after the slot is written
+    volatile unsigned int tail;                 // free running, committed after $TD OK
+}SwarmQueueRing;
+
+typedef struct{
+    unsigned int magic;
+    SwarmQueueRing ring[SwarmQueueClassCount];
+    SwarmQueueSlot slot[SWARM_QUEUE_SLOTS];     // Urgent's first, then Normal's, then Bulk's
+}SwarmQueueStore;
+
+typedef struct{
+    unsigned long pushed;
+    unsigned long sent;                         // $TD written to the modem, retries included
+    unsigned long accepted;                     // $TD OK
+    unsigned long dropped;                      // queue was full
+    unsigned long rejected;                     // modem said the message itself is bad, or kept saying retry, it's gone
+    unsigned long corrupt;                      // failed the CRC after a reset
+    unsigned long takenBack;                    // handed to another modem with swarm_queueTakeBack()
+    unsigned long modemFull;                    // times we held off because the modem had enough
+    unsigned long expired;                      // deadline passed while it waited here, never sent
+    unsigned long coalesced;                    // replaced by a newer push with the same key
+    unsigned long backoffs;                     // ERR said not yet, waited before the next $TD
+    unsigned int highWater;
+}SwarmQueueStats;
+
+typedef struct{
+    struct SwarmModem* modem;                   // who the $TD go to
+    SwarmQueueStore* store;
+    SwarmQueueClassConfig cls[SwarmQueueClassCount];   // SWARM_QUEUE_*_HOLD_s defaults, change them after init
+    bool inFlight;                              // a $TD from the tail of ring[inFlightClass] is waiting on OK / ERR
+    unsigned char inFlightClass;
+    unsigned long inFlightSince;
+    unsigned int inFlightTd;                    // tdSent of ours, its answer is the one when tdAnswered gets there
+    unsigned int tdSent;                        // every $TD to the modem, ours or not, free running
+    unsigned int tdAnswered;                    // OK / ERR for them, the modem answers in order
+    unsigned int modemUnsent;                   // our best idea of the modem's count
+    bool modemKnown;                            // we've had an $MT C=U answer since startup
+    bool holding;                               // modem has SWARM_QUEUE_MODEM_MAX, waiting on $TD SENT
+    unsigned char backoffTries;                 // ERR with SwarmRecoverBackoff in a row, reset by $TD OK
+    unsigned char retryTries;                   // Retry / Reinit ERR for the one at the tail, reset when tail moves
+    unsigned long backoffAt;
+    unsigned long backoffMs;                    // 0 = not waiting
+    unsigned long lastQuery;                    // last $MT C=U we asked
+    unsigned long epoch;                        // last valid $DT, 0 = no time yet
+    unsigned long epochAt;                      // millis when it came
+    SwarmQueueStats stats;
+}SwarmQueue;
+
+/* * * * * * * * FUNCTIONS * * * * * * * * * */
+void swarm_queueInit(SwarmQueue* queue, struct SwarmModem* modem, SwarmQueueStore* store);   // keeps what survived in the store
+bool swarm_queuePush(SwarmQueue* queue, const unsigned char* data, unsigned int len);   // SwarmQueueNormal, no key
+bool swarm_queuePushClass(SwarmQueue* queue, SwarmQueueClass cls, unsigned char key, const unsigned char* data,
+                          unsigned int len);
+bool swarm_queueTakeBack(SwarmQueue* queue, unsigned char* data, unsigned int* len);   // newest Normal, never the one in flight
+unsigned int swarm_queueDepth(const SwarmQueue* queue);                            // all classes
+unsigned int swarm_queueRoom(const SwarmQueue* queue, SwarmQueueClass cls);
+const unsigned char* swarm_queueInFlight(const SwarmQueue* queue, unsigned int* len);   // the $TD waiting on OK, 0 if none
+bool swarm_queueReplyIsOurs(const SwarmQueue* queue);               // the next $TD OK / ERR answers the one in flight
+unsigned int swarm_queueHoldParam(const SwarmQueue* queue, SwarmQueueClass cls, char* param);   // "ET=..," or "HD=..,"
+void swarm_queueService(SwarmQueue* queue, unsigned long now);
+void swarm_queueOnTdReply(SwarmQueue* queue, const SwarmSentence* sentence);
+bool swarm_queueAskModem(SwarmQueue* queue, unsigned long now);     // $MT C=U now, not in SWARM_QUEUE_QUERY_ms
+void swarm_queueOnUnsentCount(SwarmQueue* queue, unsigned int unsent);
+void swarm_queueForgetModem(SwarmQueue* queue);                    // it rebooted or is being re-inited, ask $MT C=U again
+void swarm_queueOnDateTime(SwarmQueue* queue, const Calendar* dateTime, unsigned long now);
+
+#endif /* SWARMQUEUE_H_ */
@@ -0,0 +1,194 @@
+/*
+ * SwarmRates.c
+ *
+ *  Created on: Oct 16, 2026
+ *      Author: MicroTechEE
+ */
+
+// STD C
+#include <stdbool.h>
+#include "string.h"
+
+#include <Message.h>
+#include <SwarmMSP430.h>
+#include <SwarmRates.h>
+
+/* - - - - - - - - - - - - - GLOBALS - - - - - - - - - - - - - - - */
+static const unsigned long rateDefaults[SwarmRateCount][SwarmPowerCount] = {
+    SWARM_RATES_DT_s,
+    SWARM_RATES_GJ_s,
+    SWARM_RATES_GN_s,
+    SWARM_RATES_GS_s,
+    SWARM_RATES_PW_s,
+    SWARM_RATES_RT_s
+};
+
+/* - - - - - - - - - - - - - HELPERS - - - - - - - - - - - - - - - */
+static unsigned int rates_header(SwarmRate which)
+{
+    return (unsigned int)swarmRateCommands[which][1] << 8 | (unsigned char)swarmRateCommands[which][2];
+}
+
+static bool rates_index(unsigned int header, SwarmRate* which)
+{
+    unsigned char i;
+
+    for(i = 0; i < SwarmRateCount; i++){
+        if(header == rates_header((SwarmRate)i)){
+            *which = (SwarmRate)i;
+            return true;
+        }
+    }
+    return false;
+}
+
+static bool rates_isReport(const SwarmSentence* sentence)
+{
+    // data, not "$GN OK" or the "$GN 60" a ? gets back, and only a valid $DT is worth anything
+    const char* field;
+    unsigned int i;
+
+    if(sentence->isError || sentence->fieldCount == 0)
+        return false;
+    if(sentence->header == SAT_HEADER_DATE_TIME)
+        return sentence->fieldCount == 2 && sentence->line[sentence->fieldStart[1]] == 'V';
+    if(sentence->fieldCount > 1)
+        return true;
+    if(swarm_sentenceFieldIs(sentence, 0, "OK"))
+        return false;
+    field = sentence->line + sentence->fieldStart[0];
+    for(i = 0; i < sentence->fieldLen[0]; i++){
+        if(field[i] < '0' || field[i] > '9')
+            return true;                        // $RT RSSI=-104
+    }
+    return false;
+}
+
+static bool rates_poll(SwarmRates* rates, SwarmRate which, unsigned long now)
+{
+    SwarmModem* modem = rates->modem;
+
+    if(!rates->ready || swarm_cmdIsPending(&modem->cmds, rates_header(which)))
+        return false;                           // can't ask now, or already asked
+    if(rates->pollTried[which] && now - rates->polledAt[which] < rates->retryMs)
+        return false;                           // asked and got nothing worth having, not again so soon
+    if(!swarm_cmdSubmit(&modem->cmds, swarmRateCommands[which], SAT_CMD_PARAM_QUERY_LAST_MESSAGE, 0, 0, 0))
+        return false;
+    rates->pollTried[which] = true;
+    rates->polledAt[which] = now;
+    rates->stats.polls++;
+    return true;
+}
+
+/* - - - - - - - - - - - - - FUNCTIONS - - - - - - - - - - - - - - - */
+void swarm_ratesInit(SwarmRates* rates, struct SwarmModem* modem)
+{
+    memset(rates, 0, sizeof(*rates));
+    rates->modem = modem;
+    rates->power = SwarmPowerNormal;
+    memcpy(rates->maxAgeS, rateDefaults, sizeof(rates->maxAgeS));
+    rates->streamMaxS = SWARM_RATES_STREAM_MAX_s;
+    rates->retryMs = SWARM_RATES_RETRY_ms;
+}
+
+void swarm_ratesStart(SwarmRates* rates)
+{
+    rates->running = true;
+}
+
+void swarm_ratesStop(SwarmRates* rates)
+{
+    rates->running = false;
+}
+
+void swarm_ratesSetPower(SwarmRates* rates, SwarmPowerMode power)
+{
+    if(power >= SwarmPowerCount || power == rates->power)
+        return;
+    rates->power = power;
+    memset(rates->setTried, 0, sizeof(rates->setTried));   // new targets, no reason to wait on the old ones
+    rates->stats.powerChanges++;
+}
+
+unsigned long swarm_ratesTarget(const SwarmRates* rates, SwarmRate which)
+{
+    unsigned long maxAge = rates->maxAgeS[which][rates->power];
+
+    return maxAge <= rates->streamMaxS ? maxAge : 0;
+}
+
+bool swarm_ratesFresh(SwarmRates* rates, SwarmRate which, unsigned long maxAgeS)
+{
+    unsigned long now = rates->modem->hal->millis();
+
+    if(which >= SwarmRateCount)
+        return false;
+    if(rates->seen[which] && now - rates->updatedAt[which] <= maxAgeS * 1000UL)
+        return true;
+    rates_poll(rates, which, now);
+    return false;
+}
+
+void swarm_ratesService(SwarmRates* rates, unsigned long now)
+{
+    SwarmModem* modem = rates->modem;
+    bool ready = modem->info.satFullyInitialized && !modem->info.isSleeping && !modem->warm.booting;
+    unsigned long target;
+    unsigned long maxAge;
+    unsigned long age;
+    unsigned char i;
+
+    if(ready && !rates->ready){
+        rates->readyAt = now;                   // up again, what we tried before it went away doesn't count
+        memset(rates->setTried, 0, sizeof(rates->setTried));
+        memset(rates->pollTried, 0, sizeof(rates->pollTried));
+    }
+    rates->ready = ready;
+    if(!rates->running || !ready)
+        return;
+
+    for(i = 0; i < SwarmRateCount; i++){
+        target = swarm_ratesTarget(rates, (SwarmRate)i);
+        if(modem->warm.rateHave[i] != target){
+            if(rates->setTried[i] && now - rates->setAt[i] < rates->retryMs)
+                continue;
+            if(swarm_warmSetRate(modem, (SwarmRate)i, target)){
+                rates->setTried[i] = true;
+                rates->setAt[i] = now;
+                rates->stats.sets++;
+            }
+            continue;                           // the poll can wait for the next pass
+        }
+
+        maxAge = rates->maxAgeS[i][rates->power] * 1000UL;
+        if(maxAge == 0)
+            continue;
+        if(target){
+            // streamed, late counts from when the modem came up or the rate went on, not from before it slept
+            age = now - rates->readyAt;
+            if(rates->setTried[i] && now - rates->setAt[i] < age)
+                age = now - rates->setAt[i];
+            if(rates->seen[i] && now - rates->updatedAt[i] < age)
+                age = now - rates->updatedAt[i];
+            if(age > 2 * maxAge && rates_poll(rates, (SwarmRate)i, now))
+                rates->stats.stale++;
+        }
+        else if(!rates->seen[i] || now - rates->updatedAt[i] >= maxAge)
+            rates_poll(rates, (SwarmRate)i, now);
+    }
+}
+
+void swarm_ratesOnSentence(SwarmRates* rates, const SwarmSentence* sentence)
+{
+    SwarmRate which;
+
+    if(!rates_index(sentence->header, &which) || !rates_isReport(sentence))
+        return;
+    if(swarm_cmdIsPending(&rates->modem->cmds, sentence->header))
+        rates->stats.polled++;                  // the command engine hasn't matched it to the @ yet
+    else
+        rates->stats.streamed++;
+    rates->seen[which] = true;
+    rates->pollTried[which] = false;            // answered, the next one is up to maxAge
+    rates->updatedAt[which] = rates->modem->hal->millis();
+}
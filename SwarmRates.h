@@ -0,0 +1,101 @@
+/*
+ * SwarmRates.h
+ *
+ *  Created on: Oct 16, 2026
+ *      Author: MicroTechEE
+ */
+
+#ifndef SWARMRATES_H_
+#define SWARMRATES_H_
+
+#include <stdbool.h>
+#include <SwarmParser.h>
+#include <SwarmWarm.h>
+
+/* Decides which $DT / $GJ / $GN / $GS / $PW / $RT lines the modem sends on its own, instead of leaving them at
+ * whatever they were. You say how old each part of modem->info may get, per power mode, and once swarm_ratesStart()
+ * hands it control:
+ *
+ *      maxAge 0                    rate 0, never asked for, whatever is in modem->info stays as it was
+ *      maxAge up to streamMaxS     rate = maxAge, the modem sends it on its own
+ *      maxAge over streamMaxS      rate 0, $XX @ from swarm_handleMsg() once the last one is older than maxAge
+ *
+ * Every unsolicited line wakes the MCU and goes through the parser, a poll is one line each way but it's on our
+ * clock and only when it's due. A rate of a minute is cheaper streamed, an hour isn't worth a timer on the modem.
+ * A streamed one that's twice as old as it should be after the modem has been up that long is polled too.
+ *
+ * Rates go through swarm_warmSetRate() so they're kept in the SwarmWarmStore and put back after a modem reboot,
+ * and a rate is only sent when it isn't what the modem already has. Nothing is sent while the modem is asleep or
+ * not initialized, a change waits until it's up.
+ *
+ *      swarm_ratesStart(&modem->rates);                          // after swarm_modemInit(), the defaults below
+ *      modem->rates.maxAgeS[SwarmRateGpsInfo][SwarmPowerLow] = 0; // don't care where we are on battery
+ *      swarm_ratesSetPower(&modem->rates, SwarmPowerLow);        // battery's low, everything slows down
+ *
+ *      if(swarm_ratesFresh(&modem->rates, SwarmRateReceiveTest, 30))  // need it now, $RT @ if it's older
+ *          decide(modem->info.rssi.background);
+ *
+ * It keeps the ages either way (started or not). Don't call swarm_warmSetRate() yourself once it's started, the
+ * next pass puts its own rate back.
+ */
+
+#define SWARM_RATES_STREAM_MAX_s                        600      // up to this the modem streams it, longer is polled
+#define SWARM_RATES_RETRY_ms                            60000    // a rate or @ that went unanswered goes again after this
+
+/* maxAgeS defaults in seconds, Full / Normal / Low, 0 = don't want it */
+#define SWARM_RATES_DT_s                                {3600, 86400, 86400}   // the RTC drifts slowly, ET= needs it
+#define SWARM_RATES_GJ_s                                {60, 900, 0}           // the scheduler asks $GJ @ on wake anyway
+#define SWARM_RATES_GN_s                                {60, 600, 3600}
+#define SWARM_RATES_GS_s                                {300, 0, 0}
+#define SWARM_RATES_PW_s                                {60, 900, 3600}
+#define SWARM_RATES_RT_s                                {60, 180, 900}         // 180 is the old background RSSI rate
+
+struct SwarmModem;
+
+/* * * * * * * * STRUCTS * * * * * * * * * */
+typedef enum{
+    SwarmPowerFull = 0,                         // on external power, keep everything fresh
+    SwarmPowerNormal,
+    SwarmPowerLow,                              // battery low, only what decisions need
+    SwarmPowerCount
+}SwarmPowerMode;
+
+typedef struct{
+    unsigned long streamed;                     // lines the modem sent on its own
+    unsigned long polled;                       // answers to our $XX @
+    unsigned long polls;                        // $XX @ sent, stale ones included
+    unsigned long stale;                        // streamed but late, polled instead
+    unsigned long sets;                         // rates sent to the modem
+    unsigned long powerChanges;
+}SwarmRatesStats;
+
+typedef struct{
+    struct SwarmModem* modem;                   // whose rates
+    bool running;                               // swarm_ratesStart() was called
+    SwarmPowerMode power;
+    unsigned long maxAgeS[SwarmRateCount][SwarmPowerCount];   // 0 = don't want it
+    unsigned long streamMaxS;
+    unsigned long retryMs;
+
+    bool ready;                                 // initialized and awake the last pass
+    unsigned long readyAt;
+    bool seen[SwarmRateCount];                  // updatedAt means something
+    unsigned long updatedAt[SwarmRateCount];    // millis of the last line with data in it
+    bool setTried[SwarmRateCount];              // setAt means something
+    unsigned long setAt[SwarmRateCount];
+    bool pollTried[SwarmRateCount];             // polledAt means something
+    unsigned long polledAt[SwarmRateCount];
+    SwarmRatesStats stats;
+}SwarmRates;
+
+/* * * * * * * * FUNCTIONS * * * * * * * * * */
+void swarm_ratesInit(SwarmRates* rates, struct SwarmModem* modem);   // swarm_modemInit() does this, defaults
+void swarm_ratesStart(SwarmRates* rates);
+void swarm_ratesStop(SwarmRates* rates);                              // rates stay as they are on the modem
+void swarm_ratesSetPower(SwarmRates* rates, SwarmPowerMode power);
+unsigned long swarm_ratesTarget(const SwarmRates* rates, SwarmRate which);   // the rate we want on the modem
+bool swarm_ratesFresh(SwarmRates* rates, SwarmRate which, unsigned long maxAgeS);   // false = $XX @ is on its way
+void swarm_ratesService(SwarmRates* rates, unsigned long now);
+void swarm_ratesOnSentence(SwarmRates* rates, const SwarmSentence* sentence);   // before the command engine sees it
+
+#endif /* SWARMRATES_H_ */
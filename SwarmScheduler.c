@@ -0,0 +1,174 @@
+/*
+ * SwarmScheduler.c
+ *
+ *  Created on: Oct 16, 2026
+ *      Author: MicroTechEE
+ */
+
+// STD C
+#include <stdbool.h>
+#include "string.h"
+
+#include <Message.h>
+#include <SwarmMSP430.h>
+#include <SwarmScheduler.h>
+
+/* - - - - - - - - - - - - - HELPERS - - - - - - - - - - - - - - - */
+static bool sched_skyIsBad(const SwarmScheduler* sched)
+{
+    const SatInfo* info = &sched->modem->info;
+
+    // background 0 means we haven't had an $RT yet, don't hold anything back on a guess
+    if(info->rssi.background != 0 && info->signalRating <= SignalStrengthBad)
+        return true;
+    return info->gpsJamming.level > sched->jammingMax;
+}
+
+static void sched_refresh(SwarmScheduler* sched)
+{
+    // fresh numbers for the next decision, these are cheap and answer right away
+    swarm_cmdSubmit(&sched->modem->cmds, SAT_CMD_RECEIVE_TEST, SAT_CMD_PARAM_QUERY_LAST_MESSAGE, 0, 0, 0);
+    swarm_cmdSubmit(&sched->modem->cmds, SAT_CMD_GPS_JAMMING, SAT_CMD_PARAM_QUERY_LAST_MESSAGE, 0, 0, 0);
+}
+
+static void sched_sleep(SwarmScheduler* sched, bool backoff, unsigned long now)
+{
+    if(swarm_sleepFor(sched->modem, backoff ? sched->backoffSleepS : sched->idleSleepS) == 0)
+        return;                                 // TX ring full, next time around
+    sched->sleepRequested = now;
+    sched->stats.sleeps++;
+    if(backoff)
+        sched->stats.backoffSleeps++;
+    else
+        sched->stats.idleSleeps++;
+}
+
+/* - - - - - - - - - - - - - FUNCTIONS - - - - - - - - - - - - - - - */
+void swarm_schedInit(SwarmScheduler* sched, struct SwarmModem* modem, unsigned long now)
+{
+    memset(sched, 0, sizeof(*sched));
+    sched->modem = modem;
+    sched->idleSleepS = SWARM_SCHED_IDLE_SLEEP_s;
+    sched->backoffSleepS = SWARM_SCHED_BACKOFF_SLEEP_s;
+    sched->minAwakeMs = SWARM_SCHED_MIN_AWAKE_ms;
+    sched->maxAwakeMs = SWARM_SCHED_MAX_AWAKE_ms;
+    sched->wakeDepth = SWARM_SCHED_WAKE_DEPTH;
+    sched->jammingMax = SWARM_SCHED_JAMMING_MAX;
+    sched->lastService = now;
+    sched->awakeSince = now;
+    sched->lastTdSent = now;
+}
+
+void swarm_schedStart(SwarmScheduler* sched)
+{
+    sched->running = true;
+}
+
+void swarm_schedStop(SwarmScheduler* sched)
+{
+    sched->running = false;
+}
+
+void swarm_schedService(SwarmScheduler* sched, unsigned long now)
+{
+    SwarmModem* modem = sched->modem;
+    bool sleeping = modem->info.isSleeping;
+    bool pending;
+
+    // keep the books whether we're in charge or not
+    if(sched->wasSleeping)
+        sched->stats.asleepMs += now - sched->lastService;
+    else
+        sched->stats.awakeMs += now - sched->lastService;
+    sched->lastService = now;
+
+    if(sleeping != sched->wasSleeping){
+        sched->wasSleeping = sleeping;
+        sched->sleepRequested = 0;
+        if(!sleeping){
+            sched->awakeSince = now;
+            if(sched->running)
+                sched_refresh(sched);
+        }
+    }
+
+    if(!sched->running || !modem->info.satFullyInitialized)
+        return;
+
+    if(sleeping){
+        if(swarm_queueDepth(&modem->queue) >= sched->wakeDepth){
+            swarm_wake(modem);                  // enough waiting that it's worth not waiting for the timer
+            swarm_cmdSubmit(&modem->cmds, SAT_CMD_RECEIVE_TEST, SAT_CMD_PARAM_QUERY_LAST_MESSAGE, 0, 0, 0);   // serial wakes it too
+            sched->stats.wakes++;
+        }
+        return;
+    }
+
+    if(sched->sleepRequested){
+        if(now - sched->sleepRequested < 4UL * SAT_RX_TIMEOUT_ms)
+            return;                             // waiting on $SL OK
+        sched->sleepRequested = 0;
+    }
+    if(now - sched->awakeSince < sched->minAwakeMs || modem->cmds.count)
+        return;
+
+    pending = swarm_queueDepth(&modem->queue) || modem->queue.inFlight;
+    if(!pending && modem->queue.modemUnsent && now - modem->queue.lastQuery >= sched->minAwakeMs){
+        // the count drifts, a $TD that expires on the modem never says SENT. Ask before staying up for it,
+        // modem->cmds.count holds the decision until $MT C=U is answered
+        swarm_queueAskModem(&modem->queue, now);
+        return;
+    }
+    pending = pending || modem->queue.modemUnsent;
+    if(!pending)
+        sched_sleep(sched, false, now);
+    else if(sched_skyIsBad(sched) ||
+            now - (sched->lastTdSent > sched->awakeSince ? sched->lastTdSent : sched->awakeSince) >= sched->maxAwakeMs)
+        sched_sleep(sched, true, now);
+}
+
+void swarm_schedOnTdOk(SwarmScheduler* sched, unsigned long now)
+{
+    sched->okAt[sched->okHead % SWARM_SCHED_LATENCY_SLOTS] = now;
+    sched->okHead++;
+    if((unsigned char)(sched->okHead - sched->okTail) > SWARM_SCHED_LATENCY_SLOTS)
+        sched->okTail++;                        // lost track of the oldest one, it won't be counted
+}
+
+void swarm_schedOnTdSent(SwarmScheduler* sched, unsigned long now)
+{
+    // the modem sends in order, so this SENT is the oldest OK we have
+    unsigned long latency;
+
+    sched->lastTdSent = now;
+    sched->stats.tdSent++;
+    if(sched->okTail == sched->okHead)
+        return;
+    latency = now - sched->okAt[sched->okTail % SWARM_SCHED_LATENCY_SLOTS];
+    sched->okTail++;
+    sched->stats.latencySamples++;
+    sched->stats.latencyTotalMs += latency;
+    if(latency > sched->stats.latencyMaxMs)
+        sched->stats.latencyMaxMs = latency;
+}
+
+void swarm_schedEstimate(const SwarmScheduler* sched, SwarmSchedEstimate* estimate)
+{
+    unsigned long long total = (unsigned long long)sched->stats.awakeMs + sched->stats.asleepMs;
+    unsigned long long charge;                  // uA * ms
+
+    memset(estimate, 0, sizeof(*estimate));
+    estimate->sent = sched->stats.tdSent;
+    if(sched->stats.latencySamples){
+        estimate->latencyAvgMs = sched->stats.latencyTotalMs / sched->stats.latencySamples;
+        estimate->latencyMaxMs = sched->stats.latencyMaxMs;
+    }
+    if(total == 0)
+        return;
+    charge = (unsigned long long)sched->stats.tdSent * SWARM_SCHED_TX_uAs * 1000ULL;
+    estimate->txCurrent_uA = (unsigned long)(charge / total);
+    charge += (unsigned long long)sched->stats.awakeMs * SWARM_SCHED_AWAKE_uA +
+              (unsigned long long)sched->stats.asleepMs * SWARM_SCHED_SLEEP_uA;
+    estimate->avgCurrent_uA = (unsigned long)(charge / total);
+    estimate->dutyPercent = (unsigned int)(100ULL * sched->stats.awakeMs / total);
+}
@@ -0,0 +1,95 @@
+/*
+ * SwarmScheduler.h
+ *
+ *  Created on: Oct 16, 2026
+ *      Author: MicroTechEE
+ */
+
+#ifndef SWARMSCHEDULER_H_
+#define SWARMSCHEDULER_H_
+
+#include <stdbool.h>
+
+/* Decides when the modem is awake instead of a fixed day long $SL. Once swarm_schedStart() hands it control:
+ *
+ *      Nothing queued and nothing unsent in the modem   -> $SL S=idleSleepS
+ *      Data waiting but the sky is bad                  -> $SL S=backoffSleepS, try again later
+ *          (background RSSI rated Bad, GPS jamming over jammingMax, or no $TD SENT for maxAwakeMs)
+ *      Data waiting and the sky is fine                 -> stay awake, the modem sends on the next pass
+ *      Asleep and the queue reaches wakeDepth           -> wake it early
+ *
+ * Every wake asks for $RT @ and $GJ @ so decisions use fresh numbers, and when the modem's unsent count is all that
+ * keeps it awake $MT C=U is asked again first, a $TD that expired on the modem never says SENT. It also keeps the
+ * books either way (started or not): how long the modem was awake / asleep, how many $TD went out, and the time from
+ * $TD OK to $TD SENT, which swarm_schedEstimate() turns into average current and delivery latency.
+ */
+
+#define SWARM_SCHED_IDLE_SLEEP_s                        3600     // nothing to send
+#define SWARM_SCHED_BACKOFF_SLEEP_s                     900      // something to send, bad conditions
+#define SWARM_SCHED_MIN_AWAKE_ms                        10000    // let $RT / $GJ come back before deciding
+#define SWARM_SCHED_MAX_AWAKE_ms                        7200000  // no $TD SENT in 2h of trying, back off
+#define SWARM_SCHED_WAKE_DEPTH                          8        // queued messages that justify waking early
+#define SWARM_SCHED_JAMMING_MAX                         150      // $GJ jamming_level above this is "bad"
+
+/* M138 datasheet currents, only used for the estimate */
+#define SWARM_SCHED_AWAKE_uA                            26000    // receive / idle
+#define SWARM_SCHED_SLEEP_uA                            33
+#define SWARM_SCHED_TX_uAs                              200000   // per $TD on the air, ~1A for ~0.2s
+#define SWARM_SCHED_LATENCY_SLOTS                       20       // $TD OK times we remember, SWARM_QUEUE_MODEM_MAX
+
+struct SwarmModem;
+
+/* * * * * * * * STRUCTS * * * * * * * * * */
+typedef struct{
+    unsigned long avgCurrent_uA;
+    unsigned long txCurrent_uA;                 // the part of avgCurrent_uA that's $TD on the air, same for any schedule
+    unsigned int dutyPercent;                   // time awake
+    unsigned long latencyAvgMs;                 // $TD OK -> $TD SENT
+    unsigned long latencyMaxMs;
+    unsigned long sent;
+}SwarmSchedEstimate;
+
+typedef struct{
+    unsigned long wakes;                        // early, by us
+    unsigned long sleeps;
+    unsigned long idleSleeps;
+    unsigned long backoffSleeps;
+    unsigned long awakeMs;
+    unsigned long asleepMs;
+    unsigned long tdSent;
+    unsigned long latencySamples;
+    unsigned long latencyTotalMs;
+    unsigned long latencyMaxMs;
+}SwarmSchedStats;
+
+typedef struct{
+    struct SwarmModem* modem;                   // the one it puts to sleep
+    bool running;                               // swarm_schedStart() was called
+    unsigned int idleSleepS;
+    unsigned int backoffSleepS;
+    unsigned long minAwakeMs;
+    unsigned long maxAwakeMs;
+    unsigned int wakeDepth;
+    unsigned char jammingMax;
+
+    bool wasSleeping;
+    unsigned long lastService;
+    unsigned long awakeSince;
+    unsigned long lastTdSent;
+    unsigned long sleepRequested;               // when we sent $SL, 0 = not waiting on $SL OK
+    unsigned long okAt[SWARM_SCHED_LATENCY_SLOTS];
+    unsigned char okHead;
+    unsigned char okTail;
+    SwarmSchedStats stats;
+}SwarmScheduler;
+
+/* * * * * * * * FUNCTIONS * * * * * * * * * */
+void swarm_schedInit(SwarmScheduler* sched, struct SwarmModem* modem, unsigned long now);
+void swarm_schedStart(SwarmScheduler* sched);
+void swarm_schedStop(SwarmScheduler* sched);
+void swarm_schedService(SwarmScheduler* sched, unsigned long now);
+void swarm_schedOnTdOk(SwarmScheduler* sched, unsigned long now);
+void swarm_schedOnTdSent(SwarmScheduler* sched, unsigned long now);
+void swarm_schedEstimate(const SwarmScheduler* sched, SwarmSchedEstimate* estimate);
+
+#endif /* SWARMSCHEDULER_H_ */
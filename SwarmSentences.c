@@ -0,0 +1,544 @@
+/*
+ * SwarmSentences.c
+ *
+ *  Created on: Oct 16, 2026
+ *      Author: MicroTechEE
+ */
+
+// STD C
+#include <stdbool.h>
+
+#include <SwarmSentences.h>
+
+#define SENT_LONG_DIGITS                                9        // fits a 32 bit long whatever the digits are
+#define SENT_LONG_MAX                                   0x7FFFFFFFL  // 32 bit long, what swarm_fieldToFixed() can hold
+
+/* - - - - - - - - - - - - - HELPERS - - - - - - - - - - - - - - - */
+static bool sent_startsWith(const char* text, unsigned int len, const char* prefix)
+{
+    unsigned int i;
+
+    for(i = 0; prefix[i]; i++){
+        if(i >= len || text[i] != prefix[i])
+            return false;
+    }
+    return true;
+}
+
+static bool sent_valueToLong(const SwarmSentence* sentence, unsigned char field, long* value)
+{
+    const char* text;
+    unsigned int len;
+
+    text = swarm_sentenceValue(sentence, field, &len);
+    return swarm_fieldToLong(text, len, value);
+}
+
+static bool sent_valueToFixed(const SwarmSentence* sentence, unsigned char field, unsigned char decimals, long* value)
+{
+    const char* text;
+    unsigned int len;
+
+    text = swarm_sentenceValue(sentence, field, &len);
+    return swarm_fieldToFixed(text, len, decimals, value);
+}
+
+static bool sent_valueToULong(const SwarmSentence* sentence, unsigned char field, unsigned long* value)
+{
+    // epoch seconds need all 32 bits
+    const char* text;
+    unsigned int len;
+    unsigned int i;
+    unsigned long result = 0;
+
+    text = swarm_sentenceValue(sentence, field, &len);
+    if(len == 0)
+        return false;
+    for(i = 0; i < len; i++){
+        if(text[i] < '0' || text[i] > '9' || result > (0xFFFFFFFFUL - (text[i] - '0')) / 10)
+            return false;
+        result = result * 10 + (text[i] - '0');
+    }
+    *value = result;
+    return true;
+}
+
+static bool sent_twoDigits(const char* text, unsigned char* value)
+{
+    if(text[0] < '0' || text[0] > '9' || text[1] < '0' || text[1] > '9')
+        return false;
+    *value = (unsigned char)((text[0] - '0') * 10 + (text[1] - '0'));
+    return true;
+}
+
+static void sent_copyVersion(const char* text, unsigned int len, char* version, unsigned int size)
+{
+    unsigned int i;
+
+    if(size == 0)
+        return;
+    for(i = 0; i < len && i < size - 1; i++)
+        version[i] = text[i];
+    version[i] = '\0';
+}
+
+/* - - - - - - - - - - - - - FUNCTIONS - - - - - - - - - - - - - - - */
+/* - - - - NUMBERS - - - - */
+bool swarm_fieldToLong(const char* text, unsigned int len, long* value)
+{
+    unsigned int i = 0;
+    bool negative = false;
+    long result = 0;
+
+    if(len && (text[0] == '-' || text[0] == '+')){
+        negative = text[0] == '-';
+        i++;
+    }
+    if(i == len || len - i > SENT_LONG_DIGITS)
+        return false;
+    for(; i < len; i++){
+        if(text[i] < '0' || text[i] > '9')
+            return false;
+        result = result * 10 + (text[i] - '0');
+    }
+    *value = negative ? -result : result;
+    return true;
+}
+
+bool swarm_fieldToFixed(const char* text, unsigned int len, unsigned char decimals, long* value)
+{
+    // "-122.0155" with 6 decimals is -122015500. The first digit past the ones we keep rounds, missing ones are 0
+    unsigned int i = 0;
+    bool negative = false;
+    bool point = false;
+    bool digits = false;
+    bool dropped = false;
+    bool roundUp = false;
+    unsigned char kept = 0;
+    long result = 0;
+
+    if(len && (text[0] == '-' || text[0] == '+')){
+        negative = text[0] == '-';
+        i++;
+    }
+    for(; i < len; i++){
+        if(text[i] == '.' && !point){
+            point = true;
+            continue;
+        }
+        if(text[i] < '0' || text[i] > '9')
+            return false;
+        digits = true;
+        if(point && kept == decimals){
+            if(!dropped)
+                roundUp = text[i] >= '5';
+            dropped = true;
+            continue;                           // still has to be a number to the end
+        }
+        if(result > (SENT_LONG_MAX - (text[i] - '0')) / 10)
+            return false;                       // checked before the step, the step itself would be the overflow
+        result = result * 10 + (text[i] - '0');
+        if(point)
+            kept++;
+    }
+    if(!digits)
+        return false;
+    for(; kept < decimals; kept++){
+        if(result > SENT_LONG_MAX / 10)
+            return false;
+        result *= 10;
+    }
+    if(roundUp){
+        if(result == SENT_LONG_MAX)
+            return false;
+        result++;
+    }
+    *value = negative ? -result : result;
+    return true;
+}
+
+bool swarm_fieldHexToLong(const char* text, unsigned int len, unsigned long* value)
+{
+    unsigned int i = 0;
+    unsigned long result = 0;
+    char c;
+
+    if(len > 2 && text[0] == '0' && (text[1] == 'x' || text[1] == 'X'))
+        i = 2;
+    if(i == len || len - i > 2 * sizeof(long))
+        return false;
+    for(; i < len; i++){
+        c = text[i];
+        if(c >= '0' && c <= '9')
+            result = (result << 4) | (c - '0');
+        else if(c >= 'a' && c <= 'f')
+            result = (result << 4) | (c - 'a' + 10);
+        else if(c >= 'A' && c <= 'F')
+            result = (result << 4) | (c - 'A' + 10);
+        else
+            return false;
+    }
+    *value = result;
+    return true;
+}
+
+/* - - - - SENTENCES - - - - */
+bool swarm_sentenceCs(const SwarmSentence* sentence, EasyLong* deviceId)
+{
+    // $CS DI=0x<hex>,DN=M138
+    const char* text;
+    unsigned int len;
+    unsigned long id;
+
+    if(sentence->isError || sentence->fieldCount < 1)
+        return false;
+    text = swarm_sentenceValue(sentence, 0, &len);
+    if(!swarm_fieldHexToLong(text, len, &id))
+        return false;
+    deviceId->asLong = (long)id;
+    return true;
+}
+
+bool swarm_sentenceDt(const SwarmSentence* sentence, Calendar* dateTime)
+{
+    // $DT <YYYYMMDDhhmmss>,<V|I>   anything else is a rate or OK
+    const char* dt = &sentence->line[sentence->fieldStart[0]];
+    unsigned char century;
+    unsigned char year;
+    unsigned char month;
+    unsigned char day;
+    unsigned char hours;
+    unsigned char minutes;
+    unsigned char seconds;
+
+    if(sentence->fieldCount != 2 || sentence->fieldLen[0] != 14 || sentence->line[sentence->fieldStart[1]] != 'V')
+        return false;                           // V means Valid Date/Time, I means Invalid
+    if(!sent_twoDigits(dt, &century) || !sent_twoDigits(dt + 2, &year) || !sent_twoDigits(dt + 4, &month) ||
+       !sent_twoDigits(dt + 6, &day) || !sent_twoDigits(dt + 8, &hours) || !sent_twoDigits(dt + 10, &minutes) ||
+       !sent_twoDigits(dt + 12, &seconds) || month == 0)
+        return false;
+    dateTime->Year = century * 100 + year;
+    dateTime->Month = month - 1;                // RTC Month is 0-starting (January = 0)
+    dateTime->DayOfMonth = day;
+    dateTime->Hours = hours;
+    dateTime->Minutes = minutes;
+    dateTime->Seconds = seconds;
+    return true;
+}
+
+bool swarm_sentenceFv(const SwarmSentence* sentence, char* version, unsigned int size)
+{
+    // $FV <build date>,<version>   the version is always last
+    const char* text;
+    unsigned int len;
+
+    if(sentence->isError || sentence->fieldCount < 1)
+        return false;
+    text = swarm_sentenceField(sentence, sentence->fieldCount - 1, &len);
+    if(len == 0 || text[0] != 'v')
+        return false;
+    sent_copyVersion(text, len, version, size);
+    return true;
+}
+
+bool swarm_sentenceGn(const SwarmSentence* sentence, GPS* gps)
+{
+    // $GN <lat>,<lon>,<alt>,<course>,<speed>
+    long latitude;
+    long longitude;
+    long altitude;
+    long course;
+    long speed;
+
+    if(sentence->fieldCount != 5)               // $GN <rate> or $GN OK
+        return false;
+    if(!sent_valueToFixed(sentence, 0, 6, &latitude) || !sent_valueToFixed(sentence, 1, 6, &longitude) ||
+       !sent_valueToFixed(sentence, 2, 2, &altitude) || !sent_valueToFixed(sentence, 3, 0, &course) ||
+       !sent_valueToFixed(sentence, 4, 0, &speed))
+        return false;
+    gps->latitude = latitude;
+    gps->longitude = longitude;
+    gps->altitude = altitude;
+    gps->course = (unsigned int)course;
+    gps->speed = (unsigned int)speed;
+    return true;
+}
+
+bool swarm_sentenceGs(const SwarmSentence* sentence, GPSStatus* status)
+{
+    // $GS <hdop>,<vdop>,<gnss_sats>,<unused>,<fix>
+    static const char fixNames[][2] = {{'N','F'}, {'D','R'}, {'G','2'}, {'G','3'}, {'D','2'}, {'D','3'}, {'R','K'}, {'T','T'}};
+    const char* fix;
+    unsigned int len;
+    unsigned char i;
+    long hdop;
+    long vdop;
+    long satellites;
+
+    if(sentence->fieldCount != 5)
+        return false;
+    if(!sent_valueToLong(sentence, 0, &hdop) || !sent_valueToLong(sentence, 1, &vdop) ||
+       !sent_valueToLong(sentence, 2, &satellites))
+        return false;
+    fix = swarm_sentenceField(sentence, 4, &len);
+    if(len != 2)
+        return false;
+    for(i = 0; i < sizeof(fixNames) / sizeof(fixNames[0]); i++){
+        if(fix[0] == fixNames[i][0] && fix[1] == fixNames[i][1])
+            break;
+    }
+    if(i == sizeof(fixNames) / sizeof(fixNames[0]))
+        return false;
+    status->hdop = (unsigned int)hdop;
+    status->vdop = (unsigned int)vdop;
+    status->satellites = (unsigned char)satellites;
+    status->fix = (GpsFix)i;
+    return true;
+}
+
+bool swarm_sentenceGj(const SwarmSentence* sentence, GPSJamming* jamming)
+{
+    // $GJ <spoof_state>,<jamming_level>   or $GJ <rate> / OK
+    long spoof;
+    long level;
+
+    if(sentence->fieldCount != 2)
+        return false;
+    if(!sent_valueToLong(sentence, 0, &spoof) || !sent_valueToLong(sentence, 1, &level) || level < 0)
+        return false;
+    jamming->spoofState = (unsigned char)spoof;
+    jamming->level = level > 255 ? 255 : (unsigned char)level;
+    return true;
+}
+
+bool swarm_sentencePw(const SwarmSentence* sentence, PowerStatus* power)
+{
+    // $PW <cpu_volts>,<unused>,<unused>,<unused>,<temp>
+    long voltage;
+    long temperature;
+
+    if(sentence->fieldCount != 5)
+        return false;
+    if(!sent_valueToFixed(sentence, 0, 3, &voltage) || !sent_valueToFixed(sentence, 4, 1, &temperature))
+        return false;
+    power->voltage_mV = (unsigned int)voltage;
+    power->temperature_dC = (int)temperature;
+    return true;
+}
+
+bool swarm_sentenceRt(const SwarmSentence* sentence, RSSI* rssi, bool* isBackground)
+{
+    // $RT RSSI=<rssi_sat>,SNR=<snr>,FDEV=<fdev>,TS=<time>,DI=<sat_id>   or   $RT RSSI=<rssi_bkgnd>
+    const char* text;
+    unsigned int len;
+    long signal;
+    long snr;
+    long fdev;
+    unsigned long id;
+
+    if(sentence->fieldCount == 0 || !sent_startsWith(&sentence->line[sentence->fieldStart[0]], sentence->fieldLen[0], "RSSI="))
+        return false;                           // $RT <rate> / OK
+    if(!sent_valueToFixed(sentence, 0, 0, &signal))
+        return false;
+    if(signal < 0)
+        signal = -signal;                       // the driver works with the magnitude
+
+    if(sentence->fieldCount == 1){
+        rssi->background = (char)signal;
+        *isBackground = true;
+        return true;
+    }
+    if(sentence->fieldCount < 5 || !sent_valueToFixed(sentence, 1, 0, &snr) || !sent_valueToFixed(sentence, 2, 0, &fdev))
+        return false;
+    text = swarm_sentenceValue(sentence, 4, &len);
+    if(!swarm_fieldHexToLong(text, len, &id))
+        return false;
+    rssi->satellite = (char)signal;
+    rssi->snr = (char)snr;
+    rssi->fdev = (int)fdev;
+    rssi->satelliteId = id;
+    *isBackground = false;
+    return true;
+}
+
+bool swarm_sentenceRd(const SwarmSentence* sentence, SwarmRdMessage* message)
+{
+    // $RD AI=<appID>,RSSI=<rssi>,SNR=<snr>,FDEV=<fdev>,<data>   older firmware leaves out the KEY=
+    long appId;
+    long rssi;
+    long snr;
+    long fdev;
+
+    if(sentence->isError || sentence->fieldCount < 5)
+        return false;
+    if(!sent_valueToLong(sentence, 0, &appId) || !sent_valueToLong(sentence, 1, &rssi) ||
+       !sent_valueToLong(sentence, 2, &snr) || !sent_valueToLong(sentence, 3, &fdev))
+        return false;
+    message->appId = (unsigned int)appId;
+    message->rssi = (int)rssi;
+    message->snr = (int)snr;
+    message->fdev = (int)fdev;
+    message->data = &sentence->line[sentence->fieldStart[4]];
+    message->dataLen = sentence->length - sentence->fieldStart[4];   // "quoted ASCII" may have had commas in it
+    return true;
+}
+
+bool swarm_sentenceMm(const SwarmSentence* sentence, SwarmMmReply* reply)
+{
+    const char* text;
+    unsigned int len;
+    long number;
+    unsigned long epoch;
+
+    if(sentence->isError || sentence->fieldCount == 0)
+        return false;
+    reply->count = 0;
+    reply->appId = 0;
+    reply->data = 0;
+    reply->dataLen = 0;
+    reply->msgId = 0;
+    reply->msgIdLen = 0;
+    reply->epoch = 0;
+
+    text = swarm_sentenceField(sentence, 0, &len);
+    if(swarm_sentenceFieldIs(sentence, 0, "OK")){
+        reply->kind = SwarmMmOk;
+    }
+    else if(sent_startsWith(text, len, "AI=") && sentence->fieldCount >= 4){
+        // AI=<appID>,<data>,<msg_id>,<es>
+        if(!sent_valueToLong(sentence, 0, &number))
+            return false;
+        reply->kind = SwarmMmMessage;
+        reply->appId = (unsigned int)number;
+        reply->data = swarm_sentenceField(sentence, 1, &reply->dataLen);
+        reply->msgId = swarm_sentenceValue(sentence, 2, &reply->msgIdLen);
+        if(sent_valueToULong(sentence, 3, &epoch))
+            reply->epoch = epoch;
+    }
+    else if(sentence->fieldCount == 2 && swarm_sentenceFieldIs(sentence, 1, "DELETED")){
+        reply->kind = SwarmMmDeleted;
+        if(swarm_fieldToLong(text, len, &number))
+            reply->count = (unsigned int)number;
+        reply->msgId = text;
+        reply->msgIdLen = len;
+    }
+    else if(sentence->fieldCount == 1 && swarm_fieldToLong(text, len, &number)){
+        reply->kind = SwarmMmCount;
+        reply->count = (unsigned int)number;
+    }
+    else{
+        reply->kind = SwarmMmOther;
+    }
+    return true;
+}
+
+bool swarm_sentenceMt(const SwarmSentence* sentence, unsigned int* count)
+{
+    // $MT <count> answers C=U, anything else (OK, a message listing) isn't a count
+    const char* text;
+    unsigned int len;
+    long number;
+
+    if(sentence->isError || sentence->fieldCount != 1)
+        return false;
+    text = swarm_sentenceField(sentence, 0, &len);
+    if(len == 0 || text[0] == '-' || text[0] == '+' || !swarm_fieldToLong(text, len, &number))
+        return false;
+    *count = (unsigned int)number;
+    return true;
+}
+
+bool swarm_sentenceTd(const SwarmSentence* sentence, SwarmTdReply* reply)
+{
+    long number;
+
+    if(sentence->fieldCount == 0)
+        return false;
+    reply->rssi = 0;
+    reply->snr = 0;
+    reply->fdev = 0;
+    if(sentence->isError){
+        // $TD ERR,<reason>
+        reply->kind = SwarmTdError;
+        reply->msgId = swarm_sentenceField(sentence, 1, &reply->msgIdLen);
+        return true;
+    }
+    if(swarm_sentenceFieldIs(sentence, 0, "OK")){
+        // $TD OK,<msg_id>
+        reply->kind = SwarmTdOk;
+        reply->msgId = swarm_sentenceField(sentence, 1, &reply->msgIdLen);
+        return true;
+    }
+    if(sent_startsWith(&sentence->line[sentence->fieldStart[0]], sentence->fieldLen[0], "SENT")){
+        // $TD SENT RSSI=<rssi>,SNR=<snr>,FDEV=<fdev>,<msg_id>   "SENT RSSI=" is one field, it has no comma
+        reply->kind = SwarmTdSent;
+        if(sent_valueToLong(sentence, 0, &number))
+            reply->rssi = (int)number;
+        if(sent_valueToLong(sentence, 1, &number))
+            reply->snr = (int)number;
+        if(sent_valueToLong(sentence, 2, &number))
+            reply->fdev = (int)number;
+        reply->msgId = swarm_sentenceField(sentence, 3, &reply->msgIdLen);
+        return true;
+    }
+    return false;
+}
+
+bool swarm_sentenceM138(const SwarmSentence* sentence, ModemStatus* modem)
+{
+    // $M138 BOOT,<POWERON|ABORT|...|DEVICEID|VERSION|RUNNING>   $M138 DATETIME   $M138 POSITION   $M138 DEBUG|ERROR,...
+    const char* text;
+    unsigned int len;
+
+    if(sentence->fieldCount == 0)
+        return false;
+    if(swarm_sentenceFieldIs(sentence, 0, "BOOT")){
+        if(swarm_sentenceFieldIs(sentence, 1, "RUNNING")){
+            modem->lastEvent = ModemEventRunning;
+            modem->running = true;
+        }
+        else if(swarm_sentenceFieldIs(sentence, 1, "VERSION")){
+            // BOOT,VERSION,<build date>,<version>
+            text = swarm_sentenceField(sentence, sentence->fieldCount - 1, &len);
+            if(len && text[0] == 'v')
+                sent_copyVersion(text, len, modem->firmware, sizeof(modem->firmware));
+        }
+        else if(!swarm_sentenceFieldIs(sentence, 1, "DEVICEID")){
+            // first line of a boot, whatever we knew about the modem is gone
+            if(modem->lastEvent != ModemEventBoot){
+                modem->boots++;                 // more BOOT lines straight after are the same boot
+                modem->bootReason = ModemBootUnknown;
+            }
+            if(swarm_sentenceFieldIs(sentence, 1, "ABORT")){
+                modem->bootReason = ModemBootAbort;
+                modem->aborts++;
+            }
+            else if(swarm_sentenceFieldIs(sentence, 1, "POWERON") && modem->bootReason == ModemBootUnknown)
+                modem->bootReason = ModemBootPowerOn;
+            else if(swarm_sentenceFieldIs(sentence, 1, "UPDATED"))
+                modem->bootReason = ModemBootUpdated;
+            modem->lastEvent = ModemEventBoot;
+            modem->running = false;
+            modem->dateTimeValid = false;
+            modem->positionValid = false;
+        }
+    }
+    else if(swarm_sentenceFieldIs(sentence, 0, "DATETIME")){
+        modem->lastEvent = ModemEventDateTime;
+        modem->dateTimeValid = true;
+    }
+    else if(swarm_sentenceFieldIs(sentence, 0, "POSITION")){
+        modem->lastEvent = ModemEventPosition;
+        modem->positionValid = true;
+    }
+    else if(swarm_sentenceFieldIs(sentence, 0, "DEBUG")){
+        modem->lastEvent = ModemEventDebug;
+    }
+    else if(swarm_sentenceFieldIs(sentence, 0, "ERROR")){
+        modem->lastEvent = ModemEventError;
+    }
+    else{
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,169 @@
+/*
+ * SwarmSentences.h
+ *
+ *  Created on: Oct 16, 2026
+ *      Author: MicroTechEE
+ */
+
+#ifndef SWARMSENTENCES_H_
+#define SWARMSENTENCES_H_
+
+#include <stdbool.h>
+#include "misc.h"
+#include <SwarmParser.h>
+
+/* Typed parsers for every M138 sentence. SwarmParser already split the line into fields, these turn the fields
+ * into numbers in one pass: each character is looked at once, nothing is written back into the line, there's no
+ * strtok / strtof / strtol / malloc / float, and nothing is kept between calls. Output goes wherever you point it,
+ * so the same functions fill modem->info for the driver and anything else for you.
+ *
+ * Every swarm_sentenceXx() returns true if the sentence carried the data it parses, false for $XX OK, $XX <rate>,
+ * $XX ERR,... or anything malformed. On false the output isn't touched, the last good value stays.
+ *
+ * SwarmRdMessage / SwarmMmReply / SwarmTdReply point into the sentence, they're only good until
+ * swarm_parserRelease(). Copy what you need to keep.
+ */
+
+#define SWARM_FW_VERSION_MAX                            16       // "v1.1.0", cut short if it's ever longer
+
+/* * * * * * * * STRUCTS * * * * * * * * * */
+typedef struct{
+    char background;                            // magnitude, "-104" is 104
+    char satellite;
+    char snr;
+    int fdev;                                   // Hz
+    unsigned long satelliteId;
+}RSSI;
+
+/* No floats anywhere, the MSP430 has no FPU. Decimals come out as integers in a fixed unit, 1e-6 degrees keeps
+ * every digit the M138 sends and still fits a 32 bit long (180000000 < 2^31).
+ */
+typedef struct{
+    long longitude;                             // micro-degrees, -122.0155 is -122015500
+    long latitude;
+    long altitude;                              // cm
+    unsigned int course;                        // degrees, 0 = north
+    unsigned int speed;                         // km/h
+}GPS;
+
+typedef enum{
+    GpsFixNone = 0,                             // NF
+    GpsFixDeadReckoning,                        // DR
+    GpsFix2D,                                   // G2
+    GpsFix3D,                                   // G3
+    GpsFixDiff2D,                               // D2
+    GpsFixDiff3D,                               // D3
+    GpsFixRtk,                                  // RK, GPS + dead reckoning
+    GpsFixTimeOnly                              // TT
+}GpsFix;
+
+typedef struct{
+    unsigned int hdop;                          // x100, 0-9999
+    unsigned int vdop;
+    unsigned char satellites;
+    GpsFix fix;
+}GPSStatus;
+
+typedef struct{
+    unsigned char spoofState;                   // 0 unknown, 1 none, 2 indicated, 3 multiple
+    unsigned char level;                        // 0-255, higher is worse
+}GPSJamming;
+
+typedef struct{
+    unsigned int voltage_mV;
+    int temperature_dC;                         // tenths of a degree C, 32.0 is 320
+}PowerStatus;
+
+typedef enum{
+    ModemEventNone = 0,
+    ModemEventBoot,                             // $M138 BOOT,<anything but RUNNING>
+    ModemEventRunning,                          // $M138 BOOT,RUNNING
+    ModemEventDateTime,                         // $M138 DATETIME, $DT is good from here
+    ModemEventPosition,                         // $M138 POSITION, $GN is good from here
+    ModemEventDebug,
+    ModemEventError
+}ModemEvent;
+
+typedef enum{
+    ModemBootUnknown = 0,                       // a BOOT line we don't know, or boot noise
+    ModemBootPowerOn,                           // $M138 BOOT,POWERON, power was applied or a reset pin / watchdog
+    ModemBootAbort,                             // $M138 BOOT,ABORT, its firmware crashed, the POWERON after it is the same boot
+    ModemBootUpdated                            // $M138 BOOT,UPDATED, new firmware
+}ModemBootReason;
+
+typedef struct{
+    ModemEvent lastEvent;
+    ModemBootReason bootReason;                 // why the last boot happened
+    bool running;                               // saw BOOT,RUNNING since the last BOOT
+    bool dateTimeValid;
+    bool positionValid;
+    unsigned int boots;                         // ABORT then POWERON counts once
+    unsigned int aborts;
+    char firmware[SWARM_FW_VERSION_MAX];        // from $FV or $M138 BOOT,VERSION
+}ModemStatus;
+
+typedef struct{
+    unsigned int appId;
+    int rssi;                                   // dBm
+    int snr;                                    // dB
+    int fdev;                                   // Hz
+    const char* data;                           // in the line, hex or "quoted ASCII" as the sender wrote it
+    unsigned int dataLen;
+}SwarmRdMessage;
+
+typedef enum{
+    SwarmMmOk = 0,                              // $MM OK
+    SwarmMmCount,                               // $MM <count>
+    SwarmMmMessage,                             // $MM AI=<appID>,<data>,<msg_id>,<es>
+    SwarmMmDeleted,                             // $MM <count>,DELETED  or  $MM <msg_id>,DELETED
+    SwarmMmOther                                // a listing, rate, or something newer than this code
+}SwarmMmKind;
+
+typedef struct{
+    SwarmMmKind kind;
+    unsigned int count;
+    unsigned int appId;
+    const char* data;
+    unsigned int dataLen;
+    const char* msgId;                          // text, too big for a long and only ever sent back to the modem
+    unsigned int msgIdLen;
+    unsigned long epoch;                        // when the modem received it
+}SwarmMmReply;
+
+typedef enum{
+    SwarmTdOk = 0,                              // $TD OK,<msg_id>
+    SwarmTdSent,                                // $TD SENT RSSI=<rssi>,SNR=<snr>,FDEV=<fdev>,<msg_id>
+    SwarmTdError                                // $TD ERR,<reason>
+}SwarmTdKind;
+
+typedef struct{
+    SwarmTdKind kind;
+    int rssi;                                   // SENT only
+    int snr;
+    int fdev;
+    const char* msgId;                          // or the ERR reason
+    unsigned int msgIdLen;
+}SwarmTdReply;
+
+/* * * * * * * * FUNCTIONS * * * * * * * * * */
+/* Numbers, for your own sentences too */
+bool swarm_fieldToLong(const char* text, unsigned int len, long* value);           // [-]digits, nothing else
+bool swarm_fieldToFixed(const char* text, unsigned int len, unsigned char decimals, long* value);   // [-]digits[.digits] x 10^decimals
+bool swarm_fieldHexToLong(const char* text, unsigned int len, unsigned long* value);   // [0x]hex
+
+/* One per sentence */
+bool swarm_sentenceCs(const SwarmSentence* sentence, EasyLong* deviceId);
+bool swarm_sentenceDt(const SwarmSentence* sentence, Calendar* dateTime);          // only a V (valid) time
+bool swarm_sentenceFv(const SwarmSentence* sentence, char* version, unsigned int size);
+bool swarm_sentenceGn(const SwarmSentence* sentence, GPS* gps);
+bool swarm_sentenceGs(const SwarmSentence* sentence, GPSStatus* status);
+bool swarm_sentenceGj(const SwarmSentence* sentence, GPSJamming* jamming);
+bool swarm_sentencePw(const SwarmSentence* sentence, PowerStatus* power);
+bool swarm_sentenceRt(const SwarmSentence* sentence, RSSI* rssi, bool* isBackground);
+bool swarm_sentenceRd(const SwarmSentence* sentence, SwarmRdMessage* message);
+bool swarm_sentenceMm(const SwarmSentence* sentence, SwarmMmReply* reply);
+bool swarm_sentenceMt(const SwarmSentence* sentence, unsigned int* count);         // $MT <count>
+bool swarm_sentenceTd(const SwarmSentence* sentence, SwarmTdReply* reply);
+bool swarm_sentenceM138(const SwarmSentence* sentence, ModemStatus* modem);
+
+#endif /* SWARMSENTENCES_H_ */
@@ -0,0 +1,217 @@
+/*
+ * SwarmStats.c
+ *
+ *  Created on: Oct 16, 2026
+ *      Author: MicroTechEE
+ */
+
+// STD C
+#include <stdbool.h>
+#include "string.h"
+
+#include <Message.h>
+#include <SwarmMSP430.h>
+#include <SwarmCodec.h>
+#include <SwarmStats.h>
+
+/* - - - - - - - - - - - - - GLOBALS - - - - - - - - - - - - - - - */
+static const unsigned int bucketMs[SWARM_STATS_BUCKETS - 1] = SWARM_STATS_BUCKET_ms;
+
+/* - - - - - - - - - - - - - HELPERS - - - - - - - - - - - - - - - */
+static SwarmStatsHeader* stats_find(SwarmStats* stats, unsigned int header, bool add)
+{
+    unsigned char i;
+
+    for(i = 0; i < stats->headers; i++){
+        if(stats->header[i].header == header)
+            return &stats->header[i];
+    }
+    if(!add || stats->headers >= SWARM_STATS_HEADERS)
+        return 0;
+    memset(&stats->header[i], 0, sizeof(stats->header[i]));
+    stats->header[i].header = header;
+    stats->headers++;
+    return &stats->header[i];
+}
+
+static unsigned int stats_ticks(const SwarmStats* stats)
+{
+    const SwarmHal* hal = stats->modem->hal;
+
+    return hal->ticks ? hal->ticks() : 0;
+}
+
+/* - - - - - - - - - - - - - FUNCTIONS - - - - - - - - - - - - - - - */
+void swarm_statsInit(SwarmStats* stats, struct SwarmModem* modem)
+{
+    memset(stats, 0, sizeof(*stats));
+    stats->modem = modem;
+    stats->txHead = modem->txRing.head;
+}
+
+void swarm_statsOnTx(SwarmStats* stats, unsigned int header)
+{
+    // bytes are whatever the ring grew by since last time, so nothing that bypassed a hook is missed
+    SwarmStatsHeader* h = stats_find(stats, header, true);
+    unsigned int head = stats->modem->txRing.head;
+
+    stats->txBytes += (unsigned int)(head - stats->txHead);
+    stats->txHead = head;
+    stats->txSentences++;
+    if(!h)
+        return;
+    h->tx++;
+    if(!h->waiting){
+        h->waiting = true;
+        h->txAt = stats->modem->hal->millis();
+    }
+}
+
+void swarm_statsOnRx(SwarmStats* stats, const SwarmSentence* sentence)
+{
+    SwarmStatsHeader* h;
+    unsigned long ms;
+    unsigned char b;
+
+    stats->rxSentences++;
+    stats->rxBytes += sentence->length;
+    if(SWARM_STATS_MESSAGE_HIGH_WATER() > stats->messageHighWater)
+        stats->messageHighWater = SWARM_STATS_MESSAGE_HIGH_WATER();
+    if(sentence->status == SwarmSentenceBadChecksum || sentence->status == SwarmSentenceNoChecksum){
+        stats->badChecksum++;
+        return;                                 // can't trust the header either
+    }
+    if(sentence->status == SwarmSentenceNoise)
+        return;
+
+    h = stats_find(stats, sentence->header, true);
+    if(sentence->isError)
+        stats->errors++;
+    if(!h)
+        return;
+    h->replies++;
+    if(sentence->isError)
+        h->errors++;
+    if(!h->waiting)
+        return;
+
+    h->waiting = false;
+    ms = stats->modem->hal->millis() - h->txAt;
+    h->timed++;
+    h->latencySumMs += ms;
+    if(ms > h->latencyMaxMs)
+        h->latencyMaxMs = ms;
+    for(b = 0; b < SWARM_STATS_BUCKETS - 1 && ms >= bucketMs[b]; b++)
+        ;
+    h->latency[b]++;
+}
+
+void swarm_statsParseBegin(SwarmStats* stats)
+{
+    stats->parseStart = stats_ticks(stats);
+}
+
+void swarm_statsParseEnd(SwarmStats* stats, const SwarmSentence* sentence)
+{
+    SwarmStatsHeader* h = stats_find(stats, sentence->header, false);
+    unsigned int ticks = stats_ticks(stats) - stats->parseStart;   // a 16 bit timer wraps, the difference doesn't
+
+    if(!h)
+        return;
+    h->parseTicks += ticks;
+    if(ticks > h->parseMaxTicks)
+        h->parseMaxTicks = ticks;
+}
+
+const SwarmStatsHeader* swarm_statsHeader(const SwarmStats* stats, unsigned int header)
+{
+    return stats_find((SwarmStats*)stats, header, false);
+}
+
+unsigned int swarm_statsSnapshot(const SwarmStats* stats, unsigned char* buff, unsigned int max)
+{
+    // version, the totals, then one record per header until the next one wouldn't fit
+    const SwarmStatsHeader* h;
+    SwarmCodec codec;
+    unsigned int bits;
+    unsigned char i;
+    unsigned char b;
+
+    swarm_codecInit(&codec, buff, max);
+    swarm_codecPutVarint(&codec, SWARM_STATS_VERSION);
+    swarm_codecPutVarint(&codec, stats->txBytes);
+    swarm_codecPutVarint(&codec, stats->rxBytes);
+    swarm_codecPutVarint(&codec, stats->txSentences);
+    swarm_codecPutVarint(&codec, stats->rxSentences);
+    swarm_codecPutVarint(&codec, stats->badChecksum);
+    swarm_codecPutVarint(&codec, stats->errors);
+    swarm_codecPutVarint(&codec, stats->messageHighWater);
+    if(codec.overflow)
+        return 0;
+
+    for(i = 0; i < stats->headers; i++){
+        h = &stats->header[i];
+        bits = codec.bits;
+        swarm_codecPutBits(&codec, h->header, 16);   // two letters, never 0, that's how the reader knows it's done
+        swarm_codecPutVarint(&codec, h->tx);
+        swarm_codecPutVarint(&codec, h->replies);
+        swarm_codecPutVarint(&codec, h->errors);
+        swarm_codecPutVarint(&codec, h->timed);
+        swarm_codecPutVarint(&codec, h->latencySumMs);
+        swarm_codecPutVarint(&codec, h->latencyMaxMs);
+        for(b = 0; b < SWARM_STATS_BUCKETS; b++)
+            swarm_codecPutVarint(&codec, h->latency[b]);
+        swarm_codecPutVarint(&codec, h->parseTicks);
+        swarm_codecPutVarint(&codec, h->parseMaxTicks);
+        if(codec.overflow){
+            codec.bits = bits;                  // this one didn't fit, the ones before did
+            codec.overflow = false;
+            break;
+        }
+    }
+    return swarm_codecLength(&codec);
+}
+
+bool swarm_statsDecode(const unsigned char* buff, unsigned int len, SwarmStats* stats)
+{
+    SwarmStatsHeader* h;
+    SwarmCodec codec;
+    unsigned int header;
+    unsigned char b;
+
+    memset(stats, 0, sizeof(*stats));
+    swarm_codecInit(&codec, (unsigned char*)buff, len);
+    if(swarm_codecGetVarint(&codec) != SWARM_STATS_VERSION)
+        return false;
+    stats->txBytes = swarm_codecGetVarint(&codec);
+    stats->rxBytes = swarm_codecGetVarint(&codec);
+    stats->txSentences = swarm_codecGetVarint(&codec);
+    stats->rxSentences = swarm_codecGetVarint(&codec);
+    stats->badChecksum = swarm_codecGetVarint(&codec);
+    stats->errors = swarm_codecGetVarint(&codec);
+    stats->messageHighWater = (unsigned int)swarm_codecGetVarint(&codec);
+    if(codec.overflow)
+        return false;
+
+    while(stats->headers < SWARM_STATS_HEADERS && codec.bits + 16 <= len * 8){
+        header = (unsigned int)swarm_codecGetBits(&codec, 16);
+        if(header == 0)
+            break;                              // padding
+        h = &stats->header[stats->headers];
+        h->header = header;
+        h->tx = swarm_codecGetVarint(&codec);
+        h->replies = swarm_codecGetVarint(&codec);
+        h->errors = swarm_codecGetVarint(&codec);
+        h->timed = swarm_codecGetVarint(&codec);
+        h->latencySumMs = swarm_codecGetVarint(&codec);
+        h->latencyMaxMs = swarm_codecGetVarint(&codec);
+        for(b = 0; b < SWARM_STATS_BUCKETS; b++)
+            h->latency[b] = (unsigned int)swarm_codecGetVarint(&codec);
+        h->parseTicks = swarm_codecGetVarint(&codec);
+        h->parseMaxTicks = (unsigned int)swarm_codecGetVarint(&codec);
+        if(codec.overflow)
+            return false;
+        stats->headers++;
+    }
+    return true;
+}
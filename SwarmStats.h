@@ -0,0 +1,102 @@
+/*
+ * SwarmStats.h
+ *
+ *  Created on: Oct 16, 2026
+ *      Author: MicroTechEE
+ */
+
+#ifndef SWARMSTATS_H_
+#define SWARMSTATS_H_
+
+#include <stdbool.h>
+#include <SwarmParser.h>
+
+/* Field numbers for the driver, off unless SWARM_STATS_ENABLE is 1. Off, every hook below is an empty macro and
+ * SwarmModem doesn't even have the struct, so it costs nothing. On, per SAT_HEADER_* seen:
+ *
+ *      commands sent, replies, ERRs
+ *      command -> first reply latency in ms, sum / max and a histogram (SWARM_STATS_BUCKET_ms edges)
+ *      time spent in its swarm_parseXxMessage(), in HAL ticks (hal->ticks(), a free running hardware timer)
+ *
+ * plus bytes and sentences both ways, bad checksums and the Message pool high water. Only the first reply after a
+ * command is timed, a burst of $TD gets its first $TD OK timed and the rest counted.
+ *
+ *      n = swarm_statsSnapshot(&modem->stats, buff, 64);      // varints, ride along in a $TD
+ *      swarm_statsDecode(buff, n, &ground);                   // on the ground
+ *
+ * The snapshot puts headers in the order they were first seen and stops at the last one that fits.
+ */
+
+#ifndef SWARM_STATS_ENABLE
+#define SWARM_STATS_ENABLE                              0
+#endif
+#ifndef SWARM_STATS_MESSAGE_HIGH_WATER
+#define SWARM_STATS_MESSAGE_HIGH_WATER()                0        // your Message System's pool high water, if it keeps one
+#endif
+
+#define SWARM_STATS_HEADERS                             16       // different SAT_HEADER_* tracked, the rest only in the totals
+#define SWARM_STATS_BUCKETS                             8
+#define SWARM_STATS_BUCKET_ms                           {50, 100, 250, 500, 1000, 2500, 5000}   // the last bucket is the rest
+#define SWARM_STATS_VERSION                             1        // first varint of a snapshot
+
+struct SwarmModem;
+
+/* * * * * * * * STRUCTS * * * * * * * * * */
+typedef struct{
+    unsigned int header;                        // SAT_HEADER_*
+    bool waiting;                               // a command went out, its first reply isn't back
+    unsigned long txAt;                         // ms, when it went out
+    unsigned long tx;
+    unsigned long replies;                      // every sentence with this header, unsolicited too
+    unsigned long errors;                       // $XX ERR,...
+    unsigned long timed;                        // replies that had a command to time against
+    unsigned long latencySumMs;
+    unsigned long latencyMaxMs;
+    unsigned int latency[SWARM_STATS_BUCKETS];
+    unsigned long parseTicks;                   // sum
+    unsigned int parseMaxTicks;
+}SwarmStatsHeader;
+
+typedef struct{
+    struct SwarmModem* modem;
+    unsigned int txHead;                        // modem->txRing.head last time we counted
+    unsigned long txBytes;
+    unsigned long rxBytes;                      // in sentences that reached the driver, '$' to '*'
+    unsigned long txSentences;
+    unsigned long rxSentences;
+    unsigned long badChecksum;                  // and no checksum
+    unsigned long errors;                       // $XX ERR, every header
+    unsigned int messageHighWater;
+    unsigned int parseStart;                    // hal->ticks() at SWARM_STATS_PARSE_BEGIN
+    SwarmStatsHeader header[SWARM_STATS_HEADERS];
+    unsigned char headers;
+}SwarmStats;
+
+/* * * * * * * * HOOKS * * * * * * * * * */
+#if SWARM_STATS_ENABLE
+#define SWARM_STATS_INIT(modem)                         swarm_statsInit(&(modem)->stats, (modem))
+#define SWARM_STATS_TX(modem, header)                   swarm_statsOnTx(&(modem)->stats, (header))
+#define SWARM_STATS_RX(modem, sentence)                 swarm_statsOnRx(&(modem)->stats, (sentence))
+#define SWARM_STATS_PARSE_BEGIN(modem)                  swarm_statsParseBegin(&(modem)->stats)
+#define SWARM_STATS_PARSE_END(modem, sentence)          swarm_statsParseEnd(&(modem)->stats, (sentence))
+#else
+#define SWARM_STATS_INIT(modem)
+#define SWARM_STATS_TX(modem, header)
+#define SWARM_STATS_RX(modem, sentence)
+#define SWARM_STATS_PARSE_BEGIN(modem)
+#define SWARM_STATS_PARSE_END(modem, sentence)
+#endif
+
+/* * * * * * * * FUNCTIONS * * * * * * * * * */
+void swarm_statsInit(SwarmStats* stats, struct SwarmModem* modem);
+void swarm_statsOnTx(SwarmStats* stats, unsigned int header);                       // a sentence went into the TX ring
+void swarm_statsOnRx(SwarmStats* stats, const SwarmSentence* sentence);             // before it's handled
+void swarm_statsParseBegin(SwarmStats* stats);
+void swarm_statsParseEnd(SwarmStats* stats, const SwarmSentence* sentence);          // hal->ticks() since the begin
+const SwarmStatsHeader* swarm_statsHeader(const SwarmStats* stats, unsigned int header);   // 0 if never seen
+
+/* Snapshot, both ends */
+unsigned int swarm_statsSnapshot(const SwarmStats* stats, unsigned char* buff, unsigned int max);   // bytes written
+bool swarm_statsDecode(const unsigned char* buff, unsigned int len, SwarmStats* stats);
+
+#endif /* SWARMSTATS_H_ */
@@ -0,0 +1,206 @@
+/*
+ * SwarmTx.c
+ *
+ *  Created on: Oct 16, 2026
+ *      Author: MicroTechEE
+ */
+
+// STD C
+#include <stdbool.h>
+#include "string.h"
+
+#include <SwarmTx.h>
+
+#define TX_MASK                                         (SWARM_TX_RING_SIZE - 1)
+
+static const unsigned char hexNibble[16] = {'0','1','2','3','4','5','6','7','8','9','A','B','C','D','E','F'};
+
+/* - - - - - - - - - - - - - HELPERS - - - - - - - - - - - - - - - */
+static bool tx_hasPendingSlot(SwarmTxRing* ring)
+{
+    if((unsigned char)(ring->pendingHead - ring->pendingTail) >= SWARM_TX_MAX_PENDING)
+        swarm_txService(ring);                          // we're in the main loop, retire what the ISR finished
+    return (unsigned char)(ring->pendingHead - ring->pendingTail) < SWARM_TX_MAX_PENDING;
+}
+
+static SwarmTxTag tx_publish(SwarmTxRing* ring, unsigned int newHead)
+{
+    unsigned char slot;
+    SwarmTxTag tag;
+
+    tag = ring->nextTag++;
+    if(ring->nextTag == 0)
+        ring->nextTag = 1;                              // 0 is reserved for "not queued"
+
+    slot = ring->pendingHead % SWARM_TX_MAX_PENDING;
+    ring->pendingEnd[slot] = newHead;
+    ring->pendingTag[slot] = tag;
+    ring->pendingHead++;
+
+    ring->head = newHead;                               // publish last, the ISR can take it from here
+    return tag;
+}
+
+/* - - - - - - - - - - - - - FUNCTIONS - - - - - - - - - - - - - - - */
+/* - - - - MAIN LOOP - - - - */
+void swarm_txInit(SwarmTxRing* ring)
+{
+    ring->head = 0;
+    ring->tail = 0;
+    ring->pendingHead = 0;
+    ring->pendingTail = 0;
+    ring->nextTag = 1;
+    ring->lastComplete = 0;
+    ring->onComplete = 0;
+}
+
+void swarm_txSetCallback(SwarmTxRing* ring, void (*onComplete)(SwarmTxTag tag))
+{
+    ring->onComplete = onComplete;
+}
+
+unsigned int swarm_txFree(const SwarmTxRing* ring)
+{
+    return SWARM_TX_RING_SIZE - (unsigned int)(ring->head - ring->tail);
+}
+
+SwarmTxTag swarm_txWrite(SwarmTxRing* ring, const unsigned char* data, unsigned int len)
+{
+    unsigned int head = ring->head;
+    unsigned int first;
+
+    if(len == 0 || len > swarm_txFree(ring) || !tx_hasPendingSlot(ring))
+        return 0;
+
+    // copy in up to two pieces if we wrap around the end of the buffer
+    first = SWARM_TX_RING_SIZE - (head & TX_MASK);
+    if(first > len)
+        first = len;
+    memcpy(&ring->buff[head & TX_MASK], data, first);
+    memcpy(&ring->buff[0], data + first, len - first);
+
+    return tx_publish(ring, head + len);
+}
+
+void swarm_txService(SwarmTxRing* ring)
+{
+    unsigned int tail = ring->tail;
+    unsigned char slot;
+
+    while(ring->pendingTail != ring->pendingHead){
+        slot = ring->pendingTail % SWARM_TX_MAX_PENDING;
+        if((int)(tail - ring->pendingEnd[slot]) < 0)
+            return;                                     // the ISR isn't through this one yet
+        ring->lastComplete = ring->pendingTag[slot];
+        ring->pendingTail++;
+        if(ring->onComplete)
+            ring->onComplete(ring->lastComplete);
+    }
+}
+
+bool swarm_txIsComplete(const SwarmTxRing* ring, SwarmTxTag tag)
+{
+    unsigned char i;
+
+    if(tag == 0)
+        return false;
+    // if it's still in the pending list, the UART hasn't had all of it yet
+    for(i = ring->pendingTail; i != ring->pendingHead; i++){
+        if(ring->pendingTag[i % SWARM_TX_MAX_PENDING] == tag)
+            return (int)(ring->tail - ring->pendingEnd[i % SWARM_TX_MAX_PENDING]) >= 0;
+    }
+    return true;
+}
+
+bool swarm_txIsIdle(const SwarmTxRing* ring)
+{
+    return ring->head == ring->tail;
+}
+
+/* - - - - BUILDING IN PLACE - - - - */
+bool swarm_txBegin(SwarmTxRing* ring, SwarmTxWriter* writer)
+{
+    writer->ring = ring;
+    writer->head = ring->head;
+    writer->limit = ring->tail + SWARM_TX_RING_SIZE;   // the ISR only ever makes more room than this
+    writer->cs = 0;
+    writer->overflow = !tx_hasPendingSlot(ring);
+    return !writer->overflow;
+}
+
+void swarm_txPutByte(SwarmTxWriter* writer, unsigned char byte)
+{
+    if(writer->head == writer->limit){
+        writer->overflow = true;
+        return;
+    }
+    if(byte != '$' || writer->head != writer->ring->head)
+        writer->cs ^= byte;                             // '$' at the start isn't part of the checksum
+    writer->ring->buff[writer->head & TX_MASK] = byte;
+    writer->head++;
+}
+
+void swarm_txPutString(SwarmTxWriter* writer, const char* str)
+{
+    while(*str)
+        swarm_txPutByte(writer, (unsigned char)*str++);
+}
+
+void swarm_txPutBytes(SwarmTxWriter* writer, const unsigned char* data, unsigned int len)
+{
+    unsigned int i;
+
+    for(i = 0; i < len; i++)
+        swarm_txPutByte(writer, data[i]);
+}
+
+void swarm_txPutHex(SwarmTxWriter* writer, const unsigned char* data, unsigned int len)
+{
+    // Two ASCII chars per byte straight into the ring, checksum as we go
+    unsigned int i;
+
+    for(i = 0; i < len; i++){
+        swarm_txPutByte(writer, hexNibble[data[i] >> 4]);
+        swarm_txPutByte(writer, hexNibble[data[i] & 0x0F]);
+    }
+}
+
+SwarmTxTag swarm_txEnd(SwarmTxWriter* writer)
+{
+    unsigned char cs = writer->cs;
+
+    swarm_txPutByte(writer, '*');
+    swarm_txPutByte(writer, hexNibble[cs >> 4]);
+    swarm_txPutByte(writer, hexNibble[cs & 0x0F]);
+    swarm_txPutByte(writer, '\n');
+    if(writer->overflow)
+        return 0;                                       // head was never moved, as if it never happened
+    return tx_publish(writer->ring, writer->head);
+}
+
+/* - - - - TX ISR / DMA - - - - */
+unsigned int swarm_txPeek(const SwarmTxRing* ring, const unsigned char** data)
+{
+    unsigned int tail = ring->tail;
+    unsigned int count = (unsigned int)(ring->head - tail);
+    unsigned int contiguous = SWARM_TX_RING_SIZE - (tail & TX_MASK);
+
+    *data = &ring->buff[tail & TX_MASK];
+    return count < contiguous ? count : contiguous;      // DMA needs one contiguous block
+}
+
+void swarm_txConsume(SwarmTxRing* ring, unsigned int len)
+{
+    ring->tail += len;
+}
+
+bool swarm_txPop(SwarmTxRing* ring, unsigned char* byte)
+{
+    unsigned int tail = ring->tail;
+
+    if(tail == ring->head)
+        return false;
+    *byte = ring->buff[tail & TX_MASK];
+    ring->tail = tail + 1;
+    return true;
+}
@@ -0,0 +1,82 @@
+/*
+ * SwarmTx.h
+ *
+ *  Created on: Oct 16, 2026
+ *      Author: MicroTechEE
+ */
+
+#ifndef SWARMTX_H_
+#define SWARMTX_H_
+
+#include <stdbool.h>
+
+/* TX ring between the main loop and the UART. swarm_sendData() copies a sentence in and returns right away,
+ * the eUSCI TX interrupt or DMA (see the HAL) drains it in the background. Nothing on the send path waits.
+ *
+ *      Producer: main loop only        -> swarm_txWrite()
+ *      Consumer: TX ISR / DMA only     -> swarm_txPeek() + swarm_txConsume(), or swarm_txPop() a byte at a time
+ *
+ * head is only written by the producer and tail only by the consumer, both are single 16-bit writes on the
+ * MSP430 so no interrupt disabling is needed. Every sentence gets a tag, swarm_txIsComplete() or the
+ * completion callback (called from swarm_txService() in the main loop, never from the ISR) tell you when
+ * the last byte of it has been handed to the UART.
+ *
+ * Sentences can also be built right in the ring with a SwarmTxWriter, no buffer anywhere else:
+ *
+ *      swarm_txBegin(&ring, &w);  swarm_txPutString(&w, "$TD ");  swarm_txPutHex(&w, data, n);  tag = swarm_txEnd(&w);
+ *
+ * The writer keeps the running checksum and swarm_txEnd() appends "*xx\n". Nothing is visible to the ISR until
+ * swarm_txEnd(), and if the sentence didn't fit it returns 0 and the ring is left exactly as it was.
+ */
+
+#define SWARM_TX_RING_SIZE                              512      // MUST be a power of 2, a full $TD is ~410 bytes
+#define SWARM_TX_MAX_PENDING                            8        // sentences in the ring at once
+
+/* * * * * * * * STRUCTS * * * * * * * * * */
+typedef unsigned int SwarmTxTag;                                 // 0 means it wasn't queued
+
+typedef struct{
+    unsigned char buff[SWARM_TX_RING_SIZE];
+    volatile unsigned int head;                                  // free running, written by producer
+    volatile unsigned int tail;                                  // free running, written by consumer
+    unsigned int pendingEnd[SWARM_TX_MAX_PENDING];               // head value after each queued sentence
+    SwarmTxTag pendingTag[SWARM_TX_MAX_PENDING];
+    unsigned char pendingHead;
+    unsigned char pendingTail;
+    SwarmTxTag nextTag;
+    SwarmTxTag lastComplete;
+    void (*onComplete)(SwarmTxTag tag);
+}SwarmTxRing;
+
+typedef struct{
+    SwarmTxRing* ring;
+    unsigned int head;                                           // where the next byte goes, not published yet
+    unsigned int limit;                                          // tail + SWARM_TX_RING_SIZE when we started
+    unsigned char cs;                                            // NMEA checksum so far, '$' excluded
+    bool overflow;
+}SwarmTxWriter;
+
+/* * * * * * * * FUNCTIONS * * * * * * * * * */
+/* Main loop */
+void swarm_txInit(SwarmTxRing* ring);
+void swarm_txSetCallback(SwarmTxRing* ring, void (*onComplete)(SwarmTxTag tag));
+unsigned int swarm_txFree(const SwarmTxRing* ring);
+SwarmTxTag swarm_txWrite(SwarmTxRing* ring, const unsigned char* data, unsigned int len);
+void swarm_txService(SwarmTxRing* ring);
+bool swarm_txIsComplete(const SwarmTxRing* ring, SwarmTxTag tag);
+bool swarm_txIsIdle(const SwarmTxRing* ring);
+
+/* Building a sentence in place */
+bool swarm_txBegin(SwarmTxRing* ring, SwarmTxWriter* writer);
+void swarm_txPutByte(SwarmTxWriter* writer, unsigned char byte);
+void swarm_txPutString(SwarmTxWriter* writer, const char* str);
+void swarm_txPutBytes(SwarmTxWriter* writer, const unsigned char* data, unsigned int len);
+void swarm_txPutHex(SwarmTxWriter* writer, const unsigned char* data, unsigned int len);
+SwarmTxTag swarm_txEnd(SwarmTxWriter* writer);
+
+/* TX ISR / DMA */
+unsigned int swarm_txPeek(const SwarmTxRing* ring, const unsigned char** data);
+void swarm_txConsume(SwarmTxRing* ring, unsigned int len);
+bool swarm_txPop(SwarmTxRing* ring, unsigned char* byte);
+
+#endif /* SWARMTX_H_ */
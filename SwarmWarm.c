@@ -0,0 +1,168 @@
+/*
+ * SwarmWarm.c
+ *
+ *  Created on: Oct 16, 2026
+ *      Author: MicroTechEE
+ */
+
+// STD C
+#include <stdbool.h>
+#include <stddef.h>
+#include "string.h"
+
+#include <Message.h>
+#include <SwarmMSP430.h>
+#include <SwarmWarm.h>
+
+/* - - - - - - - - - - - - - GLOBALS - - - - - - - - - - - - - - - */
+const char* const swarmRateCommands[SwarmRateCount] = {
+    SAT_CMD_DATE_TIME,
+    SAT_CMD_GPS_JAMMING,
+    SAT_CMD_GPS_INFO,
+    SAT_CMD_GPS_FIX_QUALITY,
+    SAT_CMD_POWER_STATUS,
+    SAT_CMD_RECEIVE_TEST
+};
+
+/* - - - - - - - - - - - - - HELPERS - - - - - - - - - - - - - - - */
+static unsigned int warm_crc(const SwarmWarmStore* store)
+{
+    return swarm_crc16((const unsigned char*)&store->deviceId,
+                       sizeof(*store) - offsetof(SwarmWarmStore, deviceId), 0xFFFF);
+}
+
+static char warm_gpioMode(void)
+{
+    return SAT_GPIO_CONFIGURATION[sizeof(SAT_GPIO_CONFIGURATION) - 2];   // "$GP 3" -> '3'
+}
+
+static void warm_commit(SwarmWarmStore* store)
+{
+    // magic last, a reset anywhere before it leaves a record that doesn't check out and the next start is cold
+    store->crc = warm_crc(store);
+    store->magic = SWARM_WARM_MAGIC;
+}
+
+static void warm_formatSeconds(char* param, unsigned long seconds)
+{
+    char digits[10];
+    unsigned int n = 0;
+
+    do{
+        digits[n++] = '0' + seconds % 10;
+        seconds /= 10;
+    }while(seconds && n < sizeof(digits));
+    while(n)
+        *param++ = digits[--n];
+    *param = '\0';
+}
+
+static void warm_rateDone(struct SwarmModem* modem, unsigned int header, SwarmReply result, const SwarmSentence* reply)
+{
+    SwarmWarm* warm = &modem->warm;
+    unsigned char i;
+    bool valid;
+
+    (void)reply;
+    if(result != SwarmReplyOk)
+        return;
+    for(i = 0; i < SwarmRateCount; i++){
+        if(header == ((unsigned int)swarmRateCommands[i][1] << 8 | (unsigned char)swarmRateCommands[i][2]))
+            break;
+    }
+    if(i == SwarmRateCount)
+        return;
+    warm->rateHave[i] = warm->rateWant[i];
+    if(warm->store == 0 || warm->store->rate[i] == warm->rateWant[i])
+        return;
+
+    valid = swarm_warmIsValid(warm);
+    SWARM_FRAM_WRITE_BEGIN();
+    warm->store->magic = 0;
+    warm->store->rate[i] = warm->rateWant[i];
+    if(valid)
+        warm_commit(warm->store);               // a bad record stays bad, the next init's swarm_warmSave() makes it good
+    SWARM_FRAM_WRITE_END();
+    warm->stats.saves++;
+}
+
+/* - - - - - - - - - - - - - FUNCTIONS - - - - - - - - - - - - - - - */
+void swarm_warmAttach(struct SwarmModem* modem, SwarmWarmStore* store)
+{
+    modem->warm.modem = modem;
+    modem->warm.store = store;
+}
+
+bool swarm_warmIsValid(const SwarmWarm* warm)
+{
+    const SwarmWarmStore* store = warm->store;
+
+    return store != 0 && store->magic == SWARM_WARM_MAGIC && store->crc == warm_crc(store) &&
+           store->gpioMode == warm_gpioMode();  // built with a different $GP, the modem has the old one
+}
+
+void swarm_warmSave(SwarmWarm* warm)
+{
+    SwarmWarmStore* store = warm->store;
+    const SatInfo* info;
+
+    if(store == 0)
+        return;
+    info = &warm->modem->info;
+
+    SWARM_FRAM_WRITE_BEGIN();
+    store->magic = 0;
+    if(store->deviceId != info->deviceID.asLong){
+        memset(store->rate, 0, sizeof(store->rate));   // someone swapped the modem, what we set was on the old one
+        store->firmware[0] = '\0';
+    }
+    store->deviceId = info->deviceID.asLong;
+    store->gpioMode = warm_gpioMode();
+    if(info->modem.firmware[0])                 // only there if we saw the modem boot or asked $FV
+        memcpy(store->firmware, info->modem.firmware, sizeof(store->firmware));
+    warm_commit(store);
+    SWARM_FRAM_WRITE_END();
+    warm->stats.saves++;
+}
+
+void swarm_warmForget(SwarmWarm* warm)
+{
+    if(warm->store == 0)
+        return;
+    SWARM_FRAM_WRITE_BEGIN();
+    warm->store->magic = 0;
+    SWARM_FRAM_WRITE_END();
+}
+
+bool swarm_warmSetRate(struct SwarmModem* modem, SwarmRate which, unsigned long seconds)
+{
+    SwarmWarm* warm = &modem->warm;
+
+    if(which >= SwarmRateCount || swarm_cmdIsPending(&modem->cmds, (unsigned int)swarmRateCommands[which][1] << 8 |
+                                                     (unsigned char)swarmRateCommands[which][2]))
+        return false;                           // rateParam is still in use by the one before
+    warm->rateWant[which] = seconds;
+    warm_formatSeconds(warm->rateParam[which], seconds);
+    return swarm_cmdSubmit(&modem->cmds, swarmRateCommands[which], warm->rateParam[which], 0, 0, warm_rateDone);
+}
+
+void swarm_warmRestoreRates(struct SwarmModem* modem)
+{
+    SwarmWarm* warm = &modem->warm;
+    unsigned char i;
+
+    if(!swarm_warmIsValid(warm))
+        return;
+    for(i = 0; i < SwarmRateCount; i++){
+        if(warm->store->rate[i])
+            swarm_warmSetRate(modem, (SwarmRate)i, warm->store->rate[i]);
+    }
+}
+
+void swarm_warmRatesAre(SwarmWarm* warm, unsigned long seconds)
+{
+    unsigned char i;
+
+    for(i = 0; i < SwarmRateCount; i++)
+        warm->rateHave[i] = seconds;
+}
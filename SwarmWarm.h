@@ -0,0 +1,92 @@
+/*
+ * SwarmWarm.h
+ *
+ *  Created on: Oct 16, 2026
+ *      Author: MicroTechEE
+ */
+
+#ifndef SWARMWARM_H_
+#define SWARMWARM_H_
+
+#include <stdbool.h>
+#include <SwarmQueue.h>
+#include <SwarmSentences.h>
+
+/* Warm restart. An MCU reset (brownout, watchdog, new firmware) usually leaves the M138 running and configured, so
+ * the full init ($CS, $DT @ until the time is valid, $GP) is wasted on it. What the last good init found is kept in
+ * FRAM next to the queue:
+ *
+ *      SWARM_PERSISTENT(warm0)
+ *      SwarmWarmStore warm0 SWARM_PERSISTENT_ATTR = {0};
+ *
+ *      swarm_modemInit(&modem0, &swarmHalMsp430, &port0, &store0);
+ *      swarm_warmAttach(&modem0, &warm0);
+ *      swarm_startup(&modem0);                 // one $CS if warm0 is good, the full init if not
+ *
+ * If the record's CRC checks out and the $GP mode is still SAT_GPIO_CONFIGURATION, swarm_startup() sends a single
+ * $CS. Same device ID back and the modem is satFullyInitialized on that answer, $DT @ still goes out for the RTC but
+ * nobody waits on it. A different ID, an error or no answer and it's the full init after all.
+ *
+ * $M138 BOOT (or boot noise) means the modem itself restarted and forgot everything: nothing is sent until
+ * $M138 BOOT,RUNNING, then the full init, then the rates set with swarm_warmSetRate() are put back.
+ */
+
+#define SWARM_WARM_MAGIC                                (0x574D ^ SWARM_FW_VERSION_MAX)   // layout changed -> cold start
+#define SWARM_WARM_PROBE_ms                             300      // $CS gets this long, doubled on every retry
+#define SWARM_WARM_BOOT_ms                              10000    // no BOOT,RUNNING after a reboot this long, init anyway
+#define SWARM_WARM_RATE_PARAM_MAX                       11       // "4294967295" and the '\0', warm_formatSeconds() never writes more
+#define SWARM_WARM_RATE_UNKNOWN                         0xFFFFFFFFUL   // rateHave: can't tell what the modem has
+
+struct SwarmModem;
+
+/* * * * * * * * STRUCTS * * * * * * * * * */
+typedef enum{
+    SwarmRateDateTime = 0,                      // $DT
+    SwarmRateGpsJamming,                        // $GJ
+    SwarmRateGpsInfo,                           // $GN
+    SwarmRateGpsStatus,                         // $GS
+    SwarmRatePower,                             // $PW
+    SwarmRateReceiveTest,                       // $RT
+    SwarmRateCount
+}SwarmRate;
+
+typedef struct{
+    unsigned int magic;
+    unsigned int crc;                           // swarm_crc16 of everything after it
+    long deviceId;
+    char gpioMode;                              // the digit of the $GP we sent
+    unsigned long rate[SwarmRateCount];         // seconds, 0 = off or never set
+    char firmware[SWARM_FW_VERSION_MAX];
+}SwarmWarmStore;
+
+typedef struct{
+    unsigned long warmStarts;                   // satFullyInitialized off one $CS
+    unsigned long coldStarts;                   // the full init
+    unsigned long mismatches;                   // the record was good but the modem wasn't the same one, or didn't answer
+    unsigned long reboots;                      // $M138 BOOT / boot noise, the modem restarted under us
+    unsigned long saves;
+}SwarmWarmStats;
+
+typedef struct{
+    struct SwarmModem* modem;
+    SwarmWarmStore* store;                      // 0 = always cold
+    bool probing;                               // the $CS is out
+    bool booting;                               // saw the modem restart, waiting for BOOT,RUNNING
+    unsigned long rateWant[SwarmRateCount];     // asked for, kept in the store once the modem says OK
+    unsigned long rateHave[SwarmRateCount];     // what the modem has as far as we know, SWARM_WARM_RATE_UNKNOWN
+    char rateParam[SwarmRateCount][SWARM_WARM_RATE_PARAM_MAX];   // the command engine keeps params by pointer
+    SwarmWarmStats stats;
+}SwarmWarm;
+
+extern const char* const swarmRateCommands[SwarmRateCount];   // "$DT" ... "$RT", in SwarmRate order
+
+/* * * * * * * * FUNCTIONS * * * * * * * * * */
+void swarm_warmAttach(struct SwarmModem* modem, SwarmWarmStore* store);   // after swarm_modemInit(), before swarm_startup()
+bool swarm_warmIsValid(const SwarmWarm* warm);
+void swarm_warmSave(SwarmWarm* warm);           // what modem->info knows now, swarm_initDone() does this
+void swarm_warmForget(SwarmWarm* warm);         // next swarm_startup() is cold
+bool swarm_warmSetRate(struct SwarmModem* modem, SwarmRate which, unsigned long seconds);   // $GN 60 etc., kept on OK
+void swarm_warmRestoreRates(struct SwarmModem* modem);    // after a full init, the modem forgot them
+void swarm_warmRatesAre(SwarmWarm* warm, unsigned long seconds);   // every rateHave, 0 after a modem boot
+
+#endif /* SWARMWARM_H_ */
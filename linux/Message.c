@@ -0,0 +1,148 @@
+/*
+ * Message.c  (host stand-in)
+ *
+ *  Created on: Oct 16, 2026
+ *      Author: MicroTechEE
+ */
+
+// STD C
+#include <stdbool.h>
+#include <string.h>
+
+#include "Message.h"
+
+#define MESSAGE_RX_QUEUE                                32    // finished lines waiting for message_getMsg()
+
+/* - - - - - - - - - - - - - GLOBALS - - - - - - - - - - - - - - - */
+static unsigned char smallBuffs[MESSAGE_POOL_SMALL][MESSAGE_BUFF_SIZE_SMALL + 1];   // +1 keeps room for a NUL
+static unsigned char largeBuffs[MESSAGE_POOL_LARGE][MESSAGE_BUFF_SIZE_LARGE + 1];
+static Message smallPool[MESSAGE_POOL_SMALL];
+static Message largePool[MESSAGE_POOL_LARGE];
+
+static Message* rxActive = 0;                   // line the "ISR" is currently filling
+static bool rxDiscard = false;                  // no buffer for this line, skip to the next '\n'
+static Message* rxQueue[MESSAGE_RX_QUEUE];
+static unsigned int rxHead = 0;
+static unsigned int rxTail = 0;
+
+MessageStats messageStats = {0, 0, 0, 0, 0, 0};
+
+/* - - - - - - - - - - - - - FUNCTIONS - - - - - - - - - - - - - - - */
+static Message* message_takeFrom(Message* pool, unsigned char* buffs, unsigned int count, unsigned int size, MessageSize type)
+{
+    unsigned int i;
+
+    for(i = 0; i < count; i++){
+        if(!pool[i].inUse){
+            pool[i].msgPtr = buffs + i * (size + 1);
+            pool[i].buffSize = size;
+            pool[i].dataLength = 0;
+            pool[i].size = type;
+            pool[i].inUse = true;
+            pool[i].msgPtr[0] = 0;
+            return &pool[i];
+        }
+    }
+    return 0;
+}
+
+Message* message_requestMsgBuff(MessageSize size)
+{
+    Message* msg = 0;
+
+    if(size == small)
+        msg = message_takeFrom(smallPool, &smallBuffs[0][0], MESSAGE_POOL_SMALL, MESSAGE_BUFF_SIZE_SMALL, small);
+    if(!msg)                                    // the board falls back to large too
+        msg = message_takeFrom(largePool, &largeBuffs[0][0], MESSAGE_POOL_LARGE, MESSAGE_BUFF_SIZE_LARGE, large);
+
+    if(!msg){
+        messageStats.failures++;
+        return 0;
+    }
+    messageStats.requests++;
+    if(++messageStats.inUse > messageStats.highWater)
+        messageStats.highWater = messageStats.inUse;
+    return msg;
+}
+
+void message_append(Message* msg, const void* data, unsigned int len)
+{
+    if(!msg)
+        return;
+    if(msg->dataLength + len > msg->buffSize)
+        len = msg->buffSize - msg->dataLength;
+    memcpy(msg->msgPtr + msg->dataLength, data, len);
+    msg->dataLength += len;
+    msg->msgPtr[msg->dataLength] = 0;
+}
+
+void message_freeMsg(Message* msg)
+{
+    if(!msg || !msg->inUse)
+        return;
+    msg->inUse = false;
+    msg->dataLength = 0;
+    messageStats.inUse--;
+}
+
+void message_killMsg(Message** msg)
+{
+    message_freeMsg(*msg);
+    *msg = 0;
+}
+
+/* - - - - RX - - - - */
+void message_rxByte(MessagePort port, unsigned char byte)
+{
+    (void)port;
+
+    if(byte == '\r')
+        return;
+
+    if(byte == '\n'){
+        rxDiscard = false;
+        if(!rxActive)
+            return;
+        if(rxHead - rxTail >= MESSAGE_RX_QUEUE){
+            messageStats.rxDropped++;
+            message_killMsg(&rxActive);
+            return;
+        }
+        rxQueue[rxHead % MESSAGE_RX_QUEUE] = rxActive;
+        rxHead++;
+        rxActive = 0;
+        messageStats.rxLines++;
+        return;
+    }
+
+    if(rxDiscard)
+        return;
+    if(!rxActive){
+        rxActive = message_requestMsgBuff(large);
+        if(!rxActive){
+            messageStats.rxDropped++;
+            rxDiscard = true;
+            return;
+        }
+    }
+    if(rxActive->dataLength < rxActive->buffSize)
+        message_append(rxActive, &byte, 1);
+}
+
+Message* message_getMsg(MessagePort port)
+{
+    Message* msg;
+    (void)port;
+
+    if(rxHead == rxTail)
+        return 0;
+    msg = rxQueue[rxTail % MESSAGE_RX_QUEUE];
+    rxTail++;
+    return msg;
+}
+
+unsigned int message_rxPending(MessagePort port)
+{
+    (void)port;
+    return rxHead - rxTail;
+}
@@ -0,0 +1,64 @@
+/*
+ * Message.h  (host stand-in)
+ *
+ *  Created on: Oct 16, 2026
+ *      Author: MicroTechEE
+ *
+ * Host build only. On the MSP430 this comes from my Message System repository, this is just enough of
+ * the same API for SwarmMSP430.c to run on Linux. RX lines are assembled the way the UART ISR does it
+ * on the board: bytes go in through message_rxByte() and a finished line comes out of message_getMsg().
+ */
+
+#ifndef MESSAGE_H_
+#define MESSAGE_H_
+
+#include <stdbool.h>
+
+#define MESSAGE_BUFF_SIZE_SMALL                         32
+#define MESSAGE_BUFF_SIZE_LARGE                         440
+#define RX_BUFF_SIZE_LARGE                              MESSAGE_BUFF_SIZE_LARGE
+#define MESSAGE_POOL_SMALL                              8
+#define MESSAGE_POOL_LARGE                              32
+
+/* * * * * * * * STRUCTS * * * * * * * * * */
+typedef enum{
+    small,
+    large
+}MessageSize;
+
+typedef enum{
+    UART,
+    SPI
+}MessagePort;
+
+typedef struct{
+    unsigned char* msgPtr;
+    unsigned int dataLength;
+    unsigned int buffSize;
+    MessageSize size;
+    bool inUse;
+}Message;
+
+typedef struct{
+    unsigned long requests;                 // every successful message_requestMsgBuff()
+    unsigned long failures;                 // pool empty
+    unsigned int inUse;
+    unsigned int highWater;
+    unsigned long rxLines;                  // lines completed by message_rxByte()
+    unsigned long rxDropped;                // lines lost because the RX queue or pool was full
+}MessageStats;
+
+extern MessageStats messageStats;
+
+/* * * * * * * * FUNCTIONS * * * * * * * * * */
+Message* message_requestMsgBuff(MessageSize size);
+void message_append(Message* msg, const void* data, unsigned int len);
+void message_freeMsg(Message* msg);
+void message_killMsg(Message** msg);
+
+/* RX side, what the UART ISR and Message system do on the board */
+void message_rxByte(MessagePort port, unsigned char byte);
+Message* message_getMsg(MessagePort port);
+unsigned int message_rxPending(MessagePort port);
+
+#endif /* MESSAGE_H_ */
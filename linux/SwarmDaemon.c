@@ -0,0 +1,549 @@
+/*
+ * SwarmDaemon.c
+ *
+ *  Created on: Oct 16, 2026
+ *      Author: MicroTechEE
+ */
+
+#define _GNU_SOURCE                             // accept4
+
+// STD C
+#include <stdbool.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+
+// POSIX
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <SwarmMSP430.h>
+#include "SwarmHAL_Linux.h"
+#include "SwarmDaemon.h"
+
+#define DAEMON_EV_TTY       0                   // epoll data.u32, clients are DAEMON_EV_CLIENT + index
+#define DAEMON_EV_LISTEN    1
+#define DAEMON_EV_CLIENT    2
+#define DAEMON_REOPEN_ms    1000                // tty gone, try it again this often
+
+/* - - - - - - - - - - - - - GLOBALS - - - - - - - - - - - - - - - */
+static SwarmDaemon* downlinkDaemon = 0;         // SwarmDownlinkHandler has no context, one daemon per process
+static unsigned long lastReopen = 0;
+
+/* - - - - - - - - - - - - - CLIENTS - - - - - - - - - - - - - - - */
+static void daemon_drop(SwarmDaemon* d, SwarmDaemonClient* c)
+{
+    if(c->fd < 0)
+        return;
+    epoll_ctl(d->epollFd, EPOLL_CTL_DEL, c->fd, 0);
+    close(c->fd);
+    c->fd = -1;
+    c->generation++;                            // whatever it still had queued is answered to nobody
+    c->inLen = 0;
+    c->outLen = 0;
+    c->wantOut = false;
+    c->subs = 0;
+}
+
+static void daemon_printf(SwarmDaemon* d, SwarmDaemonClient* c, const char* format, ...)
+{
+    va_list args;
+    int n;
+
+    if(c->fd < 0)
+        return;
+    va_start(args, format);
+    n = vsnprintf(c->out + c->outLen, sizeof(c->out) - c->outLen, format, args);
+    va_end(args);
+    if(n < 0 || (unsigned int)n >= sizeof(c->out) - c->outLen){
+        d->stats.slow++;                        // it isn't reading, it doesn't get to hold anything up
+        daemon_drop(d, c);
+        return;
+    }
+    c->outLen += (unsigned int)n;
+}
+
+static SwarmDaemonClient* daemon_owner(SwarmDaemon* d, const SwarmDaemonToken* token)
+{
+    SwarmDaemonClient* c = &d->client[token->client];
+
+    if(c->fd < 0 || c->generation != token->generation){
+        d->stats.orphaned++;
+        return 0;
+    }
+    return c;
+}
+
+static void daemon_flush(SwarmDaemon* d, SwarmDaemonClient* c, unsigned int index)
+{
+    struct epoll_event ev;
+    ssize_t n;
+    bool wantOut;
+
+    if(c->fd < 0 || c->outLen == 0)
+        return;
+    n = send(c->fd, c->out, c->outLen, MSG_NOSIGNAL);
+    if(n < 0 && errno != EAGAIN && errno != EWOULDBLOCK){
+        daemon_drop(d, c);
+        return;
+    }
+    d->stats.writes++;
+    if(n > 0){
+        memmove(c->out, c->out + n, c->outLen - (unsigned int)n);
+        c->outLen -= (unsigned int)n;
+    }
+    wantOut = c->outLen != 0;                   // the socket is full, finish when it says it has room
+    if(wantOut == c->wantOut)
+        return;
+    c->wantOut = wantOut;
+    ev.events = EPOLLIN | (wantOut ? EPOLLOUT : 0);
+    ev.data.u32 = DAEMON_EV_CLIENT + index;
+    epoll_ctl(d->epollFd, EPOLL_CTL_MOD, c->fd, &ev);
+}
+
+static bool daemon_subscribed(const SwarmDaemonClient* c, unsigned int appId)
+{
+    unsigned char i;
+
+    for(i = 0; i < c->subs; i++){
+        if(c->sub[i] == appId || c->sub[i] == SWARM_DAEMON_SUB_ALL)
+            return true;
+    }
+    return false;
+}
+
+static void daemon_subscribe(SwarmDaemonClient* c, const char* arg, bool on)
+{
+    unsigned long appId = arg[0] == '*' ? SWARM_DAEMON_SUB_ALL : strtoul(arg, 0, 10);
+    unsigned char i;
+
+    for(i = 0; i < c->subs && c->sub[i] != appId; i++)
+        ;
+    if(on && i == c->subs && c->subs < SWARM_DAEMON_SUBS)
+        c->sub[c->subs++] = appId;
+    else if(!on && i < c->subs)
+        c->sub[i] = c->sub[--c->subs];
+}
+
+/* - - - - - - - - - - - - - JOBS - - - - - - - - - - - - - - - */
+static void daemon_submit(SwarmDaemon* d, SwarmDaemonClient* c, char* args)
+{
+    SwarmDaemonJob* job;
+    char* hex;
+    unsigned long tag = strtoul(args, &hex, 10);
+    unsigned int len;
+
+    d->stats.submitted++;
+    while(*hex == ' ')
+        hex++;
+    if(d->head - d->tail >= SWARM_DAEMON_BACKLOG){
+        d->stats.full++;
+        daemon_printf(d, c, "FULL %lu\n", tag);
+        return;
+    }
+    job = &d->backlog[d->head % SWARM_DAEMON_BACKLOG];
+    len = (unsigned int)strlen(hex);
+    if(len == 0 || len > SWARM_QUEUE_DATA_MAX * 2 || !swarm_downlinkDecode(hex, len, job->data, &len) || len == 0){
+        d->stats.bad++;
+        daemon_printf(d, c, "BAD %lu\n", tag);
+        return;
+    }
+    job->len = (unsigned char)len;
+    job->token.client = (unsigned char)(c - d->client);
+    job->token.generation = c->generation;
+    job->token.tag = tag;
+    job->token.submittedUs = swarm_halLinuxMicros();
+    daemon_printf(d, c, "Q %lu %u\n", tag, d->head - d->tail + swarm_queueDepth(&d->modem.queue));
+    d->head++;
+}
+
+static void daemon_feed(SwarmDaemon* d)
+{
+    // backlog -> the modem's queue in arrival order, each job's owner goes in the matching slot of queued[]
+    SwarmDaemonJob* job;
+
+    while(d->head != d->tail && swarm_queueRoom(&d->modem.queue, SwarmQueueNormal)){
+        job = &d->backlog[d->tail % SWARM_DAEMON_BACKLOG];
+        d->queued[d->store.ring[SwarmQueueNormal].head % SWARM_QUEUE_SLOTS] = job->token;
+        if(!swarm_queuePush(&d->modem.queue, job->data, job->len))
+            return;
+        d->tail++;
+    }
+}
+
+static void daemon_sent(SwarmDaemon* d, const SwarmTdReply* reply)
+{
+    SwarmDaemonSentWait* w;
+    SwarmDaemonClient* c;
+    unsigned int i;
+
+    for(i = 0; i < SWARM_DAEMON_SENT_WAIT; i++){
+        w = &d->sentWait[i];
+        if(w->used && strlen(w->msgId) == reply->msgIdLen && memcmp(w->msgId, reply->msgId, reply->msgIdLen) == 0)
+            break;
+    }
+    if(i == SWARM_DAEMON_SENT_WAIT)
+        return;                                 // from before we started, or we forgot it
+    w->used = false;
+    d->stats.sent++;
+    c = daemon_owner(d, &w->token);
+    if(c)
+        daemon_printf(d, c, "SENT %lu %s %d %d %d\n", w->token.tag, w->msgId, reply->rssi, reply->snr, reply->fdev);
+}
+
+static void daemon_dropped(SwarmDaemon* d, unsigned int upTo)
+{
+    // the queue let these go without a reply (failed their CRC, or their deadline passed)
+    SwarmDaemonClient* c;
+
+    while(d->queueTail != upTo){
+        c = daemon_owner(d, &d->queued[d->queueTail % SWARM_QUEUE_SLOTS]);
+        if(c)
+            daemon_printf(d, c, "ERR %lu DROPPED\n", d->queued[d->queueTail % SWARM_QUEUE_SLOTS].tag);
+        d->queueTail++;
+        d->stats.rejected++;
+    }
+}
+
+static void daemon_onTd(SwarmModem* modem, const SwarmSentence* sentence)
+{
+    // runs after SwarmQueue has seen the same line. If it took the line as the answer for its $TD (accepted or
+    // rejected went up) the job is the slot it just committed, tail - 1, anything before that it skipped without
+    // one. If not it's an ERR the queue will retry or an OK it wasn't waiting for
+    SwarmDaemon* d = (SwarmDaemon*)modem;      // modem is the first member
+    SwarmDaemonToken* token;
+    SwarmDaemonSentWait* w;
+    SwarmDaemonClient* c;
+    SwarmTdReply reply;
+    unsigned long long us;
+    unsigned long answered = modem->queue.stats.accepted + modem->queue.stats.rejected;
+    unsigned int tail = d->store.ring[SwarmQueueNormal].tail;
+    unsigned int len;
+
+    if(!swarm_sentenceTd(sentence, &reply))
+        return;
+    if(reply.kind == SwarmTdSent){
+        daemon_sent(d, &reply);
+        return;
+    }
+    if(answered == d->queueAnswered || d->queueTail == tail)
+        return;
+    d->queueAnswered = answered;
+    daemon_dropped(d, tail - 1);
+    token = &d->queued[(tail - 1) % SWARM_QUEUE_SLOTS];
+    d->queueTail = tail;
+    c = daemon_owner(d, token);
+    len = reply.msgIdLen < SWARM_DAEMON_MSGID_MAX ? reply.msgIdLen : SWARM_DAEMON_MSGID_MAX - 1;
+
+    if(reply.kind == SwarmTdOk){
+        us = swarm_halLinuxMicros() - token->submittedUs;
+        d->stats.accepted++;
+        d->stats.acceptUs += us;
+        if(us > d->stats.acceptUsMax)
+            d->stats.acceptUsMax = us;
+        w = &d->sentWait[d->sentNext++ % SWARM_DAEMON_SENT_WAIT];
+        w->used = true;
+        w->token = *token;
+        memcpy(w->msgId, reply.msgId, len);
+        w->msgId[len] = '\0';
+        if(c)
+            daemon_printf(d, c, "OK %lu %s\n", token->tag, w->msgId);
+    }
+    else{
+        d->stats.rejected++;
+        if(c)
+            daemon_printf(d, c, "ERR %lu %.*s\n", token->tag, (int)len, reply.msgId);
+    }
+}
+
+static void daemon_reconcile(SwarmDaemon* d)
+{
+    // every reply has been through daemon_onTd(), whatever else moved the tail was a drop
+    daemon_dropped(d, d->store.ring[SwarmQueueNormal].tail);
+}
+
+static void daemon_onDownlink(const SwarmDownlinkMsg* message)
+{
+    static const char hexDigits[] = "0123456789abcdef";
+    char hex[SWARM_DOWNLINK_DATA_MAX * 2 + 1];
+    SwarmDaemon* d = downlinkDaemon;
+    unsigned int i;
+
+    if(!d)
+        return;
+    for(i = 0; i < message->len; i++){
+        hex[i * 2] = hexDigits[message->data[i] >> 4];
+        hex[i * 2 + 1] = hexDigits[message->data[i] & 0x0F];
+    }
+    hex[i * 2] = '\0';
+    for(i = 0; i < SWARM_DAEMON_CLIENTS; i++){
+        if(d->client[i].fd < 0 || !daemon_subscribed(&d->client[i], message->appId))
+            continue;
+        daemon_printf(d, &d->client[i], "RD %u %d %d %d %s\n", message->appId, message->rssi, message->snr,
+                      message->fdev, hex);
+        d->stats.downlinks++;
+    }
+}
+
+static void daemon_line(SwarmDaemon* d, SwarmDaemonClient* c, char* line, bool* batch)
+{
+    if(strncmp(line, "TD ", 3) == 0){
+        daemon_submit(d, c, line + 3);
+        *batch = true;
+    }
+    else if(strncmp(line, "SUB ", 4) == 0)
+        daemon_subscribe(c, line + 4, true);
+    else if(strncmp(line, "UNSUB ", 6) == 0)
+        daemon_subscribe(c, line + 6, false);
+    else if(strcmp(line, "ST") == 0)
+        daemon_printf(d, c, "ST %u %u %u %d %u\n", d->head - d->tail, swarm_queueDepth(&d->modem.queue),
+                      d->modem.queue.modemUnsent, d->modem.info.satFullyInitialized, swarm_daemonClients(d));
+    else if(line[0])
+        daemon_printf(d, c, "BAD 0\n");
+}
+
+static void daemon_read(SwarmDaemon* d, SwarmDaemonClient* c)
+{
+    // everything the socket has, every complete line in it, then one flush for all the answers
+    char* line;
+    char* end;
+    bool batch = false;
+    ssize_t n;
+
+    for(;;){
+        n = read(c->fd, c->in + c->inLen, sizeof(c->in) - 1 - c->inLen);
+        if(n == 0 || (n < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)){
+            d->stats.batches += batch;          // wrote and hung up, what it sent still goes
+            daemon_drop(d, c);
+            return;
+        }
+        if(n < 0)
+            break;
+        d->stats.reads++;
+        c->inLen += (unsigned int)n;
+        c->in[c->inLen] = '\0';
+
+        line = c->in;
+        while(c->fd >= 0 && (end = strchr(line, '\n')) != 0){
+            *end = '\0';
+            if(end > line && end[-1] == '\r')
+                end[-1] = '\0';
+            daemon_line(d, c, line, &batch);
+            line = end + 1;
+        }
+        if(c->fd < 0){
+            d->stats.batches += batch;
+            return;
+        }
+        c->inLen -= (unsigned int)(line - c->in);
+        memmove(c->in, line, c->inLen);
+        if(c->inLen >= sizeof(c->in) - 1){
+            daemon_drop(d, c);                  // a line longer than anything we'd take
+            return;
+        }
+    }
+    d->stats.batches += batch;
+}
+
+static void daemon_accept(SwarmDaemon* d)
+{
+    struct epoll_event ev;
+    unsigned int i;
+    int fd;
+
+    while((fd = accept4(d->listenFd, 0, 0, SOCK_NONBLOCK | SOCK_CLOEXEC)) >= 0){
+        for(i = 0; i < SWARM_DAEMON_CLIENTS && d->client[i].fd >= 0; i++)
+            ;
+        if(i == SWARM_DAEMON_CLIENTS){
+            close(fd);
+            continue;
+        }
+        ev.events = EPOLLIN;
+        ev.data.u32 = DAEMON_EV_CLIENT + i;
+        if(epoll_ctl(d->epollFd, EPOLL_CTL_ADD, fd, &ev) < 0){
+            close(fd);
+            continue;
+        }
+        d->client[i].fd = fd;
+        d->client[i].generation++;
+        d->client[i].inLen = 0;
+        d->client[i].outLen = 0;
+        d->client[i].wantOut = false;
+        d->client[i].subs = 0;
+    }
+}
+
+/* - - - - - - - - - - - - - MODEM - - - - - - - - - - - - - - - */
+static bool daemon_ttyAdd(SwarmDaemon* d)
+{
+    struct epoll_event ev;
+
+    if(d->port.fd < 0)
+        return false;
+    ev.events = EPOLLIN;
+    ev.data.u32 = DAEMON_EV_TTY;
+    d->wantOut = false;
+    return epoll_ctl(d->epollFd, EPOLL_CTL_ADD, d->port.fd, &ev) == 0;
+}
+
+static void daemon_ttyLost(SwarmDaemon* d)
+{
+    // unplugged. The queue is in RAM and stays, the $TD in flight goes again once it's back
+    epoll_ctl(d->epollFd, EPOLL_CTL_DEL, d->port.fd, 0);
+    d->modem.hal->uartClose(&d->modem);
+    d->modem.info.satFullyInitialized = false;
+    lastReopen = d->modem.hal->millis();
+}
+
+static void daemon_ttyService(SwarmDaemon* d)
+{
+    int fed;
+
+    do{
+        fed = swarm_halLinuxPoll(&d->modem, 0);
+        swarm_handleMsg(&d->modem);
+    }while(fed > 0);
+    if(fed < 0)
+        daemon_ttyLost(d);
+}
+
+static void daemon_ttyWantOut(SwarmDaemon* d)
+{
+    struct epoll_event ev;
+    bool wantOut;
+
+    if(d->port.fd < 0)
+        return;
+    wantOut = !swarm_txIsIdle(&d->modem.txRing);
+    if(wantOut == d->wantOut)
+        return;
+    ev.events = EPOLLIN | (wantOut ? EPOLLOUT : 0);
+    ev.data.u32 = DAEMON_EV_TTY;
+    epoll_ctl(d->epollFd, EPOLL_CTL_MOD, d->port.fd, &ev);
+    d->wantOut = wantOut;
+}
+
+/* - - - - - - - - - - - - - FUNCTIONS - - - - - - - - - - - - - - - */
+bool swarm_daemonInit(SwarmDaemon* daemon, const char* ttyPath, const char* socketPath)
+{
+    struct sockaddr_un addr;
+    struct epoll_event ev;
+    unsigned int i;
+
+    memset(daemon, 0, sizeof(*daemon));
+    daemon->listenFd = -1;
+    for(i = 0; i < SWARM_DAEMON_CLIENTS; i++)
+        daemon->client[i].fd = -1;
+    daemon->epollFd = epoll_create1(EPOLL_CLOEXEC);
+    if(daemon->epollFd < 0 || strlen(socketPath) >= sizeof(addr.sun_path))
+        return false;
+    strncpy(daemon->socketPath, socketPath, sizeof(daemon->socketPath) - 1);
+
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    strncpy(addr.sun_path, socketPath, sizeof(addr.sun_path) - 1);
+    unlink(socketPath);                         // left over from a daemon that didn't get to clean up
+    daemon->listenFd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if(daemon->listenFd < 0 || bind(daemon->listenFd, (struct sockaddr*)&addr, sizeof(addr)) < 0 ||
+       listen(daemon->listenFd, SWARM_DAEMON_CLIENTS) < 0)
+        return false;
+    ev.events = EPOLLIN;
+    ev.data.u32 = DAEMON_EV_LISTEN;
+    if(epoll_ctl(daemon->epollFd, EPOLL_CTL_ADD, daemon->listenFd, &ev) < 0)
+        return false;
+
+    swarm_halLinuxPortInit(&daemon->port, ttyPath);
+    swarm_modemInit(&daemon->modem, &swarmHalLinux, &daemon->port, &daemon->store);
+    swarm_eventOn(&daemon->modem.events, SAT_HEADER_TRANSMIT_DATA, daemon_onTd);
+    downlinkDaemon = daemon;
+    swarm_downlinkFallback(&daemon->modem.downlink, daemon_onDownlink);
+    swarm_startup(&daemon->modem);
+    daemon->queueTail = daemon->store.ring[SwarmQueueNormal].tail;
+    if(!daemon_ttyAdd(daemon))
+        lastReopen = daemon->modem.hal->millis();   // not there yet, swarm_daemonRun() keeps trying
+    return true;
+}
+
+void swarm_daemonClose(SwarmDaemon* daemon)
+{
+    unsigned int i;
+
+    for(i = 0; i < SWARM_DAEMON_CLIENTS; i++)
+        daemon_drop(daemon, &daemon->client[i]);
+    if(daemon->port.fd >= 0){
+        epoll_ctl(daemon->epollFd, EPOLL_CTL_DEL, daemon->port.fd, 0);
+        daemon->modem.hal->uartClose(&daemon->modem);
+    }
+    if(daemon->listenFd >= 0){
+        close(daemon->listenFd);
+        unlink(daemon->socketPath);
+    }
+    if(daemon->epollFd >= 0)
+        close(daemon->epollFd);
+    daemon->listenFd = -1;
+    daemon->epollFd = -1;
+    if(downlinkDaemon == daemon)
+        downlinkDaemon = 0;
+}
+
+unsigned int swarm_daemonClients(const SwarmDaemon* daemon)
+{
+    unsigned int n = 0;
+    unsigned int i;
+
+    for(i = 0; i < SWARM_DAEMON_CLIENTS; i++)
+        n += daemon->client[i].fd >= 0;
+    return n;
+}
+
+int swarm_daemonRun(SwarmDaemon* daemon, int timeoutMs)
+{
+    struct epoll_event events[SWARM_DAEMON_CLIENTS + 2];
+    SwarmDaemonClient* c;
+    unsigned long now;
+    unsigned int i;
+    unsigned int index;
+    int n;
+
+    n = epoll_wait(daemon->epollFd, events, SWARM_DAEMON_CLIENTS + 2, timeoutMs);
+    if(n < 0)
+        return errno == EINTR ? 0 : -1;
+
+    for(i = 0; i < (unsigned int)n; i++){
+        index = events[i].data.u32;
+        if(index == DAEMON_EV_TTY){
+            if(daemon->port.fd >= 0)
+                daemon_ttyService(daemon);      // reads what's left before a hang up too
+            if(daemon->port.fd >= 0 && (events[i].events & (EPOLLERR | EPOLLHUP)))
+                daemon_ttyLost(daemon);
+        }
+        else if(index == DAEMON_EV_LISTEN)
+            daemon_accept(daemon);
+        else{
+            c = &daemon->client[index - DAEMON_EV_CLIENT];
+            if(c->fd >= 0 && (events[i].events & (EPOLLIN | EPOLLHUP | EPOLLERR)))
+                daemon_read(daemon, c);
+        }
+    }
+
+    now = daemon->modem.hal->millis();
+    if(daemon->port.fd < 0 && now - lastReopen >= DAEMON_REOPEN_ms){
+        lastReopen = now;
+        swarm_startup(&daemon->modem);          // same as power on, the queue store carries over
+        daemon->queueAnswered = 0;              // its stats start over
+        daemon_ttyAdd(daemon);
+    }
+
+    // new jobs in first so this same pass puts one on the wire, then the answers out in one write per client
+    daemon_feed(daemon);
+    swarm_handleMsg(&daemon->modem);
+    daemon_reconcile(daemon);
+    daemon_ttyWantOut(daemon);
+    for(i = 0; i < SWARM_DAEMON_CLIENTS; i++)
+        daemon_flush(daemon, &daemon->client[i], i);
+    return n;
+}
@@ -0,0 +1,135 @@
+/*
+ * SwarmDaemon.h
+ *
+ *  Created on: Oct 16, 2026
+ *      Author: MicroTechEE
+ *
+ * One process owns the modem, every other process on the box talks to it over a Unix socket. The tty is only ever
+ * written by the daemon's own SwarmModem, so there's nothing to fight over: submissions from every client go into
+ * one backlog, then into the modem's SwarmQueue in arrival order, and that queue is the one writer to the modem.
+ * Completions come back to whoever submitted, $RD downlinks go to whoever subscribed to the appID.
+ *
+ *      static SwarmDaemon swarmd;                 // not "daemon", unistd.h has one of those
+ *      swarm_daemonInit(&swarmd, "/dev/ttyUSB0", "/run/swarmd.sock");
+ *      for(;;)
+ *          swarm_daemonRun(&swarmd, 1000);
+ *
+ * The protocol is lines of text, so socat or nc -U can drive it by hand. A client can write as many lines as it
+ * likes in one write(), they're all taken from one read() and all answered in one write() back. That's the batch:
+ *
+ *      -> TD <tag> <hex>           queue a $TD, tag is yours (a number), payload in hex or "quoted", up to 192 bytes
+ *      <- Q <tag> <depth>          in the backlog, depth is what's ahead of it
+ *      <- FULL <tag>               backlog full, try again later
+ *      <- BAD <tag>                not hex, empty or too long
+ *      <- OK <tag> <msg_id>        $TD OK, the modem has it
+ *      <- SENT <tag> <msg_id> <rssi> <snr> <fdev>     $TD SENT, it's gone up
+ *      <- ERR <tag> <reason>       $TD ERR the queue gave up on, the modem said the message itself is bad, or
+ *                                  DROPPED: the queue threw it away unsent (failed its CRC, deadline passed)
+ *
+ *      -> SUB <appId> | SUB *      $RD / $MM downlinks for that appID (or all) from now on, UNSUB the same way
+ *      <- RD <appId> <rssi> <snr> <fdev> <hex>
+ *
+ *      -> ST                       <- ST <backlog> <queued> <modem unsent> <initialized 0/1> <clients>
+ *
+ * A client that goes away doesn't take its jobs with it, they still go out, only the answers are thrown away. A
+ * client that stops reading gets disconnected once SWARM_DAEMON_OUT_MAX is waiting for it, the modem doesn't wait
+ * for anybody.
+ *
+ * SENT is matched by msg_id, so it still finds the right client however the modem orders them. OK and ERR carry no
+ * tag on the wire and are matched by order: SwarmQueue only ever has one $TD in flight, the reply is for the job at
+ * its tail. Every job goes in as SwarmQueueNormal, the tag of each sits in SwarmDaemon.queued[], indexed by that
+ * ring's counter.
+ */
+
+#ifndef SWARMDAEMON_H_
+#define SWARMDAEMON_H_
+
+#include <stdbool.h>
+#include <SwarmMSP430.h>
+#include "SwarmHAL_Linux.h"
+
+#define SWARM_DAEMON_CLIENTS                            32
+#define SWARM_DAEMON_BACKLOG                            1024     // jobs waiting for room in the modem's queue, power of 2
+#define SWARM_DAEMON_SENT_WAIT                          256      // accepted jobs waiting for $TD SENT, oldest forgotten first
+#define SWARM_DAEMON_SUBS                               8        // appIDs one client can subscribe to
+#define SWARM_DAEMON_SUB_ALL                            0xFFFFFFFFUL
+#define SWARM_DAEMON_IN_MAX                             8192     // a client's unfinished lines
+#define SWARM_DAEMON_OUT_MAX                            65536    // answers waiting for a client to read them
+#define SWARM_DAEMON_MSGID_MAX                          24       // $TD OK,<msg_id> digits
+
+/* * * * * * * * STRUCTS * * * * * * * * * */
+typedef struct{
+    unsigned char client;                       // index into SwarmDaemon.client
+    unsigned int generation;                    // that client's, a reconnect in the same slot doesn't get these
+    unsigned long tag;
+    unsigned long long submittedUs;
+}SwarmDaemonToken;
+
+typedef struct{
+    SwarmDaemonToken token;
+    unsigned char len;
+    unsigned char data[SWARM_QUEUE_DATA_MAX];
+}SwarmDaemonJob;
+
+typedef struct{
+    SwarmDaemonToken token;
+    char msgId[SWARM_DAEMON_MSGID_MAX];
+    bool used;
+}SwarmDaemonSentWait;
+
+typedef struct{
+    unsigned long submitted;                    // TD lines
+    unsigned long batches;                      // read()s that had at least one TD in them
+    unsigned long accepted;                     // $TD OK
+    unsigned long long acceptUs;                // submit -> $TD OK, sum
+    unsigned long long acceptUsMax;
+    unsigned long sent;                         // $TD SENT matched to a job
+    unsigned long rejected;
+    unsigned long full;
+    unsigned long bad;
+    unsigned long orphaned;                     // answers for a client that had gone
+    unsigned long downlinks;                    // $RD handed out, one per subscriber
+    unsigned long slow;                         // clients dropped for not reading
+    unsigned long reads;
+    unsigned long writes;
+}SwarmDaemonStats;
+
+typedef struct{
+    int fd;                                     // -1 = free
+    unsigned int generation;
+    char in[SWARM_DAEMON_IN_MAX];
+    unsigned int inLen;
+    char out[SWARM_DAEMON_OUT_MAX];
+    unsigned int outLen;
+    bool wantOut;                               // EPOLLOUT armed, the socket was full
+    unsigned long sub[SWARM_DAEMON_SUBS];
+    unsigned char subs;
+}SwarmDaemonClient;
+
+typedef struct{
+    SwarmModem modem;
+    SwarmLinuxPort port;
+    SwarmQueueStore store;                      // RAM here, the FRAM queue code runs as is
+    char socketPath[108];
+    int listenFd;
+    int epollFd;
+    bool wantOut;                               // EPOLLOUT armed on the tty
+    SwarmDaemonClient client[SWARM_DAEMON_CLIENTS];
+    SwarmDaemonJob backlog[SWARM_DAEMON_BACKLOG];
+    unsigned int head;                          // free running
+    unsigned int tail;
+    SwarmDaemonToken queued[SWARM_QUEUE_SLOTS]; // who each slot of store belongs to
+    unsigned int queueTail;                     // store.ring[SwarmQueueNormal].tail the last time we looked
+    unsigned long queueAnswered;                // modem.queue.stats accepted + rejected the last time we looked
+    SwarmDaemonSentWait sentWait[SWARM_DAEMON_SENT_WAIT];
+    unsigned int sentNext;
+    SwarmDaemonStats stats;
+}SwarmDaemon;
+
+/* * * * * * * * FUNCTIONS * * * * * * * * * */
+bool swarm_daemonInit(SwarmDaemon* daemon, const char* ttyPath, const char* socketPath);   // false with errno
+void swarm_daemonClose(SwarmDaemon* daemon);
+int swarm_daemonRun(SwarmDaemon* daemon, int timeoutMs);   // one epoll_wait and everything after it, -1 on error
+unsigned int swarm_daemonClients(const SwarmDaemon* daemon);
+
+#endif /* SWARMDAEMON_H_ */
@@ -0,0 +1,111 @@
+/*
+ * SwarmDefrag.c
+ *
+ *  Created on: Oct 16, 2026
+ *      Author: MicroTechEE
+ */
+
+// STD C
+#include <stdbool.h>
+#include <string.h>
+
+#include "SwarmDefrag.h"
+
+/* - - - - - - - - - - - - - HELPERS - - - - - - - - - - - - - - - */
+static bool defrag_isDone(const SwarmDefrag* defrag, unsigned char id, unsigned int count)
+{
+    unsigned int i;
+
+    for(i = 0; i < SWARM_DEFRAG_DONE; i++){
+        if(defrag->done[i].used && defrag->done[i].id == id && defrag->done[i].count == count)
+            return true;
+    }
+    return false;
+}
+
+static SwarmDefragSlot* defrag_slot(SwarmDefrag* defrag, unsigned char id, unsigned int count)
+{
+    // the blob's slot, or a new one: a free one if there is one, otherwise whichever hasn't moved for longest
+    SwarmDefragSlot* oldest = 0;
+    SwarmDefragSlot* slot;
+    unsigned int i;
+
+    for(i = 0; i < SWARM_DEFRAG_SLOTS; i++){
+        slot = &defrag->slot[i];
+        if(slot->used && slot->id == id && slot->count == count)
+            return slot;
+        if(!oldest || (oldest->used && (!slot->used || slot->touched < oldest->touched)))
+            oldest = slot;
+    }
+    if(oldest->used)
+        defrag->stats.evicted++;
+    oldest->used = true;
+    oldest->id = id;
+    oldest->count = count;
+    oldest->have = 0;
+    oldest->length = 0;
+    memset(oldest->seen, 0, sizeof(oldest->seen));
+    return oldest;
+}
+
+/* - - - - - - - - - - - - - FUNCTIONS - - - - - - - - - - - - - - - */
+void swarm_defragInit(SwarmDefrag* defrag)
+{
+    memset(defrag, 0, sizeof(*defrag));
+}
+
+SwarmDefragResult swarm_defragFeed(SwarmDefrag* defrag, const unsigned char* packet, unsigned int len,
+                                   const unsigned char** blob, unsigned long* blobLen)
+{
+    SwarmDefragSlot* slot;
+    unsigned int dataLen = len - SWARM_FRAG_HEADER;
+    unsigned int count;
+    unsigned int seq;
+    unsigned int crc;
+
+    if(len <= SWARM_FRAG_HEADER || len > SWARM_QUEUE_DATA_MAX || packet[0] != SWARM_FRAG_VERSION){
+        defrag->stats.notFragment++;
+        return SwarmDefragNotFragment;
+    }
+    seq = packet[2];
+    count = packet[3] + 1U;
+    if(seq >= count || (seq + 1 < count && dataLen != SWARM_FRAG_DATA)){
+        defrag->stats.notFragment++;            // only the last one is allowed to be short
+        return SwarmDefragNotFragment;
+    }
+    defrag->stats.fragments++;
+    if(defrag_isDone(defrag, packet[1], count)){
+        defrag->stats.duplicates++;
+        return SwarmDefragDuplicate;
+    }
+
+    slot = defrag_slot(defrag, packet[1], count);
+    slot->touched = ++defrag->feeds;
+    if(slot->seen[seq >> 3] & (1 << (seq & 7))){
+        defrag->stats.duplicates++;
+        return SwarmDefragDuplicate;
+    }
+    slot->seen[seq >> 3] |= (unsigned char)(1 << (seq & 7));
+    slot->have++;
+    memcpy(slot->data + (unsigned long)seq * SWARM_FRAG_DATA, packet + SWARM_FRAG_HEADER, dataLen);
+    if(seq + 1 == count)
+        slot->length = (unsigned long)seq * SWARM_FRAG_DATA + dataLen;
+    if(slot->have < count)
+        return SwarmDefragPartial;
+
+    // all there, the last two bytes are the CRC of everything before them
+    slot->used = false;
+    crc = slot->length >= 2 ? swarm_crc16(slot->data, (unsigned int)(slot->length - 2), 0xFFFF) : 0;
+    if(slot->length < 2 || crc != ((unsigned int)slot->data[slot->length - 2] << 8 | slot->data[slot->length - 1])){
+        defrag->stats.badCrc++;
+        return SwarmDefragBadCrc;
+    }
+    defrag->done[defrag->doneNext].used = true;
+    defrag->done[defrag->doneNext].id = slot->id;
+    defrag->done[defrag->doneNext].count = slot->count;
+    defrag->doneNext = (defrag->doneNext + 1) % SWARM_DEFRAG_DONE;
+    defrag->stats.completed++;
+    *blob = slot->data;
+    *blobLen = slot->length - 2;
+    return SwarmDefragComplete;
+}
@@ -0,0 +1,78 @@
+/*
+ * SwarmDefrag.h
+ *
+ *  Created on: Oct 16, 2026
+ *      Author: MicroTechEE
+ *
+ * The ground side of SwarmFragment: $TD payloads in, whole blobs out. They can come in any order and any number of
+ * times (the Hive hands them over as they come down, the board resends what it never got a $TD SENT for), a blob is
+ * done once every seq from 0 to last has been seen once and the swarm_crc16 at its end matches.
+ *
+ *      static SwarmDefrag defrag;                 // ~400 KB, the slots hold whole blobs
+ *      swarm_defragInit(&defrag);
+ *      if(swarm_defragFeed(&defrag, payload, len, &blob, &blobLen) == SwarmDefragComplete)
+ *          save(blob, blobLen);                   // valid until the next feed
+ *
+ * A blob that's still missing pieces when SWARM_DEFRAG_SLOTS others have started since is thrown away (evicted).
+ * The last SWARM_DEFRAG_DONE finished ones are remembered by id and count, so late copies of their fragments don't
+ * start them over.
+ */
+
+#ifndef SWARMDEFRAG_H_
+#define SWARMDEFRAG_H_
+
+#include <stdbool.h>
+#include <SwarmMSP430.h>
+
+#define SWARM_DEFRAG_SLOTS                              8        // blobs being put back together at once
+#define SWARM_DEFRAG_DONE                               16       // finished blobs whose copies we still drop
+
+/* * * * * * * * STRUCTS * * * * * * * * * */
+typedef enum{
+    SwarmDefragNotFragment = 0,                 // not SWARM_FRAG_VERSION, or a header that can't be right
+    SwarmDefragPartial,
+    SwarmDefragDuplicate,
+    SwarmDefragComplete,
+    SwarmDefragBadCrc                           // every piece there and it still doesn't add up, thrown away
+}SwarmDefragResult;
+
+typedef struct{
+    bool used;
+    unsigned char id;
+    unsigned int count;
+    unsigned int have;
+    unsigned long length;                       // data and CRC, known once the last seq is in
+    unsigned long touched;                      // swarm_defragFeed() count, oldest is evicted first
+    unsigned char seen[SWARM_FRAG_COUNT_MAX / 8];
+    unsigned char data[SWARM_FRAG_COUNT_MAX * SWARM_FRAG_DATA];
+}SwarmDefragSlot;
+
+typedef struct{
+    bool used;
+    unsigned char id;
+    unsigned int count;
+}SwarmDefragDoneId;
+
+typedef struct{
+    unsigned long fragments;
+    unsigned long duplicates;
+    unsigned long completed;
+    unsigned long badCrc;
+    unsigned long evicted;
+    unsigned long notFragment;
+}SwarmDefragStats;
+
+typedef struct{
+    SwarmDefragSlot slot[SWARM_DEFRAG_SLOTS];
+    SwarmDefragDoneId done[SWARM_DEFRAG_DONE];
+    unsigned int doneNext;
+    unsigned long feeds;
+    SwarmDefragStats stats;
+}SwarmDefrag;
+
+/* * * * * * * * FUNCTIONS * * * * * * * * * */
+void swarm_defragInit(SwarmDefrag* defrag);
+SwarmDefragResult swarm_defragFeed(SwarmDefrag* defrag, const unsigned char* packet, unsigned int len,
+                                   const unsigned char** blob, unsigned long* blobLen);   // blob only on Complete
+
+#endif /* SWARMDEFRAG_H_ */
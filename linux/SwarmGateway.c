@@ -0,0 +1,289 @@
+/*
+ * SwarmGateway.c
+ *
+ *  Created on: Oct 16, 2026
+ *      Author: MicroTechEE
+ */
+
+// STD C
+#include <stdbool.h>
+#include <string.h>
+#include <errno.h>
+
+// POSIX
+#include <sys/epoll.h>
+#include <unistd.h>
+
+#include <SwarmMSP430.h>
+#include "SwarmHAL_Linux.h"
+#include "SwarmGateway.h"
+
+/* - - - - - - - - - - - - - HELPERS - - - - - - - - - - - - - - - */
+static bool gw_pushFront(SwarmGateway* gw, const unsigned char* data, unsigned int len)
+{
+    SwarmGwJob* job;
+
+    if(gw->head - gw->tail >= SWARM_GW_JOBS)
+        return false;
+    job = &gw->job[(gw->tail - 1) % SWARM_GW_JOBS];
+    job->len = (unsigned char)len;
+    memcpy(job->data, data, len);
+    gw->tail--;
+    gw->stats.requeued++;
+    return true;
+}
+
+static void gw_takeBack(SwarmGateway* gw, SwarmGwModem* m)
+{
+    // whatever this modem hasn't handed to the satellite side yet goes to the front, oldest ends up first
+    unsigned char data[SWARM_QUEUE_DATA_MAX];
+    unsigned int len;
+
+    while(gw->head - gw->tail < SWARM_GW_JOBS && swarm_queueTakeBack(&m->modem.queue, data, &len)){
+        gw_pushFront(gw, data, len);
+        m->stats.takenBack++;
+    }
+}
+
+static void gw_lost(SwarmGateway* gw, SwarmGwModem* m)
+{
+    // unplugged, or the simulator went away. The $TD in flight may or may not have made it, it goes again
+    // somewhere else: sent twice is better than not at all, same as SwarmQueue across a reset
+    epoll_ctl(gw->epollFd, EPOLL_CTL_DEL, m->port.fd, 0);
+    m->modem.hal->uartClose(&m->modem);
+    m->open = false;
+    m->wantOut = false;
+    m->modem.info.satFullyInitialized = false;
+    m->modem.queue.inFlight = false;
+    m->stats.lost++;
+    gw_takeBack(gw, m);
+}
+
+static void gw_service(SwarmGateway* gw, SwarmGwModem* m)
+{
+    // same as the superloop on the board: one line in, swarm_handleMsg(), until the tty has nothing left
+    int fed;
+
+    do{
+        fed = swarm_halLinuxPoll(&m->modem, 0);
+        swarm_handleMsg(&m->modem);
+    }while(fed > 0);
+    if(fed < 0)
+        gw_lost(gw, m);
+}
+
+static bool gw_isReady(const SwarmGwModem* m)
+{
+    const SwarmModem* modem = &m->modem;
+
+    return m->open && modem->info.satFullyInitialized && !modem->info.isSleeping && modem->queue.modemKnown &&
+           !modem->queue.holding && modem->queue.modemUnsent < SWARM_QUEUE_MODEM_MAX &&
+           swarm_queueDepth(&modem->queue) < SWARM_GW_LOCAL_MAX;
+}
+
+static int gw_score(const SwarmGwModem* m)
+{
+    const SwarmModem* modem = &m->modem;
+    int signal = modem->info.rssi.background ? modem->info.signalRating : 0;   // no $RT yet, no opinion
+
+    return (int)swarm_queueDepth(&modem->queue) * SWARM_GW_DEPTH_WEIGHT + (int)modem->queue.modemUnsent -
+           signal * SWARM_GW_RSSI_WEIGHT;
+}
+
+static void gw_assign(SwarmGateway* gw)
+{
+    SwarmGwModem* best;
+    SwarmGwJob* job;
+    unsigned int i;
+    unsigned int k;
+    int score;
+    int bestScore = 0;
+
+    while(gw->head != gw->tail){
+        best = 0;
+        for(i = 0; i < gw->modems; i++){
+            k = (gw->next + i) % gw->modems;
+            if(!gw_isReady(&gw->modem[k]))
+                continue;
+            score = gw_score(&gw->modem[k]);
+            if(!best || score < bestScore){
+                best = &gw->modem[k];
+                bestScore = score;
+            }
+        }
+        if(!best)
+            return;                             // nobody has room, the jobs wait here where any modem can get them
+
+        job = &gw->job[gw->tail % SWARM_GW_JOBS];
+        if(!swarm_queuePush(&best->modem.queue, job->data, job->len))
+            return;
+        gw->tail++;
+        gw->next = (unsigned int)(best - gw->modem) + 1;
+        best->stats.pulled++;
+        gw->stats.assigned++;
+    }
+}
+
+static void gw_housekeeping(SwarmGateway* gw, SwarmGwModem* m, unsigned long now)
+{
+    SwarmModem* modem = &m->modem;
+    struct epoll_event ev;
+    bool wantOut;
+
+    if(modem->queue.stats.accepted != m->lastAccepted || swarm_queueDepth(&modem->queue) == 0){
+        m->lastAccepted = modem->queue.stats.accepted;
+        m->lastProgress = now;
+    }
+    else if(!modem->info.satFullyInitialized || now - m->lastProgress >= SWARM_GW_STALL_ms){
+        gw_takeBack(gw, m);                     // rebooted, full or just not getting anywhere
+        m->lastProgress = now;
+    }
+
+    if(modem->info.satFullyInitialized && !modem->info.isSleeping && now - m->lastRssi >= SWARM_GW_RSSI_ms &&
+       !swarm_cmdIsPending(&modem->cmds, SAT_HEADER_RECEIVE_TEST)){
+        if(swarm_cmdSubmit(&modem->cmds, SAT_CMD_RECEIVE_TEST, SAT_CMD_PARAM_QUERY_LAST_MESSAGE, 0, 0, 0))
+            m->lastRssi = now;
+    }
+
+    // the HAL writes straight to the tty, EPOLLOUT is only needed while the kernel is full
+    wantOut = !swarm_txIsIdle(&modem->txRing);
+    if(wantOut != m->wantOut){
+        ev.events = EPOLLIN | (wantOut ? EPOLLOUT : 0);
+        ev.data.ptr = m;
+        epoll_ctl(gw->epollFd, EPOLL_CTL_MOD, m->port.fd, &ev);
+        m->wantOut = wantOut;
+    }
+}
+
+/* - - - - - - - - - - - - - FUNCTIONS - - - - - - - - - - - - - - - */
+bool swarm_gwInit(SwarmGateway* gw)
+{
+    memset(gw, 0, sizeof(*gw));
+    gw->epollFd = epoll_create1(EPOLL_CLOEXEC);
+    return gw->epollFd >= 0;
+}
+
+void swarm_gwClose(SwarmGateway* gw)
+{
+    unsigned int i;
+
+    for(i = 0; i < gw->modems; i++){
+        if(!gw->modem[i].open)
+            continue;
+        epoll_ctl(gw->epollFd, EPOLL_CTL_DEL, gw->modem[i].port.fd, 0);
+        gw->modem[i].modem.hal->uartClose(&gw->modem[i].modem);
+        gw->modem[i].open = false;
+    }
+    if(gw->epollFd >= 0)
+        close(gw->epollFd);
+    gw->epollFd = -1;
+}
+
+int swarm_gwAdd(SwarmGateway* gw, const char* ttyPath)
+{
+    SwarmGwModem* m;
+    struct epoll_event ev;
+    unsigned long now;
+
+    if(gw->modems >= SWARM_GW_MODEMS)
+        return -1;
+    m = &gw->modem[gw->modems];
+    memset(m, 0, sizeof(*m));
+    swarm_halLinuxPortInit(&m->port, ttyPath);
+    swarm_modemInit(&m->modem, &swarmHalLinux, &m->port, &m->store);
+    swarm_startup(&m->modem);
+    if(m->port.fd < 0)
+        return -1;
+
+    ev.events = EPOLLIN;
+    ev.data.ptr = m;
+    if(epoll_ctl(gw->epollFd, EPOLL_CTL_ADD, m->port.fd, &ev) < 0){
+        m->modem.hal->uartClose(&m->modem);
+        return -1;
+    }
+    now = m->modem.hal->millis();
+    m->open = true;
+    m->lastProgress = now;
+    m->lastRssi = now - SWARM_GW_RSSI_ms;      // ask as soon as it's up
+    return (int)gw->modems++;
+}
+
+bool swarm_gwPush(SwarmGateway* gw, const unsigned char* data, unsigned int len)
+{
+    SwarmGwJob* job;
+
+    if(len == 0 || len > SWARM_QUEUE_DATA_MAX || gw->head - gw->tail >= SWARM_GW_JOBS){
+        gw->stats.dropped++;
+        return false;
+    }
+    job = &gw->job[gw->head % SWARM_GW_JOBS];
+    job->len = (unsigned char)len;
+    memcpy(job->data, data, len);
+    gw->head++;
+    gw->stats.pushed++;
+    if(gw->head - gw->tail > gw->stats.highWater)
+        gw->stats.highWater = gw->head - gw->tail;
+    return true;
+}
+
+unsigned int swarm_gwDepth(const SwarmGateway* gw)
+{
+    return gw->head - gw->tail;
+}
+
+unsigned int swarm_gwPending(const SwarmGateway* gw)
+{
+    unsigned int pending = swarm_gwDepth(gw);
+    unsigned int i;
+
+    for(i = 0; i < gw->modems; i++)
+        pending += swarm_queueDepth(&gw->modem[i].modem.queue);
+    return pending;
+}
+
+unsigned long swarm_gwAccepted(const SwarmGateway* gw)
+{
+    unsigned long accepted = 0;
+    unsigned int i;
+
+    for(i = 0; i < gw->modems; i++)
+        accepted += gw->modem[i].modem.queue.stats.accepted;
+    return accepted;
+}
+
+int swarm_gwRun(SwarmGateway* gw, int timeoutMs)
+{
+    struct epoll_event events[SWARM_GW_MODEMS];
+    SwarmGwModem* m;
+    unsigned long now;
+    unsigned int i;
+    int n;
+
+    n = epoll_wait(gw->epollFd, events, SWARM_GW_MODEMS, timeoutMs);
+    if(n < 0)
+        return errno == EINTR ? 0 : -1;
+    gw->stats.waits++;
+
+    for(i = 0; i < (unsigned int)n; i++){
+        m = (SwarmGwModem*)events[i].data.ptr;
+        m->stats.events++;
+        if(m->open)
+            gw_service(gw, m);                  // reads what's left before a hang up too
+        if(m->open && (events[i].events & (EPOLLERR | EPOLLHUP)))
+            gw_lost(gw, m);
+    }
+
+    // jobs out first so this same pass puts them on the wire, then every modem's timers
+    gw_assign(gw);
+    for(i = 0; i < gw->modems; i++){
+        m = &gw->modem[i];
+        if(!m->open){
+            gw_takeBack(gw, m);                 // in case the shared queue was full when it was lost
+            continue;
+        }
+        swarm_handleMsg(&m->modem);
+        now = m->modem.hal->millis();
+        gw_housekeeping(gw, m, now);
+    }
+    return n;
+}
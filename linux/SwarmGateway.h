@@ -0,0 +1,104 @@
+/*
+ * SwarmGateway.h
+ *
+ *  Created on: Oct 16, 2026
+ *      Author: MicroTechEE
+ *
+ * Many M138s on one Linux box, each on its own USB-serial tty, all driven from one epoll loop. Every modem is a
+ * plain SwarmModem running the same SwarmMSP430.c as the board, on swarmHalLinux. What's added here is the part a
+ * single modem doesn't need: one outbound queue for all of them, and the decision of which modem gets what.
+ *
+ *      swarm_gwPush()   -> shared job ring -> whichever modem is ready pulls it into its own SwarmQueue
+ *
+ * A modem is ready when it's initialized, awake, not holding back on $MT and has fewer than SWARM_GW_LOCAL_MAX
+ * jobs of its own. Between ready modems the lowest score wins:
+ *
+ *      score = local depth * SWARM_GW_DEPTH_WEIGHT + modem's unsent count - signalRating * SWARM_GW_RSSI_WEIGHT
+ *
+ * so a quiet sky ($RT background, asked for every SWARM_GW_RSSI_ms) and an empty pipe both pull more work. Jobs
+ * only ever run SWARM_GW_LOCAL_MAX ahead, and a modem that reboots, drops off the bus or goes SWARM_GW_STALL_ms
+ * without a $TD OK has what it hasn't sent yet taken back and put at the front of the shared queue for the others.
+ *
+ *      static SwarmGateway gw;
+ *      swarm_gwInit(&gw);
+ *      swarm_gwAdd(&gw, "/dev/ttyUSB0");
+ *      swarm_gwAdd(&gw, "/dev/ttyUSB1");
+ *      for(;;){
+ *          swarm_gwPush(&gw, packet, len);      // whenever there's something to send
+ *          swarm_gwRun(&gw, 10);
+ *      }
+ *
+ * Single threaded, push from the same thread that runs the loop.
+ */
+
+#ifndef SWARMGATEWAY_H_
+#define SWARMGATEWAY_H_
+
+#include <stdbool.h>
+#include <SwarmMSP430.h>
+#include "SwarmHAL_Linux.h"
+
+#define SWARM_GW_MODEMS                                 16
+#define SWARM_GW_JOBS                                   1024     // shared outbound queue, power of 2
+#define SWARM_GW_LOCAL_MAX                              2        // jobs a modem holds in its own SwarmQueue, in flight included
+#define SWARM_GW_DEPTH_WEIGHT                           8
+#define SWARM_GW_RSSI_WEIGHT                            4
+#define SWARM_GW_RSSI_ms                                60000    // $RT @ this often on every modem
+#define SWARM_GW_STALL_ms                               30000    // jobs and no $TD OK for this long -> take them back
+
+/* * * * * * * * STRUCTS * * * * * * * * * */
+typedef struct{
+    unsigned char len;
+    unsigned char data[SWARM_QUEUE_DATA_MAX];
+}SwarmGwJob;
+
+typedef struct{
+    unsigned long pulled;                       // jobs this modem took from the shared queue
+    unsigned long takenBack;                    // and gave back
+    unsigned long lost;                         // times its tty went away
+    unsigned long events;                       // epoll wakeups for this fd
+}SwarmGwModemStats;
+
+typedef struct{
+    SwarmModem modem;
+    SwarmLinuxPort port;
+    SwarmQueueStore store;                      // RAM here, the FRAM queue code runs as is
+    bool open;
+    bool wantOut;                               // EPOLLOUT is armed, the TX ring didn't all fit in the kernel
+    unsigned long lastProgress;                 // last $TD OK, or last time it had nothing to do
+    unsigned long lastAccepted;
+    unsigned long lastRssi;
+    SwarmGwModemStats stats;
+}SwarmGwModem;
+
+typedef struct{
+    unsigned long pushed;
+    unsigned long dropped;                      // shared queue was full
+    unsigned long assigned;
+    unsigned long requeued;                     // taken back from a modem and put in front
+    unsigned long waits;                        // epoll_wait calls
+    unsigned int highWater;
+}SwarmGwStats;
+
+typedef struct{
+    SwarmGwModem modem[SWARM_GW_MODEMS];
+    unsigned int modems;
+    int epollFd;
+    SwarmGwJob job[SWARM_GW_JOBS];
+    unsigned int head;                          // free running
+    unsigned int tail;
+    unsigned int next;                          // where the next search starts, so ties go round robin
+    SwarmGwStats stats;
+}SwarmGateway;
+
+/* * * * * * * * FUNCTIONS * * * * * * * * * */
+bool swarm_gwInit(SwarmGateway* gw);
+void swarm_gwClose(SwarmGateway* gw);
+int swarm_gwAdd(SwarmGateway* gw, const char* ttyPath);           // index, -1 if it can't be opened or there's no room
+bool swarm_gwPush(SwarmGateway* gw, const unsigned char* data, unsigned int len);
+unsigned int swarm_gwDepth(const SwarmGateway* gw);                 // shared queue only
+unsigned int swarm_gwPending(const SwarmGateway* gw);               // shared queue and every modem's own
+int swarm_gwRun(SwarmGateway* gw, int timeoutMs);                   // one epoll_wait and everything after it, -1 on error
+unsigned long swarm_gwAccepted(const SwarmGateway* gw);             // $TD OK, all modems
+
+#endif /* SWARMGATEWAY_H_ */
@@ -0,0 +1,230 @@
+/*
+ * SwarmHAL_Linux.c
+ *
+ *  Created on: Oct 16, 2026
+ *      Author: MicroTechEE
+ */
+
+// STD C
+#include <stdbool.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+
+// POSIX
+#include <fcntl.h>
+#include <poll.h>
+#include <termios.h>
+#include <unistd.h>
+
+#include <Message.h>
+#include <SwarmMSP430.h>
+#include <SwarmHAL.h>
+#include "SwarmHAL_Linux.h"
+
+/* - - - - - - - - - - - - - GLOBALS - - - - - - - - - - - - - - - */
+SwarmHalLinuxStats swarmHalLinuxStats = {0, 0, 0, 0};
+Calendar swarmHalLinuxRtc = {0, 0, 0, 0, 0, 0, 0};
+
+/* - - - - - - - - - - - - - FUNCTIONS - - - - - - - - - - - - - - - */
+unsigned long long swarm_halLinuxMicros(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (unsigned long long)ts.tv_sec * 1000000ULL + (unsigned long long)ts.tv_nsec / 1000ULL;
+}
+
+void swarm_halLinuxPortInit(SwarmLinuxPort* port, const char* path)
+{
+    memset(port, 0, sizeof(*port));
+    strncpy(port->path, path, sizeof(port->path) - 1);
+    port->fd = -1;
+}
+
+int swarm_halLinuxFd(const SwarmModem* modem)
+{
+    return ((const SwarmLinuxPort*)modem->port)->fd;
+}
+
+static void linux_txDrain(SwarmModem* modem)
+{
+    // This is the TX ISR / DMA: hand the kernel whatever it takes without waiting, the rest goes next poll
+    SwarmLinuxPort* port = (SwarmLinuxPort*)modem->port;
+    const unsigned char* data;
+    unsigned int len;
+    ssize_t n;
+
+    if(port->fd < 0)
+        return;
+    while((len = swarm_txPeek(&modem->txRing, &data)) > 0){
+        n = write(port->fd, data, len);
+        if(n <= 0)
+            return;
+        swarm_traceWrite(port->trace, SwarmTraceTx, data, (unsigned int)n, swarm_halLinuxMicros());
+        swarm_txConsume(&modem->txRing, (unsigned int)n);
+        port->stats.bytesTx += (unsigned long)n;
+        swarmHalLinuxStats.bytesTx += (unsigned long)n;
+    }
+}
+
+static int linux_rxFeed(SwarmModem* modem)
+{
+    // Hand bytes to the "RX ISR" up to and including one '\n', so the caller gets to run swarm_handleMsg()
+    // between lines the way the superloop runs between RX interrupts on the board
+    SwarmLinuxPort* port = (SwarmLinuxPort*)modem->port;
+    int fed = 0;
+    unsigned char byte;
+
+    while(port->rxPos < port->rxLen){
+        byte = port->rxBuf[port->rxPos++];
+        fed++;
+#if SAT_RX_FROM_MESSAGE
+        message_rxByte((MessagePort)modem->rxMessagePort, byte);
+#else
+        swarm_rxByte(modem, byte);
+#endif
+        if(byte == '\n')
+            break;
+    }
+    return fed;
+}
+
+int swarm_halLinuxPoll(SwarmModem* modem, int timeoutMs)
+{
+    SwarmLinuxPort* port = (SwarmLinuxPort*)modem->port;
+    struct pollfd pfd;
+    ssize_t n;
+
+    if(port->fd < 0)
+        return -1;
+
+    linux_txDrain(modem);
+    if(port->rxPos < port->rxLen)
+        return linux_rxFeed(modem);                // still working through the last read
+
+    pfd.fd = port->fd;
+    pfd.events = POLLIN;
+    if(!swarm_txIsIdle(&modem->txRing))
+        pfd.events |= POLLOUT;
+    if(poll(&pfd, 1, timeoutMs) <= 0)
+        return 0;
+    if(pfd.revents & POLLOUT)
+        linux_txDrain(modem);
+    if(!(pfd.revents & POLLIN))
+        return 0;
+
+    n = read(port->fd, port->rxBuf, sizeof(port->rxBuf));
+    if(n < 0)
+        return (errno == EAGAIN || errno == EWOULDBLOCK) ? 0 : -1;
+    port->rxLen = (unsigned int)n;
+    port->rxPos = 0;
+    swarm_traceWrite(port->trace, SwarmTraceRx, port->rxBuf, port->rxLen, swarm_halLinuxMicros());
+    port->stats.bytesRx += (unsigned long)n;
+    swarmHalLinuxStats.bytesRx += (unsigned long)n;
+    return linux_rxFeed(modem);
+}
+
+static void linux_uartOpen(SwarmModem* modem)
+{
+    SwarmLinuxPort* port = (SwarmLinuxPort*)modem->port;
+    struct termios tio;
+
+    port->rxLen = 0;
+    port->rxPos = 0;
+    port->fd = open(port->path, O_RDWR | O_NOCTTY | O_NONBLOCK);
+    if(port->fd < 0)
+        return;
+
+    if(tcgetattr(port->fd, &tio) == 0){
+        cfmakeraw(&tio);
+        cfsetispeed(&tio, B115200);              // Swarm only uses 115200
+        cfsetospeed(&tio, B115200);
+        tio.c_cflag |= CLOCAL | CREAD;
+        tcsetattr(port->fd, TCSANOW, &tio);
+    }
+    tcflush(port->fd, TCIOFLUSH);                // a UART that was just set up has nothing buffered either
+}
+
+static void linux_uartClose(SwarmModem* modem)
+{
+    SwarmLinuxPort* port = (SwarmLinuxPort*)modem->port;
+
+    if(port->fd >= 0)
+        close(port->fd);
+    port->fd = -1;
+}
+
+static void linux_uartTxStart(SwarmModem* modem)
+{
+    linux_txDrain(modem);
+}
+
+static void linux_gpioWrite(SwarmModem* modem, char pinState)
+{
+    ((SwarmLinuxPort*)modem->port)->gpio = pinState;
+}
+
+static void linux_delayMs(unsigned int ms)
+{
+    unsigned long long start = swarm_halLinuxMicros();
+
+    cycleDelay_ms(ms);
+    swarmHalLinuxStats.delayCalls++;
+    swarmHalLinuxStats.blockedUs += swarm_halLinuxMicros() - start;
+}
+
+static void linux_rtcSet(Calendar dateTime)
+{
+    swarmHalLinuxRtc = dateTime;
+}
+
+static unsigned long linux_millis(void)
+{
+    return (unsigned long)(swarm_halLinuxMicros() / 1000ULL);
+}
+
+static unsigned int linux_ticks(void)
+{
+    // ns, wraps every 4 s but only the time inside one parse function is ever taken
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (unsigned int)((unsigned long long)ts.tv_sec * 1000000000ULL + (unsigned long long)ts.tv_nsec);
+}
+
+static void linux_idle(SwarmModem* const* modems, unsigned int count, unsigned long maxMs)
+{
+    // LPM on the host is poll() on every modem's tty. Nothing is read here, the caller's swarm_halLinuxPoll()
+    // feeds whatever woke us, so nothing can be missed between the check and the sleep
+    struct pollfd pfd[SWARM_LINUX_IDLE_FDS];
+    const SwarmLinuxPort* port;
+    unsigned int n = 0;
+    unsigned int i;
+
+    for(i = 0; i < count && n < SWARM_LINUX_IDLE_FDS; i++){
+        port = (const SwarmLinuxPort*)modems[i]->port;
+        if(port->rxPos < port->rxLen)
+            return;                                // half a read() still to feed
+        if(port->fd < 0)
+            continue;
+        pfd[n].fd = port->fd;
+        pfd[n].events = POLLIN;
+        if(!swarm_txIsIdle(&modems[i]->txRing))
+            pfd[n].events |= POLLOUT;
+        n++;
+    }
+    poll(pfd, n, (int)maxMs);
+}
+
+const SwarmHal swarmHalLinux = {
+    linux_uartOpen,
+    linux_uartClose,
+    linux_uartTxStart,
+    linux_gpioWrite,
+    linux_delayMs,
+    linux_rtcSet,
+    linux_millis,
+    linux_idle,
+    linux_ticks
+};
@@ -0,0 +1,59 @@
+/*
+ * SwarmHAL_Linux.h
+ *
+ *  Created on: Oct 16, 2026
+ *      Author: MicroTechEE
+ *
+ * Runs SwarmMSP430.c on Linux against a real modem on a USB-serial tty or the pty from SwarmSim.
+ * There's no ISR here, so swarm_halLinuxPoll() does the UART ISRs' job: it drains the modem's TX ring into the
+ * tty and feeds RX bytes to swarm_rxByte() (or the Message system with SAT_RX_FROM_MESSAGE), one line per
+ * call. Call it in a loop with swarm_handleMsg() until it returns 0.
+ *
+ *      SwarmLinuxPort port;
+ *      swarm_halLinuxPortInit(&port, "/dev/ttyUSB0");
+ *      swarm_modemInit(&modem, &swarmHalLinux, &port, &store);
+ *
+ * One port per modem, as many as you have fds for. swarm_halLinuxFd() is there to put them all in one
+ * poll / epoll and only call swarm_halLinuxPoll(modem, 0) on the ones that are ready.
+ */
+
+#ifndef SWARMHAL_LINUX_H_
+#define SWARMHAL_LINUX_H_
+
+#include <stdbool.h>
+#include <SwarmHAL.h>
+#include "SwarmTrace.h"
+
+#define SWARM_LINUX_IDLE_FDS                            32       // modems one swarm_eventWait() can sleep on
+
+/* * * * * * * * STRUCTS * * * * * * * * * */
+typedef struct{
+    unsigned long bytesTx;
+    unsigned long bytesRx;
+    unsigned long delayCalls;
+    unsigned long long blockedUs;           // time the driver spent in delayMs()
+}SwarmHalLinuxStats;
+
+typedef struct{
+    char path[256];                         // uartOpen opens this
+    int fd;
+    unsigned char rxBuf[256];               // last read() from the tty, fed out a line at a time
+    unsigned int rxLen;
+    unsigned int rxPos;
+    char gpio;                              // last level written to the wake pin
+    SwarmHalLinuxStats stats;               // this port only
+    SwarmTrace* trace;                      // every read() and write() goes in here when set, see SwarmTrace.h
+}SwarmLinuxPort;
+
+/* * * * * * * * GLOBALS * * * * * * * * * */
+extern const SwarmHal swarmHalLinux;
+extern SwarmHalLinuxStats swarmHalLinuxStats;   // every port added up
+extern Calendar swarmHalLinuxRtc;           // last time handed to rtcSet
+
+/* * * * * * * * FUNCTIONS * * * * * * * * * */
+void swarm_halLinuxPortInit(SwarmLinuxPort* port, const char* ttyPath);   // before swarm_modemInit()
+int swarm_halLinuxFd(const struct SwarmModem* modem);
+int swarm_halLinuxPoll(struct SwarmModem* modem, int timeoutMs);   // returns bytes fed, 0 on timeout, -1 on error
+unsigned long long swarm_halLinuxMicros(void);     // monotonic
+
+#endif /* SWARMHAL_LINUX_H_ */
@@ -0,0 +1,709 @@
+/*
+ * SwarmSim.c
+ *
+ *  Created on: Oct 16, 2026
+ *      Author: MicroTechEE
+ */
+
+#define _GNU_SOURCE
+
+// STD C
+#include <stdarg.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+
+// POSIX
+#include <fcntl.h>
+#include <poll.h>
+#include <termios.h>
+#include <unistd.h>
+
+#include "SwarmSim.h"
+
+static const char* rateHeaders[SwarmSimRateCount] = {"DT", "GJ", "GN", "GS", "PW", "RT"};
+
+/* - - - - - - - - - - - - - HELPERS - - - - - - - - - - - - - - - */
+static unsigned long long sim_nowMs(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (unsigned long long)ts.tv_sec * 1000ULL + (unsigned long long)ts.tv_nsec / 1000000ULL;
+}
+
+static unsigned int sim_rand(SwarmSim* sim)
+{
+    sim->randState = sim->randState * 1103515245u + 12345u;
+    return (sim->randState >> 16) & 0x7FFF;
+}
+
+static unsigned char sim_checksum(const char* sz, unsigned int len)
+{
+    unsigned int i = 0;
+    unsigned char cs = 0;
+
+    if(sz[0] == '$')
+        i++;
+    for(; i < len; i++)
+        cs ^= (unsigned char)sz[i];
+    return cs;
+}
+
+static unsigned long long sim_scaledMs(SwarmSim* sim, unsigned long seconds)
+{
+    return (unsigned long long)seconds * 1000ULL / (sim->config.timeScale ? sim->config.timeScale : 1);
+}
+
+/* - - - - - - - - - - - - - OUTPUT - - - - - - - - - - - - - - - */
+static void sim_queueRaw(SwarmSim* sim, unsigned long long due, const char* data, unsigned int len)
+{
+    SwarmSimLine* line;
+
+    if(sim->outHead - sim->outTail >= SWARMSIM_OUT_MAX)
+        return;                                         // a real UART would overrun too
+    if(len > SWARMSIM_LINE_MAX)
+        len = SWARMSIM_LINE_MAX;
+    if(due < sim->lastDue)
+        due = sim->lastDue;                             // bytes leave a UART in order
+    sim->lastDue = due;
+
+    line = &sim->out[sim->outHead % SWARMSIM_OUT_MAX];
+    line->due = due;
+    line->len = len;
+    memcpy(line->data, data, len);
+    sim->outHead++;
+}
+
+static void sim_sendAt(SwarmSim* sim, unsigned long long due, const char* fmt, ...)
+{
+    char buf[SWARMSIM_LINE_MAX];
+    int len;
+    va_list args;
+
+    va_start(args, fmt);
+    len = vsnprintf(buf, sizeof(buf) - 5, fmt, args);
+    va_end(args);
+    if(len < 0)
+        return;
+    if(len > (int)sizeof(buf) - 5)
+        len = (int)sizeof(buf) - 5;
+    len += snprintf(buf + len, 5, "*%02X\n", sim_checksum(buf, (unsigned int)len));
+    sim_queueRaw(sim, due, buf, (unsigned int)len);
+}
+
+static unsigned long long sim_responseDue(SwarmSim* sim)
+{
+    unsigned long long due = sim_nowMs() + sim->config.latencyMs;
+
+    if(sim->config.jitterMs)
+        due += sim_rand(sim) % (sim->config.jitterMs + 1);
+    return due;
+}
+
+#define sim_reply(sim, ...)         sim_sendAt((sim), sim_responseDue(sim), __VA_ARGS__)
+#define sim_unsolicited(sim, ...)   sim_sendAt((sim), sim_nowMs(), __VA_ARGS__)
+
+static void sim_flush(SwarmSim* sim)
+{
+    unsigned long long now = sim_nowMs();
+    SwarmSimLine* line;
+    ssize_t n;
+
+    while(sim->outTail != sim->outHead){
+        line = &sim->out[sim->outTail % SWARMSIM_OUT_MAX];
+        if(line->due > now)
+            return;
+        n = write(sim->masterFd, line->data, line->len);
+        if(n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+            return;
+        if(sim->config.verbose)
+            fprintf(stderr, "sim > %.*s", (int)line->len, line->data);
+        sim->outTail++;
+        sim->txLines++;
+    }
+}
+
+/* - - - - - - - - - - - - - REPORTS - - - - - - - - - - - - - - - */
+static void sim_report(SwarmSim* sim, SwarmSimRate which, bool solicited)
+{
+    unsigned long long due = solicited ? sim_responseDue(sim) : sim_nowMs();
+    time_t t;
+    struct tm tm;
+
+    switch(which){
+    case SwarmSimDT:
+        t = time(0);
+        gmtime_r(&t, &tm);
+        sim_sendAt(sim, due, "$DT %04d%02d%02d%02d%02d%02d,%c", tm.tm_year + 1900, tm.tm_mon + 1, tm.tm_mday,
+                   tm.tm_hour, tm.tm_min, tm.tm_sec, sim->dateTimeSent ? 'V' : 'I');
+        break;
+    case SwarmSimGJ:
+        sim_sendAt(sim, due, "$GJ 0,%u", 60 + sim_rand(sim) % 30);
+        break;
+    case SwarmSimGN:
+        if(sim->positionSent)
+            sim_sendAt(sim, due, "$GN 37.8921,-122.0155,%u,89,%u", 70 + sim_rand(sim) % 10, sim_rand(sim) % 4);
+        else
+            sim_sendAt(sim, due, "$GN 0.0000,0.0000,0,0,0");
+        break;
+    case SwarmSimGS:
+        sim_sendAt(sim, due, "$GS %u,%u,%u,0,%s", 100 + sim_rand(sim) % 50, 200 + sim_rand(sim) % 50, 8 + sim_rand(sim) % 5,
+                   sim->positionSent ? "G3" : "NF");
+        break;
+    case SwarmSimPW:
+        sim_sendAt(sim, due, "$PW 3.30000,0.00000,0.00000,0.00000,%u.0", 25 + sim_rand(sim) % 10);
+        break;
+    case SwarmSimRT:
+        if(!solicited && (sim_rand(sim) % 4) == 0)      // now and then a satellite goes over
+            sim_sendAt(sim, due, "$RT RSSI=%d,SNR=%d,FDEV=%d,TS=2026-10-16 12:00:00,DI=0x000%03x",
+                       -95 - (int)(sim_rand(sim) % 15), (int)(sim_rand(sim) % 12) - 2,
+                       (int)(sim_rand(sim) % 4000) - 2000, sim_rand(sim) % 0xFFF);
+        else
+            sim_sendAt(sim, due, "$RT RSSI=%d", sim->config.backgroundRssi - (int)(sim_rand(sim) % 4));
+        break;
+    default:
+        break;
+    }
+}
+
+/* - - - - - - - - - - - - - COMMANDS - - - - - - - - - - - - - - - */
+static void sim_rateCommand(SwarmSim* sim, SwarmSimRate which, const char* params)
+{
+    if(params[0] == '@')
+        sim_report(sim, which, true);
+    else if(params[0] == '?')
+        sim_reply(sim, "$%s %u", rateHeaders[which], sim->rate[which]);
+    else if(params[0] >= '0' && params[0] <= '9'){
+        sim->rate[which] = (unsigned int)strtoul(params, 0, 10);
+        sim->nextReport[which] = sim_nowMs() + sim_scaledMs(sim, sim->rate[which]);
+        sim_reply(sim, "$%s OK", rateHeaders[which]);
+    }
+    else
+        sim_reply(sim, "$%s ERR,BADPARAM", rateHeaders[which]);
+}
+
+static int sim_nibble(char c)
+{
+    if(c >= '0' && c <= '9')
+        return c - '0';
+    if(c >= 'a' && c <= 'f')
+        return c - 'a' + 10;
+    if(c >= 'A' && c <= 'F')
+        return c - 'A' + 10;
+    return -1;
+}
+
+static unsigned int sim_keepPayload(SwarmSim* sim, const char* data, unsigned int dataLen)
+{
+    // decoded into a free tdData slot for tdDelivered, 0 if there's no room or it isn't ours to keep
+    unsigned int i;
+    unsigned int n;
+
+    if(!sim->config.tdDelivered)
+        return 0;
+    for(i = 0; i < SWARMSIM_TD_KEEP && sim->tdDataLen[i]; i++)
+        ;
+    if(i == SWARMSIM_TD_KEEP)
+        return 0;
+    if(data[0] == '"'){
+        n = dataLen - 2;
+        memcpy(sim->tdData[i], data + 1, n);
+    }
+    else{
+        for(n = 0; n < dataLen / 2; n++)
+            sim->tdData[i][n] = (unsigned char)(sim_nibble(data[n * 2]) << 4 | sim_nibble(data[n * 2 + 1]));
+    }
+    sim->tdDataLen[i] = n;
+    return n ? i + 1 : 0;
+}
+
+static void sim_transmitData(SwarmSim* sim, const char* params)
+{
+    const char* data = params;
+    const char* comma;
+    unsigned int dataLen;
+
+    // skip AI=, HD=, ET= parameters, whatever is left is the payload
+    while((data[0] == 'A' && data[1] == 'I' && data[2] == '=') || (data[0] == 'H' && data[1] == 'D' && data[2] == '=') ||
+          (data[0] == 'E' && data[1] == 'T' && data[2] == '=')){
+        comma = strchr(data, ',');
+        if(!comma){
+            sim_reply(sim, "$TD ERR,BADDATA");
+            return;
+        }
+        data = comma + 1;
+    }
+
+    dataLen = (unsigned int)strlen(data);
+    if(dataLen == 0){
+        sim_reply(sim, "$TD ERR,BADDATA");
+        return;
+    }
+    if(data[0] == '"' ? dataLen > 192 + 2 : dataLen > 384){
+        sim_reply(sim, "$TD ERR,TDTOOLONG");
+        return;
+    }
+    if(sim->unsent >= SWARMSIM_TD_MAX){
+        sim_reply(sim, "$TD ERR,DBXTOHIVEFULL");
+        return;
+    }
+
+    sim->td[sim->unsent].id = sim->nextMsgId++;
+    sim->td[sim->unsent].sendAt = sim_nowMs() + sim->config.tdSentMs + sim_rand(sim) % (sim->config.tdSentMs / 2 + 1);
+    sim->td[sim->unsent].keep = sim_keepPayload(sim, data, dataLen);
+    sim_reply(sim, "$TD OK,%llu", sim->td[sim->unsent].id);
+    sim->unsent++;
+}
+
+static void sim_messageTxManagement(SwarmSim* sim, const char* params)
+{
+    unsigned int deleted;
+
+    if(strcmp(params, "C=U") == 0 || strcmp(params, "C=**") == 0)
+        sim_reply(sim, "$MT %u", sim->unsent);
+    else if(strcmp(params, "D=U") == 0){
+        for(deleted = 0; deleted < sim->unsent; deleted++){
+            if(sim->td[deleted].keep)
+                sim->tdDataLen[sim->td[deleted].keep - 1] = 0;
+        }
+        deleted = sim->unsent;
+        sim->unsent = 0;
+        sim_reply(sim, "$MT %u", deleted);
+    }
+    else
+        sim_reply(sim, "$MT ERR,BADPARAM");
+}
+
+static void sim_rxHex(unsigned long seq, char* hex)
+{
+    unsigned char data[SWARMSIM_RX_DATA];
+    unsigned int i;
+
+    swarmsim_downlinkData(seq, data);
+    for(i = 0; i < SWARMSIM_RX_DATA; i++)
+        sprintf(hex + i * 2, "%02x", data[i]);
+}
+
+static void sim_messageRxManagement(SwarmSim* sim, const char* params)
+{
+    char hex[SWARMSIM_RX_DATA * 2 + 1];
+    unsigned int count = 0;
+    unsigned int i;
+    unsigned int k;
+
+    if(strcmp(params, "C=U") == 0 || strcmp(params, "C=*") == 0){
+        for(i = 0; i < sim->rxStored; i++)
+            count += params[2] == '*' || !sim->rx[i].read;
+        sim_reply(sim, "$MM %u", count);
+    }
+    else if(strcmp(params, "R=O") == 0 || strcmp(params, "R=N") == 0){
+        for(k = 0; k < sim->rxStored; k++){
+            i = params[2] == 'O' ? k : sim->rxStored - 1 - k;
+            if(sim->rx[i].read)
+                continue;
+            sim->rx[i].read = true;
+            sim->mmRead++;
+            sim_rxHex(sim->rx[i].seq, hex);
+            sim_reply(sim, "$MM AI=%u,%s,%llu,%lu", sim->rx[i].appId, hex, sim->rx[i].id, sim->rx[i].epoch);
+            return;
+        }
+        sim_reply(sim, "$MM ERR,DBXNOMORE");
+    }
+    else if(strcmp(params, "M=*") == 0){
+        for(i = 0; i < sim->rxStored; i++){
+            count += !sim->rx[i].read;
+            sim->rx[i].read = true;
+        }
+        sim_reply(sim, "$MM %u,MARKED", count);
+    }
+    else if(strcmp(params, "D=*") == 0 || strcmp(params, "D=**") == 0){
+        for(i = 0, k = 0; i < sim->rxStored; i++){
+            if(params[3] == '*' || sim->rx[i].read)
+                count++;
+            else
+                sim->rx[k++] = sim->rx[i];
+        }
+        sim->rxStored = k;
+        sim_reply(sim, "$MM %u,DELETED", count);
+    }
+    else
+        sim_reply(sim, "$MM ERR,BADPARAM");
+}
+
+static void sim_downlink(SwarmSim* sim, unsigned long long now)
+{
+    // a burst from the ground, kept for $MM and pushed as $RD if the modem is listening
+    char hex[SWARMSIM_RX_DATA * 2 + 1];
+    SwarmSimRx* rx;
+    unsigned int i;
+
+    if(!sim->config.downlinkMs || now < sim->nextDownlink)
+        return;
+    sim->nextDownlink = now + sim->config.downlinkMs;
+    for(i = 0; i < sim->config.downlinkBurst; i++){
+        if(sim->config.downlinkCount && sim->rxSeq >= sim->config.downlinkCount)
+            return;
+        if(sim->rxStored >= SWARMSIM_RX_MAX)
+            return;                                     // database full, the ground keeps it
+        rx = &sim->rx[sim->rxStored++];
+        rx->seq = sim->rxSeq++;
+        rx->appId = SWARMSIM_RX_APP_BASE + rx->seq % 4;
+        rx->id = sim->nextMsgId++;
+        rx->epoch = (unsigned long)time(0);
+        rx->read = false;
+        if(sim->sleeping)
+            continue;
+        sim_rxHex(rx->seq, hex);
+        sim_unsolicited(sim, "$RD AI=%u,RSSI=%d,SNR=%d,FDEV=%d,%s", rx->appId, -95 - (int)(sim_rand(sim) % 10),
+                        (int)(sim_rand(sim) % 8), (int)(sim_rand(sim) % 1000) - 500, hex);
+        sim->rdPushed++;
+    }
+}
+
+static void sim_sleep(SwarmSim* sim, const char* params)
+{
+    unsigned long seconds;
+
+    if(params[0] != 'S' || params[1] != '='){
+        sim_reply(sim, "$SL ERR,BADPARAM");
+        return;
+    }
+    seconds = strtoul(params + 2, 0, 10);
+    if(seconds < 5){
+        sim_reply(sim, "$SL ERR,BADPARAM");
+        return;
+    }
+    sim_reply(sim, "$SL OK");
+    sim->sleeping = true;
+    sim->wakeAt = sim->lastDue + sim_scaledMs(sim, seconds);
+}
+
+static void sim_command(SwarmSim* sim, char* line, unsigned int len)
+{
+    char* star;
+    char* params;
+    char hdr[3];
+    unsigned int rxCs;
+
+    sim->rxCommands++;
+    if(sim->config.verbose)
+        fprintf(stderr, "sim < %.*s\n", (int)len, line);
+
+    if(sim->poweredOff || !sim->running)
+        return;                                         // modem isn't listening yet
+
+    if(sim->sleeping){
+        sim->sleeping = false;                          // any serial activity wakes it
+        sim_unsolicited(sim, "$SL WAKE,SERIAL");
+    }
+
+    if(len < 3 || line[0] != '$')
+        return;
+    hdr[0] = line[1];
+    hdr[1] = line[2];
+    hdr[2] = 0;
+
+    star = strrchr(line, '*');
+    if(!star || sscanf(star + 1, "%2x", &rxCs) != 1 || rxCs != sim_checksum(line, (unsigned int)(star - line))){
+        sim->rxBadChecksum++;
+        sim_reply(sim, "$%s ERR,BADCHECKSUM", hdr);
+        return;
+    }
+    if(sim->config.lossPercent && sim_rand(sim) % 100 < sim->config.lossPercent){
+        sim->rxLost++;
+        return;
+    }
+    *star = 0;
+    params = line + 3;
+    if(*params == ' ')
+        params++;
+
+    if(strcmp(hdr, "CS") == 0)
+        sim_reply(sim, "$CS DI=0x%06lx,DN=M138", sim->config.deviceId);
+    else if(strcmp(hdr, "DT") == 0)
+        sim_rateCommand(sim, SwarmSimDT, params);
+    else if(strcmp(hdr, "FV") == 0)
+        sim_reply(sim, "$FV 2021-07-16T00:10:21,v1.1.0");
+    else if(strcmp(hdr, "GJ") == 0)
+        sim_rateCommand(sim, SwarmSimGJ, params);
+    else if(strcmp(hdr, "GN") == 0)
+        sim_rateCommand(sim, SwarmSimGN, params);
+    else if(strcmp(hdr, "GS") == 0)
+        sim_rateCommand(sim, SwarmSimGS, params);
+    else if(strcmp(hdr, "PW") == 0)
+        sim_rateCommand(sim, SwarmSimPW, params);
+    else if(strcmp(hdr, "RT") == 0)
+        sim_rateCommand(sim, SwarmSimRT, params);
+    else if(strcmp(hdr, "GP") == 0){
+        if(params[0] == '?')
+            sim_reply(sim, "$GP %u", sim->gpioMode);
+        else if(params[0] == '@')
+            sim_reply(sim, "$GP 0");
+        else if(params[0] >= '0' && params[0] <= '9'){
+            sim->gpioMode = (unsigned int)(params[0] - '0');
+            sim_reply(sim, "$GP OK");
+        }
+        else
+            sim_reply(sim, "$GP ERR,BADPARAM");
+    }
+    else if(strcmp(hdr, "MM") == 0)
+        sim_messageRxManagement(sim, params);
+    else if(strcmp(hdr, "MT") == 0)
+        sim_messageTxManagement(sim, params);
+    else if(strcmp(hdr, "PO") == 0){
+        sim_reply(sim, "$PO OK");
+        sim->poweredOff = true;
+    }
+    else if(strcmp(hdr, "RS") == 0){
+        sim_reply(sim, "$RS OK");
+        if(strcmp(params, "deletedb") == 0){
+            sim->unsent = 0;
+            sim->rxStored = 0;
+        }
+        sim->bootAt = sim->lastDue + 50;
+        swarmsim_powerOn(sim);
+    }
+    else if(strcmp(hdr, "SL") == 0)
+        sim_sleep(sim, params);
+    else if(strcmp(hdr, "TD") == 0)
+        sim_transmitData(sim, params);
+    else
+        sim_reply(sim, "$%s ERR,NOCOMMAND", hdr);
+}
+
+/* - - - - - - - - - - - - - BOOT - - - - - - - - - - - - - - - */
+void swarmsim_powerOn(SwarmSim* sim)
+{
+    unsigned long long start = sim_nowMs();
+    unsigned long long step;
+    char junk[48];
+    unsigned int i;
+    unsigned int j;
+    unsigned int len;
+
+    sim->poweredOff = false;
+    sim->running = false;
+    sim->dateTimeSent = false;
+    sim->positionSent = false;
+    sim->sleeping = false;
+    memset(sim->rate, 0, sizeof(sim->rate));
+    if(start < sim->lastDue)
+        start = sim->lastDue;
+    sim->bootAt = start;
+    step = sim->config.bootMs / (sim->config.bootNoiseLines + 4);
+
+    // The bootloader prints dots and binary junk before the firmware is up, this is what the '.' check is for
+    for(i = 0; i < sim->config.bootNoiseLines; i++){
+        len = 4 + sim_rand(sim) % 24;
+        for(j = 0; j < len; j++)
+            junk[j] = (i & 1) ? (char)(0x80 | sim_rand(sim)) : '.';
+        if(junk[0] == '$')
+            junk[0] = '.';
+        junk[len++] = '\n';
+        sim_queueRaw(sim, start + step * i, junk, len);
+    }
+    start += step * i;
+    sim_sendAt(sim, start, "$M138 BOOT,POWERON,LPWR=n,WDOG=n,SFT=n,HRD=y");
+    sim_sendAt(sim, start + step, "$M138 BOOT,DEVICEID,DI=0x%06lx", sim->config.deviceId);
+    sim_sendAt(sim, start + step * 2, "$M138 BOOT,VERSION,2021-07-16T00:10:21,v1.1.0");
+    sim_sendAt(sim, sim->bootAt + sim->config.bootMs, "$M138 BOOT,RUNNING");
+}
+
+/* - - - - - - - - - - - - - LOOP - - - - - - - - - - - - - - - */
+static void sim_tick(SwarmSim* sim)
+{
+    unsigned long long now = sim_nowMs();
+    unsigned int i;
+    unsigned int k;
+
+    if(sim->poweredOff)
+        return;
+
+    if(!sim->running && now >= sim->bootAt + sim->config.bootMs){
+        sim->running = true;
+    }
+    if(!sim->running)
+        return;
+
+    if(!sim->dateTimeSent && now >= sim->bootAt + sim->config.bootMs + sim->config.dateTimeMs){
+        sim->dateTimeSent = true;
+        sim_unsolicited(sim, "$M138 DATETIME");
+    }
+    if(!sim->positionSent && now >= sim->bootAt + sim->config.bootMs + sim->config.positionMs){
+        sim->positionSent = true;
+        sim_unsolicited(sim, "$M138 POSITION");
+    }
+
+    sim_downlink(sim, now);
+    if(sim->sleeping){
+        if(now < sim->wakeAt)
+            return;
+        sim->sleeping = false;
+        sim_unsolicited(sim, "$SL WAKE,TIME");
+    }
+
+    for(i = 0; i < SwarmSimRateCount; i++){
+        if(sim->rate[i] && now >= sim->nextReport[i]){
+            sim_report(sim, (SwarmSimRate)i, false);
+            sim->nextReport[i] = now + sim_scaledMs(sim, sim->rate[i]);
+        }
+    }
+
+    // TD messages go out in order of their send time, the rest slide down
+    for(i = 0, k = 0; i < sim->unsent; i++){
+        if(now < sim->td[i].sendAt){
+            sim->td[k++] = sim->td[i];
+            continue;
+        }
+        if(sim->config.tdLossPercent && sim_rand(sim) % 100 < sim->config.tdLossPercent)
+            sim->tdLost++;                      // expired on the modem, no SENT and nothing on the ground
+        else{
+            sim_unsolicited(sim, "$TD SENT RSSI=%d,SNR=%d,FDEV=%d,%llu", -100 - (int)(sim_rand(sim) % 10),
+                            (int)(sim_rand(sim) % 10), (int)(sim_rand(sim) % 2000) - 1000, sim->td[i].id);
+            if(sim->td[i].keep)
+                sim->config.tdDelivered(sim->tdData[sim->td[i].keep - 1], sim->tdDataLen[sim->td[i].keep - 1]);
+        }
+        if(sim->td[i].keep)
+            sim->tdDataLen[sim->td[i].keep - 1] = 0;
+    }
+    sim->unsent = k;
+}
+
+void swarmsim_step(SwarmSim* sim, int timeoutMs)
+{
+    struct pollfd pfd;
+    unsigned long long now;
+    unsigned char buf[256];
+    ssize_t n;
+    ssize_t i;
+
+    now = sim_nowMs();
+    if(sim->outTail != sim->outHead){
+        if(sim->out[sim->outTail % SWARMSIM_OUT_MAX].due <= now)
+            timeoutMs = 0;
+        else if(sim->out[sim->outTail % SWARMSIM_OUT_MAX].due - now < (unsigned long long)timeoutMs)
+            timeoutMs = (int)(sim->out[sim->outTail % SWARMSIM_OUT_MAX].due - now);
+    }
+
+    pfd.fd = sim->masterFd;
+    pfd.events = POLLIN;
+    if(poll(&pfd, 1, timeoutMs) > 0 && (pfd.revents & POLLIN)){
+        while((n = read(sim->masterFd, buf, sizeof(buf))) > 0){
+            for(i = 0; i < n; i++){
+                if(buf[i] == '\r')
+                    continue;
+                if(buf[i] == '\n'){
+                    sim->rxLine[sim->rxLen] = 0;
+                    sim_command(sim, sim->rxLine, sim->rxLen);
+                    sim->rxLen = 0;
+                }
+                else if(sim->rxLen < SWARMSIM_LINE_MAX - 1)
+                    sim->rxLine[sim->rxLen++] = (char)buf[i];
+            }
+        }
+    }
+
+    sim_tick(sim);
+    sim_flush(sim);
+}
+
+static void* sim_thread(void* arg)
+{
+    SwarmSim* sim = (SwarmSim*)arg;
+
+    while(!sim->stop)
+        swarmsim_step(sim, 5);
+    return 0;
+}
+
+/* - - - - - - - - - - - - - SETUP - - - - - - - - - - - - - - - */
+void swarmsim_defaultConfig(SwarmSimConfig* config)
+{
+    memset(config, 0, sizeof(*config));
+    config->latencyMs = 5;
+    config->jitterMs = 5;
+    config->bootMs = 300;
+    config->bootNoiseLines = 6;
+    config->dateTimeMs = 200;
+    config->positionMs = 400;
+    config->tdSentMs = 2000;
+    config->timeScale = 1;
+    config->backgroundRssi = -104;
+    config->deviceId = 0x000e57;
+    config->downlinkBurst = 1;
+    config->seed = 1;
+}
+
+int swarmsim_open(SwarmSim* sim, const SwarmSimConfig* config)
+{
+    struct termios tio;
+    const char* name;
+
+    memset(sim, 0, sizeof(*sim));
+    sim->config = *config;
+    sim->randState = config->seed;
+    sim->nextMsgId = 5354468575855ULL;
+    sim->gpioMode = 0;
+    sim->holdFd = -1;
+
+    sim->masterFd = posix_openpt(O_RDWR | O_NOCTTY | O_NONBLOCK);
+    if(sim->masterFd < 0)
+        return -1;
+    if(grantpt(sim->masterFd) || unlockpt(sim->masterFd) || !(name = ptsname(sim->masterFd))){
+        close(sim->masterFd);
+        return -1;
+    }
+    strncpy(sim->slavePath, name, sizeof(sim->slavePath) - 1);
+
+    sim->holdFd = open(sim->slavePath, O_RDWR | O_NOCTTY);
+    if(sim->holdFd >= 0 && tcgetattr(sim->holdFd, &tio) == 0){
+        cfmakeraw(&tio);                                // no echo, no line discipline, like a UART
+        tcsetattr(sim->holdFd, TCSANOW, &tio);
+    }
+
+    swarmsim_powerOn(sim);
+    return 0;
+}
+
+void swarmsim_close(SwarmSim* sim)
+{
+    if(sim->holdFd >= 0)
+        close(sim->holdFd);
+    if(sim->masterFd >= 0)
+        close(sim->masterFd);
+    sim->holdFd = -1;
+    sim->masterFd = -1;
+}
+
+int swarmsim_start(SwarmSim* sim)
+{
+    sim->stop = false;
+    return pthread_create(&sim->thread, 0, sim_thread, sim);
+}
+
+void swarmsim_stop(SwarmSim* sim)
+{
+    sim->stop = true;
+    pthread_join(sim->thread, 0);
+}
+
+bool swarmsim_isRunning(SwarmSim* sim)
+{
+    return sim->running;
+}
+
+void swarmsim_downlinkData(unsigned long seq, unsigned char* data)
+{
+    unsigned int i;
+
+    data[0] = (unsigned char)(seq >> 24);
+    data[1] = (unsigned char)(seq >> 16);
+    data[2] = (unsigned char)(seq >> 8);
+    data[3] = (unsigned char)seq;
+    for(i = 4; i < SWARMSIM_RX_DATA; i++)
+        data[i] = (unsigned char)(seq * 37 + i);
+}
@@ -0,0 +1,144 @@
+/*
+ * SwarmSim.h
+ *
+ *  Created on: Oct 16, 2026
+ *      Author: MicroTechEE
+ *
+ * Swarm M138 simulator on a pseudo terminal. The driver opens simulator->slavePath exactly like it would
+ * open /dev/ttyUSB0 and can't tell the difference. Good enough to measure and regression-test the driver,
+ * NOT a replacement for the product manual.
+ *
+ *      Answers: $CS $DT $FV $GJ $GN $GP $GS $MM $MT $PO $PW $RS $RT $SL $TD
+ *      Boot:    noise lines ("....", junk bytes) then $M138 BOOT,... and $M138 DATETIME / POSITION
+ *      Inbound: downlinkBurst messages every downlinkMs, pushed as $RD and kept unread for $MM like the
+ *               real database. While it's asleep they're only kept, so $MM C=U on wake finds them
+ *      Timing:  every response is delayed by latencyMs + rand(0..jitterMs), ordering is kept like a real UART
+ */
+
+#ifndef SWARMSIM_H_
+#define SWARMSIM_H_
+
+#include <stdbool.h>
+#include <pthread.h>
+
+#define SWARMSIM_LINE_MAX                               512
+#define SWARMSIM_OUT_MAX                                256      // lines waiting for their due time
+#define SWARMSIM_TD_MAX                                 2048     // M138 holds up to 2048 unsent messages
+#define SWARMSIM_TD_KEEP                                64       // payloads kept for tdDelivered, the rest aren't
+#define SWARMSIM_RX_MAX                                 512      // received messages kept for $MM
+#define SWARMSIM_RX_DATA                                8        // sequence number + a pattern, see swarmsim_downlinkData()
+#define SWARMSIM_RX_APP_BASE                            100      // appIDs 100..103, one per sequence number % 4
+
+/* * * * * * * * STRUCTS * * * * * * * * * */
+typedef enum{
+    SwarmSimDT = 0,                     // index into the unsolicited rate table
+    SwarmSimGJ,
+    SwarmSimGN,
+    SwarmSimGS,
+    SwarmSimPW,
+    SwarmSimRT,
+    SwarmSimRateCount
+}SwarmSimRate;
+
+typedef struct{
+    unsigned int latencyMs;             // command -> response
+    unsigned int jitterMs;              // extra 0..jitterMs on top of latencyMs
+    unsigned int bootMs;                // power on -> $M138 BOOT,RUNNING
+    unsigned int bootNoiseLines;        // junk lines before the first $M138
+    unsigned int dateTimeMs;            // RUNNING -> $M138 DATETIME, $DT @ answers ",I" until then
+    unsigned int positionMs;            // RUNNING -> $M138 POSITION
+    unsigned int tdSentMs;              // $TD OK -> $TD SENT
+    unsigned int timeScale;             // divides $SL sleep times and rates so hours run in seconds, 1 = real time
+    unsigned int lossPercent;           // commands silently ignored, like a reply lost on the wire
+    unsigned int tdLossPercent;         // $TD OK but never SENT, the hold ran out before a satellite came
+    unsigned int downlinkMs;            // a burst of inbound messages this often, 0 = none
+    unsigned int downlinkBurst;         // messages per burst
+    unsigned int downlinkCount;         // stop after this many, 0 = never
+    int backgroundRssi;                 // dBm
+    unsigned long deviceId;
+    unsigned int seed;
+    bool verbose;                       // log traffic to stderr
+    void (*tdDelivered)(const unsigned char* data, unsigned int len);   // at each $TD SENT, on the sim's thread
+}SwarmSimConfig;
+
+typedef struct{
+    unsigned long long due;
+    unsigned int len;
+    char data[SWARMSIM_LINE_MAX];
+}SwarmSimLine;
+
+typedef struct{
+    unsigned long long id;
+    unsigned long long sendAt;
+    unsigned int keep;                  // 1 + index into SwarmSim.tdData, 0 = payload not kept
+}SwarmSimTd;
+
+typedef struct{
+    unsigned long long id;
+    unsigned long epoch;
+    unsigned int appId;
+    unsigned long seq;
+    bool read;
+}SwarmSimRx;
+
+typedef struct{
+    SwarmSimConfig config;
+    int masterFd;
+    int holdFd;                         // keeps the slave side alive while the driver closes/reopens it
+    char slavePath[64];
+
+    char rxLine[SWARMSIM_LINE_MAX];
+    unsigned int rxLen;
+    SwarmSimLine out[SWARMSIM_OUT_MAX];
+    unsigned int outHead;
+    unsigned int outTail;
+    unsigned long long lastDue;
+
+    unsigned long long bootAt;
+    bool poweredOff;
+    volatile bool running;
+    bool dateTimeSent;
+    bool positionSent;
+    bool sleeping;
+    unsigned long long wakeAt;
+    unsigned int gpioMode;
+
+    unsigned int rate[SwarmSimRateCount];           // seconds, 0 = off
+    unsigned long long nextReport[SwarmSimRateCount];
+
+    SwarmSimTd td[SWARMSIM_TD_MAX];
+    unsigned int unsent;
+    unsigned long long nextMsgId;
+    unsigned char tdData[SWARMSIM_TD_KEEP][192];    // decoded, only with config.tdDelivered
+    unsigned int tdDataLen[SWARMSIM_TD_KEEP];       // 0 = free
+    unsigned long tdLost;                           // tdLossPercent
+
+    SwarmSimRx rx[SWARMSIM_RX_MAX];     // oldest first
+    unsigned int rxStored;
+    unsigned long rxSeq;                // messages made so far
+    unsigned long long nextDownlink;
+    unsigned long rdPushed;
+    unsigned long mmRead;
+
+    unsigned int randState;
+    unsigned long rxCommands;
+    unsigned long rxBadChecksum;
+    unsigned long rxLost;               // ignored because of lossPercent
+    unsigned long txLines;
+
+    volatile bool stop;
+    pthread_t thread;
+}SwarmSim;
+
+/* * * * * * * * FUNCTIONS * * * * * * * * * */
+void swarmsim_defaultConfig(SwarmSimConfig* config);
+int swarmsim_open(SwarmSim* sim, const SwarmSimConfig* config);   // 0 ok, sim->slavePath is the tty to open
+void swarmsim_close(SwarmSim* sim);
+void swarmsim_step(SwarmSim* sim, int timeoutMs);                 // one pass of the event loop
+int swarmsim_start(SwarmSim* sim);                                // run the loop on its own thread
+void swarmsim_stop(SwarmSim* sim);
+void swarmsim_powerOn(SwarmSim* sim);                             // reboot with boot noise
+bool swarmsim_isRunning(SwarmSim* sim);
+void swarmsim_downlinkData(unsigned long seq, unsigned char* data);  // SWARMSIM_RX_DATA bytes message seq carries
+
+#endif /* SWARMSIM_H_ */
@@ -0,0 +1,166 @@
+/*
+ * SwarmTrace.c
+ *
+ *  Created on: Oct 16, 2026
+ *      Author: MicroTechEE
+ */
+
+// STD C
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <SwarmCodec.h>
+#include "SwarmTrace.h"
+
+/* - - - - - - - - - - - - - HELPERS - - - - - - - - - - - - - - - */
+static bool trace_getVarint(FILE* file, unsigned long long* value)
+{
+    // same bytes swarm_codecPutVarint() writes, read straight off the file
+    unsigned char shift = 0;
+    int c;
+
+    *value = 0;
+    do{
+        c = fgetc(file);
+        if(c == EOF || shift > 63)
+            return false;
+        *value |= (unsigned long long)(c & 0x7F) << shift;
+        shift += 7;
+    }while(c & 0x80);
+    return true;
+}
+
+static bool trace_readText(SwarmTrace* trace, SwarmTraceRecord* record)
+{
+    char line[SWARM_TRACE_RECORD_MAX];
+    char* p;
+    char* end;
+    unsigned long long ms;
+    unsigned int len;
+
+    while(fgets(line, sizeof(line) - 1, trace->file)){
+        trace->line++;
+        p = line;
+        len = (unsigned int)strcspn(p, "\r\n");
+        p[len] = '\0';
+        while(*p == ' ' || *p == '\t')
+            p++;
+        if(*p == '\0' || *p == '#')
+            continue;
+
+        trace->timeUs += SWARM_TRACE_TEXT_STEP_us;
+        if(*p == '['){
+            ms = strtoull(p + 1, &end, 10);
+            if(*end == ']'){
+                trace->timeUs = ms * 1000ULL;
+                p = end + 1;
+            }
+        }
+        while(*p == ' ')
+            p++;
+        record->dir = SwarmTraceRx;
+        if(*p == '>' || *p == '<'){
+            record->dir = *p == '>' ? SwarmTraceTx : SwarmTraceRx;
+            p++;
+            while(*p == ' ')
+                p++;
+        }
+        len = (unsigned int)strlen(p);
+        memcpy(record->data, p, len);
+        record->data[len++] = '\n';             // the modem ends every line with one, the parser wants it
+        record->len = len;
+        record->timeUs = trace->timeUs;
+        trace->records++;
+        trace->bytes[record->dir] += len;
+        return true;
+    }
+    return false;
+}
+
+/* - - - - - - - - - - - - - FUNCTIONS - - - - - - - - - - - - - - - */
+int swarm_traceCreate(SwarmTrace* trace, const char* path)
+{
+    memset(trace, 0, sizeof(*trace));
+    trace->file = fopen(path, "wb");
+    if(!trace->file)
+        return -1;
+    trace->writing = true;
+    fwrite(SWARM_TRACE_MAGIC, 1, 4, trace->file);
+    fputc(SWARM_TRACE_VERSION, trace->file);
+    return 0;
+}
+
+int swarm_traceOpen(SwarmTrace* trace, const char* path)
+{
+    char magic[5];
+
+    memset(trace, 0, sizeof(*trace));
+    trace->file = fopen(path, "rb");
+    if(!trace->file)
+        return -1;
+    if(fread(magic, 1, 5, trace->file) == 5 && memcmp(magic, SWARM_TRACE_MAGIC, 4) == 0 &&
+       magic[4] == SWARM_TRACE_VERSION)
+        return 0;
+    trace->text = true;                         // anything else is taken as a text log
+    rewind(trace->file);
+    return 0;
+}
+
+void swarm_traceWrite(SwarmTrace* trace, SwarmTraceDir dir, const unsigned char* data, unsigned int len,
+                      unsigned long long nowUs)
+{
+    unsigned char head[20];
+    SwarmCodec codec;
+    unsigned int chunk;
+
+    if(!trace || !trace->file || !trace->writing)
+        return;
+    if(trace->records == 0)
+        trace->startUs = nowUs;
+    nowUs -= trace->startUs;
+    while(len){
+        chunk = len > SWARM_TRACE_RECORD_MAX ? SWARM_TRACE_RECORD_MAX : len;
+        swarm_codecInit(&codec, head, sizeof(head));
+        swarm_codecPutVarint(&codec, (unsigned long)(nowUs - trace->timeUs));
+        swarm_codecPutVarint(&codec, (unsigned long)chunk << 1 | dir);
+        fwrite(head, 1, swarm_codecLength(&codec), trace->file);
+        fwrite(data, 1, chunk, trace->file);
+        trace->timeUs = nowUs;
+        trace->records++;
+        trace->bytes[dir] += chunk;
+        data += chunk;
+        len -= chunk;
+    }
+}
+
+bool swarm_traceRead(SwarmTrace* trace, SwarmTraceRecord* record)
+{
+    unsigned long long dt;
+    unsigned long long lenDir;
+
+    if(!trace->file || trace->writing)
+        return false;
+    if(trace->text)
+        return trace_readText(trace, record);
+
+    if(!trace_getVarint(trace->file, &dt) || !trace_getVarint(trace->file, &lenDir))
+        return false;
+    record->len = (unsigned int)(lenDir >> 1);
+    record->dir = (SwarmTraceDir)(lenDir & 1);
+    if(record->len > SWARM_TRACE_RECORD_MAX || fread(record->data, 1, record->len, trace->file) != record->len)
+        return false;                           // cut short, the capture was killed mid write
+    trace->timeUs += dt;
+    record->timeUs = trace->timeUs;
+    trace->records++;
+    trace->bytes[record->dir] += record->len;
+    return true;
+}
+
+void swarm_traceClose(SwarmTrace* trace)
+{
+    if(trace->file)
+        fclose(trace->file);
+    trace->file = 0;
+}
@@ -0,0 +1,71 @@
+/*
+ * SwarmTrace.h
+ *
+ *  Created on: Oct 16, 2026
+ *      Author: MicroTechEE
+ *
+ * Raw UART capture, both directions, with timestamps. Set port.trace before swarm_modemInit() and SwarmHAL_Linux
+ * records every read() and write() on that tty as it happens, boot noise and all:
+ *
+ *      SwarmTrace trace;
+ *      swarm_traceCreate(&trace, "field.swtr");
+ *      port.trace = &trace;
+ *
+ * The file is "SWTR", a version byte, then one record per read() / write():
+ *
+ *      varint  microseconds since the record before
+ *      varint  length << 1 | direction (0 RX from the modem, 1 TX to it)
+ *      bytes
+ *
+ * Varints are SwarmCodec's, 7 bits a byte, low first. A line of $RT every few seconds costs 3 bytes on top of the
+ * line itself. swarm_traceOpen() also takes a plain text log, one sentence a line, for logs that came from somewhere
+ * else:
+ *
+ *      [12345] $GN 37.8921,-122.0155,77,89,2*3D       optional [ms] stamp, 10 ms apart without one
+ *      > $CS*10                                        '>' is TX, '<' or nothing is RX, # is a comment
+ */
+
+#ifndef SWARMTRACE_H_
+#define SWARMTRACE_H_
+
+#include <stdbool.h>
+#include <stdio.h>
+
+#define SWARM_TRACE_MAGIC                               "SWTR"
+#define SWARM_TRACE_VERSION                             1
+#define SWARM_TRACE_RECORD_MAX                          1024     // longer reads are split
+#define SWARM_TRACE_TEXT_STEP_us                        10000    // between text lines with no [ms]
+
+/* * * * * * * * STRUCTS * * * * * * * * * */
+typedef enum{
+    SwarmTraceRx = 0,                           // modem -> us
+    SwarmTraceTx = 1                            // us -> modem
+}SwarmTraceDir;
+
+typedef struct{
+    unsigned long long timeUs;                  // since the first record
+    SwarmTraceDir dir;
+    unsigned int len;
+    unsigned char data[SWARM_TRACE_RECORD_MAX];
+}SwarmTraceRecord;
+
+typedef struct SwarmTrace{
+    FILE* file;
+    bool writing;
+    bool text;                                  // reading a text log, not SWTR
+    unsigned long long startUs;                 // writing: clock at the first record
+    unsigned long long timeUs;                  // last record's time
+    unsigned long records;
+    unsigned long long bytes[2];                // per SwarmTraceDir
+    unsigned long line;                         // text logs, for error messages
+}SwarmTrace;
+
+/* * * * * * * * FUNCTIONS * * * * * * * * * */
+int swarm_traceCreate(SwarmTrace* trace, const char* path);                 // 0, or -1 with errno
+int swarm_traceOpen(SwarmTrace* trace, const char* path);                   // SWTR or a text log
+void swarm_traceWrite(SwarmTrace* trace, SwarmTraceDir dir, const unsigned char* data, unsigned int len,
+                      unsigned long long nowUs);
+bool swarm_traceRead(SwarmTrace* trace, SwarmTraceRecord* record);          // false at the end or on a bad record
+void swarm_traceClose(SwarmTrace* trace);
+
+#endif /* SWARMTRACE_H_ */
@@ -0,0 +1,62 @@
+/*
+ * misc.c  (host stand-in)
+ *
+ *  Created on: Oct 16, 2026
+ *      Author: MicroTechEE
+ */
+
+// STD C
+#include <time.h>
+
+#include "misc.h"
+
+static const char hexChars[] = "0123456789ABCDEF";
+
+int ascii_to_int(char* str, unsigned char len)
+{
+    int value = 0;
+    unsigned char i;
+
+    for(i = 0; i < len && str[i] >= '0' && str[i] <= '9'; i++)
+        value = value * 10 + (str[i] - '0');
+    return value;
+}
+
+char ascii_to_char(char* str, unsigned char len)
+{
+    // RSSI comes in as "-104", the driver works with the magnitude just like on the board
+    unsigned char i = 0;
+
+    if(len && str[0] == '-')
+        i++;
+    return (char)ascii_to_int(str + i, len - i);
+}
+
+void hex_to_ascii(unsigned char* hex, unsigned char* ascii, unsigned int len)
+{
+    unsigned int i;
+
+    for(i = 0; i < len; i++){
+        ascii[i * 2] = hexChars[hex[i] >> 4];
+        ascii[i * 2 + 1] = hexChars[hex[i] & 0x0F];
+    }
+}
+
+void hexByte_to_ascii(unsigned char hex, unsigned char* ascii)
+{
+    hex_to_ascii(&hex, ascii, 1);
+}
+
+void cycleDelay_ms(unsigned int ms)
+{
+    struct timespec ts;
+
+    ts.tv_sec = ms / 1000;
+    ts.tv_nsec = (long)(ms % 1000) * 1000000L;
+    nanosleep(&ts, 0);
+}
+
+void initRTC(Calendar dateTime)
+{
+    (void)dateTime;
+}
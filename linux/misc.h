@@ -0,0 +1,46 @@
+/*
+ * misc.h  (host stand-in)
+ *
+ *  Created on: Oct 16, 2026
+ *      Author: MicroTechEE
+ *
+ * Host build only. The helpers and types SwarmMSP430.c pulls from misc.h / DriverLib on the board.
+ */
+
+#ifndef MISC_H_
+#define MISC_H_
+
+#include <stdbool.h>
+
+/* * * * * * * * STRUCTS * * * * * * * * * */
+typedef union{
+    float asFloat;
+    unsigned char asBytes[4];
+}EasyFloat;
+
+typedef union{
+    long asLong;
+    unsigned char asBytes[sizeof(long)];
+}EasyLong;
+
+typedef struct{                     // same layout as DriverLib's RTC_C Calendar
+    unsigned char Seconds;
+    unsigned char Minutes;
+    unsigned char Hours;
+    unsigned char DayOfWeek;
+    unsigned char DayOfMonth;
+    unsigned char Month;
+    unsigned int Year;
+}Calendar;
+
+#define __no_operation()            ((void)0)
+
+/* * * * * * * * FUNCTIONS * * * * * * * * * */
+int ascii_to_int(char* str, unsigned char len);
+char ascii_to_char(char* str, unsigned char len);
+void hex_to_ascii(unsigned char* hex, unsigned char* ascii, unsigned int len);
+void hexByte_to_ascii(unsigned char hex, unsigned char* ascii);
+void cycleDelay_ms(unsigned int ms);
+void initRTC(Calendar dateTime);
+
+#endif /* MISC_H_ */
@@ -0,0 +1,99 @@
+/*
+ * swarm_aggdecode.c
+ *
+ *  Created on: Oct 16, 2026
+ *      Author: MicroTechEE
+ *
+ * Unpacks SwarmAggregate packets on the ground. One packet per line, either the bare hex payload from the
+ * Swarm Hive export or a whole $TD line as the driver sent it:
+ *
+ *      ./swarm_aggdecode < packets.txt
+ *      ./swarm_aggdecode 'A1350102030405'
+ */
+
+// STD C
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <Message.h>
+#include <SwarmMSP430.h>
+#include <SwarmAggregate.h>
+
+/* - - - - - - - - - - - - - FUNCTIONS - - - - - - - - - - - - - - - */
+static int decode_nibble(char c)
+{
+    if(c >= '0' && c <= '9')
+        return c - '0';
+    if(c >= 'A' && c <= 'F')
+        return c - 'A' + 10;
+    if(c >= 'a' && c <= 'f')
+        return c - 'a' + 10;
+    return -1;
+}
+
+static unsigned int decode_hex(const char* line, unsigned char* packet, unsigned int max)
+{
+    // the payload is the last run of hex before the '*' (or the end), after any "$TD AI=..,HD=..,"
+    const char* end = strchr(line, '*');
+    const char* start;
+    unsigned int len = 0;
+    int hi;
+    int lo;
+
+    if(!end)
+        end = line + strcspn(line, "\r\n");
+    start = end;
+    while(start > line && decode_nibble(start[-1]) >= 0)
+        start--;
+    if((end - start) & 1)
+        start++;                                // odd run, the first char belonged to something else
+    while(start + 1 < end && len < max){
+        hi = decode_nibble(start[0]);
+        lo = decode_nibble(start[1]);
+        packet[len++] = (unsigned char)(hi << 4 | lo);
+        start += 2;
+    }
+    return len;
+}
+
+static void decode_line(const char* line, unsigned long number)
+{
+    unsigned char packet[SWARM_AGG_PACKET_MAX];
+    SwarmAggRecord record;
+    unsigned int len;
+    unsigned int pos = 0;
+    unsigned int i;
+    unsigned int count = 0;
+
+    len = decode_hex(line, packet, sizeof(packet));
+    if(!swarm_aggIsPacket(packet, len)){
+        printf("packet %lu: not an aggregate packet (%u bytes)\n", number, len);
+        return;
+    }
+    printf("packet %lu: %u bytes\n", number, len);
+    while(swarm_aggNextRecord(packet, len, &pos, &record)){
+        printf("  record %u type %u len %u:", count++, record.type, record.len);
+        for(i = 0; i < record.len; i++)
+            printf(" %02X", record.data[i]);
+        printf("\n");
+    }
+    if(pos != len)
+        printf("  corrupt after byte %u\n", pos ? pos : 1);
+}
+
+int main(int argc, char** argv)
+{
+    char line[1024];
+    unsigned long number = 0;
+    int i;
+
+    if(argc > 1){
+        for(i = 1; i < argc; i++)
+            decode_line(argv[i], number++);
+        return 0;
+    }
+    while(fgets(line, sizeof(line), stdin))
+        decode_line(line, number++);
+    return 0;
+}
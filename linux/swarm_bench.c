@@ -0,0 +1,747 @@
+/*
+ * swarm_bench.c
+ *
+ *  Created on: Oct 16, 2026
+ *      Author: MicroTechEE
+ *
+ * Runs the real swarm_* code against the pty simulator and reports how long the driver keeps the CPU.
+ * "busy" is wall time spent inside swarm_* calls, on the board that's time the MCU can't do anything else.
+ *
+ *      ./swarm_bench -n 100 -l 5 -j 5 -x 30 -s 6     (-x: % of commands the modem ignores during init,
+ *                                                   -s: seconds of scheduler run, sim sleeps 10x faster)
+ *      ./swarm_bench -w run.swtr                     (-w: capture the first modem's UART, swarm_replay reads it)
+ */
+
+// STD C
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// POSIX
+#include <unistd.h>
+
+#include <Message.h>
+#include <SwarmMSP430.h>
+#include <SwarmHAL.h>
+#include <SwarmAggregate.h>
+#include "SwarmHAL_Linux.h"
+#include "SwarmSim.h"
+#include "SwarmDefrag.h"
+
+#define BENCH_BLOB          8192                // bytes in the fragment phase's blob
+
+/* - - - - - - - - - - - - - GLOBALS - - - - - - - - - - - - - - - */
+static unsigned long long busyUs = 0;           // time inside swarm_* calls
+
+static SwarmModem modem;                        // the one every phase runs on
+static SwarmLinuxPort port;
+static SwarmTrace trace;                        // -w
+static SwarmQueueStore queueStore;              // FRAM on the board
+static SwarmWarmStore warmStore;                // this too
+static SwarmModem modem2;                       // a second one on its own sim, for the last phase
+static SwarmLinuxPort port2;
+static SwarmQueueStore queueStore2;
+
+static unsigned char downlinkSeen[SWARMSIM_RX_MAX];
+static unsigned long downlinkUnique = 0;
+static unsigned long downlinkTwice = 0;         // handed to us twice, the repeat check missed it
+static unsigned long downlinkWrong = 0;         // bad data or the wrong handler
+static unsigned long downlinkFromMm = 0;
+
+static unsigned long rtReplies = 0;             // $RT seen by the events phase handler
+
+static const unsigned long benchRates[SwarmRateCount][SwarmPowerCount] = {   // seconds, streamMaxS is 2
+    {1, 5, 5},                                  // $DT, polled past Full
+    {1, 3, 0},                                  // $GJ
+    {1, 2, 5},                                  // $GN
+    {1, 0, 0},                                  // $GS
+    {1, 3, 5},                                  // $PW
+    {1, 2, 3}                                   // $RT
+};
+
+static SwarmFragSender frag;
+static SwarmDefrag defrag;                      // the ground, fed from the sim's thread at each $TD SENT
+static volatile unsigned long blobsComplete = 0;
+static volatile unsigned long blobsWrong = 0;
+
+#define BENCH_CALL(call)    do{ unsigned long long t0_ = swarm_halLinuxMicros(); call; busyUs += swarm_halLinuxMicros() - t0_; }while(0)
+
+/* - - - - - - - - - - - - - FUNCTIONS - - - - - - - - - - - - - - - */
+static void bench_serviceModem(SwarmModem* m, int timeoutMs)
+{
+    int fed = swarm_halLinuxPoll(m, timeoutMs);
+
+    BENCH_CALL(swarm_handleMsg(m));                 // the superloop calls this whether there's RX or not
+    while(fed > 0){
+        fed = swarm_halLinuxPoll(m, 0);
+        BENCH_CALL(swarm_handleMsg(m));
+    }
+}
+
+static void bench_service(int timeoutMs)
+{
+    bench_serviceModem(&modem, timeoutMs);
+}
+
+static bool bench_waitLines(unsigned long lines, unsigned int timeoutMs)
+{
+    unsigned long long deadline = swarm_halLinuxMicros() + (unsigned long long)timeoutMs * 1000ULL;
+
+    while(modem.parser.stats.sentences < lines){
+        if(swarm_halLinuxMicros() > deadline)
+            return false;
+        bench_service(5);
+    }
+    return true;
+}
+
+static void bench_downlink(const SwarmDownlinkMsg* message)
+{
+    unsigned char expect[SWARMSIM_RX_DATA];
+    unsigned long seq;
+
+    if(message->len != SWARMSIM_RX_DATA){
+        downlinkWrong++;
+        return;
+    }
+    seq = (unsigned long)message->data[0] << 24 | (unsigned long)message->data[1] << 16 |
+          (unsigned long)message->data[2] << 8 | message->data[3];
+    swarmsim_downlinkData(seq, expect);
+    if(seq >= SWARMSIM_RX_MAX || memcmp(expect, message->data, SWARMSIM_RX_DATA) ||
+       message->appId != SWARMSIM_RX_APP_BASE + seq % 4){
+        downlinkWrong++;
+        return;
+    }
+    if(downlinkSeen[seq]++)
+        downlinkTwice++;
+    else
+        downlinkUnique++;
+    if(message->source == SwarmDownlinkFromMm)
+        downlinkFromMm++;
+}
+
+static void bench_onRt(SwarmModem* m, const SwarmSentence* sentence)
+{
+    (void)m;
+    (void)sentence;
+    rtReplies++;
+}
+
+static unsigned char bench_blobByte(unsigned long offset)
+{
+    return (unsigned char)(offset * 131 + (offset >> 8));
+}
+
+static unsigned int bench_fragSource(SwarmModem* m, unsigned long offset, unsigned char* data, unsigned int len)
+{
+    // what a log in external flash would do, read on demand
+    unsigned int i;
+
+    (void)m;
+    for(i = 0; i < len; i++)
+        data[i] = bench_blobByte(offset + i);
+    return len;
+}
+
+static void bench_tdDelivered(const unsigned char* data, unsigned int len)
+{
+    const unsigned char* blob;
+    unsigned long blobLen;
+    unsigned long i;
+
+    if(swarm_defragFeed(&defrag, data, len, &blob, &blobLen) != SwarmDefragComplete)
+        return;
+    for(i = 0; i < blobLen && blob[i] == bench_blobByte(i); i++)
+        ;
+    if(blobLen != BENCH_BLOB || i != blobLen)
+        blobsWrong++;
+    blobsComplete++;
+}
+
+static unsigned long bench_rtRoundTrips(unsigned int count, bool events, unsigned long long* wallUs)
+{
+    // $RT @ one at a time, either spinning on swarm_handleMsg() like the old superloop or sleeping in
+    // swarm_eventWait() between sentences. Returns the swarm_handleMsg() calls it took
+    SwarmModem* modems[1] = { &modem };
+    unsigned long long start = swarm_halLinuxMicros();
+    unsigned long calls = 0;
+    unsigned long want;
+    unsigned int i;
+
+    for(i = 0; i < count; i++){
+        want = rtReplies + 1;
+        swarm_cmdSubmit(&modem.cmds, SAT_CMD_RECEIVE_TEST, SAT_CMD_PARAM_QUERY_LAST_MESSAGE, 0, 0, 0);
+        while(rtReplies < want && swarm_halLinuxMicros() - start < 20000000ULL){
+            swarm_halLinuxPoll(&modem, 0);
+            BENCH_CALL(swarm_handleMsg(&modem));
+            calls++;
+            if(events && rtReplies < want)
+                swarm_eventWait(modems, 1);
+        }
+    }
+    *wallUs = swarm_halLinuxMicros() - start;
+    return calls;
+}
+
+static bool bench_coalesceFull(unsigned int pushes, unsigned int* live, unsigned int* newest)
+{
+    // one Bulk reading at the tail that can't go yet (nothing is serviced), then keyed pushes well past the class
+    // size. Exactly one keyed slot may be live and it has to hold the last push
+    unsigned char data[24];
+    unsigned int dropped = (unsigned int)modem.queue.stats.dropped;
+    unsigned int i;
+    const SwarmQueueSlot* slot;
+
+    memset(data, 0, sizeof(data));
+    swarm_queuePushClass(&modem.queue, SwarmQueueBulk, 0, data, 16);
+    for(i = 0; i < pushes; i++){
+        data[0] = (unsigned char)i;
+        BENCH_CALL(swarm_queuePushClass(&modem.queue, SwarmQueueBulk, 2, data, sizeof(data)));
+    }
+    *live = 0;
+    *newest = 0xFFFF;
+    for(i = queueStore.ring[SwarmQueueBulk].tail; i != queueStore.ring[SwarmQueueBulk].head; i++){
+        slot = &queueStore.slot[SWARM_QUEUE_URGENT_SLOTS + SWARM_QUEUE_NORMAL_SLOTS + i % SWARM_QUEUE_BULK_SLOTS];
+        if(slot->key == 2 && !slot->retired){
+            (*live)++;
+            *newest = slot->data[0];
+        }
+    }
+    return *live == 1 && *newest == (unsigned char)(pushes - 1) && modem.queue.stats.dropped == dropped;
+}
+
+static bool bench_restart(bool warm, unsigned long long* wallUs, unsigned long* commands)
+{
+    // what an MCU reset looks like to the driver: everything in RAM is gone, the stores and the modem aren't
+    unsigned long long start = swarm_halLinuxMicros();
+
+    if(!warm)
+        swarm_warmForget(&modem.warm);
+    modem.hal->uartClose(&modem);
+    swarm_modemInit(&modem, &swarmHalLinux, &port, &queueStore);
+    swarm_warmAttach(&modem, &warmStore);
+    BENCH_CALL(swarm_startup(&modem));
+    while(!modem.info.satFullyInitialized && swarm_halLinuxMicros() - start < 30000000ULL)
+        bench_service(2);
+    *wallUs = swarm_halLinuxMicros() - start;
+    *commands = modem.cmds.stats.sent;
+    return modem.info.satFullyInitialized;
+}
+
+static void bench_ratesWindow(SwarmSim* sim, SwarmPowerMode power, unsigned int ms, unsigned long* rx, unsigned long* tx)
+{
+    // switch, let the new rates get to the modem, then count what goes back and forth for ms
+    unsigned long long start = swarm_halLinuxMicros();
+    unsigned long lines;
+    unsigned long commands;
+
+    swarm_ratesSetPower(&modem.rates, power);
+    do{
+        bench_service(5);
+    }while(modem.cmds.count && swarm_halLinuxMicros() - start < 5000000ULL);
+    lines = modem.parser.stats.sentences;
+    commands = sim->rxCommands;
+    start = swarm_halLinuxMicros();
+    while(swarm_halLinuxMicros() - start < ms * 1000ULL)
+        bench_service(5);
+    *rx = modem.parser.stats.sentences - lines;
+    *tx = sim->rxCommands - commands;
+}
+
+static void bench_printStats(const SwarmStats* stats)
+{
+    // every header the modem saw, then the snapshot a board would send home, decoded again
+    unsigned char snapshot[SAT_NUMBER_MAX_PACKET_BYTES_HEX];
+    const SwarmStatsHeader* h;
+    SwarmStats ground;
+    unsigned int len;
+    unsigned char i;
+    unsigned char b;
+
+    printf("stats     : %lu bytes / %lu sentences tx, %lu bytes / %lu sentences rx, %lu bad checksum, %lu ERR, message high water %u\n",
+           stats->txBytes, stats->txSentences, stats->rxBytes, stats->rxSentences, stats->badChecksum, stats->errors,
+           stats->messageHighWater);
+    for(i = 0; i < stats->headers; i++){
+        h = &stats->header[i];
+        printf("            $%c%c %6lu tx %6lu rx %4lu err  latency %6.1f avg %5lu max ms [",
+               (char)(h->header >> 8), (char)h->header, h->tx, h->replies, h->errors,
+               h->timed ? h->latencySumMs / (double)h->timed : 0.0, h->latencyMaxMs);
+        for(b = 0; b < SWARM_STATS_BUCKETS; b++)
+            printf("%s%u", b ? " " : "", h->latency[b]);
+        printf("]  parse %6.0f avg %6u max ns\n", h->replies ? h->parseTicks / (double)h->replies : 0.0, h->parseMaxTicks);
+    }
+    len = swarm_statsSnapshot(stats, snapshot, sizeof(snapshot));
+    if(!swarm_statsDecode(snapshot, len, &ground))
+        printf("            snapshot: %u bytes, DOESN'T DECODE\n", len);
+    else
+        printf("            snapshot: %u bytes, %u of %u headers, decodes to %lu tx %lu rx sentences%s\n", len,
+               ground.headers, stats->headers, ground.txSentences, ground.rxSentences,
+               ground.rxBytes == stats->rxBytes && ground.txBytes == stats->txBytes ? "" : " (MISMATCH)");
+}
+
+static void bench_report(const char* name, unsigned int count, unsigned long long wallUs, unsigned long long sendUs,
+                         unsigned long long blockedUs)
+{
+    printf("%-10s: %5u ops  %9.1f ops/s sent  %8.1f ms wall  busy %5.1f%%  idle %5.1f%%  blocked %8.1f ms\n",
+           name, count, sendUs ? count * 1e6 / (double)sendUs : 0.0, wallUs / 1000.0,
+           wallUs ? 100.0 * busyUs / (double)wallUs : 0.0, wallUs ? 100.0 - 100.0 * busyUs / (double)wallUs : 0.0,
+           blockedUs / 1000.0);
+}
+
+int main(int argc, char** argv)
+{
+    SwarmSimConfig config;
+    SwarmSim sim;
+    SwarmSim sim2;
+    SwarmAggregator agg;
+    unsigned char record[10];
+    unsigned char payload[64];
+    unsigned int count = 100;
+    unsigned int i;
+    unsigned long long start;
+    unsigned long long sent;
+    unsigned long long blocked;
+    unsigned long lines;
+    unsigned int schedSeconds = 6;
+    SwarmSchedEstimate estimate;
+    unsigned long long nextPush;
+    unsigned long long steady;
+    unsigned long long tdBefore;
+    unsigned long long tdBefore2;
+    unsigned long accepted;
+    unsigned long urgentAfter = 0;
+    unsigned int urgentTail;
+    unsigned long long polledUs;
+    unsigned long long eventUs;
+    unsigned long polledCalls;
+    unsigned long eventCalls;
+    unsigned long long coldUs;
+    unsigned long long warmUs;
+    unsigned long coldCmds;
+    unsigned long ratesRx[SwarmPowerCount];
+    unsigned long ratesTx[SwarmPowerCount];
+    unsigned long warmCmds;
+    bool coldOk;
+    bool warmOk;
+    bool fullOk;
+    unsigned int fullLive;
+    unsigned int fullNewest;
+    const char* tracePath = 0;
+    int opt;
+
+    swarmsim_defaultConfig(&config);
+    config.bootMs = 100;
+    config.dateTimeMs = 0;
+    config.tdSentMs = 100;
+    while((opt = getopt(argc, argv, "n:l:j:x:s:w:vh")) != -1){
+        switch(opt){
+        case 'n': count = (unsigned int)atoi(optarg); break;
+        case 'l': config.latencyMs = (unsigned int)atoi(optarg); break;
+        case 'j': config.jitterMs = (unsigned int)atoi(optarg); break;
+        case 'x': config.lossPercent = (unsigned int)atoi(optarg); break;
+        case 's': schedSeconds = (unsigned int)atoi(optarg); break;
+        case 'w': tracePath = optarg; break;
+        case 'v': config.verbose = true; break;
+        default:
+            fprintf(stderr, "usage: %s [-n commands] [-l latency_ms] [-j jitter_ms] [-x init_loss_%%] [-s sched_seconds] [-w trace] [-v]\n", argv[0]);
+            return 2;
+        }
+    }
+    for(i = 0; i < sizeof(payload); i++)
+        payload[i] = (unsigned char)(i * 37);
+
+    if(swarmsim_open(&sim, &config) || swarmsim_start(&sim)){
+        perror("swarmsim");
+        return 1;
+    }
+    while(!swarmsim_isRunning(&sim))
+        usleep(1000);
+
+    swarm_halLinuxPortInit(&port, sim.slavePath);
+    if(tracePath){
+        if(swarm_traceCreate(&trace, tracePath)){
+            perror(tracePath);
+            return 1;
+        }
+        port.trace = &trace;
+    }
+    swarm_modemInit(&modem, &swarmHalLinux, &port, &queueStore);
+    swarm_warmAttach(&modem, &warmStore);
+    printf("swarm_bench: %s latency %u ms jitter %u ms\n", sim.slavePath, config.latencyMs, config.jitterMs);
+
+    /* Cold start until satFullyInitialized */
+    busyUs = 0;
+    start = swarm_halLinuxMicros();
+    BENCH_CALL(swarm_startup(&modem));
+    while(!modem.info.satFullyInitialized && swarm_halLinuxMicros() - start < 30000000ULL)
+        bench_service(5);
+    printf("init      : %8.1f ms to satFullyInitialized%s\n", (swarm_halLinuxMicros() - start) / 1000.0,
+           modem.info.satFullyInitialized ? "" : " (TIMED OUT)");
+    sim.config.lossPercent = 0;                     // the rest doesn't retry, only the init commands go through modem.cmds
+
+    /* Command throughput, $MT C=U back to back */
+    bench_service(50);
+    busyUs = 0;
+    lines = modem.parser.stats.sentences;
+    blocked = swarmHalLinuxStats.blockedUs;
+    start = swarm_halLinuxMicros();
+    for(i = 0; i < count; i++){
+        BENCH_CALL(swarm_sendCommand(&modem, SAT_CMD_MSG_TX_MANAGEMENT, SAT_CMD_PARAM_QUERY_UNSENT_MESSAGES));
+        bench_service(0);
+    }
+    sent = swarm_halLinuxMicros() - start;
+    bench_waitLines(lines + count, 5000);
+    bench_report("commands", count, swarm_halLinuxMicros() - start, sent, swarmHalLinuxStats.blockedUs - blocked);
+
+    /* $TD with a 64 byte payload */
+    busyUs = 0;
+    lines = modem.parser.stats.sentences;
+    blocked = swarmHalLinuxStats.blockedUs;
+    start = swarm_halLinuxMicros();
+    for(i = 0; i < count / 4; i++){
+        BENCH_CALL(swarm_transmitData(&modem, SAT_MSG_APPLICATION_ID, SAT_MSG_HOLD_TIME_1DAY, (char*)payload, sizeof(payload)));
+        bench_service(0);
+    }
+    sent = swarm_halLinuxMicros() - start;
+    bench_waitLines(lines + count / 4, 5000);
+    bench_report("transmit", count / 4, swarm_halLinuxMicros() - start, sent, swarmHalLinuxStats.blockedUs - blocked);
+
+    /* Same 10 byte readings, one $TD each vs. packed with SwarmAggregate */
+    swarm_aggInit(&agg, &modem, 0);
+    busyUs = 0;
+    lines = modem.parser.stats.sentences;
+    blocked = swarmHalLinuxStats.blockedUs;
+    start = swarm_halLinuxMicros();
+    for(i = 0; i < count; i++){
+        memcpy(record, payload + (i % 32), sizeof(record));
+        BENCH_CALL(swarm_aggAdd(&agg, 1, record, sizeof(record), modem.hal->millis()));
+        bench_service(0);
+    }
+    BENCH_CALL(swarm_aggFlush(&agg));
+    sent = swarm_halLinuxMicros() - start;
+    while((swarm_queueDepth(&modem.queue) || modem.queue.inFlight) && swarm_halLinuxMicros() - start < 5000000ULL)
+        bench_service(5);                           // the packets go through the queue
+    bench_report("aggregate", count, swarm_halLinuxMicros() - start, sent, swarmHalLinuxStats.blockedUs - blocked);
+    printf("            %lu records in %lu packets (%u unpacked), %.1f records/packet, %.1f%% of each packet is data\n",
+           agg.stats.records, agg.stats.packets, count, agg.stats.packets ? agg.stats.records / (double)agg.stats.packets : 0.0,
+           agg.stats.packets ? 100.0 * agg.stats.recordBytes / (double)(agg.stats.packets * SWARM_AGG_PACKET_MAX) : 0.0);
+
+    /* FRAM queue: push faster than the modem takes them, nothing may be lost */
+    busyUs = 0;
+    blocked = swarmHalLinuxStats.blockedUs;
+    start = swarm_halLinuxMicros();
+    for(i = 0; i < SWARM_QUEUE_NORMAL_SLOTS; i++){
+        payload[0] = (unsigned char)i;
+        BENCH_CALL(swarm_queuePush(&modem.queue, payload, sizeof(payload)));
+        if(i == SWARM_QUEUE_NORMAL_SLOTS / 2)
+            swarm_queueInit(&modem.queue, &modem, &queueStore);   // "reset" halfway, the store has to carry over
+    }
+    sent = swarm_halLinuxMicros() - start;
+    while((swarm_queueDepth(&modem.queue) || modem.queue.inFlight) && swarm_halLinuxMicros() - start < 20000000ULL)
+        bench_service(5);
+    bench_report("queue", SWARM_QUEUE_NORMAL_SLOTS, swarm_halLinuxMicros() - start, sent, swarmHalLinuxStats.blockedUs - blocked);
+    printf("            %u pushed across a reset, %lu accepted, depth %u, high water %u, %lu dropped, %lu rejected, %lu held for modem\n",
+           (unsigned int)SWARM_QUEUE_NORMAL_SLOTS, modem.queue.stats.accepted, swarm_queueDepth(&modem.queue), modem.queue.stats.highWater,
+           modem.queue.stats.dropped, modem.queue.stats.rejected, modem.queue.stats.modemFull);
+
+    /* Priorities: Bulk readings that outlive their deadline, a position fix every pass that should collapse into one
+     * slot, a Normal backlog, and an alarm pushed once that backlog is moving. The alarm should be the next one the
+     * modem accepts after whatever was already in flight */
+    swarm_cmdSubmit(&modem.cmds, SAT_CMD_DATE_TIME, SAT_CMD_PARAM_QUERY_LAST_MESSAGE, 0, 0, 0);
+    while(modem.queue.epoch == 0 && swarm_halLinuxMicros() - start < 25000000ULL)
+        bench_service(5);                           // deadlines need the time
+    memset(&modem.queue.stats, 0, sizeof(modem.queue.stats));
+    busyUs = 0;
+    blocked = swarmHalLinuxStats.blockedUs;
+    start = swarm_halLinuxMicros();
+    modem.queue.cls[SwarmQueueBulk].holdS = 30;     // less than SWARM_QUEUE_HOLD_MIN_s, stale before it can go
+    for(i = 0; i < 4; i++)
+        BENCH_CALL(swarm_queuePushClass(&modem.queue, SwarmQueueBulk, 0, payload, 16));
+    modem.queue.cls[SwarmQueueBulk].holdS = SWARM_QUEUE_BULK_HOLD_s;
+    for(i = 0; i < SWARM_QUEUE_NORMAL_SLOTS; i++){
+        payload[0] = (unsigned char)i;
+        BENCH_CALL(swarm_queuePushClass(&modem.queue, SwarmQueueBulk, 1, payload, 24));
+        BENCH_CALL(swarm_queuePush(&modem.queue, payload, sizeof(payload)));
+    }
+    while(modem.queue.stats.accepted < 3 && swarm_halLinuxMicros() - start < 20000000ULL)
+        bench_service(5);
+    accepted = modem.queue.stats.accepted;
+    urgentTail = queueStore.ring[SwarmQueueUrgent].tail;
+    BENCH_CALL(swarm_queuePushClass(&modem.queue, SwarmQueueUrgent, 0, payload, 8));
+    sent = swarm_halLinuxMicros() - start;
+    while((swarm_queueDepth(&modem.queue) || modem.queue.inFlight) && swarm_halLinuxMicros() - start < 30000000ULL){
+        bench_service(5);
+        if(!urgentAfter && queueStore.ring[SwarmQueueUrgent].tail != urgentTail)
+            urgentAfter = modem.queue.stats.accepted - accepted;
+    }
+    bench_report("priority", 4 + 2 * SWARM_QUEUE_NORMAL_SLOTS + 1, swarm_halLinuxMicros() - start, sent,
+                 swarmHalLinuxStats.blockedUs - blocked);
+    printf("            %lu pushed, %lu coalesced, %lu expired, %lu accepted, alarm was #%lu accepted after its push%s\n",
+           modem.queue.stats.pushed, modem.queue.stats.coalesced, modem.queue.stats.expired, modem.queue.stats.accepted,
+           urgentAfter, modem.queue.epoch ? "" : " (NO $DT, NO DEADLINES)");
+    fullOk = bench_coalesceFull(3 * SWARM_QUEUE_BULK_SLOTS, &fullLive, &fullNewest);
+    printf("            full Bulk class: held tail + %u keyed pushes, %u live with the key, newest #%u, depth %u/%u%s\n",
+           3 * SWARM_QUEUE_BULK_SLOTS, fullLive, fullNewest, swarm_queueDepth(&modem.queue), SWARM_QUEUE_BULK_SLOTS,
+           fullOk ? "" : " (WRONG VALUE LIVE)");
+    start = swarm_halLinuxMicros();
+    while((swarm_queueDepth(&modem.queue) || modem.queue.inFlight) && swarm_halLinuxMicros() - start < 10000000ULL)
+        bench_service(5);
+
+    /* Fragments: a blob streamed from a callback as $TD after $TD. The sim loses some on the way up and sends the
+     * rest in its own order, the board resends whatever never got a $TD SENT and the ground has to end up with the
+     * same bytes, once */
+    swarm_fragInit(&frag, &modem);
+    frag.resendMs = 1000;
+    swarm_defragInit(&defrag);
+    sim.config.tdDelivered = bench_tdDelivered;
+    sim.config.tdLossPercent = 10;
+    busyUs = 0;
+    blocked = swarmHalLinuxStats.blockedUs;
+    start = swarm_halLinuxMicros();
+    BENCH_CALL(swarm_fragSend(&frag, BENCH_BLOB, bench_fragSource));
+    while((swarm_fragBusy(&frag) || !blobsComplete) && swarm_halLinuxMicros() - start < 30000000ULL)
+        bench_service(5);
+    sim.config.tdLossPercent = 0;
+    sim.config.tdDelivered = 0;
+    bench_report("fragment", (unsigned int)frag.stats.fragments, swarm_halLinuxMicros() - start,
+                 swarm_halLinuxMicros() - start, swarmHalLinuxStats.blockedUs - blocked);
+    printf("            %u bytes in %u fragments, %lu queued (%lu resent), %lu acked, %lu lost on the way up\n",
+           BENCH_BLOB, frag.count, frag.stats.fragments, frag.stats.resent, frag.stats.acked, sim.tdLost);
+    printf("            ground: %lu of 1 blob complete%s, %lu fragments %lu duplicates %lu evicted\n", blobsComplete,
+           blobsWrong ? " (WRONG BYTES)" : "", defrag.stats.fragments, defrag.stats.duplicates, defrag.stats.evicted);
+
+    /* Downlink: bursts of $RD while awake, then a few that land while the modem sleeps and have to be read back
+     * with $MM. Every message carries its sequence number, each one has to reach its appID handler exactly once */
+    for(i = 0; i < 4; i++)
+        swarm_downlinkRoute(&modem.downlink, SWARMSIM_RX_APP_BASE + i, bench_downlink);
+    modem.downlink.cleanupIdleMs = 200;
+    sim.config.timeScale = 10;
+    busyUs = 0;
+    blocked = swarmHalLinuxStats.blockedUs;
+    start = swarm_halLinuxMicros();
+    sim.config.downlinkBurst = 10;
+    sim.config.downlinkCount = count;
+    sim.config.downlinkMs = 50;
+    while(downlinkUnique < count && swarm_halLinuxMicros() - start < 10000000ULL)
+        bench_service(5);
+    while((swarm_downlinkIsBusy(&modem.downlink) || modem.cmds.count) && swarm_halLinuxMicros() - start < 10000000ULL)
+        bench_service(5);                           // same as the scheduler, nothing may be waiting on an answer
+    swarm_sleepFor(&modem, 5);
+    while(!modem.info.isSleeping && swarm_halLinuxMicros() - start < 10000000ULL)
+        bench_service(5);
+    sim.config.downlinkCount = count + 24;          // these only go into the modem's database
+    while((downlinkUnique < count + 24 || swarm_downlinkIsBusy(&modem.downlink) || sim.rxStored) &&
+          swarm_halLinuxMicros() - start < 15000000ULL)
+        bench_service(5);
+    sim.config.downlinkMs = 0;
+    bench_report("downlink", (unsigned int)downlinkUnique, swarm_halLinuxMicros() - start, swarm_halLinuxMicros() - start,
+                 swarmHalLinuxStats.blockedUs - blocked);
+    printf("            %lu of %u delivered (%lu read back with $MM), %lu twice, %lu wrong, %lu repeats caught, %lu dropped\n",
+           downlinkUnique, count + 24, downlinkFromMm, downlinkTwice, downlinkWrong, modem.downlink.stats.repeats,
+           modem.downlink.stats.dropped);
+    printf("            %lu $MM commands for %lu messages (%lu batches, %lu clean ups), %u left on the modem\n",
+           modem.downlink.stats.commands, downlinkUnique, modem.downlink.stats.batches, modem.downlink.stats.cleanups, sim.rxStored);
+
+    /* Scheduler: nothing to send and it sleeps, readings pile up while it sleeps and it's woken early, the sky goes
+     * bad with a $TD still in the modem and it backs off, then a reading every 400 ms for -s seconds. Everything is
+     * wall time so the sleep / awake split is real, the sim just runs $SL 10x faster so a 20 s sleep takes 2 s.
+     * Whatever the fragment phase lost on the way up is still in queue.modemUnsent, $MT C=U has to clear it */
+    sim.config.timeScale = 10;
+    swarm_schedInit(&modem.sched, &modem, modem.hal->millis());
+    modem.sched.idleSleepS = 20;
+    modem.sched.backoffSleepS = 10;
+    modem.sched.minAwakeMs = 300;
+    modem.sched.maxAwakeMs = 5000;
+    modem.sched.wakeDepth = 4;
+    swarm_schedStart(&modem.sched);
+    busyUs = 0;
+    blocked = swarmHalLinuxStats.blockedUs;
+    start = swarm_halLinuxMicros();
+    i = 0;
+    while(!modem.sched.stats.idleSleeps && swarm_halLinuxMicros() - start < 5000000ULL)
+        bench_service(5);
+    nextPush = swarm_halLinuxMicros();
+    while(!modem.sched.stats.wakes && swarm_halLinuxMicros() - start < 10000000ULL){
+        if(swarm_halLinuxMicros() >= nextPush){
+            payload[0] = (unsigned char)i++;
+            BENCH_CALL(swarm_queuePush(&modem.queue, payload, 16));
+            nextPush += 300000ULL;
+        }
+        bench_service(5);
+    }
+    while((swarm_queueDepth(&modem.queue) || !modem.info.isSleeping) && swarm_halLinuxMicros() - start < 15000000ULL)
+        bench_service(5);                           // the early batch goes out, then it's idle again
+    sim.config.backgroundRssi = -88;                // rated Bad
+    sim.config.tdSentMs = 3000;                     // and nothing gets up while it is
+    payload[0] = (unsigned char)i++;
+    BENCH_CALL(swarm_queuePush(&modem.queue, payload, 16));
+    while(!modem.sched.stats.backoffSleeps && swarm_halLinuxMicros() - start < 20000000ULL)
+        bench_service(5);
+    sim.config.backgroundRssi = -104;
+    sim.config.tdSentMs = 100;
+    nextPush = swarm_halLinuxMicros();
+    steady = nextPush + schedSeconds * 1000000ULL;
+    while(swarm_halLinuxMicros() < steady){
+        if(swarm_halLinuxMicros() >= nextPush){
+            payload[0] = (unsigned char)i++;
+            BENCH_CALL(swarm_queuePush(&modem.queue, payload, 16));
+            nextPush += 400000ULL;
+        }
+        bench_service(5);
+    }
+    swarm_schedStop(&modem.sched);
+    bench_report("scheduler", i, swarm_halLinuxMicros() - start, swarm_halLinuxMicros() - start,
+                 swarmHalLinuxStats.blockedUs - blocked);
+    swarm_schedEstimate(&modem.sched, &estimate);
+    printf("            %lu uA average vs %lu uA always awake (%lu uA of both is $TD on the air), %u%% awake\n",
+           estimate.avgCurrent_uA, SWARM_SCHED_AWAKE_uA + estimate.txCurrent_uA, estimate.txCurrent_uA,
+           estimate.dutyPercent);
+    printf("            %lu sent, $TD OK -> SENT latency %lu ms avg %lu ms max\n",
+           estimate.sent, estimate.latencyAvgMs, estimate.latencyMaxMs);
+    printf("            %lu sleeps (%lu idle, %lu backoff), %lu early wakes, depth %u left\n",
+           modem.sched.stats.sleeps, modem.sched.stats.idleSleeps, modem.sched.stats.backoffSleeps, modem.sched.stats.wakes,
+           swarm_queueDepth(&modem.queue));
+    if(modem.info.isSleeping)
+        swarm_wake(&modem);
+
+    printf("uart      : %lu bytes tx, %lu bytes rx, %lu sim rx commands, %lu bad checksums\n",
+           swarmHalLinuxStats.bytesTx, swarmHalLinuxStats.bytesRx, sim.rxCommands, sim.rxBadChecksum);
+    printf("parser    : %lu sentences, %lu bad checksum, %lu no checksum, %lu noise, %lu dropped, %lu overflow\n",
+           modem.parser.stats.sentences, modem.parser.stats.badChecksum, modem.parser.stats.noChecksum, modem.parser.stats.noise,
+           modem.parser.stats.dropped, modem.parser.stats.overflow);
+    printf("            line pool high water: short %u/%u mid %u/%u full %u/%u, %lu took a bigger size, %lu found none\n",
+           modem.parser.pool.stats[SwarmPoolShort].highWater, SWARM_POOL_SHORT_COUNT,
+           modem.parser.pool.stats[SwarmPoolMid].highWater, SWARM_POOL_MID_COUNT,
+           modem.parser.pool.stats[SwarmPoolFull].highWater, SWARM_POOL_FULL_COUNT,
+           modem.parser.pool.stats[SwarmPoolShort].bigger + modem.parser.pool.stats[SwarmPoolMid].bigger,
+           modem.parser.pool.stats[SwarmPoolShort].empty + modem.parser.pool.stats[SwarmPoolMid].empty +
+           modem.parser.pool.stats[SwarmPoolFull].empty);
+    printf("cmd engine: %lu sent, %lu retries, %lu completed, %lu errors, %lu timeouts\n",
+           modem.cmds.stats.sent, modem.cmds.stats.retries, modem.cmds.stats.completed, modem.cmds.stats.errors, modem.cmds.stats.timeouts);
+    printf("messages  : %lu requests, %u high water, %lu failures\n",
+           messageStats.requests, messageStats.highWater, messageStats.failures);
+
+    /* Two modems, each on its own sim and its own SwarmModem, serviced from one loop. Every $TD has to land on
+     * the modem it was given to, and the first one must not notice the second starting up */
+    start = swarm_halLinuxMicros();
+    while((swarm_queueDepth(&modem.queue) || modem.queue.inFlight) && swarm_halLinuxMicros() - start < 10000000ULL)
+        bench_service(5);                           // what the scheduler left behind goes out first
+    if(swarmsim_open(&sim2, &config) || swarmsim_start(&sim2)){
+        perror("swarmsim");
+        return 1;
+    }
+    while(!swarmsim_isRunning(&sim2))
+        usleep(1000);
+    sim2.config.lossPercent = 0;
+    swarm_halLinuxPortInit(&port2, sim2.slavePath);
+    swarm_modemInit(&modem2, &swarmHalLinux, &port2, &queueStore2);
+    busyUs = 0;
+    start = swarm_halLinuxMicros();
+    BENCH_CALL(swarm_startup(&modem2));
+    while(!modem2.info.satFullyInitialized && swarm_halLinuxMicros() - start < 30000000ULL){
+        bench_serviceModem(&modem, 2);
+        bench_serviceModem(&modem2, 2);
+    }
+    tdBefore = sim.nextMsgId;                       // the sims number every $TD they take
+    tdBefore2 = sim2.nextMsgId;
+    lines = modem.parser.stats.sentences + modem2.parser.stats.sentences;
+    for(i = 0; i < count / 4; i++){
+        BENCH_CALL(swarm_transmitData(&modem, SAT_MSG_APPLICATION_ID, SAT_MSG_HOLD_TIME_1DAY, (char*)payload, 16));
+        BENCH_CALL(swarm_transmitData(&modem2, SAT_MSG_APPLICATION_ID, SAT_MSG_HOLD_TIME_1DAY, (char*)payload, 32));
+        bench_serviceModem(&modem, 0);
+        bench_serviceModem(&modem2, 0);
+    }
+    while(modem.parser.stats.sentences + modem2.parser.stats.sentences < lines + count / 2 &&
+          swarm_halLinuxMicros() - start < 35000000ULL){
+        bench_serviceModem(&modem, 2);
+        bench_serviceModem(&modem2, 2);
+    }
+    bench_report("two modems", count / 2, swarm_halLinuxMicros() - start, swarm_halLinuxMicros() - start, 0);
+    printf("            modem 1: %lu $TD taken, %lu bytes tx, init %s   modem 2: %lu $TD taken, %lu bytes tx, init %s\n",
+           (unsigned long)(sim.nextMsgId - tdBefore), port.stats.bytesTx,
+           modem.info.satFullyInitialized ? "kept" : "LOST",
+           (unsigned long)(sim2.nextMsgId - tdBefore2), port2.stats.bytesTx,
+           modem2.info.satFullyInitialized ? "done" : "TIMED OUT");
+    swarm_shutdown(&modem2);
+    swarmsim_stop(&sim2);
+    swarmsim_close(&sim2);
+
+    /* Rates: what modem->info is allowed to get as old as, in each power mode, with seconds standing in for
+     * minutes. Full streams all six every second like an app that wants everything fresh, Normal and Low should
+     * cost far fewer lines for the same ages. Everything goes back to off at the end */
+    start = swarm_halLinuxMicros();
+    while(sim.unsent && swarm_halLinuxMicros() - start < 5000000ULL)
+        bench_service(5);                           // the two modem phase's $TD SENT aren't ours to count
+    sim.config.timeScale = 1;                       // sim rates are seconds again
+    memcpy(modem.rates.maxAgeS, benchRates, sizeof(modem.rates.maxAgeS));
+    modem.rates.streamMaxS = 2;
+    modem.rates.retryMs = 1000;
+    modem.rates.power = SwarmPowerFull;
+    memset(&modem.rates.stats, 0, sizeof(modem.rates.stats));
+    swarm_ratesStart(&modem.rates);
+    busyUs = 0;
+    start = swarm_halLinuxMicros();
+    for(i = 0; i < SwarmPowerCount; i++)
+        bench_ratesWindow(&sim, (SwarmPowerMode)i, 3000, &ratesRx[i], &ratesTx[i]);
+    bench_report("rates", (unsigned int)(modem.rates.stats.streamed + modem.rates.stats.polled),
+                 swarm_halLinuxMicros() - start, swarm_halLinuxMicros() - start, 0);
+    printf("            lines a minute rx / tx: Full %lu / %lu   Normal %lu / %lu   Low %lu / %lu\n",
+           ratesRx[SwarmPowerFull] * 20, ratesTx[SwarmPowerFull] * 20, ratesRx[SwarmPowerNormal] * 20,
+           ratesTx[SwarmPowerNormal] * 20, ratesRx[SwarmPowerLow] * 20, ratesTx[SwarmPowerLow] * 20);
+    printf("            %lu streamed, %lu polled (%lu @ sent, %lu of them late streams), %lu rates set\n",
+           modem.rates.stats.streamed, modem.rates.stats.polled, modem.rates.stats.polls, modem.rates.stats.stale,
+           modem.rates.stats.sets);
+    memset(modem.rates.maxAgeS, 0, sizeof(modem.rates.maxAgeS));
+    while((modem.cmds.count || sim.rate[SwarmSimGN] || sim.rate[SwarmSimRT]) && swarm_halLinuxMicros() - start < 20000000ULL)
+        bench_service(5);
+    swarm_ratesStop(&modem.rates);
+
+    /* Events: the same $RT @ round trips polled and event driven. The latency should come out the same, the
+     * swarm_handleMsg() calls per reply is what the board saves in LPM */
+    swarm_eventOn(&modem.events, SAT_HEADER_RECEIVE_TEST, bench_onRt);
+    polledCalls = bench_rtRoundTrips(count / 4, false, &polledUs);
+    eventCalls = bench_rtRoundTrips(count / 4, true, &eventUs);
+    swarm_eventOn(&modem.events, SAT_HEADER_RECEIVE_TEST, 0);
+    swarm_warmSetRate(&modem, SwarmRatePower, 3600);    // for the reboot below, it has to come back by itself
+    printf("events    : %u $RT round trips, polled %8.1f calls/reply %6.2f ms/reply   event driven %6.1f calls/reply %6.2f ms/reply\n",
+           count / 4, polledCalls / (double)(count / 4), polledUs / 1000.0 / (count / 4),
+           eventCalls / (double)(count / 4), eventUs / 1000.0 / (count / 4));
+    printf("            %lu handler calls, %lu waits, %lu busy, %lu ms of sleep asked for\n",
+           modem.events.stats.dispatched, modem.events.stats.waits, modem.events.stats.busy, modem.events.stats.idleMs);
+
+    bench_printStats(&modem.stats);
+
+    /* Restart: an MCU reset with the FRAM record thrown away, then one with it kept, then the modem rebooting
+     * under us. The $PW rate set above has to survive all three */
+    sim.config.timeScale = 1;
+    while(modem.cmds.count && swarm_halLinuxMicros() - start < 60000000ULL)
+        bench_service(5);
+    busyUs = 0;
+    coldOk = bench_restart(false, &coldUs, &coldCmds);
+    warmOk = bench_restart(true, &warmUs, &warmCmds);
+    printf("restart   : cold %6.1f ms %lu commands sent%s   warm %6.1f ms %lu sent%s   ($PW rate on the modem %u)\n",
+           coldUs / 1000.0, coldCmds, coldOk ? "" : " (TIMED OUT)", warmUs / 1000.0, warmCmds,
+           warmOk ? (modem.warm.stats.warmStarts ? "" : " (WENT COLD)") : " (TIMED OUT)", sim.rate[SwarmSimPW]);
+    start = swarm_halLinuxMicros();
+    swarm_sendCommand(&modem, SAT_CMD_RESTART_DEVICE, SAT_CMD_PARAM_NO_PARAMS);
+    while(!modem.warm.booting && swarm_halLinuxMicros() - start < 5000000ULL)
+        bench_service(2);
+    while((!modem.info.satFullyInitialized || modem.cmds.count) && swarm_halLinuxMicros() - start < 30000000ULL)
+        bench_service(2);
+    printf("            modem reboot: %6.1f ms until initialized again, %lu reboots seen, $PW rate %u after it\n",
+           (swarm_halLinuxMicros() - start) / 1000.0, modem.warm.stats.reboots, sim.rate[SwarmSimPW]);
+    printf("            faults: %lu boot, %lu abort, %lu noise   %lu back in service, last %lu ms max %lu ms, %lu quick inits\n",
+           modem.errors.stats.faults[SwarmFaultBoot], modem.errors.stats.faults[SwarmFaultAbort],
+           modem.errors.stats.faults[SwarmFaultNoise], modem.errors.stats.recovered, modem.errors.stats.recoveryLastMs,
+           modem.errors.stats.recoveryMaxMs, modem.errors.stats.quickInits);
+
+    if(tracePath){
+        printf("trace     : %lu records, %llu bytes RX %llu TX, %.1f s in %s\n", trace.records,
+               trace.bytes[SwarmTraceRx], trace.bytes[SwarmTraceTx], trace.timeUs / 1e6, tracePath);
+        swarm_traceClose(&trace);
+    }
+    swarmsim_stop(&sim);
+    swarmsim_close(&sim);
+    return fullOk ? 0 : 1;
+}
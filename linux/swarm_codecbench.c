@@ -0,0 +1,201 @@
+/*
+ * swarm_codecbench.c
+ *
+ *  Created on: Oct 16, 2026
+ *      Author: MicroTechEE
+ *
+ * Packs a recorded sensor trace into 192 byte packets with SwarmCodec, decodes every packet again to check it, and
+ * reports bytes per sample against sending the raw struct. Trace is CSV, '#' lines are comments:
+ *
+ *      time_s,temp_c100,pressure_hpa10,battery_mv,lat,lon
+ *
+ *      ./swarm_codecbench traces/buoy.csv
+ */
+
+// STD C
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <SwarmCodec.h>
+
+#define BENCH_MAX_SAMPLES                               8192
+#define BENCH_PACKET                                    192      // SAT_NUMBER_MAX_PACKET_BYTES_HEX
+#define BENCH_RAW_SAMPLE                                18       // u32 time, i16 temp, u16 pressure, u16 battery, 2 floats
+
+/* * * * * * * * STRUCTS * * * * * * * * * */
+typedef struct{
+    long time;
+    long temp;
+    long pressure;
+    long battery;
+    long lat;                                   // SwarmCodec fixed point
+    long lon;
+}Sample;
+
+typedef struct{
+    long time;
+    long timeStep;                              // time is delta-of-delta, a steady sample rate costs 1 byte
+    long temp;
+    long pressure;
+    long battery;
+    long lat;
+    long lon;
+}History;
+
+/* - - - - - - - - - - - - - GLOBALS - - - - - - - - - - - - - - - */
+static Sample samples[BENCH_MAX_SAMPLES];
+
+/* - - - - - - - - - - - - - FUNCTIONS - - - - - - - - - - - - - - - */
+static unsigned int bench_load(const char* path)
+{
+    FILE* f = fopen(path, "r");
+    char line[256];
+    double lat;
+    double lon;
+    unsigned int count = 0;
+    Sample* s;
+
+    if(!f){
+        perror(path);
+        exit(1);
+    }
+    while(count < BENCH_MAX_SAMPLES && fgets(line, sizeof(line), f)){
+        if(line[0] == '#' || line[0] == '\n')
+            continue;
+        s = &samples[count];
+        if(sscanf(line, "%ld,%ld,%ld,%ld,%lf,%lf", &s->time, &s->temp, &s->pressure, &s->battery, &lat, &lon) != 6)
+            continue;
+        s->lat = swarm_codecGpsFromMicro((long)(lat * 1e6 + (lat < 0 ? -0.5 : 0.5)));     // same units as info.gps
+        s->lon = swarm_codecGpsFromMicro((long)(lon * 1e6 + (lon < 0 ? -0.5 : 0.5)));
+        count++;
+    }
+    fclose(f);
+    return count;
+}
+
+static void bench_encode(SwarmCodec* codec, const Sample* s, History* h, bool first)
+{
+    // first sample in a packet is absolute so every packet decodes on its own
+    long step;
+
+    if(first){
+        swarm_codecPutVarint(codec, (unsigned long)s->time);
+        swarm_codecPutSVarint(codec, s->temp);
+        swarm_codecPutVarint(codec, (unsigned long)s->pressure);
+        swarm_codecPutVarint(codec, (unsigned long)s->battery);
+        swarm_codecPutGps(codec, s->lat, s->lon);
+        h->timeStep = 0;
+    }
+    else{
+        step = s->time - h->time;
+        swarm_codecPutDelta(codec, step, &h->timeStep);
+        swarm_codecPutDelta(codec, s->temp, &h->temp);
+        swarm_codecPutDelta(codec, s->pressure, &h->pressure);
+        swarm_codecPutDelta(codec, s->battery, &h->battery);
+        swarm_codecPutDelta(codec, s->lat, &h->lat);
+        swarm_codecPutDelta(codec, s->lon, &h->lon);
+    }
+    h->time = s->time;
+    h->temp = s->temp;
+    h->pressure = s->pressure;
+    h->battery = s->battery;
+    h->lat = s->lat;
+    h->lon = s->lon;
+}
+
+static unsigned int bench_decode(const unsigned char* packet, unsigned int len, unsigned int count, const Sample* expect)
+{
+    // the ground side, returns how many samples didn't come back exactly
+    SwarmCodec codec;
+    History h;
+    Sample s;
+    unsigned int i;
+    unsigned int bad = 0;
+
+    swarm_codecInit(&codec, (unsigned char*)packet, len);
+    for(i = 0; i < count; i++){
+        if(i == 0){
+            s.time = (long)swarm_codecGetVarint(&codec);
+            s.temp = swarm_codecGetSVarint(&codec);
+            s.pressure = (long)swarm_codecGetVarint(&codec);
+            s.battery = (long)swarm_codecGetVarint(&codec);
+            swarm_codecGetGps(&codec, &s.lat, &s.lon);
+            h.timeStep = 0;
+        }
+        else{
+            s.time = h.time + swarm_codecGetDelta(&codec, &h.timeStep);
+            s.temp = swarm_codecGetDelta(&codec, &h.temp);
+            s.pressure = swarm_codecGetDelta(&codec, &h.pressure);
+            s.battery = swarm_codecGetDelta(&codec, &h.battery);
+            s.lat = swarm_codecGetDelta(&codec, &h.lat);
+            s.lon = swarm_codecGetDelta(&codec, &h.lon);
+        }
+        h.time = s.time;
+        h.temp = s.temp;
+        h.pressure = s.pressure;
+        h.battery = s.battery;
+        h.lat = s.lat;
+        h.lon = s.lon;
+        if(codec.overflow || memcmp(&s, &expect[i], sizeof(s)) != 0)
+            bad++;
+    }
+    return bad;
+}
+
+int main(int argc, char** argv)
+{
+    const char* path = argc > 1 ? argv[1] : "traces/buoy.csv";
+    unsigned char packet[BENCH_PACKET];
+    SwarmCodec codec;
+    History h;
+    unsigned int count;
+    unsigned int i;
+    unsigned int first = 0;                     // first sample in the current packet
+    unsigned int packets = 0;
+    unsigned int printable = 0;
+    unsigned int bad = 0;
+    unsigned long bytes = 0;
+    unsigned int mark;
+    History saved;
+
+    count = bench_load(path);
+    if(count == 0){
+        fprintf(stderr, "%s: no samples\n", path);
+        return 1;
+    }
+
+    memset(&h, 0, sizeof(h));
+    swarm_codecInit(&codec, packet, sizeof(packet));
+    for(i = 0; i <= count; i++){
+        if(i < count){
+            mark = codec.bits;
+            saved = h;
+            bench_encode(&codec, &samples[i], &h, i == first);
+            if(!codec.overflow)
+                continue;
+            codec.bits = mark;                  // didn't fit, close the packet without it
+            codec.overflow = false;
+            h = saved;
+        }
+        packets++;
+        bytes += swarm_codecLength(&codec);
+        printable += swarm_codecIsPrintable(packet, swarm_codecLength(&codec));
+        bad += bench_decode(packet, swarm_codecLength(&codec), i - first, &samples[first]);
+        first = i;
+        swarm_codecInit(&codec, packet, sizeof(packet));
+        if(i < count)
+            i--;                                // encode this one again as the start of the next packet
+    }
+
+    printf("trace     : %s, %u samples\n", path, count);
+    printf("raw       : %5.2f bytes/sample  %3u samples/packet  %4u packets  %6.1f hex chars/sample\n",
+           (double)BENCH_RAW_SAMPLE, BENCH_PACKET / BENCH_RAW_SAMPLE,
+           (count + BENCH_PACKET / BENCH_RAW_SAMPLE - 1) / (BENCH_PACKET / BENCH_RAW_SAMPLE), 2.0 * BENCH_RAW_SAMPLE);
+    printf("codec     : %5.2f bytes/sample  %5.1f samples/packet  %4u packets  %6.1f hex chars/sample\n",
+           bytes / (double)count, count / (double)packets, packets, 2.0 * bytes / count);
+    printf("ascii     : %u of %u packets printable (SwarmPayloadAuto would send those at 1 char/byte)\n", printable, packets);
+    printf("decode    : %u of %u samples mismatched\n", bad, count);
+    return bad ? 1 : 0;
+}
@@ -0,0 +1,116 @@
+/*
+ * swarm_defrag.c
+ *
+ *  Created on: Oct 16, 2026
+ *      Author: MicroTechEE
+ *
+ * Puts SwarmFragment blobs back together on the ground. One $TD payload per line in any order, repeats are fine,
+ * either the bare hex from the Swarm Hive export or a whole $TD line as the driver sent it. Lines that aren't
+ * fragments are skipped. Every finished blob is reported, and written to <prefix><id>.bin with -o:
+ *
+ *      ./swarm_defrag -o blob_ < payloads.txt
+ */
+
+// STD C
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// POSIX
+#include <unistd.h>
+
+#include <SwarmMSP430.h>
+#include "SwarmDefrag.h"
+
+/* - - - - - - - - - - - - - GLOBALS - - - - - - - - - - - - - - - */
+static SwarmDefrag defrag;
+
+/* - - - - - - - - - - - - - FUNCTIONS - - - - - - - - - - - - - - - */
+static int defrag_nibble(char c)
+{
+    if(c >= '0' && c <= '9')
+        return c - '0';
+    if(c >= 'A' && c <= 'F')
+        return c - 'A' + 10;
+    if(c >= 'a' && c <= 'f')
+        return c - 'a' + 10;
+    return -1;
+}
+
+static unsigned int defrag_hex(const char* line, unsigned char* packet, unsigned int max)
+{
+    // the payload is the last run of hex before the '*' (or the end), same as swarm_aggdecode
+    const char* end = strchr(line, '*');
+    const char* start;
+    unsigned int len = 0;
+
+    if(!end)
+        end = line + strcspn(line, "\r\n");
+    start = end;
+    while(start > line && defrag_nibble(start[-1]) >= 0)
+        start--;
+    if((end - start) & 1)
+        start++;
+    while(start + 1 < end && len < max){
+        packet[len++] = (unsigned char)(defrag_nibble(start[0]) << 4 | defrag_nibble(start[1]));
+        start += 2;
+    }
+    return len;
+}
+
+static void defrag_save(const char* prefix, unsigned char id, const unsigned char* blob, unsigned long len)
+{
+    char path[512];
+    FILE* file;
+
+    snprintf(path, sizeof(path), "%s%u.bin", prefix, id);
+    file = fopen(path, "wb");
+    if(!file || fwrite(blob, 1, len, file) != len)
+        perror(path);
+    if(file)
+        fclose(file);
+}
+
+int main(int argc, char** argv)
+{
+    unsigned char packet[SWARM_QUEUE_DATA_MAX];
+    const unsigned char* blob;
+    unsigned long blobLen;
+    const char* prefix = 0;
+    char line[1024];
+    unsigned long number = 0;
+    unsigned int len;
+    int opt;
+
+    while((opt = getopt(argc, argv, "o:h")) != -1){
+        switch(opt){
+        case 'o': prefix = optarg; break;
+        default:
+            fprintf(stderr, "usage: %s [-o prefix] < payloads\n", argv[0]);
+            return 2;
+        }
+    }
+
+    swarm_defragInit(&defrag);
+    while(fgets(line, sizeof(line), stdin)){
+        number++;
+        len = defrag_hex(line, packet, sizeof(packet));
+        switch(swarm_defragFeed(&defrag, packet, len, &blob, &blobLen)){
+        case SwarmDefragComplete:
+            printf("blob %u: %lu bytes in %u fragments, CRC ok (line %lu)\n", packet[1], blobLen, packet[3] + 1U, number);
+            if(prefix)
+                defrag_save(prefix, packet[1], blob, blobLen);
+            break;
+        case SwarmDefragBadCrc:
+            printf("blob %u: %u fragments, CRC MISMATCH (line %lu)\n", packet[1], packet[3] + 1U, number);
+            break;
+        default:
+            break;
+        }
+    }
+    printf("%lu lines, %lu fragments, %lu duplicates, %lu complete, %lu bad CRC, %lu evicted, %lu not fragments\n",
+           number, defrag.stats.fragments, defrag.stats.duplicates, defrag.stats.completed, defrag.stats.badCrc,
+           defrag.stats.evicted, defrag.stats.notFragment);
+    return defrag.stats.badCrc ? 1 : 0;
+}
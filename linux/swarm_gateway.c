@@ -0,0 +1,174 @@
+/*
+ * swarm_gateway.c
+ *
+ *  Created on: Oct 16, 2026
+ *      Author: MicroTechEE
+ *
+ * SwarmGateway against 1, 2, 4 ... -m simulated modems, or against the ttys on the command line. Pushes -n
+ * 64 byte jobs into the shared queue and times how long until every one has a $TD OK, so you can see the
+ * throughput go up with the modems. -k pulls the plug on the last modem halfway through, its jobs have to
+ * end up on the others.
+ *
+ *      ./swarm_gateway -m 8 -n 400 -t 200 -k
+ *      ./swarm_gateway -n 20 /dev/ttyUSB0 /dev/ttyUSB1
+ */
+
+// STD C
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// POSIX
+#include <unistd.h>
+
+#include <SwarmMSP430.h>
+#include "SwarmHAL_Linux.h"
+#include "SwarmGateway.h"
+#include "SwarmSim.h"
+
+/* - - - - - - - - - - - - - GLOBALS - - - - - - - - - - - - - - - */
+static SwarmGateway gw;
+static SwarmSim sims[SWARM_GW_MODEMS];
+
+/* - - - - - - - - - - - - - FUNCTIONS - - - - - - - - - - - - - - - */
+static bool gateway_waitInit(unsigned int modems, unsigned long long timeoutUs)
+{
+    unsigned long long start = swarm_halLinuxMicros();
+    unsigned int i;
+    unsigned int ready;
+
+    do{
+        swarm_gwRun(&gw, 5);
+        for(i = 0, ready = 0; i < modems; i++)
+            ready += gw.modem[i].modem.info.satFullyInitialized;
+        if(ready == modems)
+            return true;
+    }while(swarm_halLinuxMicros() - start < timeoutUs);
+    return false;
+}
+
+static int gateway_run(char** paths, unsigned int modems, const SwarmSimConfig* config, unsigned int jobs, bool kill)
+{
+    unsigned char payload[64];
+    unsigned long long start;
+    unsigned long long elapsed;
+    unsigned long long taken = 0;
+    unsigned int i;
+    bool killed = false;
+
+    if(!swarm_gwInit(&gw)){
+        perror("epoll");
+        return 1;
+    }
+    for(i = 0; i < modems; i++){
+        if(!paths){
+            if(swarmsim_open(&sims[i], config) || swarmsim_start(&sims[i])){
+                perror("swarmsim");
+                return 1;
+            }
+            sims[i].config.backgroundRssi = -106 + (int)(i % 4) * 4;   // not every modem sees the same sky
+            while(!swarmsim_isRunning(&sims[i]))
+                usleep(1000);
+        }
+        if(swarm_gwAdd(&gw, paths ? paths[i] : sims[i].slavePath) < 0){
+            fprintf(stderr, "swarm_gateway: can't open %s\n", paths ? paths[i] : sims[i].slavePath);
+            return 1;
+        }
+    }
+    if(!gateway_waitInit(modems, 30000000ULL))
+        fprintf(stderr, "swarm_gateway: not every modem came up\n");
+    for(i = 0; !paths && i < modems; i++)
+        taken -= sims[i].nextMsgId;             // the sims number every $TD they take
+
+    start = swarm_halLinuxMicros();
+    for(i = 0; i < jobs; i++){
+        memset(payload, (int)i, sizeof(payload));
+        payload[0] = (unsigned char)(i >> 8);
+        payload[1] = (unsigned char)i;
+        if(!swarm_gwPush(&gw, payload, sizeof(payload)))
+            break;
+    }
+    while(swarm_gwPending(&gw) && swarm_halLinuxMicros() - start < 60000000ULL){
+        swarm_gwRun(&gw, 5);
+        if(kill && !killed && modems > 1 && swarm_gwAccepted(&gw) >= jobs / 2){
+            swarmsim_stop(&sims[modems - 1]);   // unplugged
+            swarmsim_close(&sims[modems - 1]);
+            killed = true;
+        }
+    }
+    elapsed = swarm_halLinuxMicros() - start;
+
+    for(i = 0; !paths && i < modems; i++)
+        taken += sims[i].nextMsgId;
+    printf("%2u modem%s: %5lu of %u accepted in %8.1f ms  %8.1f msg/s  %lu epoll waits, %lu taken back%s\n",
+           modems, modems == 1 ? " " : "s", swarm_gwAccepted(&gw), jobs, elapsed / 1000.0,
+           elapsed ? swarm_gwAccepted(&gw) * 1e6 / (double)elapsed : 0.0, gw.stats.waits, gw.stats.requeued,
+           killed ? " (one unplugged)" : "");
+    printf("           pulled:");
+    for(i = 0; i < modems; i++)
+        printf(" %lu%s", gw.modem[i].stats.pulled, gw.modem[i].open ? "" : "x");
+    printf("   rssi:");
+    for(i = 0; i < modems; i++)
+        printf(" -%d", gw.modem[i].modem.info.rssi.background);
+    if(!paths)
+        printf("   sims took %llu", taken);
+    printf("\n");
+
+    swarm_gwClose(&gw);
+    for(i = 0; !paths && i < modems; i++){
+        if(killed && i == modems - 1)
+            continue;
+        swarmsim_stop(&sims[i]);
+        swarmsim_close(&sims[i]);
+    }
+    return 0;
+}
+
+int main(int argc, char** argv)
+{
+    SwarmSimConfig config;
+    unsigned int modems = 4;
+    unsigned int jobs = 400;
+    unsigned int m;
+    bool kill = false;
+    int opt;
+
+    swarmsim_defaultConfig(&config);
+    config.bootMs = 100;
+    config.dateTimeMs = 0;
+    config.tdSentMs = 200;
+    while((opt = getopt(argc, argv, "m:n:t:l:j:kvh")) != -1){
+        switch(opt){
+        case 'm': modems = (unsigned int)atoi(optarg); break;
+        case 'n': jobs = (unsigned int)atoi(optarg); break;
+        case 't': config.tdSentMs = (unsigned int)atoi(optarg); break;
+        case 'l': config.latencyMs = (unsigned int)atoi(optarg); break;
+        case 'j': config.jitterMs = (unsigned int)atoi(optarg); break;
+        case 'k': kill = true; break;
+        case 'v': config.verbose = true; break;
+        default:
+            fprintf(stderr, "usage: %s [-m max_modems] [-n jobs] [-t tdsent_ms] [-l latency_ms] [-j jitter_ms] [-k] [-v] [tty ...]\n",
+                    argv[0]);
+            return 2;
+        }
+    }
+    if(jobs > SWARM_GW_JOBS)
+        jobs = SWARM_GW_JOBS;
+    if(modems < 1 || modems > SWARM_GW_MODEMS)
+        modems = modems < 1 ? 1 : SWARM_GW_MODEMS;
+
+    if(optind < argc)
+        return gateway_run(argv + optind, (unsigned int)(argc - optind) > SWARM_GW_MODEMS ? SWARM_GW_MODEMS :
+                           (unsigned int)(argc - optind), &config, jobs, false);
+
+    printf("swarm_gateway: %u jobs, latency %u ms jitter %u ms, $TD SENT after %u ms\n",
+           jobs, config.latencyMs, config.jitterMs, config.tdSentMs);
+    for(m = 1; m <= modems; m *= 2){
+        if(gateway_run(0, m, &config, jobs, false))
+            return 1;
+    }
+    if(kill && gateway_run(0, modems, &config, jobs, true))
+        return 1;
+    return 0;
+}
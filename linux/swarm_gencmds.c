@@ -0,0 +1,78 @@
+/*
+ * swarm_gencmds.c
+ *
+ *  Created on: Oct 16, 2026
+ *      Author: MicroTechEE
+ *
+ * Writes SwarmCommandTable.c from SAT_PREBUILT_COMMANDS in SwarmMSP430.h, every sentence complete with its
+ * checksum so the board never has to build them. "make commands" runs it for you.
+ *
+ *      ./swarm_gencmds > ../SwarmCommandTable.c
+ */
+
+// STD C
+#include <stdbool.h>
+#include <stdio.h>
+
+#include <Message.h>
+#include <SwarmMSP430.h>
+
+/* - - - - - - - - - - - - - GLOBALS - - - - - - - - - - - - - - - */
+typedef struct{
+    const char* id;
+    const char* cmd;
+    const char* params;
+}GenCmd;
+
+#define GEN_ENTRY(id, cmd, params)      {#id, cmd, params},
+static const GenCmd genCmds[] = {
+    SAT_PREBUILT_COMMANDS(GEN_ENTRY)
+};
+#undef GEN_ENTRY
+
+/* - - - - - - - - - - - - - FUNCTIONS - - - - - - - - - - - - - - - */
+static unsigned char gen_checksum(const char* sentence)
+{
+    // same as swarm_checksum(), '$' isn't included
+    unsigned char cs = 0;
+
+    if(*sentence == '$')
+        sentence++;
+    while(*sentence)
+        cs ^= (unsigned char)*sentence++;
+    return cs;
+}
+
+int main(void)
+{
+    char sentence[64];
+    unsigned int i;
+    int len;
+
+    printf("/*\n"
+           " * SwarmCommandTable.c\n"
+           " *\n"
+           " *  GENERATED by linux/swarm_gencmds.c from SAT_PREBUILT_COMMANDS in SwarmMSP430.h, don't edit.\n"
+           " *  Run \"make -C linux commands\" after changing the commands.\n"
+           " */\n"
+           "\n"
+           "#include <Message.h>\n"
+           "#include <SwarmMSP430.h>\n"
+           "\n"
+           "const SwarmPrebuiltCmd swarmCommandTable[SwarmCmdCount] = {\n");
+
+    for(i = 0; i < sizeof(genCmds) / sizeof(genCmds[0]); i++){
+        if(*genCmds[i].params)
+            len = snprintf(sentence, sizeof(sentence), "%s %s", genCmds[i].cmd, genCmds[i].params);
+        else
+            len = snprintf(sentence, sizeof(sentence), "%s", genCmds[i].cmd);
+        if(len < 0 || len + 4 >= (int)sizeof(sentence)){
+            fprintf(stderr, "swarm_gencmds: %s is too long\n", genCmds[i].id);
+            return 1;
+        }
+        printf("    [%s] = {\"%s\", \"%s\", \"%s*%02X\\n\", %d},\n", genCmds[i].id, genCmds[i].cmd, genCmds[i].params,
+               sentence, gen_checksum(sentence), len + 4);
+    }
+    printf("};\n");
+    return 0;
+}
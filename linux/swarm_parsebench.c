@@ -0,0 +1,445 @@
+/*
+ * swarm_parsebench.c
+ *
+ *  Created on: Oct 16, 2026
+ *      Author: MicroTechEE
+ *
+ * Times the typed parsers in SwarmSentences.c on one of every M138 sentence, after SwarmParser has split them.
+ * Each sentence is parsed in BENCH_ROUNDS rounds, "worst" is the slowest round's average so one context switch
+ * doesn't hide the number. Prints what each one parsed so a wrong number shows up next to its timing.
+ *
+ * Then how many of them the parser holds in a burst the main loop doesn't get to, and which SwarmPool sizes that took.
+ *
+ * Then $GN and $PW three ways: strtof / strtol like the driver used to, a hand-rolled float reader, and the fixed
+ * point parsers the driver uses now. Cycles come from the TSC on x86. The host has an FPU, on the MSP430 every float
+ * operation in the first two is a soft-float library call, so the gap there is bigger than what this prints.
+ *
+ *      ./swarm_parsebench -n 100000
+ */
+
+// STD C
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+// POSIX
+#include <unistd.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define BENCH_CYCLES()  __rdtsc()
+#else
+#define BENCH_CYCLES()  0ULL
+#endif
+
+#include <SwarmParser.h>
+#include <SwarmSentences.h>
+
+/* * * * * * * * STRUCTS * * * * * * * * * */
+typedef struct{
+    const char* body;                           // without '$' and *xx
+    unsigned long long totalNs;
+    double worstNs;                             // slowest round, per parse
+    bool parsed;
+    SwarmSentence sentence;
+    char text[SWARM_PARSER_LINE_MAX + 1];       // sentence.line, the parser's pool is gone after bench_split()
+}BenchLine;
+
+/* - - - - - - - - - - - - - GLOBALS - - - - - - - - - - - - - - - */
+static BenchLine lines[] = {
+    {"CS DI=0x000ab5,DN=M138"},
+    {"DT 20261016120000,V"},
+    {"FV 2021-07-16T00:10:21,v1.1.0"},
+    {"GN 37.8921,-122.0155,77,89,2"},
+    {"GS 109,214,9,0,G3"},
+    {"GJ 1,75"},
+    {"PW 3.30300,0.00000,0.00000,0.00000,32.0"},
+    {"RT RSSI=-102,SNR=5,FDEV=-1250,TS=2026-10-16 12:00:00,DI=0x000ab5"},
+    {"RT RSSI=-104"},
+    {"RD AI=7777,RSSI=-95,SNR=2,FDEV=-420,48656c6c6f2066726f6d20746865206865617673"},
+    {"MM AI=7777,48656c6c6f,5354468402891,1792152000"},
+    {"MM 3"},
+    {"MT 12"},
+    {"TD OK,5354468402891"},
+    {"TD SENT RSSI=-103,SNR=7,FDEV=812,5354468402891"},
+    {"M138 BOOT,RUNNING"},
+};
+#define BENCH_LINES     (sizeof(lines) / sizeof(lines[0]))
+#define BENCH_ROUNDS    20
+#define BENCH_DOWNLINK_MAX  192                 // SWARM_DOWNLINK_DATA_MAX, the biggest $RD / $MM R=O
+
+/* - - - - - - - - - - - - - FUNCTIONS - - - - - - - - - - - - - - - */
+static unsigned long long bench_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (unsigned long long)ts.tv_sec * 1000000000ULL + (unsigned long long)ts.tv_nsec;
+}
+
+static void bench_feed(SwarmParser* parser, const char* body)
+{
+    const char* c;
+    unsigned char cs = 0;
+    char tail[8];
+
+    swarm_parserFeed(parser, '$');
+    for(c = body; *c; c++){
+        cs ^= (unsigned char)*c;
+        swarm_parserFeed(parser, (unsigned char)*c);
+    }
+    snprintf(tail, sizeof(tail), "*%02X\n", cs);
+    for(c = tail; *c; c++)
+        swarm_parserFeed(parser, (unsigned char)*c);
+}
+
+static bool bench_split(BenchLine* line)
+{
+    // through the real byte-at-a-time parser so the fields are exactly what the driver sees
+    static SwarmParser parser;
+    const SwarmSentence* sentence;
+
+    swarm_parserInit(&parser);
+    bench_feed(&parser, line->body);
+    sentence = swarm_parserGet(&parser);
+    if(!sentence || sentence->status != SwarmSentenceOk)
+        return false;
+    line->sentence = *sentence;
+    memcpy(line->text, sentence->line, sentence->length + 1);
+    line->sentence.line = line->text;
+    return true;
+}
+
+static bool bench_parse(const SwarmSentence* s, char* out, unsigned int size)
+{
+    // one call per sentence type, out gets a human readable copy (only filled when size != 0)
+    EasyLong id;
+    Calendar dt;
+    char fw[SWARM_FW_VERSION_MAX];
+    GPS gps;
+    GPSStatus gs;
+    GPSJamming gj;
+    PowerStatus pw;
+    RSSI rssi;
+    bool background;
+    SwarmRdMessage rd;
+    SwarmMmReply mm;
+    unsigned int count;
+    SwarmTdReply td;
+    ModemStatus modem;
+    bool ok = false;
+
+    memset(&modem, 0, sizeof(modem));
+    switch(s->header){
+    case 'C' << 8 | 'S':
+        ok = swarm_sentenceCs(s, &id);
+        if(ok && size) snprintf(out, size, "device 0x%06lx", (unsigned long)id.asLong);
+        break;
+    case 'D' << 8 | 'T':
+        ok = swarm_sentenceDt(s, &dt);
+        if(ok && size) snprintf(out, size, "%04u-%02u-%02u %02u:%02u:%02u", dt.Year, dt.Month + 1, dt.DayOfMonth, dt.Hours,
+                                dt.Minutes, dt.Seconds);
+        break;
+    case 'F' << 8 | 'V':
+        ok = swarm_sentenceFv(s, fw, sizeof(fw));
+        if(ok && size) snprintf(out, size, "firmware %s", fw);
+        break;
+    case 'G' << 8 | 'N':
+        ok = swarm_sentenceGn(s, &gps);
+        if(ok && size) snprintf(out, size, "%ld,%ld udeg alt %ld cm course %u speed %u km/h", gps.latitude,
+                                gps.longitude, gps.altitude, gps.course, gps.speed);
+        break;
+    case 'G' << 8 | 'S':
+        ok = swarm_sentenceGs(s, &gs);
+        if(ok && size) snprintf(out, size, "hdop %u vdop %u sats %u fix %d", gs.hdop, gs.vdop, gs.satellites, gs.fix);
+        break;
+    case 'G' << 8 | 'J':
+        ok = swarm_sentenceGj(s, &gj);
+        if(ok && size) snprintf(out, size, "spoof %u jamming %u", gj.spoofState, gj.level);
+        break;
+    case 'P' << 8 | 'W':
+        ok = swarm_sentencePw(s, &pw);
+        if(ok && size) snprintf(out, size, "%u mV %s%d.%d C", pw.voltage_mV, pw.temperature_dC < 0 ? "-" : "",
+                                abs(pw.temperature_dC) / 10, abs(pw.temperature_dC) % 10);
+        break;
+    case 'R' << 8 | 'T':
+        memset(&rssi, 0, sizeof(rssi));
+        ok = swarm_sentenceRt(s, &rssi, &background);
+        if(ok && size && background) snprintf(out, size, "background -%d dBm", rssi.background);
+        else if(ok && size) snprintf(out, size, "satellite -%d dBm snr %d fdev %d sat 0x%lx", rssi.satellite, rssi.snr,
+                                     rssi.fdev, rssi.satelliteId);
+        break;
+    case 'R' << 8 | 'D':
+        ok = swarm_sentenceRd(s, &rd);
+        if(ok && size) snprintf(out, size, "app %u rssi %d snr %d fdev %d, %u data chars", rd.appId, rd.rssi, rd.snr,
+                                rd.fdev, rd.dataLen);
+        break;
+    case 'M' << 8 | 'M':
+        ok = swarm_sentenceMm(s, &mm);
+        if(ok && size) snprintf(out, size, "kind %d count %u app %u data %u chars id %.*s es %lu", mm.kind, mm.count,
+                                mm.appId, mm.dataLen, (int)mm.msgIdLen, mm.msgId ? mm.msgId : "", mm.epoch);
+        break;
+    case 'M' << 8 | 'T':
+        ok = swarm_sentenceMt(s, &count);
+        if(ok && size) snprintf(out, size, "%u unsent", count);
+        break;
+    case 'T' << 8 | 'D':
+        ok = swarm_sentenceTd(s, &td);
+        if(ok && size) snprintf(out, size, "kind %d rssi %d snr %d fdev %d id %.*s", td.kind, td.rssi, td.snr, td.fdev,
+                                (int)td.msgIdLen, td.msgId);
+        break;
+    case 'M' << 8 | '1':
+        ok = swarm_sentenceM138(s, &modem);
+        if(ok && size) snprintf(out, size, "event %d running %d", modem.lastEvent, modem.running);
+        break;
+    }
+    return ok;
+}
+
+/* - - - - FLOAT VS FIXED - - - - */
+typedef struct{
+    float latitude;
+    float longitude;
+    float altitude;
+    long course;
+    long speed;
+}FloatGps;
+
+static volatile long benchSink;
+
+static bool bench_gnStrtof(const SwarmSentence* s, FloatGps* gps)
+{
+    // the old swarm_parseGpsMessage, strtof stops at the comma
+    char* end;
+
+    if(s->fieldCount != 5)
+        return false;
+    gps->latitude = strtof(&s->line[s->fieldStart[0]], &end);
+    gps->longitude = strtof(&s->line[s->fieldStart[1]], &end);
+    gps->altitude = strtof(&s->line[s->fieldStart[2]], &end);
+    gps->course = strtol(&s->line[s->fieldStart[3]], &end, 10);
+    gps->speed = strtol(&s->line[s->fieldStart[4]], &end, 10);
+    return true;
+}
+
+static bool bench_toFloat(const char* text, unsigned int len, float* value)
+{
+    // one integer pass and a divide, what SwarmSentences did before it went fixed point
+    static const float pow10[] = {1e0f, 1e1f, 1e2f, 1e3f, 1e4f, 1e5f, 1e6f, 1e7f, 1e8f};
+    unsigned int i = 0;
+    bool negative = false;
+    bool point = false;
+    unsigned char decimals = 0;
+    unsigned long mantissa = 0;
+
+    if(len && text[0] == '-'){
+        negative = true;
+        i++;
+    }
+    for(; i < len; i++){
+        if(text[i] == '.' && !point){
+            point = true;
+            continue;
+        }
+        if(text[i] < '0' || text[i] > '9' || decimals == 8)
+            return false;
+        mantissa = mantissa * 10 + (text[i] - '0');
+        if(point)
+            decimals++;
+    }
+    *value = negative ? -(float)mantissa / pow10[decimals] : (float)mantissa / pow10[decimals];
+    return true;
+}
+
+static bool bench_gnFloat(const SwarmSentence* s, FloatGps* gps)
+{
+    long value;
+
+    if(s->fieldCount != 5)
+        return false;
+    return bench_toFloat(&s->line[s->fieldStart[0]], s->fieldLen[0], &gps->latitude) &&
+           bench_toFloat(&s->line[s->fieldStart[1]], s->fieldLen[1], &gps->longitude) &&
+           bench_toFloat(&s->line[s->fieldStart[2]], s->fieldLen[2], &gps->altitude) &&
+           swarm_fieldToLong(&s->line[s->fieldStart[3]], s->fieldLen[3], &value) && (gps->course = value, true) &&
+           swarm_fieldToLong(&s->line[s->fieldStart[4]], s->fieldLen[4], &value) && (gps->speed = value, true);
+}
+
+static bool bench_pwStrtof(const SwarmSentence* s, float* volts, float* temp)
+{
+    char* end;
+
+    if(s->fieldCount != 5)
+        return false;
+    *volts = strtof(&s->line[s->fieldStart[0]], &end);
+    *temp = strtof(&s->line[s->fieldStart[4]], &end);
+    return true;
+}
+
+static bool bench_pwFloat(const SwarmSentence* s, float* volts, float* temp)
+{
+    if(s->fieldCount != 5)
+        return false;
+    return bench_toFloat(&s->line[s->fieldStart[0]], s->fieldLen[0], volts) &&
+           bench_toFloat(&s->line[s->fieldStart[4]], s->fieldLen[4], temp);
+}
+
+static void bench_burst(void)
+{
+    // every line back to back with the main loop busy elsewhere, nothing released until the parser has to drop one
+    static SwarmParser parser;
+    unsigned int poolBytes = sizeof(parser.pool.shortLine) + sizeof(parser.pool.midLine) + sizeof(parser.pool.fullLine);
+    unsigned int i;
+
+    swarm_parserInit(&parser);
+    for(i = 0; parser.stats.dropped == 0 && i < 4 * BENCH_LINES; i++)
+        bench_feed(&parser, lines[i % BENCH_LINES].body);
+    printf("\nRX burst, nothing released: %lu lines held, line %u was dropped (SWARM_PARSER_SLOTS %u)\n",
+           parser.stats.sentences, i, SWARM_PARSER_SLOTS);
+    printf("  line pool %u bytes (%u full size lines' worth), high water short %u/%u mid %u/%u full %u/%u\n",
+           poolBytes, poolBytes / (SWARM_PARSER_LINE_MAX + 1), parser.pool.stats[SwarmPoolShort].highWater,
+           SWARM_POOL_SHORT_COUNT, parser.pool.stats[SwarmPoolMid].highWater, SWARM_POOL_MID_COUNT,
+           parser.pool.stats[SwarmPoolFull].highWater, SWARM_POOL_FULL_COUNT);
+}
+
+static bool bench_fullSize(void)
+{
+    // a 192 byte downlink with every other field as long as it gets, as $RD and as the $MM R=O read back
+    static SwarmParser parser;
+    const SwarmSentence* sentence;
+    SwarmRdMessage rd;
+    SwarmMmReply mm;
+    char body[2 * BENCH_DOWNLINK_MAX + 64];
+    char hex[2 * BENCH_DOWNLINK_MAX + 1];
+    bool rdOk;
+    bool mmOk;
+    unsigned int i;
+
+    for(i = 0; i < 2 * BENCH_DOWNLINK_MAX; i++)
+        hex[i] = "0123456789abcdef"[i % 16];
+    hex[i] = '\0';
+    swarm_parserInit(&parser);
+
+    snprintf(body, sizeof(body), "RD AI=65535,RSSI=-128,SNR=-32,FDEV=-32768,%s", hex);
+    bench_feed(&parser, body);
+    sentence = swarm_parserGet(&parser);
+    rdOk = sentence && sentence->status == SwarmSentenceOk && swarm_sentenceRd(sentence, &rd) &&
+           rd.dataLen == 2 * BENCH_DOWNLINK_MAX;
+    if(sentence)
+        swarm_parserRelease(&parser);
+    printf("\nfull size $RD, %u chars up to the *: %s\n", (unsigned int)strlen(body) + 1, rdOk ? "parsed" : "FAILED");
+
+    snprintf(body, sizeof(body), "MM AI=65535,%s,18446744073709551615,4294967295", hex);
+    bench_feed(&parser, body);
+    sentence = swarm_parserGet(&parser);
+    mmOk = sentence && sentence->status == SwarmSentenceOk && swarm_sentenceMm(sentence, &mm) &&
+           mm.kind == SwarmMmMessage && mm.dataLen == 2 * BENCH_DOWNLINK_MAX;
+    if(sentence)
+        swarm_parserRelease(&parser);
+    printf("full size $MM, %u chars up to the *: %s\n", (unsigned int)strlen(body) + 1, mmOk ? "parsed" : "FAILED");
+    if(parser.stats.overflow)
+        printf("  %lu overflow, SWARM_PARSER_LINE_MAX is %u\n", parser.stats.overflow, SWARM_PARSER_LINE_MAX);
+    return rdOk && mmOk;
+}
+
+static void bench_compare(const char* name, int way, const SwarmSentence* s, unsigned long iterations)
+{
+    FloatGps fgps;
+    GPS gps;
+    PowerStatus pw;
+    float volts;
+    float temp;
+    unsigned long n;
+    unsigned long long t0;
+    unsigned long long c0;
+    unsigned long long ns;
+    unsigned long long cycles;
+
+    t0 = bench_ns();
+    c0 = BENCH_CYCLES();
+    for(n = 0; n < iterations; n++){
+        switch(way){
+        case 0: bench_gnStrtof(s, &fgps); benchSink = (long)fgps.latitude; break;
+        case 1: bench_gnFloat(s, &fgps); benchSink = (long)fgps.latitude; break;
+        case 2: swarm_sentenceGn(s, &gps); benchSink = gps.latitude; break;
+        case 3: bench_pwStrtof(s, &volts, &temp); benchSink = (long)volts; break;
+        case 4: bench_pwFloat(s, &volts, &temp); benchSink = (long)volts; break;
+        case 5: swarm_sentencePw(s, &pw); benchSink = pw.voltage_mV; break;
+        }
+    }
+    cycles = BENCH_CYCLES() - c0;
+    ns = bench_ns() - t0;
+    printf("  %-26s %9.1f ns %9.1f cycles\n", name, ns / (double)iterations, cycles / (double)iterations);
+}
+
+int main(int argc, char** argv)
+{
+    unsigned long iterations = 100000;
+    unsigned long perRound;
+    unsigned long n;
+    unsigned int i;
+    unsigned int round;
+    unsigned long long t0;
+    double ns;
+    unsigned int failed = 0;
+    char text[128];
+    int opt;
+
+    while((opt = getopt(argc, argv, "n:h")) != -1){
+        switch(opt){
+        case 'n': iterations = strtoul(optarg, 0, 10); break;
+        default:
+            fprintf(stderr, "usage: %s [-n iterations]\n", argv[0]);
+            return 2;
+        }
+    }
+    perRound = iterations / BENCH_ROUNDS ? iterations / BENCH_ROUNDS : 1;
+
+    for(i = 0; i < BENCH_LINES; i++){
+        if(!bench_split(&lines[i])){
+            fprintf(stderr, "$%s didn't split\n", lines[i].body);
+            return 1;
+        }
+    }
+
+    for(round = 0; round < BENCH_ROUNDS; round++){
+        for(i = 0; i < BENCH_LINES; i++){
+            t0 = bench_ns();
+            for(n = 0; n < perRound; n++)
+                lines[i].parsed = bench_parse(&lines[i].sentence, 0, 0);
+            ns = (double)(bench_ns() - t0);
+            lines[i].totalNs += (unsigned long long)ns;
+            if(ns / perRound > lines[i].worstNs)
+                lines[i].worstNs = ns / perRound;
+        }
+    }
+
+    printf("%-6s %6s %9s %9s  %s\n", "", "chars", "avg ns", "worst ns", "parsed");
+    for(i = 0; i < BENCH_LINES; i++){
+        text[0] = '\0';
+        if(!bench_parse(&lines[i].sentence, text, sizeof(text)))
+            failed++;
+        printf("$%-5.*s %6u %9.1f %9.1f  %s\n", (int)strcspn(lines[i].body, " "), lines[i].body, lines[i].sentence.length,
+               lines[i].totalNs / (double)(perRound * BENCH_ROUNDS), lines[i].worstNs, lines[i].parsed ? text : "FAILED");
+    }
+
+    bench_burst();
+    if(!bench_fullSize())
+        failed++;
+
+    printf("\nfloat vs fixed point, per sentence:\n");
+    for(i = 0; i < BENCH_LINES; i++){
+        if(lines[i].sentence.header == ('G' << 8 | 'N')){
+            bench_compare("$GN strtof / strtol", 0, &lines[i].sentence, iterations);
+            bench_compare("$GN float, one pass", 1, &lines[i].sentence, iterations);
+            bench_compare("$GN fixed (driver)", 2, &lines[i].sentence, iterations);
+        }
+        else if(lines[i].sentence.header == ('P' << 8 | 'W')){
+            bench_compare("$PW strtof", 3, &lines[i].sentence, iterations);
+            bench_compare("$PW float, one pass", 4, &lines[i].sentence, iterations);
+            bench_compare("$PW fixed (driver)", 5, &lines[i].sentence, iterations);
+        }
+    }
+    return failed ? 1 : 0;
+}
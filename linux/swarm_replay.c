@@ -0,0 +1,511 @@
+/*
+ * swarm_replay.c
+ *
+ *  Created on: Oct 16, 2026
+ *      Author: MicroTechEE
+ *
+ * Feeds a captured UART trace (SwarmTrace.h, SWTR or a text log) back through the real driver: every RX byte goes to
+ * swarm_rxByte() and swarm_handleMsg() runs after every line, the way linux_rxFeed() does it live. There's no tty and
+ * no wall clock, hal->millis() is the trace's own clock and delayMs() just moves it on, so the same trace does the
+ * same thing every time. Whatever the driver sends back is drained and hashed, TX records in the trace are only
+ * counted, the driver that made them may have been asked for different things than this one.
+ *
+ * The digest is FNV-1a over every sentence the event handlers see and every byte the driver sent. Keep it next to the
+ * trace and a driver change that handles the log differently shows up as a different number.
+ *
+ *      ./swarm_replay traces/m138_boot_err.log                 summary and digest
+ *      ./swarm_replay -b -n 50 field.swtr                      plus the benchmarks, 50 rounds each
+ *      ./swarm_replay -d 0xcdadb082 traces/m138_boot_err.log   exit 1 if the digest changed
+ *
+ * Benchmarks, each on the trace's RX lines:
+ *
+ *      parser      swarm_parserFeed() alone, sentences/s
+ *      handleMsg   the whole replay from swarm_modemInit(), parse functions, commands, events, sentences/s
+ *      checksum    swarm_checksum() over every line '$' to '*', MB/s
+ *      hex         swarm_transmitData() with a full 192 byte payload, hex straight into the TX ring, MB/s of payload
+ *
+ * and heap allocations and Message buffers taken per operation, both should stay at 0. malloc / calloc / realloc are
+ * counted with -Wl,--wrap, see the Makefile.
+ */
+
+// STD C
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+// POSIX
+#include <unistd.h>
+
+#include <Message.h>
+#include <SwarmMSP430.h>
+#include <SwarmHAL.h>
+#include "SwarmTrace.h"
+
+#define REPLAY_TD_PAYLOAD   192                 // the most one $TD takes
+#define REPLAY_TD_CALLS     2000                // per round
+
+/* * * * * * * * STRUCTS * * * * * * * * * */
+typedef struct{
+    unsigned long long ops;
+    unsigned long long ns;
+    unsigned long long bytes;
+    unsigned long allocs;
+    unsigned long messages;
+}ReplayBench;
+
+typedef struct{
+    unsigned char* rx;                          // every RX byte in the trace, in order
+    unsigned int rxLen;
+    unsigned int* lineStart;                    // offsets of each '$', for the checksum bench
+    unsigned int* lineLen;                      // up to the '*'
+    unsigned int lines;
+    unsigned long txRecords;
+    unsigned long long txBytes;
+}ReplayInput;
+
+/* - - - - - - - - - - - - - GLOBALS - - - - - - - - - - - - - - - */
+static unsigned long allocCalls = 0;            // by the wrappers below, from the first call on
+static unsigned long long replayUs = 0;         // the trace clock
+static unsigned long digest;
+static unsigned long driverTxBytes;
+static unsigned long driverTxLines;
+static unsigned long eventsSeen;
+static bool countTx = true;                     // off for the hex bench, nothing to hash there
+
+static SwarmModem modem;
+static SwarmQueueStore queueStore;
+
+/* - - - - - - - - - - - - - ALLOCATIONS - - - - - - - - - - - - - - - */
+void* __real_malloc(size_t size);
+void* __real_calloc(size_t count, size_t size);
+void* __real_realloc(void* ptr, size_t size);
+
+void* __wrap_malloc(size_t size)
+{
+    allocCalls++;
+    return __real_malloc(size);
+}
+
+void* __wrap_calloc(size_t count, size_t size)
+{
+    allocCalls++;
+    return __real_calloc(count, size);
+}
+
+void* __wrap_realloc(void* ptr, size_t size)
+{
+    allocCalls++;
+    return __real_realloc(ptr, size);
+}
+
+/* - - - - - - - - - - - - - REPLAY HAL - - - - - - - - - - - - - - - */
+static unsigned long replay_hash(unsigned long hash, const void* data, unsigned int len)
+{
+    const unsigned char* p = (const unsigned char*)data;
+
+    while(len--){
+        hash ^= *p++;
+        hash = (hash * 16777619UL) & 0xFFFFFFFFUL;
+    }
+    return hash;
+}
+
+static void replay_uartOpen(SwarmModem* m)
+{
+    (void)m;
+}
+
+static void replay_uartClose(SwarmModem* m)
+{
+    (void)m;
+}
+
+static void replay_uartTxStart(SwarmModem* m)
+{
+    // the "UART" takes everything at once
+    const unsigned char* data;
+    unsigned int len;
+    unsigned int i;
+
+    while((len = swarm_txPeek(&m->txRing, &data)) > 0){
+        if(countTx){
+            digest = replay_hash(digest, data, len);
+            driverTxBytes += len;
+            for(i = 0; i < len; i++)
+                driverTxLines += data[i] == '\n';
+        }
+        swarm_txConsume(&m->txRing, len);
+    }
+}
+
+static void replay_gpioWrite(SwarmModem* m, char pinState)
+{
+    (void)m;
+    (void)pinState;
+}
+
+static void replay_delayMs(unsigned int ms)
+{
+    replayUs += ms * 1000ULL;                   // nobody waits, the clock just moves
+}
+
+static void replay_rtcSet(Calendar dateTime)
+{
+    (void)dateTime;
+}
+
+static unsigned long replay_millis(void)
+{
+    return (unsigned long)(replayUs / 1000ULL);
+}
+
+static unsigned long long replay_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (unsigned long long)ts.tv_sec * 1000000000ULL + (unsigned long long)ts.tv_nsec;
+}
+
+static unsigned int replay_ticks(void)
+{
+    return (unsigned int)replay_ns();           // SwarmStats only, never in the digest
+}
+
+static const SwarmHal swarmHalReplay = {
+    replay_uartOpen,
+    replay_uartClose,
+    replay_uartTxStart,
+    replay_gpioWrite,
+    replay_delayMs,
+    replay_rtcSet,
+    replay_millis,
+    0,                                          // never sleeps, the next record is already here
+    replay_ticks
+};
+
+/* - - - - - - - - - - - - - FUNCTIONS - - - - - - - - - - - - - - - */
+static void replay_onSentence(SwarmModem* m, const SwarmSentence* sentence)
+{
+    unsigned char meta[4];
+
+    (void)m;
+    meta[0] = (unsigned char)(sentence->header >> 8);
+    meta[1] = (unsigned char)sentence->header;
+    meta[2] = sentence->status;
+    meta[3] = sentence->isError;
+    digest = replay_hash(digest, meta, sizeof(meta));
+    digest = replay_hash(digest, sentence->line, sentence->length);
+    eventsSeen++;
+}
+
+static bool replay_load(const char* path, ReplayInput* in)
+{
+    // the whole trace in memory, so the benchmarks time the driver and not the file
+    SwarmTrace trace;
+    SwarmTraceRecord* record = malloc(sizeof(*record));
+    unsigned int cap = 0;
+    unsigned int lineCap = 0;
+    unsigned int i;
+    unsigned int start = 0;
+    bool inLine = false;
+
+    memset(in, 0, sizeof(*in));
+    if(!record || swarm_traceOpen(&trace, path)){
+        perror(path);
+        free(record);
+        return false;
+    }
+    while(swarm_traceRead(&trace, record)){
+        if(record->dir == SwarmTraceTx){
+            in->txRecords++;
+            in->txBytes += record->len;
+            continue;
+        }
+        if(in->rxLen + record->len > cap){
+            cap = (in->rxLen + record->len) * 2;
+            in->rx = realloc(in->rx, cap);
+        }
+        memcpy(in->rx + in->rxLen, record->data, record->len);
+        in->rxLen += record->len;
+    }
+    swarm_traceClose(&trace);
+    free(record);
+
+    for(i = 0; i < in->rxLen; i++){
+        if(in->rx[i] == '$'){
+            start = i;
+            inLine = true;
+        }
+        else if(in->rx[i] == '*' && inLine){
+            if(in->lines == lineCap){
+                lineCap = lineCap ? lineCap * 2 : 256;
+                in->lineStart = realloc(in->lineStart, lineCap * sizeof(unsigned int));
+                in->lineLen = realloc(in->lineLen, lineCap * sizeof(unsigned int));
+            }
+            in->lineStart[in->lines] = start;
+            in->lineLen[in->lines] = i - start;
+            in->lines++;
+            inLine = false;
+        }
+        else if(in->rx[i] == '\n')
+            inLine = false;
+    }
+    return in->rxLen > 0;
+}
+
+static void replay_run(const char* path, bool timed, ReplayBench* bench)
+{
+    // the real thing, a fresh driver and the trace in file order with its timestamps
+    SwarmTrace trace;
+    static SwarmTraceRecord record;
+    unsigned long long start;
+    unsigned int i;
+    unsigned char byte;
+
+    if(swarm_traceOpen(&trace, path))
+        return;
+    digest = 2166136261UL;
+    driverTxBytes = 0;
+    driverTxLines = 0;
+    eventsSeen = 0;
+    replayUs = 0;
+    countTx = true;
+
+    start = replay_ns();
+    swarm_modemInit(&modem, &swarmHalReplay, 0, &queueStore);
+    swarm_eventOn(&modem.events, SWARM_EVENT_ANY, replay_onSentence);
+    swarm_startup(&modem);
+    while(swarm_traceRead(&trace, &record)){
+        if(record.timeUs > replayUs)
+            replayUs = record.timeUs;           // a delayMs() may have pushed us past it already
+        if(record.dir == SwarmTraceTx)
+            continue;
+        for(i = 0; i < record.len; i++){
+            byte = record.data[i];
+#if SAT_RX_FROM_MESSAGE
+            message_rxByte((MessagePort)modem.rxMessagePort, byte);
+#else
+            swarm_rxByte(&modem, byte);
+#endif
+            if(byte == '\n')
+                swarm_handleMsg(&modem);
+        }
+        swarm_handleMsg(&modem);                // timers, the same as a poll that timed out
+    }
+    if(timed){
+        bench->ns += replay_ns() - start;       // the file reads are in there too, they're buffered and small
+        bench->ops += modem.parser.stats.sentences;
+        bench->bytes += trace.bytes[SwarmTraceRx];
+    }
+    swarm_traceClose(&trace);
+}
+
+static bool replay_benchHandle(const char* path, unsigned int rounds, ReplayBench* bench)
+{
+    // true if every round came out with the same digest as the first replay
+    unsigned long first = digest;
+    bool same = true;
+    unsigned int r;
+
+    for(r = 0; r < rounds; r++){
+        replay_run(path, true, bench);
+        if(digest != first)
+            same = false;
+    }
+    return same;
+}
+
+static void replay_benchParser(const ReplayInput* in, unsigned int rounds, ReplayBench* bench)
+{
+    static SwarmParser parser;
+    unsigned long long start;
+    unsigned int r;
+    unsigned int i;
+
+    start = replay_ns();
+    for(r = 0; r < rounds; r++){
+        swarm_parserInit(&parser);
+        for(i = 0; i < in->rxLen; i++){
+            swarm_parserFeed(&parser, in->rx[i]);
+            if(in->rx[i] == '\n' && swarm_parserGet(&parser))
+                swarm_parserRelease(&parser);
+        }
+        bench->ops += parser.stats.sentences;
+        bench->bytes += in->rxLen;
+    }
+    bench->ns += replay_ns() - start;
+}
+
+static void replay_benchChecksum(const ReplayInput* in, unsigned int rounds, ReplayBench* bench)
+{
+    volatile unsigned char sink = 0;
+    unsigned long long start;
+    unsigned int r;
+    unsigned int i;
+
+    start = replay_ns();
+    for(r = 0; r < rounds * 10; r++){           // it's quick, give the clock something to measure
+        for(i = 0; i < in->lines; i++){
+            sink ^= swarm_checksum((const char*)in->rx + in->lineStart[i], in->lineLen[i]);
+            bench->bytes += in->lineLen[i];
+        }
+        bench->ops += in->lines;
+    }
+    bench->ns += replay_ns() - start;
+    (void)sink;
+}
+
+static void replay_benchHex(unsigned int rounds, ReplayBench* bench)
+{
+    static char payload[REPLAY_TD_PAYLOAD];
+    unsigned long long start;
+    unsigned int r;
+    unsigned int i;
+
+    for(i = 0; i < sizeof(payload); i++)
+        payload[i] = (char)(i * 37 + 11);
+    countTx = false;
+    swarm_modemInit(&modem, &swarmHalReplay, 0, &queueStore);
+    swarm_startup(&modem);                      // its init commands aren't timed
+
+    start = replay_ns();
+    for(r = 0; r < rounds; r++){
+        for(i = 0; i < REPLAY_TD_CALLS; i++){
+            if(swarm_transmitData(&modem, SAT_MSG_APPLICATION_ID, SAT_MSG_HOLD_TIME_1DAY, payload, sizeof(payload)) == 0)
+                fprintf(stderr, "swarm_replay: $TD didn't fit the TX ring\n");
+        }
+        bench->ops += REPLAY_TD_CALLS;
+        bench->bytes += REPLAY_TD_CALLS * sizeof(payload);
+    }
+    bench->ns += replay_ns() - start;
+    countTx = true;
+}
+
+static void replay_report(const char* name, const ReplayBench* bench, const char* unit, double rate)
+{
+    printf("%-10s %10llu ops %9.1f ns/op %12.1f %-14s %6.2f allocs/op %6.2f msgs/op\n", name, bench->ops,
+           bench->ops ? bench->ns / (double)bench->ops : 0.0, rate, unit,
+           bench->ops ? bench->allocs / (double)bench->ops : 0.0, bench->ops ? bench->messages / (double)bench->ops : 0.0);
+}
+
+#define REPLAY_BENCH(bench, call)   do{ unsigned long a_ = allocCalls; unsigned long m_ = messageStats.requests;      \
+                                        memset(&(bench), 0, sizeof(bench)); call;                                       \
+                                        (bench).allocs = allocCalls - a_; (bench).messages = messageStats.requests - m_; \
+                                    }while(0)
+
+int main(int argc, char** argv)
+{
+    ReplayInput in;
+    ReplayBench parser;
+    ReplayBench handle;
+    ReplayBench checksum;
+    ReplayBench hex;
+    unsigned long expect = 0;
+    unsigned int rounds = 20;
+    unsigned int i;
+    unsigned long matched = 0;
+    unsigned long differ = 0;
+    bool benchmarks = false;
+    bool verbose = false;
+    bool changed = false;
+    bool same = true;
+    int opt;
+    int a;
+
+    while((opt = getopt(argc, argv, "bn:d:vh")) != -1){
+        switch(opt){
+        case 'b': benchmarks = true; break;
+        case 'n': rounds = (unsigned int)atoi(optarg); break;
+        case 'd': expect = strtoul(optarg, 0, 0); break;
+        case 'v': verbose = true; break;
+        default:
+            fprintf(stderr, "usage: %s [-b] [-n rounds] [-d expected_digest] [-v] trace...\n", argv[0]);
+            return 2;
+        }
+    }
+    if(optind >= argc){
+        fprintf(stderr, "usage: %s [-b] [-n rounds] [-d expected_digest] [-v] trace...\n", argv[0]);
+        return 2;
+    }
+    if(rounds == 0)
+        rounds = 1;
+
+    for(a = optind; a < argc; a++){
+        if(!replay_load(argv[a], &in)){
+            fprintf(stderr, "swarm_replay: %s has no RX bytes\n", argv[a]);
+            return 1;
+        }
+
+        replay_run(argv[a], false, 0);
+        printf("swarm_replay: %s\n", argv[a]);
+        printf("trace     : %u RX bytes, %u lines, %lu TX records %llu bytes, %.1f s\n", in.rxLen, in.lines,
+               in.txRecords, in.txBytes, replayUs / 1e6);
+        printf("parser    : %lu sentences, %lu bad checksum, %lu no checksum, %lu noise, %lu too long, %lu dropped\n",
+               modem.parser.stats.sentences, modem.parser.stats.badChecksum, modem.parser.stats.noChecksum,
+               modem.parser.stats.noise, modem.parser.stats.overflow, modem.parser.stats.dropped);
+        printf("            line pool high water: short %u/%u mid %u/%u full %u/%u, %lu took a bigger size, %lu found none\n",
+               modem.parser.pool.stats[SwarmPoolShort].highWater, SWARM_POOL_SHORT_COUNT,
+               modem.parser.pool.stats[SwarmPoolMid].highWater, SWARM_POOL_MID_COUNT,
+               modem.parser.pool.stats[SwarmPoolFull].highWater, SWARM_POOL_FULL_COUNT,
+               modem.parser.pool.stats[SwarmPoolShort].bigger + modem.parser.pool.stats[SwarmPoolMid].bigger,
+               modem.parser.pool.stats[SwarmPoolShort].empty + modem.parser.pool.stats[SwarmPoolMid].empty +
+               modem.parser.pool.stats[SwarmPoolFull].empty);
+        printf("driver    : %lu events, %lu lines %lu bytes sent, %s, device 0x%06lx, %lu reboots seen\n",
+               eventsSeen, driverTxLines, driverTxBytes, modem.info.satFullyInitialized ? "initialized" : "not initialized",
+               (unsigned long)modem.info.deviceID.asLong, modem.warm.stats.reboots);
+#if SWARM_STATS_ENABLE
+        printf("            %lu ERR replies, Message pool high water %u\n", modem.stats.errors, modem.stats.messageHighWater);
+#endif
+        printf("errors    : %lu full, %lu bad command, %lu bad checksum, %lu other ERR   %lu dropped, %lu retried, %lu backed off\n",
+               modem.errors.stats.codes[SwarmErrFull], modem.errors.stats.codes[SwarmErrBadCommand],
+               modem.errors.stats.codes[SwarmErrBadChecksum],
+               modem.errors.stats.codes[SwarmErrNoTime] + modem.errors.stats.codes[SwarmErrBusy] +
+               modem.errors.stats.codes[SwarmErrNotFound] + modem.errors.stats.codes[SwarmErrOther],
+               modem.errors.stats.recoveries[SwarmRecoverDrop], modem.errors.stats.recoveries[SwarmRecoverRetry],
+               modem.errors.stats.recoveries[SwarmRecoverBackoff]);
+        printf("            faults: %lu boot, %lu abort, %lu noise, %lu silent   %lu recovered, %lu ms max, last $%c%c ERR,%s\n",
+               modem.errors.stats.faults[SwarmFaultBoot], modem.errors.stats.faults[SwarmFaultAbort],
+               modem.errors.stats.faults[SwarmFaultNoise], modem.errors.stats.faults[SwarmFaultSilent],
+               modem.errors.stats.recovered, modem.errors.stats.recoveryMaxMs, (char)(modem.errors.last.header >> 8),
+               (char)modem.errors.last.header, modem.errors.last.text);
+        printf("digest    : 0x%08lx\n", digest);
+        if(expect && digest != expect){
+            printf("            CHANGED, expected 0x%08lx\n", expect);
+            changed = true;
+        }
+
+        if(verbose){
+            for(i = 0; i < in.lines; i++){
+                if(in.lineStart[i] + in.lineLen[i] + 2 >= in.rxLen)
+                    continue;
+                if(strtoul((const char*)in.rx + in.lineStart[i] + in.lineLen[i] + 1, 0, 16) ==
+                   swarm_checksum((const char*)in.rx + in.lineStart[i], in.lineLen[i]))
+                    matched++;
+                else
+                    differ++;
+            }
+            printf("checksums : %lu lines match their *xx, %lu don't\n", matched, differ);
+        }
+
+        if(benchmarks){
+            REPLAY_BENCH(parser, replay_benchParser(&in, rounds, &parser));
+            REPLAY_BENCH(handle, same = replay_benchHandle(argv[a], rounds, &handle));
+            REPLAY_BENCH(checksum, replay_benchChecksum(&in, rounds, &checksum));
+            REPLAY_BENCH(hex, replay_benchHex(rounds, &hex));
+            replay_report("parser", &parser, "sentences/s", parser.ns ? parser.ops * 1e9 / parser.ns : 0.0);
+            replay_report("handleMsg", &handle, "sentences/s", handle.ns ? handle.ops * 1e9 / handle.ns : 0.0);
+            replay_report("checksum", &checksum, "MB/s", checksum.ns ? checksum.bytes * 1e3 / checksum.ns : 0.0);
+            replay_report("hex", &hex, "MB/s payload", hex.ns ? hex.bytes * 1e3 / hex.ns : 0.0);
+            printf("            %u rounds, every replay gave the same digest: %s\n", rounds, same ? "yes" : "NO");
+            if(!same)
+                changed = true;
+        }
+        free(in.rx);
+        free(in.lineStart);
+        free(in.lineLen);
+    }
+    return changed ? 1 : 0;
+}
@@ -0,0 +1,66 @@
+/*
+ * swarm_sim.c
+ *
+ *  Created on: Oct 16, 2026
+ *      Author: MicroTechEE
+ *
+ * Standalone M138 simulator. Prints the pty to point your driver (or minicom) at, then runs forever.
+ *
+ *      ./swarm_sim -l 20 -j 10 -b 2000 -n 12 -v
+ */
+
+// STD C
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+// POSIX
+#include <unistd.h>
+
+#include "SwarmSim.h"
+
+static void usage(const char* name)
+{
+    fprintf(stderr,
+            "usage: %s [-l latency_ms] [-j jitter_ms] [-b boot_ms] [-n noise_lines] [-d datetime_ms]\n"
+            "          [-p position_ms] [-t tdsent_ms] [-s time_scale] [-r bkgnd_rssi] [-x loss_%%]\n"
+            "          [-D downlink_ms] [-B downlink_burst] [-S seed] [-v]\n", name);
+}
+
+int main(int argc, char** argv)
+{
+    SwarmSimConfig config;
+    SwarmSim sim;
+    int opt;
+
+    swarmsim_defaultConfig(&config);
+    while((opt = getopt(argc, argv, "l:j:b:n:d:p:t:s:r:x:D:B:S:vh")) != -1){
+        switch(opt){
+        case 'l': config.latencyMs = (unsigned int)atoi(optarg); break;
+        case 'j': config.jitterMs = (unsigned int)atoi(optarg); break;
+        case 'b': config.bootMs = (unsigned int)atoi(optarg); break;
+        case 'n': config.bootNoiseLines = (unsigned int)atoi(optarg); break;
+        case 'd': config.dateTimeMs = (unsigned int)atoi(optarg); break;
+        case 'p': config.positionMs = (unsigned int)atoi(optarg); break;
+        case 't': config.tdSentMs = (unsigned int)atoi(optarg); break;
+        case 's': config.timeScale = (unsigned int)atoi(optarg); break;
+        case 'r': config.backgroundRssi = atoi(optarg); break;
+        case 'x': config.lossPercent = (unsigned int)atoi(optarg); break;
+        case 'D': config.downlinkMs = (unsigned int)atoi(optarg); break;
+        case 'B': config.downlinkBurst = (unsigned int)atoi(optarg); break;
+        case 'S': config.seed = (unsigned int)atoi(optarg); break;
+        case 'v': config.verbose = true; break;
+        default: usage(argv[0]); return 2;
+        }
+    }
+
+    if(swarmsim_open(&sim, &config)){
+        perror("swarmsim_open");
+        return 1;
+    }
+    printf("%s\n", sim.slavePath);
+    fflush(stdout);
+
+    for(;;)
+        swarmsim_step(&sim, 50);
+}
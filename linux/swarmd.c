@@ -0,0 +1,123 @@
+/*
+ * swarmd.c
+ *
+ *  Created on: Oct 16, 2026
+ *      Author: MicroTechEE
+ *
+ * SwarmDaemon as a program: owns one modem, serves everyone on the box over a Unix socket. See SwarmDaemon.h for
+ * the protocol.
+ *
+ *      ./swarmd -s /run/swarmd.sock /dev/ttyUSB0
+ *      ./swarmd -S                                 against the simulator, with a downlink burst every 5 s
+ *
+ *      printf 'SUB *\nTD 1 48656c6c6f\nTD 2 "Hello"\n' | nc -U -q 30 /tmp/swarmd.sock
+ */
+
+// STD C
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <signal.h>
+
+// POSIX
+#include <unistd.h>
+
+#include <SwarmMSP430.h>
+#include "SwarmHAL_Linux.h"
+#include "SwarmDaemon.h"
+#include "SwarmSim.h"
+
+/* - - - - - - - - - - - - - GLOBALS - - - - - - - - - - - - - - - */
+static SwarmDaemon swarmd;
+static SwarmSim sim;
+static volatile sig_atomic_t stop = 0;
+
+/* - - - - - - - - - - - - - FUNCTIONS - - - - - - - - - - - - - - - */
+static void swarmd_onSignal(int sig)
+{
+    (void)sig;
+    stop = 1;
+}
+
+static void swarmd_printStats(void)
+{
+    const SwarmDaemonStats* s = &swarmd.stats;
+
+    printf("swarmd: %u clients, %lu submitted in %lu batches, %lu OK (%.1f ms avg, %.1f max), %lu SENT, %lu ERR, "
+           "%lu full, %lu bad, %lu RD out, %lu orphaned, %lu slow, backlog %u queue %u\n",
+           swarm_daemonClients(&swarmd), s->submitted, s->batches, s->accepted,
+           s->accepted ? s->acceptUs / 1000.0 / s->accepted : 0.0, s->acceptUsMax / 1000.0, s->sent, s->rejected,
+           s->full, s->bad, s->downlinks, s->orphaned, s->slow, swarmd.head - swarmd.tail,
+           swarm_queueDepth(&swarmd.modem.queue));
+    fflush(stdout);
+}
+
+int main(int argc, char** argv)
+{
+    SwarmSimConfig config;
+    const char* socketPath = "/tmp/swarmd.sock";
+    const char* ttyPath;
+    unsigned long long lastPrint;
+    unsigned int printSeconds = 0;
+    bool simulate = false;
+    int opt;
+
+    while((opt = getopt(argc, argv, "s:Sp:h")) != -1){
+        switch(opt){
+        case 's': socketPath = optarg; break;
+        case 'S': simulate = true; break;
+        case 'p': printSeconds = (unsigned int)atoi(optarg); break;
+        default:
+            fprintf(stderr, "usage: %s [-s socket] [-p stats_seconds] (-S | tty)\n", argv[0]);
+            return 2;
+        }
+    }
+    if(!simulate && optind >= argc){
+        fprintf(stderr, "usage: %s [-s socket] [-p stats_seconds] (-S | tty)\n", argv[0]);
+        return 2;
+    }
+
+    ttyPath = simulate ? 0 : argv[optind];
+    if(simulate){
+        swarmsim_defaultConfig(&config);
+        config.bootMs = 100;
+        config.dateTimeMs = 0;
+        config.downlinkMs = 5000;
+        if(swarmsim_open(&sim, &config) || swarmsim_start(&sim)){
+            perror("swarmsim");
+            return 1;
+        }
+        while(!swarmsim_isRunning(&sim))
+            usleep(1000);
+        ttyPath = sim.slavePath;
+    }
+
+    if(!swarm_daemonInit(&swarmd, ttyPath, socketPath)){
+        perror(socketPath);
+        return 1;
+    }
+    signal(SIGINT, swarmd_onSignal);
+    signal(SIGTERM, swarmd_onSignal);
+    printf("swarmd: %s on %s\n", ttyPath, socketPath);
+    fflush(stdout);
+
+    lastPrint = swarm_halLinuxMicros();
+    while(!stop){
+        if(swarm_daemonRun(&swarmd, 100) < 0){
+            perror("epoll_wait");
+            break;
+        }
+        if(printSeconds && swarm_halLinuxMicros() - lastPrint >= printSeconds * 1000000ULL){
+            lastPrint = swarm_halLinuxMicros();
+            swarmd_printStats();
+        }
+    }
+    swarmd_printStats();
+    swarm_daemonClose(&swarmd);
+    if(simulate){
+        swarmsim_stop(&sim);
+        swarmsim_close(&sim);
+    }
+    return 0;
+}
@@ -0,0 +1,312 @@
+/*
+ * swarmd_bench.c
+ *
+ *  Created on: Oct 16, 2026
+ *      Author: MicroTechEE
+ *
+ * SwarmDaemon against the simulator with -c client threads on its socket, each submitting its share of -n $TD
+ * -b lines to a write(), and subscribed to one of the simulator's downlink appIDs. Times submit -> Q (the daemon
+ * has it), submit -> OK (the modem has it) and counts every SENT and RD that comes back, then does it again with
+ * more clients and bigger batches. syscalls/job is the daemon's read()s and write()s on client sockets per job.
+ *
+ *      ./swarmd_bench -n 200 -c 8 -b 16
+ */
+
+// STD C
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+
+// POSIX
+#include <pthread.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <SwarmMSP430.h>
+#include "SwarmHAL_Linux.h"
+#include "SwarmDaemon.h"
+#include "SwarmSim.h"
+
+#define BENCH_SOCKET        "/tmp/swarmd_bench.sock"
+#define BENCH_CLIENTS_MAX   SWARM_DAEMON_CLIENTS
+#define BENCH_JOBS_MAX      1024
+#define BENCH_PAYLOAD       64
+
+/* * * * * * * * STRUCTS * * * * * * * * * */
+typedef struct{
+    unsigned int index;
+    unsigned int jobs;
+    unsigned int batch;
+    unsigned long long submitUs[BENCH_JOBS_MAX];
+    unsigned long long queuedUs;                // sums
+    unsigned long long okUs;
+    unsigned long long okUsMax;
+    unsigned int queued;
+    unsigned int ok;
+    unsigned int sent;
+    unsigned int err;
+    unsigned int rd;
+    unsigned int other;
+    unsigned int writes;
+    bool failed;
+    volatile bool finished;                     // the thread is done with everything above
+    pthread_t thread;
+}BenchClient;
+
+/* - - - - - - - - - - - - - GLOBALS - - - - - - - - - - - - - - - */
+static SwarmDaemon swarmd;
+static SwarmSim sim;
+static BenchClient clients[BENCH_CLIENTS_MAX];
+
+/* - - - - - - - - - - - - - FUNCTIONS - - - - - - - - - - - - - - - */
+static int bench_connect(void)
+{
+    struct sockaddr_un addr;
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    strncpy(addr.sun_path, BENCH_SOCKET, sizeof(addr.sun_path) - 1);
+    if(fd < 0 || connect(fd, (struct sockaddr*)&addr, sizeof(addr)) < 0){
+        if(fd >= 0)
+            close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+static void bench_answer(BenchClient* c, char* line)
+{
+    unsigned long tag;
+    unsigned long long us;
+    char kind[8];
+
+    if(sscanf(line, "%7s %lu", kind, &tag) != 2){
+        c->other++;
+        return;
+    }
+    if(strcmp(kind, "RD") == 0){
+        c->rd++;
+        return;
+    }
+    if(tag >= c->jobs){
+        c->other++;
+        return;
+    }
+    us = swarm_halLinuxMicros() - c->submitUs[tag];
+    if(strcmp(kind, "Q") == 0){
+        c->queued++;
+        c->queuedUs += us;
+    }
+    else if(strcmp(kind, "OK") == 0){
+        c->ok++;
+        c->okUs += us;
+        if(us > c->okUsMax)
+            c->okUsMax = us;
+    }
+    else if(strcmp(kind, "SENT") == 0)
+        c->sent++;
+    else if(strcmp(kind, "ERR") == 0)
+        c->err++;
+    else
+        c->other++;
+}
+
+static void* bench_client(void* arg)
+{
+    // what a producer process would do: connect, subscribe, fire off batches without waiting, then read the answers
+    BenchClient* c = (BenchClient*)arg;
+    char out[BENCH_CLIENTS_MAX * (BENCH_PAYLOAD * 2 + 32)];
+    char in[16384];
+    unsigned int inLen = 0;
+    unsigned int outLen;
+    unsigned int next = 0;
+    unsigned int i;
+    unsigned int b;
+    unsigned long long start = swarm_halLinuxMicros();
+    struct pollfd pfd;
+    char* line;
+    char* end;
+    ssize_t n;
+    int fd = bench_connect();
+
+    if(fd < 0){
+        c->failed = true;
+        c->finished = true;
+        return 0;
+    }
+    outLen = (unsigned int)snprintf(out, sizeof(out), "SUB %u\n", SWARMSIM_RX_APP_BASE + c->index % 4);
+    while(c->sent + c->err < c->jobs && swarm_halLinuxMicros() - start < 60000000ULL){
+        for(b = 0; next < c->jobs && b < c->batch; b++, next++){
+            outLen += (unsigned int)snprintf(out + outLen, sizeof(out) - outLen, "TD %u ", next);
+            for(i = 0; i < BENCH_PAYLOAD; i++)
+                outLen += (unsigned int)snprintf(out + outLen, sizeof(out) - outLen, "%02x",
+                                                 (c->index * 31 + next * 7 + i) & 0xFF);
+            out[outLen++] = '\n';
+            c->submitUs[next] = swarm_halLinuxMicros();
+        }
+        if(outLen){
+            if(write(fd, out, outLen) != (ssize_t)outLen){
+                c->failed = true;
+                break;
+            }
+            c->writes++;
+            outLen = 0;
+        }
+
+        pfd.fd = fd;
+        pfd.events = POLLIN;
+        if(poll(&pfd, 1, next < c->jobs ? 0 : 100) <= 0)
+            continue;
+        n = read(fd, in + inLen, sizeof(in) - 1 - inLen);
+        if(n <= 0){
+            c->failed = true;
+            break;
+        }
+        inLen += (unsigned int)n;
+        in[inLen] = '\0';
+        line = in;
+        while((end = strchr(line, '\n')) != 0){
+            *end = '\0';
+            bench_answer(c, line);
+            line = end + 1;
+        }
+        inLen -= (unsigned int)(line - in);
+        memmove(in, line, inLen);
+    }
+    close(fd);
+    c->finished = true;
+    return 0;
+}
+
+static void bench_run(unsigned int clientCount, unsigned int jobs, unsigned int batch)
+{
+    SwarmDaemonStats before = swarmd.stats;
+    unsigned long long start;
+    unsigned long long elapsed;
+    unsigned long long queuedUs = 0;
+    unsigned long long okUs = 0;
+    unsigned long long okUsMax = 0;
+    unsigned int queued = 0;
+    unsigned int ok = 0;
+    unsigned int sent = 0;
+    unsigned int err = 0;
+    unsigned int rd = 0;
+    unsigned int writes = 0;
+    unsigned int total = 0;
+    unsigned int done;
+    unsigned int i;
+    bool failed = false;
+
+    start = swarm_halLinuxMicros();
+    for(i = 0; i < clientCount; i++){
+        memset(&clients[i], 0, sizeof(clients[i]));
+        clients[i].index = i;
+        clients[i].jobs = jobs / clientCount;
+        clients[i].batch = batch;
+        total += clients[i].jobs;
+        pthread_create(&clients[i].thread, 0, bench_client, &clients[i]);
+    }
+    // the daemon runs here, on the main thread, until every client has its answers
+    do{
+        swarm_daemonRun(&swarmd, 5);
+        for(i = 0, done = 0; i < clientCount; i++)
+            done += clients[i].finished;
+    }while(done < clientCount);
+    elapsed = swarm_halLinuxMicros() - start;
+    for(i = 0; i < clientCount; i++){
+        pthread_join(clients[i].thread, 0);
+        queued += clients[i].queued;
+        queuedUs += clients[i].queuedUs;
+        ok += clients[i].ok;
+        okUs += clients[i].okUs;
+        if(clients[i].okUsMax > okUsMax)
+            okUsMax = clients[i].okUsMax;
+        sent += clients[i].sent;
+        err += clients[i].err;
+        rd += clients[i].rd;
+        writes += clients[i].writes;
+        failed |= clients[i].failed;
+    }
+    for(i = 0; i < 50; i++)
+        swarm_daemonRun(&swarmd, 1);            // let it see the hang ups
+
+    printf("%2u clients batch %2u: %4u jobs in %7.1f ms %6.1f OK/s   Q %6.3f ms   OK %6.1f ms avg %6.1f max   "
+           "%u SENT %u ERR %u RD   %.2f syscalls/job %.2f client writes/job%s\n",
+           clientCount, batch, total, elapsed / 1000.0, elapsed ? ok * 1e6 / (double)elapsed : 0.0,
+           queued ? queuedUs / 1000.0 / queued : 0.0, ok ? okUs / 1000.0 / ok : 0.0, okUsMax / 1000.0, sent, err, rd,
+           total ? (swarmd.stats.reads - before.reads + swarmd.stats.writes - before.writes) / (double)total : 0.0,
+           total ? writes / (double)total : 0.0, failed ? " (A CLIENT FAILED)" : "");
+}
+
+int main(int argc, char** argv)
+{
+    SwarmSimConfig config;
+    unsigned long long start;
+    unsigned int jobs = 200;
+    unsigned int clientMax = 8;
+    unsigned int batchMax = 16;
+    unsigned int c;
+    unsigned int b;
+    int opt;
+
+    swarmsim_defaultConfig(&config);
+    config.bootMs = 100;
+    config.dateTimeMs = 0;
+    config.tdSentMs = 200;
+    config.downlinkMs = 500;
+    config.downlinkBurst = 2;
+    while((opt = getopt(argc, argv, "n:c:b:l:j:vh")) != -1){
+        switch(opt){
+        case 'n': jobs = (unsigned int)atoi(optarg); break;
+        case 'c': clientMax = (unsigned int)atoi(optarg); break;
+        case 'b': batchMax = (unsigned int)atoi(optarg); break;
+        case 'l': config.latencyMs = (unsigned int)atoi(optarg); break;
+        case 'j': config.jitterMs = (unsigned int)atoi(optarg); break;
+        case 'v': config.verbose = true; break;
+        default:
+            fprintf(stderr, "usage: %s [-n jobs] [-c max_clients] [-b max_batch] [-l latency_ms] [-j jitter_ms] [-v]\n",
+                    argv[0]);
+            return 2;
+        }
+    }
+    if(clientMax < 1 || clientMax > BENCH_CLIENTS_MAX)
+        clientMax = clientMax < 1 ? 1 : BENCH_CLIENTS_MAX;
+    if(batchMax < 1 || batchMax > BENCH_CLIENTS_MAX)
+        batchMax = batchMax < 1 ? 1 : BENCH_CLIENTS_MAX;
+    if(jobs > BENCH_JOBS_MAX)
+        jobs = BENCH_JOBS_MAX;
+
+    if(swarmsim_open(&sim, &config) || swarmsim_start(&sim)){
+        perror("swarmsim");
+        return 1;
+    }
+    while(!swarmsim_isRunning(&sim))
+        usleep(1000);
+    if(!swarm_daemonInit(&swarmd, sim.slavePath, BENCH_SOCKET)){
+        perror(BENCH_SOCKET);
+        return 1;
+    }
+    start = swarm_halLinuxMicros();
+    while(!swarmd.modem.info.satFullyInitialized && swarm_halLinuxMicros() - start < 30000000ULL)
+        swarm_daemonRun(&swarmd, 5);
+
+    printf("swarmd_bench: %u jobs of %u bytes, latency %u ms jitter %u ms, $TD SENT after %u ms\n", jobs, BENCH_PAYLOAD,
+           config.latencyMs, config.jitterMs, config.tdSentMs);
+    for(c = 1; c <= clientMax; c *= 4){
+        for(b = 1; b <= batchMax; b *= 16)
+            bench_run(c, jobs, b);
+    }
+    printf("              daemon: %lu submits in %lu batches, %lu OK %lu SENT %lu ERR, %lu RD out, %lu orphaned, %lu slow clients\n",
+           swarmd.stats.submitted, swarmd.stats.batches, swarmd.stats.accepted, swarmd.stats.sent, swarmd.stats.rejected,
+           swarmd.stats.downlinks, swarmd.stats.orphaned, swarmd.stats.slow);
+
+    swarm_daemonClose(&swarmd);
+    swarmsim_stop(&sim);
+    swarmsim_close(&sim);
+    return 0;
+}